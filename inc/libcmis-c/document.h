@@ -61,6 +61,67 @@ LIBCMIS_C_API void libcmis_document_setContentStream(
         bool overwrite,
         libcmis_ErrorPtr );
 
+/** Open the content stream of the document to read it chunk by chunk
+    using libcmis_content_stream_read( ). The returned handle needs to
+    be closed with libcmis_content_stream_close( ).
+
+    \param streamId the id of the rendition to read or NULL for the
+                    main content stream
+  */
+LIBCMIS_C_API libcmis_ContentStreamPtr libcmis_document_openContentStream(
+        libcmis_DocumentPtr document,
+        const char* streamId,
+        libcmis_ErrorPtr error );
+
+/** Set the document content, pulling it from the stream when the
+    request body is sent rather than copying it first.
+
+    \param stream a stream created by libcmis_content_stream_create( )
+  */
+LIBCMIS_C_API void libcmis_document_uploadContentStream(
+        libcmis_DocumentPtr document,
+        libcmis_ContentStreamPtr stream,
+        const char* contentType,
+        const char* filename,
+        bool overwrite,
+        libcmis_ErrorPtr error );
+
+/** Create a stream pulling the content to upload from readFn, chunkSize
+    bytes at a time.
+
+    \param seekFn an fseek-like function to rewind the content when a
+                  request needs to be sent again. Can be NULL, but the
+                  upload may then need to hold the whole content.
+    \param length the content length or -1 if unknown
+  */
+LIBCMIS_C_API libcmis_ContentStreamPtr libcmis_content_stream_create(
+        libcmis_readFn readFn,
+        libcmis_seekFn seekFn,
+        void* userData,
+        long length,
+        size_t chunkSize );
+
+/** Read up to size bytes of the stream into buffer.
+
+    \return the number of bytes read, 0 at the end of the stream,
+            after an error or once the stream has been cancelled.
+  */
+LIBCMIS_C_API size_t libcmis_content_stream_read(
+        libcmis_ContentStreamPtr stream,
+        void* buffer,
+        size_t size,
+        libcmis_ErrorPtr error );
+
+LIBCMIS_C_API bool libcmis_content_stream_isEof( libcmis_ContentStreamPtr stream );
+
+/** Stop the transfer: the next chunk won't be read. This function can be
+    called from another thread or from the readFn of an upload.
+  */
+LIBCMIS_C_API void libcmis_content_stream_cancel( libcmis_ContentStreamPtr stream );
+LIBCMIS_C_API bool libcmis_content_stream_isCancelled( libcmis_ContentStreamPtr stream );
+
+LIBCMIS_C_API void libcmis_content_stream_close( libcmis_ContentStreamPtr stream );
+
 /** The resulting value needs to be free'd
   */
 LIBCMIS_C_API char* libcmis_document_getContentType( libcmis_DocumentPtr document );
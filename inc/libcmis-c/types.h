@@ -99,6 +99,8 @@ typedef enum
 typedef struct libcmis_document* libcmis_DocumentPtr;
 typedef size_t ( *libcmis_writeFn )( const void*, size_t, size_t, void* );
 typedef size_t ( *libcmis_readFn )( void*, size_t, size_t, void* );
+typedef int ( *libcmis_seekFn )( void*, long, int );
+typedef struct libcmis_content_stream* libcmis_ContentStreamPtr;
 
 typedef struct libcmis_vector_document* libcmis_vector_document_Ptr;
 
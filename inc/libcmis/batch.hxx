@@ -0,0 +1,155 @@
+/* libcmis
+ * Version: MPL 1.1 / GPLv2+ / LGPLv2+
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License or as specified alternatively below. You may obtain a copy of
+ * the License at http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * Major Contributor(s):
+ *
+ *
+ * All Rights Reserved.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPLv2+"), or
+ * the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+ * in which case the provisions of the GPLv2+ or the LGPLv2+ are applicable
+ * instead of those above.
+ */
+#ifndef _BATCH_HXX_
+#define _BATCH_HXX_
+
+#include <string>
+
+#include <boost/shared_ptr.hpp>
+
+#include "libcmis/exception.hxx"
+#include "libcmis/libcmis-api.h"
+#include "libcmis/object.hxx"
+
+namespace libcmis
+{
+    /** Tuning parameters for the operations working on several objects at once.
+      */
+    class LIBCMIS_API BatchOptions
+    {
+        private:
+            unsigned int m_maxConcurrency;
+            unsigned int m_maxBatchSize;
+
+        public:
+            BatchOptions( unsigned int maxConcurrency = 8, unsigned int maxBatchSize = 100 ) :
+                m_maxConcurrency( maxConcurrency ),
+                m_maxBatchSize( maxBatchSize )
+            {
+            }
+
+            /** Maximum number of HTTP requests running at the same time.
+              */
+            unsigned int getMaxConcurrency( ) const { return m_maxConcurrency > 0 ? m_maxConcurrency : 1; }
+            void setMaxConcurrency( unsigned int maxConcurrency ) { m_maxConcurrency = maxConcurrency; }
+
+            /** Maximum number of items sent in one server-side batch request.
+                The bindings may use a lower value if the server limits it.
+              */
+            unsigned int getMaxBatchSize( ) const { return m_maxBatchSize > 0 ? m_maxBatchSize : 1; }
+            void setMaxBatchSize( unsigned int maxBatchSize ) { m_maxBatchSize = maxBatchSize; }
+    };
+
+    /** Outcome of the lookup of one object in Session::getObjects( ).
+      */
+    class LIBCMIS_API ObjectResult
+    {
+        private:
+            std::string m_id;
+            ObjectPtr m_object;
+            boost::shared_ptr< Exception > m_error;
+
+        public:
+            ObjectResult( std::string id, ObjectPtr object ) :
+                m_id( id ),
+                m_object( object ),
+                m_error( )
+            {
+            }
+
+            ObjectResult( std::string id, const Exception& error ) :
+                m_id( id ),
+                m_object( ),
+                m_error( new Exception( error ) )
+            {
+            }
+
+            /** The id as it was requested.
+              */
+            std::string getId( ) const { return m_id; }
+
+            bool isOk( ) const { return m_object.get( ) != NULL; }
+
+            /** The object, or an empty pointer if it couldn't be fetched.
+              */
+            ObjectPtr getObject( ) const { return m_object; }
+
+            /** The reason of the failure, or an empty pointer if there was none.
+              */
+            boost::shared_ptr< Exception > getError( ) const { return m_error; }
+    };
+
+    /** Outcome of the update of one object in Session::bulkUpdateProperties( ).
+      */
+    class LIBCMIS_API UpdateResult
+    {
+        private:
+            std::string m_id;
+            std::string m_newId;
+            std::string m_changeToken;
+            boost::shared_ptr< Exception > m_error;
+
+        public:
+            UpdateResult( std::string id, std::string newId, std::string changeToken ) :
+                m_id( id ),
+                m_newId( newId ),
+                m_changeToken( changeToken ),
+                m_error( )
+            {
+            }
+
+            UpdateResult( std::string id, const Exception& error ) :
+                m_id( id ),
+                m_newId( ),
+                m_changeToken( ),
+                m_error( new Exception( error ) )
+            {
+            }
+
+            /** The id as it was requested.
+              */
+            std::string getId( ) const { return m_id; }
+
+            bool isOk( ) const { return m_error.get( ) == NULL; }
+
+            /** The id of the updated object: it can differ from the
+                requested one if the server created a new version.
+              */
+            std::string getNewId( ) const { return m_newId; }
+
+            /** The change token of the updated object, or an empty string
+                if the server doesn't provide any.
+              */
+            std::string getChangeToken( ) const { return m_changeToken; }
+
+            /** The reason of the failure, or an empty pointer if there was none.
+              */
+            boost::shared_ptr< Exception > getError( ) const { return m_error; }
+    };
+}
+
+#endif
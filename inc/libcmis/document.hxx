@@ -29,6 +29,7 @@
 #define _DOCUMENT_HXX_
 
 #include <iostream>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -76,6 +77,16 @@ namespace libcmis
             virtual boost::shared_ptr< std::istream > getContentStream( std::string streamId = std::string( ) ) 
                         = 0;
 
+            /** Get the URL to download the content stream from, if the binding
+                provides one. The download needs to be authenticated like the
+                other requests of the session.
+
+                @return
+                    the URL or an empty string if the content can only be
+                    read using getContentStream( ).
+              */
+            virtual std::string getContentUrl( );
+
             /** Set or replace the content stream of the document.
 
                 @param is the output stream containing the new data for the content stream
@@ -90,6 +101,22 @@ namespace libcmis
             virtual void setContentStream( boost::shared_ptr< std::ostream > os, std::string contentType,
                                            std::string filename, bool overwrite = true ) = 0;
 
+            /** Set the content stream of the document unless the server already
+                has the same content.
+
+                The data is hashed locally using the algorithms of getContentHashes( )
+                and isn't uploaded when all the hashes match and the filename is the
+                same. This is a simple setContentStream( ) when the server doesn't
+                provide any supported hash.
+
+                @return true if the content has been uploaded, false if it was skipped.
+
+                @throw Exception if anything happens during the upload.
+              */
+            virtual bool setContentStreamIfChanged( boost::shared_ptr< std::ostream > os,
+                                                    std::string contentType, std::string filename,
+                                                    bool overwrite = true );
+
             /** Get the content mime type.
               */
             virtual std::string getContentType( );
@@ -102,6 +129,15 @@ namespace libcmis
               */
             virtual long getContentLength( );
 
+            /** Get the hashes of the content stream computed by the server, read
+                from the cmis:contentStreamHash property.
+
+                @return
+                    the hashes by lower case algorithm name, like md5, sha-1, sha-256
+                    or quickxorhash. The map is empty if the server provides no hash.
+              */
+            virtual std::map< std::string, std::string > getContentHashes( );
+
             /** Checks out the document and returns the object corresponding to the 
                 created Private Working Copy.
 
@@ -31,6 +31,7 @@
 #include "libcmis/libcmis-api.h"
 
 #include "libcmis/allowable-actions.hxx"
+#include "libcmis/batch.hxx"
 #include "libcmis/document.hxx"
 #include "libcmis/exception.hxx"
 #include "libcmis/folder.hxx"
@@ -43,6 +44,7 @@
 #include "libcmis/repository.hxx"
 #include "libcmis/session-factory.hxx"
 #include "libcmis/session.hxx"
+#include "libcmis/sync-engine.hxx"
 #include "libcmis/xml-utils.hxx"
 #include "libcmis/xmlserializable.hxx"
 
@@ -28,6 +28,9 @@
 #ifndef _LIBCMIS_OAUTH2_DATA_HXX_
 #define _LIBCMIS_OAUTH2_DATA_HXX_
 
+#include <ctime>
+#include <map>
+#include <mutex>
 #include <string>
 #include <boost/shared_ptr.hpp>
 
@@ -72,6 +75,76 @@ namespace libcmis
             const std::string& getRedirectUri() { return m_redirectUri; }
     };
     typedef boost::shared_ptr< OAuth2Data > OAuth2DataPtr;
+
+    /** Access and refresh tokens of an OAuth2 account.
+      */
+    class LIBCMIS_API OAuth2Tokens
+    {
+        private:
+
+            std::string m_accessToken;
+            std::string m_refreshToken;
+            time_t m_expiry;
+
+        public:
+
+            OAuth2Tokens( );
+            OAuth2Tokens( const std::string& accessToken,
+                          const std::string& refreshToken,
+                          time_t expiry );
+
+            const std::string& getAccessToken( ) const { return m_accessToken; }
+            const std::string& getRefreshToken( ) const { return m_refreshToken; }
+
+            /** \return the time when the access token expires, or 0 if it isn't known.
+              */
+            time_t getExpiry( ) const { return m_expiry; }
+    };
+
+    /** Storage of the OAuth2 tokens, to share them between the sessions
+        of the same account.
+
+        The sessions look for tokens in the store before authenticating
+        and before refreshing an expired access token, and save the tokens
+        they get. Implementations can share the tokens between processes,
+        for example using a file or a key ring.
+
+        The methods can be called by several threads at the same time.
+      */
+    class LIBCMIS_API OAuth2TokenStore
+    {
+        public:
+            virtual ~OAuth2TokenStore( ) { };
+
+            /** Get the tokens of an account.
+
+                \param account
+                    identifies the account: contains the token URL,
+                    the client ID and the user name.
+                \param tokens
+                    the loaded tokens
+                \return false if there are no tokens for the account.
+              */
+            virtual bool load( const std::string& account, OAuth2Tokens& tokens ) = 0;
+
+            virtual void save( const std::string& account, const OAuth2Tokens& tokens ) = 0;
+    };
+    typedef boost::shared_ptr< OAuth2TokenStore > OAuth2TokenStorePtr;
+
+    /** Token store sharing the tokens between the sessions of the process.
+      */
+    class LIBCMIS_API MemoryOAuth2TokenStore : public OAuth2TokenStore
+    {
+        private:
+            std::mutex m_mutex;
+            std::map< std::string, OAuth2Tokens > m_tokens;
+
+        public:
+            MemoryOAuth2TokenStore( );
+
+            virtual bool load( const std::string& account, OAuth2Tokens& tokens );
+            virtual void save( const std::string& account, const OAuth2Tokens& tokens );
+    };
 }
 
 #endif //_LIBCMIS_OAUTH2_DATA_HXX_
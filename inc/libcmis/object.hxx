@@ -30,6 +30,7 @@
 
 #include <ctime>
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -73,6 +74,49 @@ namespace libcmis
             std::vector< RenditionPtr > m_renditions;
             void initializeFromNode( xmlNodePtr node );
 
+            /** Get a property, decoding it if it hasn't been accessed yet.
+
+                \return
+                    the property or an empty pointer if the object has none
+                    with that id.
+              */
+            PropertyPtr getProperty( const std::string& id );
+
+            /** Remove all the properties, decoded or not, before setting
+                them again.
+              */
+            void clearProperties( );
+
+        private:
+
+            /** Property read from a cmis:properties node but not decoded yet.
+
+                Only the values strings are kept: they are converted and the
+                property type definition is looked up on first access. The
+                temporary type is shared with the other objects.
+              */
+            struct RawProperty
+            {
+                PropertyTypePtr m_temporaryType{ };
+                std::vector< std::string > m_values{ };
+            };
+
+            /** Compares the ids rather than their address: the raw properties
+                are indexed by their interned id, but looked up by any string.
+              */
+            struct RawPropertyIdLess
+            {
+                bool operator()( const std::string* a, const std::string* b ) const { return *a < *b; }
+            };
+            typedef std::map< const std::string*, RawProperty, RawPropertyIdLess > RawProperties;
+
+            RawProperties m_rawProperties;
+            mutable std::recursive_mutex m_propertiesMutex;
+
+            RawProperties::iterator findRawProperty( const std::string& id );
+            PropertyPtr decodeRawProperty( const std::string& id, const RawProperty& raw,
+                                           ObjectTypePtr objectType );
+
         public:
 
             Object( Session* session );
@@ -164,6 +208,12 @@ namespace libcmis
                     the returned map may lead to changes loss when calling
                     updateProperties.
 
+                \attention
+                    Only the decoding of the properties is thread-safe: the
+                    returned map isn't protected once this method returns
+                    and mustn't be used while another thread refreshes or
+                    changes the object.
+
                 \sa updateProperties to change properties on the server
               */
             virtual libcmis::PropertyPtrMap& getProperties( );
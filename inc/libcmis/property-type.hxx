@@ -70,6 +70,9 @@ namespace libcmis
             bool m_orderable;
             bool m_openChoice;
             bool m_temporary;
+            bool m_shared;
+
+            friend class PropertyTypeRegistry;
 
         public:
 
@@ -87,20 +90,27 @@ namespace libcmis
 
             PropertyType& operator=( const PropertyType& copy );
 
-            std::string getId( ) { return m_id; }
-            std::string getLocalName( ) { return m_localName; }
-            std::string getLocalNamespace( ) { return m_localNamespace; }
-            std::string getDisplayName( ) { return m_displayName; }
-            std::string getQueryName( ) { return m_queryName; }
-            Type getType( ) { return m_type; }
-            std::string getXmlType( ) { return m_xmlType; }
-            bool isMultiValued( ) { return m_multiValued; }
-            bool isUpdatable( ) { return m_updatable; }
-            bool isInherited( ) { return m_inherited; }
-            bool isRequired( ) { return m_required; }
-            bool isQueryable( ) { return m_queryable; }
-            bool isOrderable( ) { return m_orderable; }
-            bool isOpenChoice( ) { return m_openChoice; }
+            std::string getId( ) const { return m_id; }
+            std::string getLocalName( ) const { return m_localName; }
+            std::string getLocalNamespace( ) const { return m_localNamespace; }
+            std::string getDisplayName( ) const { return m_displayName; }
+            std::string getQueryName( ) const { return m_queryName; }
+            Type getType( ) const { return m_type; }
+            std::string getXmlType( ) const { return m_xmlType; }
+            bool isMultiValued( ) const { return m_multiValued; }
+            bool isUpdatable( ) const { return m_updatable; }
+            bool isInherited( ) const { return m_inherited; }
+            bool isRequired( ) const { return m_required; }
+            bool isQueryable( ) const { return m_queryable; }
+            bool isOrderable( ) const { return m_orderable; }
+            bool isOpenChoice( ) const { return m_openChoice; }
+
+            /** Whether the type is a temporary type shared by several properties.
+
+                Shared types are never modified: Property::getPropertyType( )
+                returns a copy of them.
+              */
+            bool isShared( ) const { return m_shared; }
 
             void setId( const std::string& id ) { m_id = id; }
             void setLocalName( const std::string& localName ) { m_localName = localName; }
@@ -122,6 +132,13 @@ namespace libcmis
             void update( std::vector< ObjectTypePtr > typesDefs );
     };
     typedef boost::shared_ptr< PropertyType > PropertyTypePtr;
+
+    /** Get the shared copy of a property definition id.
+
+        The returned string is never freed: all the objects can point to it
+        rather than keeping their own copy of ids like cmis:objectId.
+      */
+    LIBCMIS_API const std::string& internPropertyId( const std::string& id );
 }
 
 #endif
@@ -33,7 +33,10 @@
 
 #include <boost/date_time.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/variant.hpp>
 
+#include <algorithm>
+#include <iterator>
 #include <string>
 #include <vector>
 
@@ -45,15 +48,100 @@ namespace libcmis
 {
     class ObjectType;
 
+    /** Read-only view on the values of a property.
+
+        The view is only valid as long as the property isn't modified or destroyed.
+      */
+    template< typename T > class PropertyValues
+    {
+        private:
+            const T* m_begin;
+            size_t m_size;
+
+        public:
+            typedef const T* const_iterator;
+
+            PropertyValues( ) : m_begin( NULL ), m_size( 0 ) { }
+            PropertyValues( const T* begin, size_t size ) : m_begin( begin ), m_size( size ) { }
+
+            const_iterator begin( ) const { return m_begin; }
+            const_iterator end( ) const { return m_begin + m_size; }
+            size_t size( ) const { return m_size; }
+            bool empty( ) const { return m_size == 0; }
+            const T& front( ) const { return *m_begin; }
+            const T& operator[]( size_t i ) const { return m_begin[i]; }
+
+            std::vector< T > toVector( ) const { return std::vector< T >( begin( ), end( ) ); }
+    };
+
+    /** Array of property values storing a single value without allocating.
+
+        Most properties only have one value: only multi-valued ones
+        need an heap allocated array.
+      */
+    template< typename T > class SmallValueArray
+    {
+        private:
+            size_t m_size;
+            T m_single;
+            T* m_values;
+
+        public:
+            SmallValueArray( ) : m_size( 0 ), m_single( ), m_values( NULL ) { }
+
+            SmallValueArray( const SmallValueArray& copy ) :
+                m_size( 0 ), m_single( ), m_values( NULL )
+            {
+                assign( copy.data( ), copy.data( ) + copy.m_size );
+            }
+
+            ~SmallValueArray( ) { delete[] m_values; }
+
+            SmallValueArray& operator=( const SmallValueArray& copy )
+            {
+                if ( this != &copy )
+                    assign( copy.data( ), copy.data( ) + copy.m_size );
+                return *this;
+            }
+
+            template< typename Iterator > void assign( Iterator first, Iterator last )
+            {
+                size_t size = std::distance( first, last );
+                T* values = NULL;
+                if ( size > 1 )
+                {
+                    values = new T[ size ];
+                    std::copy( first, last, values );
+                }
+                else if ( size == 1 )
+                    m_single = *first;
+                delete[] m_values;
+                m_values = values;
+                m_size = size;
+            }
+
+            const T* data( ) const { return m_size > 1 ? m_values : &m_single; }
+            size_t size( ) const { return m_size; }
+            const T& operator[]( size_t i ) const { return data( )[i]; }
+            PropertyValues< T > view( ) const { return PropertyValues< T >( data( ), m_size ); }
+    };
+
     class LIBCMIS_API Property : public XmlSerializable
     {
         private:
+            /** Values converted according to the property type when they were set.
+
+                Only the array matching that type is stored.
+              */
+            typedef boost::variant< boost::blank,
+                                    SmallValueArray< long >,
+                                    SmallValueArray< double >,
+                                    SmallValueArray< bool >,
+                                    SmallValueArray< boost::posix_time::ptime > > TypedValues;
+
             PropertyTypePtr m_propertyType;
-            std::vector< std::string > m_strValues;
-            std::vector< bool > m_boolValues;
-            std::vector< long > m_longValues;
-            std::vector< double > m_doubleValues;
-            std::vector< boost::posix_time::ptime > m_dateTimeValues;
+            SmallValueArray< std::string > m_strValues;
+            TypedValues m_typedValues;
 
         protected:
             Property( );
@@ -65,13 +153,31 @@ namespace libcmis
 
             ~Property( ){ }
 
-            PropertyTypePtr getPropertyType( ) { return m_propertyType; }
+            /** Get the property type definition.
+
+                If the type is a shared temporary type, the property gets its
+                own copy of it first: the returned type can be modified.
+              */
+            PropertyTypePtr getPropertyType( );
+
+            /** Get the property type definition for reading only: unlike
+                getPropertyType( ), this never copies the type.
+              */
+            boost::shared_ptr< const PropertyType > getPropertyTypeView( ) const;
 
-            std::vector< boost::posix_time::ptime > getDateTimes( ) { return m_dateTimeValues; }
-            std::vector< bool > getBools( ) { return m_boolValues; }
-            std::vector< std::string > getStrings( ) { return m_strValues; }
-            std::vector< long > getLongs( ) { return m_longValues; }
-            std::vector< double > getDoubles( ) { return m_doubleValues; }
+            /** Values accessors: the returned views don't copy the values.
+              */
+            PropertyValues< std::string > getStringValues( ) const { return m_strValues.view( ); }
+            PropertyValues< long > getLongValues( ) const;
+            PropertyValues< double > getDoubleValues( ) const;
+            PropertyValues< bool > getBoolValues( ) const;
+            PropertyValues< boost::posix_time::ptime > getDateTimeValues( ) const;
+
+            std::vector< boost::posix_time::ptime > getDateTimes( ) { return getDateTimeValues( ).toVector( ); }
+            std::vector< bool > getBools( ) { return getBoolValues( ).toVector( ); }
+            std::vector< std::string > getStrings( ) { return getStringValues( ).toVector( ); }
+            std::vector< long > getLongs( ) { return getLongValues( ).toVector( ); }
+            std::vector< double > getDoubles( ) { return getDoubleValues( ).toVector( ); }
 
             void setPropertyType( PropertyTypePtr propertyType);
             void setValues( std::vector< std::string > strValues );
@@ -74,6 +74,7 @@ namespace libcmis
             std::string m_productVersion;
             std::string m_rootId;
             std::string m_cmisVersionSupported;
+            std::string m_latestChangeLogToken;
             boost::shared_ptr< std::string > m_thinClientUri;
             boost::shared_ptr< std::string > m_principalAnonymous;
             boost::shared_ptr< std::string > m_principalAnyone;
@@ -95,6 +96,11 @@ namespace libcmis
             std::string getProductVersion( ) const;
             std::string getRootId( ) const;
             std::string getCmisVersionSupported( ) const;
+
+            /** Get the change log token of the latest change at the time the
+                repository informations were retrieved.
+              */
+            std::string getLatestChangeLogToken( ) const;
             boost::shared_ptr< std::string > getThinClientUri( ) const;
             boost::shared_ptr< std::string > getPrincipalAnonymous( ) const;
             boost::shared_ptr< std::string > getPrincipalAnyone( ) const;
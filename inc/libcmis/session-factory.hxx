@@ -100,6 +100,8 @@ namespace libcmis
 
             static CertValidationHandlerPtr s_certValidationHandler;
 
+            static OAuth2TokenStorePtr s_oauth2TokenStore;
+
         public:
 
             static void setAuthenticationProvider( AuthProviderPtr provider ) { s_authProvider = provider; }
@@ -114,6 +116,12 @@ namespace libcmis
             static void setCertificateValidationHandler(const CertValidationHandlerPtr& handler ) { s_certValidationHandler = handler; }
             static CertValidationHandlerPtr getCertificateValidationHandler( ) { return s_certValidationHandler; }
 
+            /** Set the store sharing the OAuth2 tokens between the sessions of the same
+                account. If not set, each session gets and refreshes its own tokens.
+              */
+            static void setOAuth2TokenStore( const OAuth2TokenStorePtr& store ) { s_oauth2TokenStore = store; }
+            static OAuth2TokenStorePtr getOAuth2TokenStore( ) { return s_oauth2TokenStore; }
+
             static void setCurlInitProtocolsFunction(CurlInitProtocolsFunction);
 
             static void setProxySettings( std::string proxy,
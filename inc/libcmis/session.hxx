@@ -33,6 +33,7 @@
 #include <boost/shared_ptr.hpp>
 
 #include "libcmis/libcmis-api.h"
+#include "libcmis/batch.hxx"
 #include "libcmis/object-type.hxx"
 #include "libcmis/object.hxx"
 #include "libcmis/folder.hxx"
@@ -68,6 +69,62 @@ namespace libcmis
               */
             virtual ObjectPtr getObject( std::string id ) = 0;
 
+            /** Get several CMIS objects from their IDs.
+
+                The objects are fetched using the batch requests of the server
+                if it has some, or by running several requests concurrently.
+                The default implementation gets them one after the other.
+
+                \return
+                    one result per requested id, in the same order as the ids.
+                    Failures are reported in the results and not thrown.
+              */
+            virtual std::vector< ObjectResult > getObjects( const std::vector< std::string >& ids,
+                                                            const BatchOptions& options = BatchOptions( ) );
+
+            /** Set the same properties and secondary types changes on several objects.
+
+                The CMIS 1.1 bulk update is used when the server provides it,
+                otherwise the objects are updated using several concurrent requests.
+                The default implementation updates them one after the other.
+                The updated objects aren't fetched again.
+
+                \param ids
+                    the identifiers of the objects to update
+                \param properties
+                    the properties to set on all the objects
+                \param addSecondaryTypes
+                    the identifiers of the secondary types to add to the objects
+                \param removeSecondaryTypes
+                    the identifiers of the secondary types to remove from the objects
+
+                \return
+                    one result per requested id, in the same order as the ids.
+                    Failures are reported in the results and not thrown.
+              */
+            virtual std::vector< UpdateResult > bulkUpdateProperties( const std::vector< std::string >& ids,
+                    const PropertyPtrMap& properties,
+                    const std::vector< std::string >& addSecondaryTypes = std::vector< std::string >( ),
+                    const std::vector< std::string >& removeSecondaryTypes = std::vector< std::string >( ),
+                    const BatchOptions& options = BatchOptions( ) );
+
+            /** Get the objects changed since a position in the change log of the repository.
+
+                \param changeLogToken
+                    the position to start reading the changes from. If empty, no change
+                    is returned and the token is set to the current end of the change log.
+                    The token is moved after the returned changes.
+
+                \return
+                    the ids of the created, updated or deleted objects. An id may be
+                    listed several times.
+
+                \throw Exception
+                    of type notSupported if the repository doesn't provide a change log.
+                    The default implementation always throws it.
+              */
+            virtual std::vector< std::string > getContentChanges( std::string& changeLogToken );
+
             /** Get a CMIS object from one of its path.
               */
             virtual ObjectPtr getObjectByPath( std::string path ) = 0;
@@ -97,6 +154,17 @@ namespace libcmis
             virtual void setNoSSLCertificateCheck( bool noCheck ) = 0;
 
             virtual std::string getRefreshToken() { return ""; };
+
+        protected:
+
+            /** Compute the properties to send to the server to apply a bulk update
+                on the object: the cmis:secondaryObjectTypeIds property is added if
+                the secondary types need to be changed.
+              */
+            static PropertyPtrMap getBulkUpdateProperties( ObjectPtr object,
+                    const PropertyPtrMap& properties,
+                    const std::vector< std::string >& addSecondaryTypes,
+                    const std::vector< std::string >& removeSecondaryTypes );
     };
 }
 
@@ -0,0 +1,214 @@
+/* libcmis
+ * Version: MPL 1.1 / GPLv2+ / LGPLv2+
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License or as specified alternatively below. You may obtain a copy of
+ * the License at http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * Major Contributor(s):
+ *
+ *
+ * All Rights Reserved.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPLv2+"), or
+ * the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+ * in which case the provisions of the GPLv2+ or the LGPLv2+ are applicable
+ * instead of those above.
+ */
+#ifndef _SYNC_ENGINE_HXX_
+#define _SYNC_ENGINE_HXX_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "libcmis/batch.hxx"
+#include "libcmis/document.hxx"
+#include "libcmis/folder.hxx"
+#include "libcmis/libcmis-api.h"
+#include "libcmis/session.hxx"
+
+namespace libcmis
+{
+    /** Record of the state database of the SyncEngine: it tells what was
+        synchronized the last time for one remote object.
+      */
+    class LIBCMIS_API SyncEntry
+    {
+        private:
+            std::string m_id;
+            std::string m_path;
+            std::string m_changeToken;
+            std::string m_hash;
+            bool m_folder;
+
+        public:
+            SyncEntry( std::string id = std::string( ), std::string path = std::string( ),
+                       std::string changeToken = std::string( ), std::string hash = std::string( ),
+                       bool folder = false ) :
+                m_id( id ),
+                m_path( path ),
+                m_changeToken( changeToken ),
+                m_hash( hash ),
+                m_folder( folder )
+            {
+            }
+
+            std::string getId( ) const { return m_id; }
+
+            /** Path of the object relative to the local directory, using '/'
+                as separator.
+              */
+            std::string getPath( ) const { return m_path; }
+            void setPath( std::string path ) { m_path = path; }
+
+            /** The change token of the remote object, or its last modification
+                date if the server doesn't provide change tokens.
+              */
+            std::string getChangeToken( ) const { return m_changeToken; }
+
+            /** The SHA-1 of the local file content, empty for folders.
+              */
+            std::string getHash( ) const { return m_hash; }
+
+            bool isFolder( ) const { return m_folder; }
+    };
+
+    /** Outcome of a SyncEngine run. All the paths are relative to the local
+        directory.
+      */
+    class LIBCMIS_API SyncReport
+    {
+        private:
+            std::vector< std::string > m_downloaded;
+            std::vector< std::string > m_uploaded;
+            std::vector< std::string > m_deletedLocally;
+            std::vector< std::string > m_deletedRemotely;
+            std::vector< std::string > m_conflicts;
+            std::map< std::string, std::string > m_errors;
+
+        public:
+            SyncReport( ) :
+                m_downloaded( ),
+                m_uploaded( ),
+                m_deletedLocally( ),
+                m_deletedRemotely( ),
+                m_conflicts( ),
+                m_errors( )
+            {
+            }
+
+            const std::vector< std::string >& getDownloaded( ) const { return m_downloaded; }
+            const std::vector< std::string >& getUploaded( ) const { return m_uploaded; }
+            const std::vector< std::string >& getDeletedLocally( ) const { return m_deletedLocally; }
+            const std::vector< std::string >& getDeletedRemotely( ) const { return m_deletedRemotely; }
+
+            /** The paths changed on both sides since the last synchronization:
+                they are left untouched.
+              */
+            const std::vector< std::string >& getConflicts( ) const { return m_conflicts; }
+
+            /** The paths that failed to be synchronized with the error message.
+              */
+            const std::map< std::string, std::string >& getErrors( ) const { return m_errors; }
+
+            void addDownloaded( const std::string& path ) { m_downloaded.push_back( path ); }
+            void addUploaded( const std::string& path ) { m_uploaded.push_back( path ); }
+            void addDeletedLocally( const std::string& path ) { m_deletedLocally.push_back( path ); }
+            void addDeletedRemotely( const std::string& path ) { m_deletedRemotely.push_back( path ); }
+            void addConflict( const std::string& path ) { m_conflicts.push_back( path ); }
+            void addError( const std::string& path, const std::string& message ) { m_errors[path] = message; }
+
+            void merge( const SyncReport& report );
+    };
+
+    /** Keeps a local directory in sync with a remote folder.
+
+        The state of the last synchronization is stored in a file of the
+        local directory, named after STATE_FILE. It contains the position
+        in the change log of the repository and, for each synchronized
+        object, its id, local path, change token and content hash.
+
+        The change log of the repository is used to find the changed
+        objects if the binding supports it, otherwise the whole remote
+        tree is listed. Only the changed documents are downloaded, several
+        at a time. Interrupted downloads are resumed using HTTP ranges
+        when the document content has an URL.
+
+        An object changed on both sides since the last synchronization
+        is reported as a conflict and left untouched.
+      */
+    class LIBCMIS_API SyncEngine
+    {
+        private:
+            Session* m_session;
+            std::string m_folderId;
+            std::string m_localPath;
+            BatchOptions m_options;
+
+            std::string m_changeLogToken;
+            std::map< std::string, SyncEntry > m_entries;
+
+        public:
+            /** Name of the state file in the local directory.
+              */
+            static const std::string STATE_FILE;
+
+            /** \param session
+                    the session to use: the caller keeps its ownership.
+                \param folderId
+                    the id of the remote folder to synchronize
+                \param localPath
+                    the local directory to synchronize, created if needed.
+              */
+            SyncEngine( Session* session, std::string folderId, std::string localPath,
+                        const BatchOptions& options = BatchOptions( ) );
+            ~SyncEngine( );
+
+            /** Apply the remote changes to the local directory.
+              */
+            SyncReport pull( );
+
+            /** Send the local changes to the server: modified, new and
+                removed files and directories.
+              */
+            SyncReport push( );
+
+            /** Pull and then push the changes.
+              */
+            SyncReport sync( );
+
+            /** Get the synchronized objects by id, as known after the last
+                pull or push.
+              */
+            const std::map< std::string, SyncEntry >& getEntries( ) const { return m_entries; }
+
+        private:
+            SyncEngine( const SyncEngine& copy ) = delete;
+            SyncEngine& operator=( const SyncEngine& copy ) = delete;
+
+            void loadState( );
+            void saveState( );
+
+            void listRemoteTree( FolderPtr folder, const std::string& path,
+                                 std::map< std::string, std::pair< ObjectPtr, std::string > >& objects );
+
+            void pullFolder( ObjectPtr folder, const std::string& path );
+            void pullDocuments( std::vector< std::pair< DocumentPtr, std::string > >& documents,
+                                SyncReport& report );
+            void removeLocal( const std::vector< std::string >& ids, SyncReport& report );
+
+            std::string getParentId( const std::string& path );
+    };
+}
+
+#endif
@@ -30,10 +30,12 @@
 
 #include <map>
 #include <ostream>
+#include <set>
 #include <sstream>
 #include <string>
 
 #include <boost/date_time.hpp>
+#include <boost/enable_shared_from_this.hpp>
 #include <libxml/parser.h>
 #include <libxml/tree.h>
 #include <libxml/xpathInternals.h>
@@ -53,6 +55,7 @@
 #define NS_ATOM_URL         "http://www.w3.org/2005/Atom"
 #define NS_SOAP_URL         "http://schemas.xmlsoap.org/wsdl/soap/"
 #define NS_SOAP_ENV_URL     "http://schemas.xmlsoap.org/soap/envelope/"
+#define NS_XOP_URL          "http://www.w3.org/2004/08/xop/include"
 
 #define LIBCURL_VERSION_VALUE ( \
         ( LIBCURL_VERSION_MAJOR << 16 ) | ( LIBCURL_VERSION_MINOR << 8 ) | ( LIBCURL_VERSION_PATCH ) \
@@ -71,6 +74,9 @@ namespace libcmis
             xmlTextWriterPtr m_writer;
             FILE* m_stream;
             std::ostream* m_outStream;
+            std::string* m_buffer;
+            xmlParserCtxtPtr m_parser;
+            std::streambuf* m_sink;
 
             std::string m_encoding;
             bool m_decode;
@@ -81,12 +87,22 @@ namespace libcmis
         public:
             EncodedData( FILE* stream );
             EncodedData( std::ostream* stream );
+            EncodedData( std::string* buffer );
             EncodedData( const EncodedData& rCopy );
             EncodedData( xmlTextWriterPtr writer );
 
             EncodedData& operator=( const EncodedData& rCopy );
 
             void setEncoding( std::string encoding ) { m_encoding = encoding; }
+
+            /** Also push the written data to an XML parser, to parse it while it arrives.
+              */
+            void setParser( xmlParserCtxtPtr parser ) { m_parser = parser; }
+
+            /** Hand the written data to a consumer instead of the stream or buffer.
+              */
+            void setSink( std::streambuf* sink ) { m_sink = sink; }
+
             void decode( void* buf, size_t size, size_t nmemb );
             void encode( void* buf, size_t size, size_t nmemb );
             void finish( );
@@ -97,20 +113,125 @@ namespace libcmis
             void encodeBase64( const char* buf, size_t len );
     };
 
-    class LIBCMIS_API HttpResponse
+    /** Receives the elements of an XML document parsed while it is received,
+        to handle big text contents without adding them to the tree.
+      */
+    class LIBCMIS_API XmlTextFilter
+    {
+        public:
+            virtual ~XmlTextFilter( ) { };
+
+            /** Called once the element has been added to the tree.
+              */
+            virtual void startElement( xmlNodePtr node ) = 0;
+
+            /** Called for each piece of text of an element.
+
+                \return
+                    true if the text has been handled and shouldn't be added
+                    to the tree.
+              */
+            virtual bool characters( xmlNodePtr node, const xmlChar* text, int len ) = 0;
+
+            /** Called before closing the element.
+              */
+            virtual void endElement( xmlNodePtr node ) = 0;
+    };
+
+    class LIBCMIS_API HttpResponse : public boost::enable_shared_from_this< HttpResponse >
     {
         private:
             std::map< std::string, std::string > m_headers;
-            boost::shared_ptr< std::stringstream > m_stream;
+            std::string m_body;
             boost::shared_ptr< EncodedData > m_data;
+            boost::shared_ptr< std::streambuf > m_bodySink;
+            boost::shared_ptr< XmlTextFilter > m_xmlTextFilter;
+            xmlParserCtxtPtr m_xmlParser;
+            xmlDocPtr m_xmlDoc;
+            bool m_xmlParsed;
 
         public:
             HttpResponse( );
-            ~HttpResponse( ) { };
+            ~HttpResponse( );
 
             std::map< std::string, std::string >& getHeaders( ) { return m_headers; }
             boost::shared_ptr< EncodedData > getData( ) { return m_data; }
-            boost::shared_ptr< std::stringstream > getStream( ) { return m_stream; }
+
+            /** Get the received body in place, without copying it.
+
+                The reference is valid as long as the response is alive.
+              */
+            const std::string& getBody( ) const { return m_body; }
+
+            /** Replace the body, used for the responses extracted from batch replies.
+
+                The streams returned by getStream( ) can't be used anymore.
+              */
+            void setBody( const std::string& body );
+
+            /** Make room in the body buffer for the announced size of the response.
+              */
+            void reserveBody( size_t size );
+
+            /** Send the body to a consumer while it is received, instead of
+                keeping it in the body buffer. The consumer is owned by the response.
+
+                This has no effect once some of the body has been received.
+              */
+            void setBodySink( boost::shared_ptr< std::streambuf > sink );
+
+            boost::shared_ptr< std::streambuf > getBodySink( ) { return m_bodySink; }
+
+            /** Get a stream reading the body in place, without copying it.
+
+                The stream keeps the response alive: the response has to be
+                owned by an HttpResponsePtr.
+              */
+            boost::shared_ptr< std::istream > getStream( );
+
+            /** Tell whether the headers announce an XML body. XML bodies are
+                parsed while they are received.
+
+                This has no effect once some of the body has been received.
+              */
+            void setXmlContent( bool isXml );
+
+            /** Filter the text of the XML body while it is parsed.
+
+                Once the filter has handled some text, the body isn't kept in the
+                body buffer anymore: only the document returned by getXmlDoc( )
+                can be used.
+
+                This has no effect once some of the body has been received.
+              */
+            void setXmlTextFilter( boost::shared_ptr< XmlTextFilter > filter );
+
+            boost::shared_ptr< XmlTextFilter > getXmlTextFilter( ) { return m_xmlTextFilter; }
+
+            /** Get the body parsed as XML.
+
+                The document is ready if the body has been parsed while received,
+                otherwise the body is parsed now.
+
+                \return
+                    the document owned by the response, or NULL if the body
+                    isn't a well-formed XML document.
+              */
+            xmlDocPtr getXmlDoc( );
+
+        private:
+            void resetXml( );
+            void hookXmlParser( );
+
+            static void filterStartElement( void* ctx, const xmlChar* localname, const xmlChar* prefix,
+                    const xmlChar* uri, int nbNamespaces, const xmlChar** namespaces,
+                    int nbAttributes, int nbDefaulted, const xmlChar** attributes );
+            static void filterEndElement( void* ctx, const xmlChar* localname, const xmlChar* prefix,
+                    const xmlChar* uri );
+            static void filterCharacters( void* ctx, const xmlChar* text, int len );
+
+            HttpResponse( const HttpResponse& );
+            HttpResponse& operator=( const HttpResponse& );
     };
     typedef boost::shared_ptr< HttpResponse > HttpResponsePtr;
 
@@ -126,8 +247,52 @@ namespace libcmis
 
     LIBCMIS_API std::string getXPathValue( xmlXPathContextPtr xpathCtx, const std::string& req );
 
+    /** Evaluate an XPath expression, compiling it only once per process.
+
+        The compiled expressions are kept for later calls, so expressions built
+        from variable data should rather be made relative to a context node.
+
+        \return
+            the result to free with xmlXPathFreeObject, or NULL if the expression
+            can't be compiled or evaluated.
+      */
+    LIBCMIS_API xmlXPathObjectPtr evalXPath( xmlXPathContextPtr xpathCtx, const std::string& req );
+
+    /** XPath context with all the namespaces known by libcmis registered.
+
+        The libxml2 contexts are pooled: creating an XPathContext neither allocates
+        a new context nor registers the namespaces again. The namespaces are the
+        ones of registerNamespaces and registerCmisWSNamespaces.
+      */
+    class LIBCMIS_API XPathContext
+    {
+        private:
+            xmlXPathContextPtr m_ctx;
+
+        public:
+            /** \param doc the document to evaluate the expressions on
+                \param node the node to evaluate the relative expressions from
+              */
+            XPathContext( xmlDocPtr doc, xmlNodePtr node = NULL );
+            ~XPathContext( );
+
+            xmlXPathContextPtr get( ) { return m_ctx; }
+            void setNode( xmlNodePtr node );
+
+            xmlXPathObjectPtr eval( const std::string& req ) { return evalXPath( m_ctx, req ); }
+            std::string getValue( const std::string& req ) { return getXPathValue( m_ctx, req ); }
+
+        private:
+            XPathContext( const XPathContext& );
+            XPathContext& operator=( const XPathContext& );
+    };
+
     LIBCMIS_API xmlDocPtr wrapInDoc( xmlNodePtr entryNode );
 
+    /** Check if a node is an element with the given namespace URL and local name.
+      */
+    LIBCMIS_API bool isXmlElement( xmlNodePtr node, const char* nsUrl, const char* name );
+
     /** Utility extracting an attribute value from an Xml Node,
         based on the attribute name. If the defaultValue is NULL and
         the attribute can't be found then throw an exception.
@@ -157,6 +322,25 @@ namespace libcmis
 
     LIBCMIS_API std::string sha1( const std::string& str );
 
+    /** Compute the SHA-1 of the data remaining in a stream, reading it by chunks.
+      */
+    LIBCMIS_API std::string sha1( std::istream& stream );
+
+    /** Compute several hashes of the data remaining in a stream, reading it
+        only once.
+
+        \param algorithms
+            the names of the hash algorithms as used in the cmis:contentStreamHash
+            property. md5, sha-1 and quickxorhash are supported, the other ones
+            are ignored.
+
+        \return
+            the hashes by algorithm name: md5 and sha-1 hashes are written in
+            hexadecimal and quickxorhash ones in base64.
+      */
+    LIBCMIS_API std::map< std::string, std::string > computeContentHashes( std::istream& stream,
+            const std::set< std::string >& algorithms );
+
     LIBCMIS_API int stringstream_write_callback(void * context, const char * s, int len);
 
     LIBCMIS_API std::string escape( const std::string& str );
@@ -64,6 +64,19 @@ namespace
 
         return result;
     }
+
+    struct CancellingReader
+    {
+        FILE* file;
+        libcmis_ContentStreamPtr stream;
+    };
+
+    size_t lcl_cancellingRead( void* buf, size_t size, size_t nmemb, void* data )
+    {
+        CancellingReader* reader = static_cast< CancellingReader* >( data );
+        libcmis_content_stream_cancel( reader->stream );
+        return fread( buf, size, nmemb, reader->file );
+    }
 }
 
 class DocumentTest : public CppUnit::TestFixture
@@ -84,6 +97,11 @@ class DocumentTest : public CppUnit::TestFixture
         void getContentStreamBadAllocTest( );
         void setContentStreamTest( );
         void setContentStreamErrorTest( );
+        void openContentStreamTest( );
+        void openContentStreamErrorTest( );
+        void openContentStreamCancelTest( );
+        void uploadContentStreamTest( );
+        void uploadContentStreamCancelTest( );
         void getContentTypeTest( );
         void getContentFilenameTest( );
         void getContentLengthTest( );
@@ -108,6 +126,11 @@ class DocumentTest : public CppUnit::TestFixture
         CPPUNIT_TEST( getContentStreamBadAllocTest );
         CPPUNIT_TEST( setContentStreamTest );
         CPPUNIT_TEST( setContentStreamErrorTest );
+        CPPUNIT_TEST( openContentStreamTest );
+        CPPUNIT_TEST( openContentStreamErrorTest );
+        CPPUNIT_TEST( openContentStreamCancelTest );
+        CPPUNIT_TEST( uploadContentStreamTest );
+        CPPUNIT_TEST( uploadContentStreamCancelTest );
         CPPUNIT_TEST( getContentTypeTest );
         CPPUNIT_TEST( getContentFilenameTest );
         CPPUNIT_TEST( getContentLengthTest );
@@ -372,6 +395,132 @@ void DocumentTest::setContentStreamErrorTest( )
     libcmis_document_free( tested );
 }
 
+void DocumentTest::openContentStreamTest( )
+{
+    libcmis_DocumentPtr tested = getTested( true, false );
+    libcmis_ErrorPtr error = libcmis_error_create( );
+
+    // Read the content in small chunks (tested method)
+    libcmis_ContentStreamPtr stream = libcmis_document_openContentStream( tested, NULL, error );
+    CPPUNIT_ASSERT( NULL != stream );
+
+    string actual;
+    char buf[5];
+    while ( !libcmis_content_stream_isEof( stream ) )
+    {
+        size_t read = libcmis_content_stream_read( stream, buf, sizeof( buf ), error );
+        CPPUNIT_ASSERT( read <= sizeof( buf ) );
+        actual.append( buf, read );
+    }
+    libcmis_content_stream_close( stream );
+
+    // Check
+    string expected = getTestedImplementation( tested )->getContentString( );
+    CPPUNIT_ASSERT( NULL == libcmis_error_getMessage( error ) );
+    CPPUNIT_ASSERT_EQUAL( expected, actual );
+
+    // Free it all
+    libcmis_error_free( error );
+    libcmis_document_free( tested );
+}
+
+void DocumentTest::openContentStreamErrorTest( )
+{
+    libcmis_DocumentPtr tested = getTested( true, true );
+    libcmis_ErrorPtr error = libcmis_error_create( );
+
+    libcmis_ContentStreamPtr stream = libcmis_document_openContentStream( tested, NULL, error );
+
+    // Check
+    CPPUNIT_ASSERT( NULL == stream );
+    CPPUNIT_ASSERT( !string( libcmis_error_getMessage( error ) ).empty( ) );
+
+    // Free it all
+    libcmis_error_free( error );
+    libcmis_document_free( tested );
+}
+
+void DocumentTest::openContentStreamCancelTest( )
+{
+    libcmis_DocumentPtr tested = getTested( true, false );
+    libcmis_ErrorPtr error = libcmis_error_create( );
+
+    libcmis_ContentStreamPtr stream = libcmis_document_openContentStream( tested, NULL, error );
+    char buf[5];
+    CPPUNIT_ASSERT_EQUAL( sizeof( buf ), libcmis_content_stream_read( stream, buf, sizeof( buf ), error ) );
+
+    // Cancel the transfer (tested method)
+    libcmis_content_stream_cancel( stream );
+
+    // Check that nothing more is read
+    CPPUNIT_ASSERT( libcmis_content_stream_isCancelled( stream ) );
+    CPPUNIT_ASSERT_EQUAL( size_t( 0 ), libcmis_content_stream_read( stream, buf, sizeof( buf ), error ) );
+    CPPUNIT_ASSERT( libcmis_content_stream_isEof( stream ) );
+    CPPUNIT_ASSERT( NULL == libcmis_error_getMessage( error ) );
+
+    // Free it all
+    libcmis_content_stream_close( stream );
+    libcmis_error_free( error );
+    libcmis_document_free( tested );
+}
+
+void DocumentTest::uploadContentStreamTest( )
+{
+    libcmis_DocumentPtr tested = getTested( true, false );
+    libcmis_ErrorPtr error = libcmis_error_create( );
+
+    // Prepare the content to set
+    FILE* tmp = tmpfile( );
+    string expected( "New Content Stream" );
+    fwrite( expected.c_str( ), 1, expected.size( ), tmp );
+    rewind( tmp );
+
+    // Upload it pulling a few bytes at a time (tested method)
+    libcmis_ContentStreamPtr stream = libcmis_content_stream_create(
+            ( libcmis_readFn )fread, ( libcmis_seekFn )fseek, tmp, long( expected.size( ) ), 4 );
+    libcmis_document_uploadContentStream( tested, stream, "content/type", "name.txt", true, error );
+    libcmis_content_stream_close( stream );
+    fclose( tmp );
+
+    // Check
+    string actual = getTestedImplementation( tested )->getContentString( );
+    CPPUNIT_ASSERT( NULL == libcmis_error_getMessage( error ) );
+    CPPUNIT_ASSERT_EQUAL( expected, actual );
+
+    // Free it all
+    libcmis_error_free( error );
+    libcmis_document_free( tested );
+}
+
+void DocumentTest::uploadContentStreamCancelTest( )
+{
+    libcmis_DocumentPtr tested = getTested( true, false );
+    libcmis_ErrorPtr error = libcmis_error_create( );
+
+    // Prepare the content to set
+    FILE* tmp = tmpfile( );
+    string newContent( "New Content Stream" );
+    fwrite( newContent.c_str( ), 1, newContent.size( ), tmp );
+    rewind( tmp );
+
+    // Cancel the upload while reading the first chunk (tested method)
+    CancellingReader reader = { tmp, NULL };
+    libcmis_ContentStreamPtr stream = libcmis_content_stream_create(
+            lcl_cancellingRead, NULL, &reader, -1, 4 );
+    reader.stream = stream;
+    libcmis_document_uploadContentStream( tested, stream, "content/type", "name.txt", true, error );
+    libcmis_content_stream_close( stream );
+
+    // Check that no more than the first chunk was pulled
+    CPPUNIT_ASSERT_EQUAL( long( 4 ), ftell( tmp ) );
+    fclose( tmp );
+    CPPUNIT_ASSERT( !string( libcmis_error_getMessage( error ) ).empty( ) );
+
+    // Free it all
+    libcmis_error_free( error );
+    libcmis_document_free( tested );
+}
+
 void DocumentTest::getContentTypeTest( )
 {
     libcmis_DocumentPtr tested = getTested( true, false );
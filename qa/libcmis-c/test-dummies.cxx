@@ -560,12 +560,12 @@ namespace dummies
         is.seekg( 0 );
         int bufSize = 2048;
         char* buf = new char[ bufSize ];
-        while ( !is.eof( ) )
+        do
         {
             is.read( buf, bufSize );
             size_t read = is.gcount( );
             out.write( buf, read );
-        }
+        } while ( !is.eof( ) && !is.fail( ) );
         delete[] buf;
 
         m_contentString = out.str( );
@@ -30,8 +30,12 @@
 #include <cppunit/TestFixture.h>
 #include <cppunit/TestAssert.h>
 
+#include <fstream>
 #include <memory>
 #include <sstream>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 #define SERVER_URL string( "http://mockup/binding" )
 #define SERVER_REPOSITORY string( "mock" )
@@ -50,9 +54,11 @@
 
 #include <libcmis/document.hxx>
 #include <libcmis/session-factory.hxx>
+#include <libcmis/sync-engine.hxx>
 
 #include <mockup-config.h>
 #include "test-helpers.hxx"
+#include "atom-document.hxx"
 #include "atom-session.hxx"
 
 using namespace std;
@@ -60,6 +66,33 @@ using libcmis::PropertyPtrMap;
 
 typedef std::unique_ptr<AtomPubSession> AtomPubSessionPtr;
 
+namespace
+{
+    // libxml2 allocator counting the allocated bytes
+    size_t lcl_xmlAllocatedBytes = 0;
+    xmlMallocFunc lcl_xmlMalloc = NULL;
+    xmlReallocFunc lcl_xmlRealloc = NULL;
+    xmlStrdupFunc lcl_xmlStrdup = NULL;
+
+    void* lcl_countingMalloc( size_t size )
+    {
+        lcl_xmlAllocatedBytes += size;
+        return lcl_xmlMalloc( size );
+    }
+
+    void* lcl_countingRealloc( void* ptr, size_t size )
+    {
+        lcl_xmlAllocatedBytes += size;
+        return lcl_xmlRealloc( ptr, size );
+    }
+
+    char* lcl_countingStrdup( const char* str )
+    {
+        lcl_xmlAllocatedBytes += strlen( str ) + 1;
+        return lcl_xmlStrdup( str );
+    }
+}
+
 class AtomTest : public CppUnit::TestFixture
 {
     public:
@@ -74,6 +107,7 @@ class AtomTest : public CppUnit::TestFixture
         void getTypeParentsTest( );
         void getTypeChildrenTest( );
         void getObjectTest( );
+        void getObjectsTest( );
         void getDocumentTest( );
         void getDocumentRelationshipsTest( );
         void getUnexistantObjectTest( );
@@ -85,16 +119,25 @@ class AtomTest : public CppUnit::TestFixture
         void getAllowableActionsTest( );
         void getAllowableActionsNotIncludedTest( );
         void getChildrenTest( );
+        void getChildrenPagedTest( );
+        void lazyPropertiesTest( );
+        void objectXmlAllocationTest( );
         void getDocumentParentsTest( );
         void getContentStreamTest( );
         void setContentStreamTest( );
+        void setContentStreamIfChangedTest( );
         void updatePropertiesTest( );
         void updatePropertiesEmptyTest( );
+        void bulkUpdatePropertiesTest( );
+        void bulkUpdatePropertiesCollectionTest( );
         void createFolderTest( );
         void createFolderBadTypeTest( );
         void createDocumentTest( );
         void deleteDocumentTest( );
         void deleteFolderTreeTest( );
+        void deleteFolderTreeFailuresTest( );
+        void syncPullTest( );
+        void getContentChangesTest( );
         void checkOutTest( );
         void cancelCheckOutTest( );
         void checkInTest( );
@@ -113,6 +156,7 @@ class AtomTest : public CppUnit::TestFixture
         CPPUNIT_TEST( getTypeParentsTest );
         CPPUNIT_TEST( getTypeChildrenTest );
         CPPUNIT_TEST( getObjectTest );
+        CPPUNIT_TEST( getObjectsTest );
         CPPUNIT_TEST( getDocumentTest );
         CPPUNIT_TEST( getDocumentRelationshipsTest );
         CPPUNIT_TEST( getUnexistantObjectTest );
@@ -124,16 +168,25 @@ class AtomTest : public CppUnit::TestFixture
         CPPUNIT_TEST( getAllowableActionsTest );
         CPPUNIT_TEST( getAllowableActionsNotIncludedTest );
         CPPUNIT_TEST( getChildrenTest );
+        CPPUNIT_TEST( getChildrenPagedTest );
+        CPPUNIT_TEST( lazyPropertiesTest );
+        CPPUNIT_TEST( objectXmlAllocationTest );
         CPPUNIT_TEST( getDocumentParentsTest );
         CPPUNIT_TEST( getContentStreamTest );
         CPPUNIT_TEST( setContentStreamTest );
+        CPPUNIT_TEST( setContentStreamIfChangedTest );
         CPPUNIT_TEST( updatePropertiesTest );
         CPPUNIT_TEST( updatePropertiesEmptyTest );
+        CPPUNIT_TEST( bulkUpdatePropertiesTest );
+        CPPUNIT_TEST( bulkUpdatePropertiesCollectionTest );
         CPPUNIT_TEST( createFolderTest );
         CPPUNIT_TEST( createFolderBadTypeTest );
         CPPUNIT_TEST( createDocumentTest );
         CPPUNIT_TEST( deleteDocumentTest );
         CPPUNIT_TEST( deleteFolderTreeTest );
+        CPPUNIT_TEST( deleteFolderTreeFailuresTest );
+        CPPUNIT_TEST( syncPullTest );
+        CPPUNIT_TEST( getContentChangesTest );
         CPPUNIT_TEST( checkOutTest );
         CPPUNIT_TEST( cancelCheckOutTest );
         CPPUNIT_TEST( checkInTest );
@@ -426,6 +479,31 @@ void AtomTest::getObjectTest( )
     CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong Id for fetched object", expectedId, actual->getId( ) );
 }
 
+void AtomTest::getObjectsTest( )
+{
+    curl_mockup_reset( );
+    curl_mockup_addResponse( "http://mockup/mock/id", "id=valid-object", "GET", DATA_DIR "/atom/valid-object.xml" );
+    curl_mockup_addResponse( "http://mockup/mock/type", "id=cmis:folder", "GET", DATA_DIR "/atom/type-folder.xml" );
+    curl_mockup_setCredentials( SERVER_USERNAME, SERVER_PASSWORD );
+
+    AtomPubSessionPtr session = getTestSession( SERVER_USERNAME, SERVER_PASSWORD );
+
+    vector< string > ids;
+    ids.push_back( "valid-object" );
+    ids.push_back( "bad_object" );
+    vector< libcmis::ObjectResult > results = session->getObjects( ids );
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong number of results", size_t( 2 ), results.size( ) );
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong id for first result", string( "valid-object" ), results[0].getId( ) );
+    CPPUNIT_ASSERT_MESSAGE( "First object should have been fetched", results[0].isOk( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong Id for fetched object", string( "valid-object" ), results[0].getObject( )->getId( ) );
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong id for second result", string( "bad_object" ), results[1].getId( ) );
+    CPPUNIT_ASSERT_MESSAGE( "Second object shouldn't have been fetched", !results[1].isOk( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong CMIS exception type", string( "objectNotFound" ), results[1].getError( )->getType( ) );
+}
+
 void AtomTest::getDocumentTest( )
 {
     curl_mockup_reset( );
@@ -691,6 +769,98 @@ void AtomTest::getChildrenTest( )
     CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong number of document children", 3, documentCount );
 }
 
+void AtomTest::getChildrenPagedTest( )
+{
+    curl_mockup_reset( );
+    curl_mockup_addResponse( "http://mockup/mock/children", "id=root-folder", "GET", DATA_DIR "/atom/root-children-page1.xml" );
+    curl_mockup_addResponse( "http://mockup/mock/children/page2", "id=root-folder", "GET", DATA_DIR "/atom/root-children-page2.xml" );
+    curl_mockup_addResponse( "http://mockup/mock/id", "id=root-folder", "GET", DATA_DIR "/atom/root-folder.xml" );
+    curl_mockup_addResponse( "http://mockup/mock/type", "id=cmis:folder", "GET", DATA_DIR "/atom/type-folder.xml" );
+    curl_mockup_addResponse( "http://mockup/mock/type", "id=DocumentLevel2", "GET", DATA_DIR "/atom/type-docLevel2.xml" );
+    curl_mockup_setCredentials( SERVER_USERNAME, SERVER_PASSWORD );
+
+    AtomPubSessionPtr session = getTestSession( SERVER_USERNAME, SERVER_PASSWORD );
+
+    // The next link is after the entries of the first page
+    vector< libcmis::ObjectPtr > children = session->getRootFolder()->getChildren( );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong number of children", size_t( 5 ), children.size() );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong first child", string( "child1" ), children.front( )->getId( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Second page not requested", 1,
+            curl_mockup_getRequestsCount( "http://mockup/mock/children/page2", "", "GET" ) );
+}
+
+void AtomTest::lazyPropertiesTest( )
+{
+    curl_mockup_reset( );
+    curl_mockup_addResponse( "http://mockup/mock/children", "id=root-folder", "GET", DATA_DIR "/atom/root-children.xml" );
+    curl_mockup_addResponse( "http://mockup/mock/id", "id=root-folder", "GET", DATA_DIR "/atom/root-folder.xml" );
+    curl_mockup_addResponse( "http://mockup/mock/type", "id=cmis:folder", "GET", DATA_DIR "/atom/type-folder.xml" );
+    curl_mockup_addResponse( "http://mockup/mock/type", "id=DocumentLevel2", "GET", DATA_DIR "/atom/type-docLevel2.xml" );
+    curl_mockup_setCredentials( SERVER_USERNAME, SERVER_PASSWORD );
+
+    AtomPubSessionPtr session = getTestSession( SERVER_USERNAME, SERVER_PASSWORD );
+    vector< libcmis::ObjectPtr > children = session->getRootFolder()->getChildren( );
+    int typeRequests = curl_mockup_getRequestsCount( "http://mockup/mock/type", "", "GET" );
+
+    // Reading the ids and names doesn't need the properties to be decoded
+    for ( vector< libcmis::ObjectPtr >::iterator it = children.begin( );
+          it != children.end( ); ++it )
+    {
+        CPPUNIT_ASSERT_MESSAGE( "Missing child id", !( *it )->getId( ).empty( ) );
+        CPPUNIT_ASSERT_MESSAGE( "Missing child name", !( *it )->getName( ).empty( ) );
+    }
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Type definitions requested to read the names",
+            typeRequests, curl_mockup_getRequestsCount( "http://mockup/mock/type", "", "GET" ) );
+
+    // The other properties are decoded on first access
+    libcmis::ObjectPtr child = children.front( );
+    CPPUNIT_ASSERT_MESSAGE( "CreationDate is missing", !child->getCreationDate( ).is_not_a_date_time( ) );
+
+    libcmis::PropertyPtrMap& properties = child->getProperties( );
+    libcmis::PropertyPtrMap::iterator it = properties.find( "cmis:creationDate" );
+    CPPUNIT_ASSERT_MESSAGE( "cmis:creationDate property is missing", it != properties.end( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong cmis:creationDate type",
+            libcmis::PropertyType::DateTime, it->second->getPropertyType( )->getType( ) );
+    it = properties.find( "cmis:name" );
+    CPPUNIT_ASSERT_MESSAGE( "cmis:name property is missing", it != properties.end( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong cmis:name value", child->getName( ), it->second->getStrings( ).front( ) );
+}
+
+void AtomTest::objectXmlAllocationTest( )
+{
+    // Objects are built straight from the entry node: this has to allocate
+    // less libxml2 memory than a single copy of the entry. Only the libxml2
+    // allocations are counted here, not the C++ heap ones.
+    xmlDocPtr doc = xmlReadFile( DATA_DIR "/atom/test-document.xml", NULL, 0 );
+    xmlNodePtr entryNd = xmlDocGetRootElement( doc );
+
+    xmlFreeFunc freeFunc;
+    xmlMemGet( &freeFunc, &lcl_xmlMalloc, &lcl_xmlRealloc, &lcl_xmlStrdup );
+    xmlMemSetup( freeFunc, lcl_countingMalloc, lcl_countingRealloc, lcl_countingStrdup );
+
+    lcl_xmlAllocatedBytes = 0;
+    xmlDocPtr copy = libcmis::wrapInDoc( entryNd );
+    size_t copyBytes = lcl_xmlAllocatedBytes;
+    xmlFreeDoc( copy );
+
+    const int count = 100;
+    lcl_xmlAllocatedBytes = 0;
+    for ( int i = 0; i < count; ++i )
+    {
+        AtomDocument document( NULL, entryNd );
+        CPPUNIT_ASSERT_EQUAL( string( "test-document" ), document.getId( ) );
+    }
+    size_t objectBytes = lcl_xmlAllocatedBytes / count;
+
+    xmlMemSetup( freeFunc, lcl_xmlMalloc, lcl_xmlRealloc, lcl_xmlStrdup );
+    xmlFreeDoc( doc );
+
+    stringstream msg;
+    msg << "Too much memory allocated per object: " << objectBytes
+        << " bytes, a copy of the entry takes " << copyBytes << " bytes";
+    CPPUNIT_ASSERT_MESSAGE( msg.str( ), objectBytes < copyBytes );
+}
+
 void AtomTest::getDocumentParentsTest( )
 {
     curl_mockup_reset( );
@@ -783,6 +953,40 @@ void AtomTest::setContentStreamTest( )
     }
 }
 
+void AtomTest::setContentStreamIfChangedTest( )
+{
+    curl_mockup_reset( );
+    curl_mockup_addResponse( "http://mockup/mock/id", "id=test-document", "GET", DATA_DIR "/atom/test-document-hash.xml" );
+    curl_mockup_addResponse( "http://mockup/mock/type", "id=DocumentLevel2", "GET", DATA_DIR "/atom/type-docLevel2.xml" );
+    curl_mockup_addResponse( "http://mockup/mock/content/data.txt", "id=test-document", "PUT", "Updated", 0, false );
+    curl_mockup_setCredentials( SERVER_USERNAME, SERVER_PASSWORD );
+
+    AtomPubSessionPtr session = getTestSession( SERVER_USERNAME, SERVER_PASSWORD );
+
+    libcmis::ObjectPtr object = session->getObject( "test-document" );
+    libcmis::DocumentPtr document = boost::dynamic_pointer_cast< libcmis::Document >( object );
+
+    map< string, string > hashes = document->getContentHashes( );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong number of hashes", size_t( 3 ), hashes.size( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong md5 hash", string( "d84a9d48934e578d6a05f2b12906d858" ), hashes["md5"] );
+
+    // Same content: nothing should be uploaded
+    string sameContent( "Some content stream to set" );
+    boost::shared_ptr< ostream > os ( new stringstream ( sameContent ) );
+    bool uploaded = document->setContentStreamIfChanged( os, "text/plain", document->getContentFilename( ) );
+    CPPUNIT_ASSERT_MESSAGE( "Unchanged content shouldn't be uploaded", !uploaded );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Unexpected upload request", 0,
+            curl_mockup_getRequestsCount( "http://mockup/mock/content/", "id=test-document", "PUT" ) );
+
+    // Different content: the whole stream has to be uploaded
+    string newContent( "Some other content stream to set" );
+    os.reset( new stringstream( newContent ) );
+    uploaded = document->setContentStreamIfChanged( os, "text/plain", document->getContentFilename( ) );
+    CPPUNIT_ASSERT_MESSAGE( "Changed content should be uploaded", uploaded );
+    const char* content = curl_mockup_getRequestBody( "http://mockup/mock/content/", "id=test-document", "PUT" );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Bad content uploaded", newContent, string( content ) );
+}
+
 void AtomTest::updatePropertiesTest( )
 {
     curl_mockup_reset( );
@@ -857,6 +1061,117 @@ void AtomTest::updatePropertiesEmptyTest( )
     CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong change token", object->getChangeToken(), updated->getChangeToken() );
 }
 
+void AtomTest::bulkUpdatePropertiesTest( )
+{
+    curl_mockup_reset( );
+    curl_mockup_addResponse( "http://mockup/mock/type", "id=DocumentLevel2", "GET", DATA_DIR "/atom/type-docLevel2.xml" );
+    curl_mockup_addResponse( "http://mockup/mock/id", "id=test-document", "PUT", DATA_DIR "/atom/test-document-updated.xml" );
+    curl_mockup_setCredentials( SERVER_USERNAME, SERVER_PASSWORD );
+
+    AtomPubSessionPtr session = getTestSession( SERVER_USERNAME, SERVER_PASSWORD );
+
+    // Fill the map of properties to change
+    string propertyName( "cmis:name" );
+    libcmis::ObjectTypePtr objectType = session->getType( "DocumentLevel2" );
+    map< string, libcmis::PropertyTypePtr >::iterator it = objectType->getPropertiesTypes( ).find( propertyName );
+    vector< string > values;
+    values.push_back( "New name" );
+    PropertyPtrMap newProperties;
+    newProperties[ propertyName ] = libcmis::PropertyPtr( new libcmis::Property( it->second, values ) );
+
+    // Method to test: the workspace has no bulk update collection,
+    // so one PUT request is sent per object.
+    vector< string > ids;
+    ids.push_back( "test-document" );
+    ids.push_back( "bad_object" );
+    vector< libcmis::UpdateResult > results = session->bulkUpdateProperties( ids, newProperties );
+
+    // Check the sent request
+    string request( curl_mockup_getRequestBody( "http://mockup/mock/id", "id=test-document", "PUT" ) );
+    string actualObject = test::getXmlNodeAsString( request, "/atom:entry/cmisra:object" );
+    string expectedObject = "<cmisra:object>"
+                                "<cmis:properties>"
+                                    "<cmis:propertyString propertyDefinitionId=\"cmis:name\" localName=\"cmis:name\" "
+                                                          "displayName=\"Name\" queryName=\"cmis:name\">"
+                                        "<cmis:value>New name</cmis:value>"
+                                    "</cmis:propertyString>"
+                                "</cmis:properties>"
+                            "</cmisra:object>";
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong request content sent", expectedObject, actualObject );
+
+    // Check the results
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong number of results", size_t( 2 ), results.size( ) );
+
+    CPPUNIT_ASSERT_MESSAGE( "First object should have been updated", results[0].isOk( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong updated id", string( "test-document" ), results[0].getNewId( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong change token", string( "1359382206736" ), results[0].getChangeToken( ) );
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong id for second result", string( "bad_object" ), results[1].getId( ) );
+    CPPUNIT_ASSERT_MESSAGE( "Second object shouldn't have been updated", !results[1].isOk( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong CMIS exception type", string( "objectNotFound" ), results[1].getError( )->getType( ) );
+}
+
+void AtomTest::bulkUpdatePropertiesCollectionTest( )
+{
+    // A service document with a bulk update collection
+    string workspaces;
+    test::loadFromFile( DATA_DIR "/atom/workspaces.xml", workspaces );
+    string collectionEnd( "</app:collection>" );
+    workspaces.insert( workspaces.find( collectionEnd ) + collectionEnd.size( ),
+            "<app:collection href=\"http://mockup/mock/update\">"
+            "<cmisra:collectionType>update</cmisra:collectionType>"
+            "</app:collection>" );
+    AtomPubSessionPtr session( new AtomPubSession( ) );
+    session->parseServiceDocument( workspaces );
+
+    // The server gives the objects in the requested order, but one of them
+    // only has its new id
+    const char* updated =
+        "<?xml version=\"1.0\"?>"
+        "<atom:feed xmlns:atom=\"http://www.w3.org/2005/Atom\""
+        "           xmlns:cmis=\"http://docs.oasis-open.org/ns/cmis/core/200908/\""
+        "           xmlns:cmisra=\"http://docs.oasis-open.org/ns/cmis/restatom/200908/\">"
+        "  <atom:entry><cmisra:bulkUpdate><cmis:objectIdAndChangeToken>"
+        "    <cmis:id>doc-1</cmis:id><cmis:newId>doc-1-v2</cmis:newId><cmis:changeToken>token-1</cmis:changeToken>"
+        "  </cmis:objectIdAndChangeToken></cmisra:bulkUpdate></atom:entry>"
+        "  <atom:entry><cmisra:object><cmis:properties>"
+        "    <cmis:propertyId propertyDefinitionId=\"cmis:objectId\"><cmis:value>doc-2-v2</cmis:value></cmis:propertyId>"
+        "    <cmis:propertyString propertyDefinitionId=\"cmis:changeToken\"><cmis:value>token-2</cmis:value></cmis:propertyString>"
+        "  </cmis:properties></cmisra:object></atom:entry>"
+        "  <atom:entry><cmisra:object><cmis:properties>"
+        "    <cmis:propertyId propertyDefinitionId=\"cmis:objectId\"><cmis:value>doc-3</cmis:value></cmis:propertyId>"
+        "    <cmis:propertyString propertyDefinitionId=\"cmis:changeToken\"><cmis:value>token-3</cmis:value></cmis:propertyString>"
+        "  </cmis:properties></cmisra:object></atom:entry>"
+        "</atom:feed>";
+    curl_mockup_reset( );
+    curl_mockup_addResponse( "http://mockup/mock/update", "", "POST", updated, 0, false );
+
+    vector< string > values;
+    values.push_back( "New name" );
+    PropertyPtrMap newProperties;
+    libcmis::PropertyTypePtr nameType( new libcmis::PropertyType( "string", "cmis:name", "cmis:name", "Name", "cmis:name" ) );
+    newProperties[ "cmis:name" ] = libcmis::PropertyPtr( new libcmis::Property( nameType, values ) );
+
+    vector< string > ids;
+    ids.push_back( "doc-1" );
+    ids.push_back( "doc-2" );
+    ids.push_back( "doc-3" );
+    vector< libcmis::UpdateResult > results = session->bulkUpdateProperties( ids, newProperties );
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong number of requests", 1,
+            curl_mockup_getRequestsCount( "http://mockup/mock/update", "", "POST" ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong number of results", size_t( 3 ), results.size( ) );
+    const char* newIds[] = { "doc-1-v2", "doc-2-v2", "doc-3" };
+    const char* tokens[] = { "token-1", "token-2", "token-3" };
+    for ( size_t i = 0; i < results.size( ); ++i )
+    {
+        CPPUNIT_ASSERT_MESSAGE( "Object should have been updated: " + ids[i], results[i].isOk( ) );
+        CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong id", ids[i], results[i].getId( ) );
+        CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong new id", string( newIds[i] ), results[i].getNewId( ) );
+        CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong change token", string( tokens[i] ), results[i].getChangeToken( ) );
+    }
+}
+
 void AtomTest::createFolderTest( )
 {
     curl_mockup_reset( );
@@ -1096,6 +1411,142 @@ void AtomTest::deleteFolderTreeTest( )
     curl_mockup_HttpRequest_free( request );
 }
 
+void AtomTest::deleteFolderTreeFailuresTest( )
+{
+    curl_mockup_reset( );
+    curl_mockup_addResponse( "http://mockup/mock/id", "id=valid-object", "GET", DATA_DIR "/atom/valid-object.xml" );
+    curl_mockup_addResponse( "http://mockup/mock/descendants", "id=valid-object", "DELETE", "", 500, false );
+    curl_mockup_addResponse( "http://mockup/mock/descendants", "id=valid-object", "GET", DATA_DIR "/atom/root-children.xml" );
+    curl_mockup_addResponse( "http://mockup/mock/type", "id=cmis:folder", "GET", DATA_DIR "/atom/type-folder.xml" );
+    curl_mockup_setCredentials( SERVER_USERNAME, SERVER_PASSWORD );
+
+    AtomPubSessionPtr session = getTestSession( SERVER_USERNAME, SERVER_PASSWORD );
+
+    libcmis::ObjectPtr object = session->getObject( "valid-object" );
+    libcmis::Folder* folder = dynamic_cast< libcmis::Folder* >( object.get() );
+
+    vector< string > failed = folder->removeTree( true, libcmis::UnfileObjects::Delete, true );
+
+    // The objects remaining in the tree are the ones that failed to be deleted
+    vector< string > expected;
+    expected.push_back( "child1" );
+    expected.push_back( "child2" );
+    expected.push_back( "child3" );
+    expected.push_back( "child4" );
+    expected.push_back( "child5" );
+    expected.push_back( "valid-object" );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong number of failed ids", expected.size( ), failed.size( ) );
+    for ( size_t i = 0; i < expected.size( ); ++i )
+        CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong failed id", expected[i], failed[i] );
+}
+
+void AtomTest::syncPullTest( )
+{
+    curl_mockup_reset( );
+    const char* emptyFeed = "<?xml version=\"1.0\"?><atom:feed xmlns:atom=\"http://www.w3.org/2005/Atom\"/>";
+    curl_mockup_addResponse( "http://mockup/mock/id", "id=root-folder", "GET", DATA_DIR "/atom/root-folder.xml" );
+    curl_mockup_addResponse( "http://mockup/mock/children", "id=root-folder", "GET", DATA_DIR "/atom/root-children.xml" );
+    curl_mockup_addResponse( "http://mockup/mock/children", "id=child4", "GET", emptyFeed, 0, false );
+    curl_mockup_addResponse( "http://mockup/mock/children", "id=child5", "GET", emptyFeed, 0, false );
+    curl_mockup_addResponse( "http://mockup/mock/content/data.txt", "", "GET", "Some content", 0, false );
+    curl_mockup_addResponse( "http://mockup/mock/type", "id=cmis:folder", "GET", DATA_DIR "/atom/type-folder.xml" );
+    curl_mockup_addResponse( "http://mockup/mock/type", "id=DocumentLevel2", "GET", DATA_DIR "/atom/type-docLevel2.xml" );
+    curl_mockup_setCredentials( SERVER_USERNAME, SERVER_PASSWORD );
+
+    AtomPubSessionPtr session = getTestSession( SERVER_USERNAME, SERVER_PASSWORD );
+
+    char tmpDir[] = "/tmp/libcmis-sync-XXXXXX";
+    CPPUNIT_ASSERT( mkdtemp( tmpDir ) != NULL );
+    string localPath( tmpDir );
+
+    // The repository has no change log: the whole tree is listed
+    libcmis::SyncEngine engine( session.get( ), "root-folder", localPath );
+    libcmis::SyncReport report = engine.pull( );
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Unexpected errors", size_t( 0 ), report.getErrors( ).size( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong number of downloaded files", size_t( 3 ), report.getDownloaded( ).size( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong number of synchronized objects", size_t( 5 ), engine.getEntries( ).size( ) );
+
+    string content;
+    test::loadFromFile( ( localPath + "/Child 1" ).c_str( ), content );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong content", string( "Some content" ), content );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong change token", string( "1359537973932" ),
+                                  engine.getEntries( ).find( "child1" )->second.getChangeToken( ) );
+
+    // Nothing changed on the server: nothing to download, local changes are kept
+    {
+        ofstream out( ( localPath + "/Child 2" ).c_str( ) );
+        out << "Local changes";
+    }
+    report = engine.pull( );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Unchanged files downloaded", size_t( 0 ), report.getDownloaded( ).size( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Unexpected conflicts", size_t( 0 ), report.getConflicts( ).size( ) );
+    test::loadFromFile( ( localPath + "/Child 2" ).c_str( ), content );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Local changes lost", string( "Local changes" ), content );
+
+    // The state file keeps the values with tabs and line breaks
+    engine.m_entries[ "odd\tid" ] = libcmis::SyncEntry( "odd\tid", "Odd\n\\name", "token\t1", "hash\r\n", false );
+    engine.m_changeLogToken = "log\ntoken";
+    engine.saveState( );
+    engine.loadState( );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong number of loaded entries", size_t( 6 ), engine.getEntries( ).size( ) );
+    libcmis::SyncEntry odd = engine.getEntries( ).find( "odd\tid" )->second;
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong path", string( "Odd\n\\name" ), odd.getPath( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong change token", string( "token\t1" ), odd.getChangeToken( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong hash", string( "hash\r\n" ), odd.getHash( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong change log token", string( "log\ntoken" ), engine.m_changeLogToken );
+
+    const char* files[] = { "Child 1", "Child 2", "Child 3", libcmis::SyncEngine::STATE_FILE.c_str( ) };
+    for ( size_t i = 0; i < sizeof( files ) / sizeof( files[0] ); ++i )
+        remove( ( localPath + "/" + files[i] ).c_str( ) );
+    rmdir( ( localPath + "/Child 4" ).c_str( ) );
+    rmdir( ( localPath + "/Child 5" ).c_str( ) );
+    rmdir( localPath.c_str( ) );
+}
+
+void AtomTest::getContentChangesTest( )
+{
+    // A service document with a change log
+    string workspaces;
+    test::loadFromFile( DATA_DIR "/atom/workspaces.xml", workspaces );
+    string noChanges( "<cmis:capabilityChanges>none" );
+    workspaces.replace( workspaces.find( noChanges ), noChanges.size( ), "<cmis:capabilityChanges>objectidsonly" );
+    string collectionEnd( "</app:collection>" );
+    workspaces.insert( workspaces.find( collectionEnd ) + collectionEnd.size( ),
+            "<atom:link rel=\"http://docs.oasis-open.org/ns/cmis/link/200908/changes\" href=\"http://mockup/mock/changes\"/>" );
+
+    AtomPubSessionPtr session( new AtomPubSession( ) );
+    session->m_bindingUrl = SERVER_URL;
+    session->parseServiceDocument( workspaces );
+    libcmis::RepositoryPtr repository = session->getRepository( );
+
+    string latestToken( "<cmis:latestChangeLogToken>0" );
+    workspaces.replace( workspaces.find( latestToken ), latestToken.size( ), "<cmis:latestChangeLogToken>42" );
+    const char* changes =
+        "<?xml version=\"1.0\"?>"
+        "<atom:feed xmlns:atom=\"http://www.w3.org/2005/Atom\""
+        "           xmlns:cmis=\"http://docs.oasis-open.org/ns/cmis/core/200908/\""
+        "           xmlns:cmisra=\"http://docs.oasis-open.org/ns/cmis/restatom/200908/\">"
+        "  <atom:entry><cmisra:object><cmis:properties>"
+        "    <cmis:propertyId propertyDefinitionId=\"cmis:objectId\"><cmis:value>changed-doc</cmis:value></cmis:propertyId>"
+        "  </cmis:properties></cmisra:object></atom:entry>"
+        "</atom:feed>";
+
+    curl_mockup_reset( );
+    curl_mockup_addResponse( SERVER_URL.c_str( ), "", "GET", workspaces.c_str( ), 0, false );
+    curl_mockup_addResponse( "http://mockup/mock/changes", "changeLogToken=12", "GET", changes, 0, false );
+
+    string token( "12" );
+    vector< string > ids = session->getContentChanges( token );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong number of changes", size_t( 1 ), ids.size( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong changed id", string( "changed-doc" ), ids.front( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong latest token", string( "42" ), token );
+
+    // The repositories of the session are kept
+    CPPUNIT_ASSERT_MESSAGE( "Repository replaced", repository == session->getRepository( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong number of repositories", size_t( 1 ), session->m_repositories.size( ) );
+}
+
 void AtomTest::checkOutTest( )
 {
     curl_mockup_reset( );
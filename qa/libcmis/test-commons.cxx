@@ -46,6 +46,7 @@
 
 #include <libcmis/oauth2-data.hxx>
 #include <libcmis/object-type.hxx>
+#include <libcmis/session-factory.hxx>
 
 #include "oauth2-handler.hxx"
 
@@ -59,6 +60,9 @@ class CommonsTest : public CppUnit::TestFixture
         // constructors tests
         void oauth2DataCopyTest();
         void oauth2HandlerCopyTest();
+        void oauth2TokenStoreTest();
+        void oauth2SharedRefreshTest();
+        void oauth2RefreshTest();
         void objectTypeCopyTest();
 
         // Methods that should never be called
@@ -67,6 +71,9 @@ class CommonsTest : public CppUnit::TestFixture
         CPPUNIT_TEST_SUITE( CommonsTest );
         CPPUNIT_TEST( oauth2DataCopyTest );
         CPPUNIT_TEST( oauth2HandlerCopyTest );
+        CPPUNIT_TEST( oauth2TokenStoreTest );
+        CPPUNIT_TEST( oauth2SharedRefreshTest );
+        CPPUNIT_TEST( oauth2RefreshTest );
         CPPUNIT_TEST( objectTypeCopyTest );
         CPPUNIT_TEST( objectTypeNocallTest );
         CPPUNIT_TEST_SUITE_END( );
@@ -111,6 +118,7 @@ void CommonsTest::oauth2HandlerCopyTest( )
     OAuth2Handler handler( &session, data );
     handler.m_access = "access";
     handler.m_refresh = "refresh";
+    handler.m_expiry = 1234;
     handler.m_oauth2Parser = &DummyOAuth2Parser;
 
     {
@@ -121,6 +129,7 @@ void CommonsTest::oauth2HandlerCopyTest( )
         CPPUNIT_ASSERT_EQUAL( data, copy.m_data );
         CPPUNIT_ASSERT_EQUAL( handler.m_access, copy.m_access );
         CPPUNIT_ASSERT_EQUAL( handler.m_refresh, copy.m_refresh );
+        CPPUNIT_ASSERT_EQUAL( handler.m_expiry, copy.m_expiry );
         CPPUNIT_ASSERT_EQUAL( &DummyOAuth2Parser, copy.m_oauth2Parser );
     }
 
@@ -131,10 +140,113 @@ void CommonsTest::oauth2HandlerCopyTest( )
         CPPUNIT_ASSERT_EQUAL( data, copy.m_data );
         CPPUNIT_ASSERT_EQUAL( handler.m_access, copy.m_access );
         CPPUNIT_ASSERT_EQUAL( handler.m_refresh, copy.m_refresh );
+        CPPUNIT_ASSERT_EQUAL( handler.m_expiry, copy.m_expiry );
         CPPUNIT_ASSERT_EQUAL( &DummyOAuth2Parser, copy.m_oauth2Parser );
     }
 }
 
+void CommonsTest::oauth2TokenStoreTest( )
+{
+    OAuth2DataPtr data( new OAuth2Data ( "url", "token", "scope", "redirect",
+                                         "clientid", "clientsecret" ) );
+    SessionFactory::setOAuth2TokenStore( OAuth2TokenStorePtr( new MemoryOAuth2TokenStore( ) ) );
+
+    HttpSession session( "user", "pass" );
+    OAuth2Handler handler( &session, data );
+    handler.setTokens( OAuth2Tokens( "access", "refresh", time( NULL ) + 3600 ) );
+    handler.saveTokens( );
+
+    // Another session of the same account gets the tokens
+    HttpSession otherSession( "user", "pass" );
+    OAuth2Handler other( &otherSession, data );
+    CPPUNIT_ASSERT_MESSAGE( "Tokens not shared", other.loadTokens( ) );
+    CPPUNIT_ASSERT_EQUAL( string( "access" ), other.getAccessToken( ) );
+    CPPUNIT_ASSERT_EQUAL( string( "refresh" ), other.getRefreshToken( ) );
+    CPPUNIT_ASSERT_EQUAL( handler.getExpiry( ), other.getExpiry( ) );
+    CPPUNIT_ASSERT_MESSAGE( "Token shouldn't be expiring", !other.isExpiring( ) );
+
+    // But not the sessions of other accounts
+    HttpSession otherUserSession( "other-user", "pass" );
+    OAuth2Handler otherUser( &otherUserSession, data );
+    CPPUNIT_ASSERT_MESSAGE( "Tokens shared with another user", !otherUser.loadTokens( ) );
+
+    SessionFactory::setOAuth2TokenStore( OAuth2TokenStorePtr( ) );
+}
+
+void CommonsTest::oauth2SharedRefreshTest( )
+{
+    // The token URL is invalid: refreshing the token would fail
+    OAuth2DataPtr data( new OAuth2Data ( "url", "token", "scope", "redirect",
+                                         "clientid", "clientsecret" ) );
+    OAuth2TokenStorePtr store( new MemoryOAuth2TokenStore( ) );
+    SessionFactory::setOAuth2TokenStore( store );
+
+    HttpSession session( "user", "pass" );
+    OAuth2Handler handler( &session, data );
+    handler.setTokens( OAuth2Tokens( "old-access", "refresh", time( NULL ) + 10 ) );
+    CPPUNIT_ASSERT_MESSAGE( "Token should be expiring", handler.isExpiring( ) );
+
+    // Another session already refreshed the token
+    store->save( handler.getAccount( ), OAuth2Tokens( "new-access", "new-refresh", time( NULL ) + 3600 ) );
+    handler.refresh( );
+
+    CPPUNIT_ASSERT_EQUAL( string( "new-access" ), handler.getAccessToken( ) );
+    CPPUNIT_ASSERT_EQUAL( string( "new-refresh" ), handler.getRefreshToken( ) );
+    CPPUNIT_ASSERT_MESSAGE( "Token shouldn't be expiring", !handler.isExpiring( ) );
+
+    SessionFactory::setOAuth2TokenStore( OAuth2TokenStorePtr( ) );
+}
+
+static HttpSession* refreshingSession = NULL;
+static bool tokenRequestInOAuth2 = false;
+
+// Allow the token responses to be read from the test files, and check the
+// token requests are sent as OAuth2 requests, thus without the access token.
+static void initFileProtocol( CURL* handle )
+{
+#if (LIBCURL_VERSION_MAJOR > 7) || (LIBCURL_VERSION_MAJOR == 7 && LIBCURL_VERSION_MINOR >= 85)
+    curl_easy_setopt( handle, CURLOPT_PROTOCOLS_STR, "file" );
+#else
+    curl_easy_setopt( handle, CURLOPT_PROTOCOLS, CURLPROTO_FILE );
+#endif
+    if ( refreshingSession != NULL )
+        tokenRequestInOAuth2 = refreshingSession->m_inOAuth2Authentication;
+}
+
+void CommonsTest::oauth2RefreshTest( )
+{
+    OAuth2DataPtr data( new OAuth2Data ( "url", "file://" DATA_DIR "/gdrive/refresh_response_no_token.json",
+                                         "scope", "redirect", "clientid", "clientsecret" ) );
+    HttpSession session( "user", "pass", false, OAuth2DataPtr( ), false, &initFileProtocol );
+    session.m_oauth2Handler = new OAuth2Handler( &session, data );
+    session.m_oauth2Handler->setTokens( OAuth2Tokens( "old-access", "refresh", time( NULL ) + 3600 ) );
+    refreshingSession = &session;
+
+    // A response without access token is a failure: the old token is kept
+    tokenRequestInOAuth2 = false;
+    try
+    {
+        session.oauth2Refresh( );
+        CPPUNIT_FAIL( "Refresh without access token should fail" );
+    }
+    catch ( const libcmis::Exception& )
+    {
+    }
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Old access token lost",
+                                  string( "old-access" ), session.m_oauth2Handler->getAccessToken( ) );
+    CPPUNIT_ASSERT_MESSAGE( "Access token sent to the token endpoint", tokenRequestInOAuth2 );
+
+    data->m_tokenUrl = "file://" DATA_DIR "/gdrive/refresh_response.json";
+    tokenRequestInOAuth2 = false;
+    session.oauth2Refresh( );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "wrong access token",
+                                  string( "new-access-token" ),
+                                  session.m_oauth2Handler->getAccessToken( ) );
+    CPPUNIT_ASSERT_MESSAGE( "Access token sent to the token endpoint", tokenRequestInOAuth2 );
+
+    refreshingSession = NULL;
+}
+
 static void assertObjectTypeEquals( const ObjectType& expected, const ObjectType& actual )
 {
     CPPUNIT_ASSERT_EQUAL( expected.getRefreshTimestamp(), actual.getRefreshTimestamp() );
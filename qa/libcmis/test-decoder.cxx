@@ -33,6 +33,9 @@
 
 #include <libcmis/xml-utils.hxx>
 
+#include "base64-kernels.hxx"
+#include "test-helpers.hxx"
+
 #define BASE64_ENCODING string( "base64" )
 
 using namespace std;
@@ -65,6 +68,9 @@ class DecoderTest : public CppUnit::TestFixture
         void base64EncodeSimpleBlockTest( );
         void base64EncodePaddedBlockTest( );
         void base64EncodeSplitRunsTest( );
+        void base64LargeSplitRunsTest( );
+        void base64KernelsTest( );
+        void base64BenchmarkTest( );
 
         void base64encodeTest( );
 
@@ -77,6 +83,9 @@ class DecoderTest : public CppUnit::TestFixture
         CPPUNIT_TEST( base64EncodeSimpleBlockTest );
         CPPUNIT_TEST( base64EncodePaddedBlockTest );
         CPPUNIT_TEST( base64EncodeSplitRunsTest );
+        CPPUNIT_TEST( base64LargeSplitRunsTest );
+        CPPUNIT_TEST( base64KernelsTest );
+        CPPUNIT_TEST( base64BenchmarkTest );
         CPPUNIT_TEST( base64encodeTest );
         CPPUNIT_TEST_SUITE_END( );
 };
@@ -212,6 +221,169 @@ void DecoderTest::base64EncodeSplitRunsTest( )
     CPPUNIT_ASSERT_EQUAL( string( "cGxlYXN1cmUu" ), getActual( ) );
 }
 
+namespace
+{
+    string lcl_referenceEncode( const string& input )
+    {
+        static const char chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        string encoded;
+        for ( size_t i = 0; i < input.size( ); i += 3 )
+        {
+            unsigned long value = 0;
+            size_t count = min( size_t( 3 ), input.size( ) - i );
+            for ( size_t j = 0; j < 3; ++j )
+                value = ( value << 8 ) | ( j < count ? ( unsigned char )input[i + j] : 0 );
+            for ( size_t j = 0; j < 4; ++j )
+                encoded += j <= count ? chars[ ( value >> ( 18 - 6 * j ) ) & 0x3F ] : '=';
+        }
+        return encoded;
+    }
+}
+
+void DecoderTest::base64LargeSplitRunsTest( )
+{
+    // Bigger than the output buffers and with all the byte values
+    string input;
+    for ( int i = 0; i < 20000; ++i )
+        input += char( ( i * 7 + i / 256 ) % 256 );
+
+    // Encode in runs of various sizes
+    {
+        string encoded;
+        libcmis::EncodedData encoderToString( &encoded );
+        encoderToString.setEncoding( BASE64_ENCODING );
+        size_t pos = 0;
+        for ( size_t run = 1; pos < input.size( ); run = ( run * 3 + 1 ) % 5000 )
+        {
+            size_t size = min( run, input.size( ) - pos );
+            encoderToString.encode( ( void* )( input.data( ) + pos ), 1, size );
+            pos += size;
+        }
+        encoderToString.finish( );
+        CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong encoding", lcl_referenceEncode( input ), encoded );
+    }
+
+    // Decode with line breaks, in runs of various sizes
+    string encoded = lcl_referenceEncode( input );
+    string wrapped;
+    for ( size_t pos = 0; pos < encoded.size( ); pos += 76 )
+        wrapped += encoded.substr( pos, 76 ) + "\r\n";
+
+    data->setEncoding( BASE64_ENCODING );
+    size_t pos = 0;
+    for ( size_t run = 1; pos < wrapped.size( ); run = ( run * 3 + 1 ) % 7000 )
+    {
+        size_t size = min( run, wrapped.size( ) - pos );
+        data->decode( ( void* )( wrapped.data( ) + pos ), 1, size );
+        pos += size;
+    }
+    data->finish( );
+    CPPUNIT_ASSERT_MESSAGE( "Wrong decoding", input == getActual( ) );
+}
+
+void DecoderTest::base64KernelsTest( )
+{
+    vector< const libcmis::Base64Kernel* > kernels = libcmis::getBase64Kernels( );
+    const libcmis::Base64Kernel* scalar = kernels.front( );
+
+    string input;
+    for ( int i = 0; i < 1000; ++i )
+        input += char( ( i * 7 + i / 256 ) % 256 );
+    string encoded = lcl_referenceEncode( input );
+
+    // Invalid characters in the middle of some vectors, to check where the kernels stop
+    vector< string > toDecode;
+    toDecode.push_back( encoded );
+    const char invalidChars[] = "=\n!\x80";
+    for ( size_t pos = 0; pos < 200; pos += 13 )
+    {
+        string invalid = encoded;
+        invalid[pos] = invalidChars[ pos % 4 ];
+        toDecode.push_back( invalid );
+    }
+
+    for ( vector< const libcmis::Base64Kernel* >::iterator it = kernels.begin( );
+          it != kernels.end( ); ++it )
+    {
+        string message = string( "Kernel " ) + ( *it )->m_name;
+
+        // Various input sizes and output capacities
+        for ( size_t len = 0; len < 200; len += 7 )
+        {
+            for ( size_t capacity = 0; capacity < 300; capacity += 37 )
+            {
+                const unsigned char* in = reinterpret_cast< const unsigned char* >( input.data( ) );
+                string expected( capacity, '\0' );
+                size_t expectedSize = 0;
+                size_t expectedRead = scalar->m_encode( in, len, &expected[0], expectedSize, capacity );
+                string actual( capacity, '\0' );
+                size_t actualSize = 0;
+                size_t actualRead = ( *it )->m_encode( in, len, &actual[0], actualSize, capacity );
+                CPPUNIT_ASSERT_EQUAL_MESSAGE( message, expectedRead, actualRead );
+                CPPUNIT_ASSERT_EQUAL_MESSAGE( message, expected.substr( 0, expectedSize ),
+                                              actual.substr( 0, actualSize ) );
+
+                for ( vector< string >::iterator dec = toDecode.begin( ); dec != toDecode.end( ); ++dec )
+                {
+                    in = reinterpret_cast< const unsigned char* >( dec->data( ) );
+                    expectedSize = 0;
+                    expectedRead = scalar->m_decode( in, len, &expected[0], expectedSize, capacity );
+                    actualSize = 0;
+                    actualRead = ( *it )->m_decode( in, len, &actual[0], actualSize, capacity );
+                    CPPUNIT_ASSERT_EQUAL_MESSAGE( message, expectedRead, actualRead );
+                    CPPUNIT_ASSERT_EQUAL_MESSAGE( message, expected.substr( 0, expectedSize ),
+                                                  actual.substr( 0, actualSize ) );
+                }
+            }
+        }
+    }
+}
+
+void DecoderTest::base64BenchmarkTest( )
+{
+    // 1 MiB of content, received in 16 KiB chunks as curl would pass it
+    const size_t chunkSize = 16 * 1024;
+    string input;
+    for ( int i = 0; i < 1024 * 1024; ++i )
+        input += char( ( i * 7 + i / 256 ) % 256 );
+
+    // Report the kernel EncodedData picked for this CPU
+    string kernel = string( " (" ) + libcmis::getBase64Kernel( ).m_name + ")";
+
+    string encoded;
+    test::Benchmark encode( "base64 encoding" + kernel );
+    while ( encode.run( ) )
+    {
+        encoded.clear( );
+        libcmis::EncodedData encoder( &encoded );
+        encoder.setEncoding( BASE64_ENCODING );
+        for ( size_t pos = 0; pos < input.size( ); pos += chunkSize )
+            encoder.encode( ( void* )( input.data( ) + pos ), 1, min( chunkSize, input.size( ) - pos ) );
+        encoder.finish( );
+    }
+    encode.report( input.size( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong encoding", lcl_referenceEncode( input ), encoded );
+
+    // Decode with line breaks, like the WS binding content
+    string wrapped;
+    for ( size_t pos = 0; pos < encoded.size( ); pos += 76 )
+        wrapped += encoded.substr( pos, 76 ) + "\r\n";
+
+    string decoded;
+    test::Benchmark decode( "base64 decoding" + kernel );
+    while ( decode.run( ) )
+    {
+        decoded.clear( );
+        libcmis::EncodedData decoder( &decoded );
+        decoder.setEncoding( BASE64_ENCODING );
+        for ( size_t pos = 0; pos < wrapped.size( ); pos += chunkSize )
+            decoder.decode( ( void* )( wrapped.data( ) + pos ), 1, min( chunkSize, wrapped.size( ) - pos ) );
+        decoder.finish( );
+    }
+    decode.report( wrapped.size( ) );
+    CPPUNIT_ASSERT_MESSAGE( "Wrong decoding", input == decoded );
+}
+
 void DecoderTest::base64encodeTest( )
 {
     string actual = libcmis::base64encode( "sure." );
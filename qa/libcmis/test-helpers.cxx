@@ -26,6 +26,9 @@
  * instead of those above.
  */
 
+#include <cstdlib>
+#include <iostream>
+
 #include <libxml/parser.h>
 #include <libxml/tree.h>
 
@@ -39,6 +42,44 @@ using libcmis::PropertyPtrMap;
 namespace test
 {
 
+    Benchmark::Benchmark( const string& name ) :
+        m_name( name ),
+        m_iterations( 1 ),
+        m_count( 0 ),
+        m_start( ),
+        m_end( )
+    {
+        const char* iterations = getenv( "LIBCMIS_BENCHMARK" );
+        if ( iterations != NULL && strtoul( iterations, NULL, 10 ) > 0 )
+            m_iterations = strtoul( iterations, NULL, 10 );
+    }
+
+    bool Benchmark::run( )
+    {
+        if ( m_count == 0 )
+            m_start = chrono::steady_clock::now( );
+        if ( m_count == m_iterations )
+        {
+            m_end = chrono::steady_clock::now( );
+            return false;
+        }
+        ++m_count;
+        return true;
+    }
+
+    void Benchmark::report( size_t bytes )
+    {
+        if ( getenv( "LIBCMIS_BENCHMARK" ) == NULL || m_count == 0 )
+            return;
+
+        double seconds = chrono::duration< double >( m_end - m_start ).count( );
+        cout << endl << m_name << ": " << m_count << " iterations, "
+             << seconds * 1e9 / m_count << " ns per iteration";
+        if ( bytes > 0 && seconds > 0 )
+            cout << ", " << double( bytes ) * m_count / seconds / ( 1024 * 1024 ) << " MiB/s";
+        cout << endl;
+    }
+
     XmlNodeRef::XmlNodeRef( xmlNodePtr node, boost::shared_ptr< xmlDoc > doc )
         : m_node( node )
         , m_doc( doc )
@@ -26,6 +26,7 @@
  * instead of those above.
  */
 
+#include <chrono>
 #include <string>
 
 #include <boost/shared_ptr.hpp>
@@ -51,6 +52,39 @@ namespace test
         boost::shared_ptr< xmlDoc > m_doc;
     };
 
+    /** Loop of a benchmark test. The loop body is run only once to keep
+        make check fast, unless the LIBCMIS_BENCHMARK environment variable
+        is set to the number of iterations to time:
+
+            test::Benchmark benchmark( "parseDateTime" );
+            while ( benchmark.run( ) )
+                libcmis::parseDateTime( str );
+            benchmark.report( );
+      */
+    class Benchmark
+    {
+    public:
+        Benchmark( const std::string& name );
+
+        /** \return whether the loop body needs to be run once more.
+          */
+        bool run( );
+
+        /** Print the time spent per iteration if the benchmark was timed.
+
+            \param bytes the size of the data processed by one iteration,
+                         to print the throughput as well.
+          */
+        void report( size_t bytes = 0 );
+
+    private:
+        std::string m_name;
+        unsigned long m_iterations;
+        unsigned long m_count;
+        std::chrono::steady_clock::time_point m_start;
+        std::chrono::steady_clock::time_point m_end;
+    };
+
     // Test helper functions for parser and writer tests
     XmlNodeRef getXmlNode( std::string str );
     const char* getXmlns( );
@@ -33,6 +33,7 @@
 #include <string>
 #include <fstream>
 #include <cerrno>
+#include <cstring>
 
 #if defined __clang__
 #pragma clang diagnostic push
@@ -48,6 +49,7 @@
 #include <libcmis/property-type.hxx>
 
 #include "json-utils.hxx"
+#include "test-helpers.hxx"
 
 using namespace std;
 using namespace libcmis;
@@ -61,6 +63,12 @@ class JsonTest : public CppUnit::TestFixture
         void createFromPropertiesTest( );
         void badKeyTest( );
         void addTest( );
+        void addToCopyTest( );
+        void typedValuesTest( );
+        void toStringTest( );
+        void listParserTest( );
+        void listParserInvalidTest( );
+        void parseBenchmarkTest( );
 
         CPPUNIT_TEST_SUITE( JsonTest );
         CPPUNIT_TEST( parseTest );
@@ -69,6 +77,12 @@ class JsonTest : public CppUnit::TestFixture
         CPPUNIT_TEST( createFromPropertiesTest );  
         CPPUNIT_TEST( badKeyTest );
         CPPUNIT_TEST( addTest );
+        CPPUNIT_TEST( addToCopyTest );
+        CPPUNIT_TEST( typedValuesTest );
+        CPPUNIT_TEST( toStringTest );
+        CPPUNIT_TEST( listParserTest );
+        CPPUNIT_TEST( listParserInvalidTest );
+        CPPUNIT_TEST( parseBenchmarkTest );
         CPPUNIT_TEST_SUITE_END( );
 };
 
@@ -179,4 +193,157 @@ void JsonTest::addTest( )
     CPPUNIT_ASSERT_EQUAL( addJson.toString( ), json["new"].toString( ) );
 }
 
+void JsonTest::addToCopyTest( )
+{
+    Json json = parseFile( DATA_DIR "/gdrive/jsontest-good.json" );
+    Json::JsonVector parents = json["parents"].getList( );
+    Json parent = parents.front( );
+    parent.add( "new", Json( "added" ) );
+
+    // The copies share the parsed document, but it mustn't be changed by add( )
+    CPPUNIT_ASSERT_EQUAL( string( "added" ), parent["new"].toString( ) );
+    CPPUNIT_ASSERT_EQUAL( string( ), parents.front( )["new"].toString( ) );
+    CPPUNIT_ASSERT_EQUAL( string( ), json["parents"].getList( ).front( )["new"].toString( ) );
+    CPPUNIT_ASSERT_EQUAL( string( "parentId" ), parent["id"].toString( ) );
+}
+
+void JsonTest::typedValuesTest( )
+{
+    Json json = Json::parse( "{ \"int\": -42, \"double\": 1.5e3, \"bool\": false, \"null\": null,"
+                             " \"escaped\": \"a\\\"b\\u00e9\\ud83d\\ude00\\/\","
+                             " \"object\": { \"a\": { \"b\": \"deep\" } }, \"array\": [ 1, 2 ] }" );
+
+    CPPUNIT_ASSERT_EQUAL( Json::json_int, json["int"].getDataType( ) );
+    CPPUNIT_ASSERT_EQUAL( string( "-42" ), json["int"].toString( ) );
+    CPPUNIT_ASSERT_EQUAL( Json::json_double, json["double"].getDataType( ) );
+    CPPUNIT_ASSERT_EQUAL( string( "1.5e3" ), json["double"].toString( ) );
+    CPPUNIT_ASSERT_EQUAL( Json::json_bool, json["bool"].getDataType( ) );
+    CPPUNIT_ASSERT_EQUAL( string( "false" ), json["bool"].toString( ) );
+    CPPUNIT_ASSERT_EQUAL( Json::json_null, json["null"].getDataType( ) );
+    CPPUNIT_ASSERT_EQUAL( string( "a\"b\xc3\xa9\xf0\x9f\x98\x80/" ), json["escaped"].toString( ) );
+    CPPUNIT_ASSERT_EQUAL( Json::json_object, json["object"].getDataType( ) );
+    CPPUNIT_ASSERT_EQUAL( string( "deep" ), json["object.a.b"].toString( ) );
+    CPPUNIT_ASSERT_EQUAL( Json::json_array, json["array"].getDataType( ) );
+    CPPUNIT_ASSERT_EQUAL( size_t( 2 ), json["array"].getList( ).size( ) );
+
+    // Invalid JSON is kept as a string
+    string invalid( "{ \"unclosed\": [ 1 }" );
+    CPPUNIT_ASSERT_EQUAL( invalid, Json::parse( invalid ).toString( ) );
+}
+
+void JsonTest::toStringTest( )
+{
+    Json parents;
+    parents.add( Json( "parent/1" ) );
+    Json json;
+    json.add( "title", Json( "a \"title\"" ) );
+    json.add( "parents", parents );
+    json.add( "size", Json::parse( "{ \"size\": 12 }" )["size"] );
+
+    string expected = "{\n"
+                      "    \"title\": \"a \\\"title\\\"\",\n"
+                      "    \"parents\": [\n"
+                      "        \"parent\\/1\"\n"
+                      "    ],\n"
+                      "    \"size\": 12\n"
+                      "}\n";
+    CPPUNIT_ASSERT_EQUAL( expected, json.toString( ) );
+    CPPUNIT_ASSERT_EQUAL( expected, Json::parse( expected ).toString( ) );
+    CPPUNIT_ASSERT_EQUAL( string( ), Json( ).toString( ) );
+}
+
+namespace
+{
+    class TestListParser : public JsonListParser
+    {
+        public:
+            TestListParser( ) : JsonListParser( "items" ), m_items( ) { }
+
+            vector< Json > m_items;
+
+        protected:
+            virtual void itemParsed( Json item )
+            {
+                m_items.push_back( item );
+            }
+    };
+}
+
+void JsonTest::listParserTest( )
+{
+    string listing = "{ \"kind\": \"list\", \"count\": 3,\n"
+                     "  \"items\": [ { \"id\": \"a\", \"name\": \"a ] \\\" }\" },\n"
+                     "             { \"id\": \"b\", \"parents\": [ { \"id\": \"root\" } ] }, 42 ],\n"
+                     "  \"next\\u002ELink\": \"https://next/page\",\n"
+                     "  \"nested\": { \"items\": [ 1 ] } }\n";
+
+    // The result mustn't depend on how the listing is split
+    for ( size_t chunkSize = 1; chunkSize <= listing.size( ); chunkSize += 7 )
+    {
+        TestListParser parser;
+        for ( size_t pos = 0; pos < listing.size( ); pos += chunkSize )
+            parser.sputn( listing.data( ) + pos, min( chunkSize, listing.size( ) - pos ) );
+        parser.finish( );
+
+        CPPUNIT_ASSERT_EQUAL( size_t( 3 ), parser.m_items.size( ) );
+        CPPUNIT_ASSERT_EQUAL( string( "a ] \" }" ), parser.m_items[0]["name"].toString( ) );
+        CPPUNIT_ASSERT_EQUAL( string( "root" ), parser.m_items[1]["parents"].getList( ).front( )["id"].toString( ) );
+        CPPUNIT_ASSERT_EQUAL( string( "42" ), parser.m_items[2].toString( ) );
+        CPPUNIT_ASSERT_EQUAL( string( "list" ), parser.getMember( "kind" ).toString( ) );
+        CPPUNIT_ASSERT_EQUAL( string( "3" ), parser.getMember( "count" ).toString( ) );
+        CPPUNIT_ASSERT_EQUAL( string( "https://next/page" ), parser.getMember( "next.Link" ).toString( ) );
+        CPPUNIT_ASSERT_EQUAL( string( "1" ), parser.getMember( "nested" )["items"].getList( ).front( ).toString( ) );
+        CPPUNIT_ASSERT_EQUAL( string( ), parser.getMember( "missing" ).toString( ) );
+    }
+}
+
+void JsonTest::listParserInvalidTest( )
+{
+    const char* listings[] = { "", "{ \"items\": [ { \"id\": \"a\" }", "[ 1, 2 ]",
+                               "{ \"items\": [ { \"id\": } ] }", "{ } }" };
+    for ( size_t i = 0; i < sizeof( listings ) / sizeof( listings[0] ); ++i )
+    {
+        TestListParser parser;
+        parser.sputn( listings[i], strlen( listings[i] ) );
+        try
+        {
+            parser.finish( );
+            CPPUNIT_FAIL( string( "Should have failed to parse: " ) + listings[i] );
+        }
+        catch ( const libcmis::Exception& )
+        {
+        }
+    }
+}
+
+void JsonTest::parseBenchmarkTest( )
+{
+    // Recorded responses of the JSON based bindings
+    const char* files[] = {
+        DATA_DIR "/gdrive/document.json",
+        DATA_DIR "/gdrive/allVersions.json",
+        DATA_DIR "/onedrive/folder-listed.json",
+        DATA_DIR "/sharepoint/children-files.json",
+        DATA_DIR "/sharepoint/auth-resp.json"
+    };
+    for ( size_t i = 0; i < sizeof( files ) / sizeof( files[0] ); ++i )
+    {
+        string contents = getFileContents( files[i] );
+
+        // Parse and read the members like the object constructors do
+        size_t members = 0;
+        test::Benchmark benchmark( string( "Json::parse " ) + files[i] );
+        while ( benchmark.run( ) )
+        {
+            Json json = Json::parse( contents );
+            Json::JsonObject objects = json.getObjects( );
+            members = 0;
+            for ( Json::JsonObject::iterator it = objects.begin( ); it != objects.end( ); ++it )
+                members += it->second.toString( ).empty( ) ? 0 : 1;
+        }
+        benchmark.report( contents.size( ) );
+        CPPUNIT_ASSERT_MESSAGE( string( "No member parsed in " ) + files[i], members > 0 );
+    }
+}
+
 CPPUNIT_TEST_SUITE_REGISTRATION( JsonTest );
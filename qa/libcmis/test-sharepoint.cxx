@@ -69,6 +69,8 @@ class SharePointTest : public CppUnit::TestFixture
         void propertiesTest( );
         void deleteTest( );
         void xdigestExpiredTest( );
+        void xdigestSharedTest( );
+        void xdigestRenewalTest( );
         void getFileAllowableActionsTest( );
         void getFolderAllowableActionsTest( );
         void getDocumentTest( );
@@ -79,6 +81,8 @@ class SharePointTest : public CppUnit::TestFixture
         void getAllVersionsTest( );
         void getFolderTest( );
         void getChildrenTest( );
+        void getChildrenLightTest( );
+        void getChildrenExpandTest( );
         void createFolderTest( );
         void createDocumentTest( );
         void moveTest( );
@@ -94,6 +98,8 @@ class SharePointTest : public CppUnit::TestFixture
         CPPUNIT_TEST( propertiesTest );
         CPPUNIT_TEST( deleteTest );
         CPPUNIT_TEST( xdigestExpiredTest );
+        CPPUNIT_TEST( xdigestSharedTest );
+        CPPUNIT_TEST( xdigestRenewalTest );
         CPPUNIT_TEST( getFileAllowableActionsTest );
         CPPUNIT_TEST( getFolderAllowableActionsTest );
         CPPUNIT_TEST( getDocumentTest );
@@ -104,6 +110,8 @@ class SharePointTest : public CppUnit::TestFixture
         CPPUNIT_TEST( getAllVersionsTest );
         CPPUNIT_TEST( getFolderTest );
         CPPUNIT_TEST( getChildrenTest );
+        CPPUNIT_TEST( getChildrenLightTest );
+        CPPUNIT_TEST( getChildrenExpandTest );
         CPPUNIT_TEST( createFolderTest );
         CPPUNIT_TEST( createDocumentTest );
         CPPUNIT_TEST( moveTest );
@@ -248,10 +256,53 @@ void SharePointTest::xdigestExpiredTest( )
                    "wrong xdigest code",
                    string ( "new-xdigest-code" ),
                    session->m_digestCode );
+            CPPUNIT_ASSERT_EQUAL_MESSAGE( "Fallback not counted",
+                   (unsigned long)1, session->getDigestFallbackCount( ) );
         }
     }
 }
 
+void SharePointTest::xdigestSharedTest( )
+{
+    // Use another user to avoid getting the digests of the other tests
+    static const string username( "shared-digest-user" );
+    SharePointSessionPtr session = getTestSession( username, PASSWORD );
+    SharePointSessionPtr other( new SharePointSession( BASE_URL, username, PASSWORD, false ) );
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "The digest should be fetched only once", 1,
+            curl_mockup_getRequestsCount( CONTEXTINFO_URL.c_str( ), "", "POST" ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong shared digest", session->m_digestCode, other->m_digestCode );
+    CPPUNIT_ASSERT_MESSAGE( "Missing digest expiry", other->m_digestExpiry != 0 );
+}
+
+void SharePointTest::xdigestRenewalTest( )
+{
+    static const string objectId ( "http://base/_api/Web/aFileId" );
+    static const string username( "renewed-digest-user" );
+
+    // The digest expires in less than the renewal margin: it is renewed
+    // before deleting the object
+    curl_mockup_reset( );
+    curl_mockup_addResponse( BASE_URL.c_str( ), "", "GET", "", 401, false );
+    curl_mockup_addResponse( ( BASE_URL + "/currentuser" ).c_str( ), "", "GET",
+                             DATA_DIR "/sharepoint/auth-resp.json", 200, true );
+    curl_mockup_addResponse( CONTEXTINFO_URL.c_str( ), "", "POST",
+                             DATA_DIR "/sharepoint/xdigest-short.json", 200, true );
+    curl_mockup_addResponse( objectId.c_str( ), "", "GET", DATA_DIR "/sharepoint/file.json", 200, true );
+    curl_mockup_addResponse( ( objectId + "/Author" ).c_str( ), "", "GET",
+                             DATA_DIR "/sharepoint/author.json", 200, true );
+    curl_mockup_addResponse( objectId.c_str( ), "", "DELETE", "", 204, false );
+    SharePointSessionPtr session( new SharePointSession( BASE_URL, username, PASSWORD, false ) );
+
+    libcmis::ObjectPtr object = session->getObject( objectId );
+    object->remove( );
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "The digest should have been renewed", 2,
+            curl_mockup_getRequestsCount( CONTEXTINFO_URL.c_str( ), "", "POST" ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Unexpected fallback",
+            (unsigned long)0, session->getDigestFallbackCount( ) );
+}
+
 void SharePointTest::getFileAllowableActionsTest( )
 {
     static const string objectId ( "http://base/_api/Web/aFileId" );
@@ -565,6 +616,93 @@ void SharePointTest::getChildrenTest( )
     CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong number of file children", 1, fileCount );
 }
 
+void SharePointTest::getChildrenLightTest( )
+{
+    // The folder and files are in the minimalmetadata format,
+    // the other responses in the nometadata one
+    static const string folderId( "http://base/_api/Web/aFolderId" );
+    static const string fileId( "http://base/_api/Web/aFileId" );
+    static const string subFolderId( BASE_URL + "/getFolderByServerRelativeUrl('" +
+                libcmis::escape( "/Shared Documents/SharePointFolder/SubFolder" ) + "')" );
+    SharePointSessionPtr session = getTestSession( USERNAME, PASSWORD );
+
+    curl_mockup_addResponse( folderId.c_str( ), "",
+                             "GET", DATA_DIR "/sharepoint/folder-light.json", 200, true );
+    curl_mockup_addResponse( ( folderId + "/Properties" ).c_str( ), "%24select=",
+                             "GET", DATA_DIR "/sharepoint/folder-properties-light.json", 200, true );
+    curl_mockup_addResponse( ( subFolderId + "/Properties" ).c_str( ), "%24select=",
+                             "GET", DATA_DIR "/sharepoint/folder-properties-light.json", 200, true );
+    curl_mockup_addResponse( ( folderId + "/Files" ).c_str( ), "%24select=",
+                             "GET", DATA_DIR "/sharepoint/children-files-light.json", 200, true );
+    curl_mockup_addResponse( ( folderId + "/Folders" ).c_str( ), "%24select=",
+                             "GET", DATA_DIR "/sharepoint/children-folders-light.json", 200, true );
+    curl_mockup_addResponse( ( fileId + "/Author" ).c_str( ), "%24select=Title",
+                             "GET", DATA_DIR "/sharepoint/author-light.json", 200, true );
+
+    libcmis::FolderPtr folder = session->getFolder( folderId );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong folder ID", folderId, folder->getId( ) );
+    CPPUNIT_ASSERT_MESSAGE( "CreationDate is missing", !folder->getCreationDate( ).is_not_a_date_time() );
+
+    vector< libcmis::ObjectPtr > children = folder->getChildren( );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Bad number of children", size_t( 2 ), children.size() );
+
+    libcmis::FolderPtr subFolder = boost::dynamic_pointer_cast< libcmis::Folder >( children[0] );
+    CPPUNIT_ASSERT_MESSAGE( "First child should be a folder", NULL != subFolder );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong sub folder ID", subFolderId, subFolder->getId( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong sub folder parent", folderId, subFolder->getParentId( ) );
+
+    libcmis::DocumentPtr document = boost::dynamic_pointer_cast< libcmis::Document >( children[1] );
+    CPPUNIT_ASSERT_MESSAGE( "Second child should be a document", NULL != document );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong document ID", fileId, document->getId( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong document name", string( "SharePoint File" ), document->getName( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong document author", string( "aUserId" ), document->getCreatedBy( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong document size", long( 18045 ), document->getContentLength( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong versions URL", fileId + "/Versions",
+                                  document->getStringProperty( "Versions" ) );
+}
+
+void SharePointTest::getChildrenExpandTest( )
+{
+    // The folder response has the expanded files, folders and parent folder:
+    // the folders are on a second page.
+    static const string folderId( "http://base/_api/Web/aFolderId" );
+    static const string fileId( "http://base/_api/Web/aFileId" );
+    static const string subFolderId( BASE_URL + "/getFolderByServerRelativeUrl('" +
+                libcmis::escape( "/Shared Documents/SharePointFolder/SubFolder" ) + "')" );
+    SharePointSessionPtr session = getTestSession( USERNAME, PASSWORD );
+
+    curl_mockup_addResponse( folderId.c_str( ), "",
+                             "GET", DATA_DIR "/sharepoint/folder-expanded.json", 200, true );
+    curl_mockup_addResponse( ( folderId + "/Properties" ).c_str( ), "",
+                             "GET", DATA_DIR "/sharepoint/folder-properties-light.json", 200, true );
+    curl_mockup_addResponse( ( subFolderId + "/Properties" ).c_str( ), "",
+                             "GET", DATA_DIR "/sharepoint/folder-properties-light.json", 200, true );
+    curl_mockup_addResponse( ( folderId + "/Folders" ).c_str( ), "%24skiptoken=",
+                             "GET", DATA_DIR "/sharepoint/children-folders-light.json", 200, true );
+    curl_mockup_addResponse( ( fileId + "/Author" ).c_str( ), "",
+                             "GET", DATA_DIR "/sharepoint/author-light.json", 200, true );
+
+    libcmis::FolderPtr folder = session->getFolder( folderId );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong files URL", folderId + "/Files",
+                                  folder->getStringProperty( "Files" ) );
+
+    vector< libcmis::ObjectPtr > children = folder->getChildren( );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Bad number of children", size_t( 2 ), children.size() );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong sub folder ID", subFolderId, children[0]->getId( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong document ID", fileId, children[1]->getId( ) );
+
+    const struct HttpRequest* request = curl_mockup_getRequest( folderId.c_str( ),
+            "%24expand=Files,Folders,ParentFolder&", "GET" );
+    CPPUNIT_ASSERT_MESSAGE( "Expanded request not sent", request );
+    curl_mockup_HttpRequest_free( request );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Files shouldn't be listed separately", 0,
+            curl_mockup_getRequestsCount( ( folderId + "/Files" ).c_str( ), "", "GET" ) );
+
+    // The parent folder was in the expanded response
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong parent ID", string( "http://base/_api/Web/rootFolderId" ),
+                                  folder->getParentId( ) );
+}
+
 void SharePointTest::createFolderTest( )
 {
     static const string folderId( "http://base/_api/Web/aFolderId" );
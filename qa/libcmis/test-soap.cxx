@@ -74,9 +74,12 @@ class SoapTest : public CppUnit::TestFixture
 
         void serializeMultipartSimpleTest( );
         void serializeMultipartComplexTest( );
+        void serializeMultipartStreamTest( );
         void parseMultipartTest( );
+        void parseMultipartStreamedTest( );
         void getStreamFromNodeXopTest( );
         void getStreamFromNodeBase64Test( );
+        void xopInlineContentFilterTest( );
 
         // CMISM utilities tests
         void writeCmismStreamTest( );
@@ -94,9 +97,12 @@ class SoapTest : public CppUnit::TestFixture
 
         CPPUNIT_TEST( serializeMultipartSimpleTest );
         CPPUNIT_TEST( serializeMultipartComplexTest );
+        CPPUNIT_TEST( serializeMultipartStreamTest );
         CPPUNIT_TEST( parseMultipartTest );
+        CPPUNIT_TEST( parseMultipartStreamedTest );
         CPPUNIT_TEST( getStreamFromNodeXopTest );
         CPPUNIT_TEST( getStreamFromNodeBase64Test );
+        CPPUNIT_TEST( xopInlineContentFilterTest );
 
         CPPUNIT_TEST( writeCmismStreamTest );
 
@@ -391,6 +397,69 @@ void SoapTest::serializeMultipartComplexTest( )
             multipart.getContentType() );
 }
 
+void SoapTest::serializeMultipartStreamTest( )
+{
+    string rootName = "root";
+    string rootType = "text/plain";
+    string rootContent = "Some content";
+
+    // The data part is read from its stream when writing the body
+    string dataName = "data";
+    string dataType = "application/octet-stream";
+    string dataContent;
+    for ( int i = 0; i < 100000; ++i )
+        dataContent += char( i * 7 );
+    boost::shared_ptr< ostream > dataStream( new stringstream( dataContent ) );
+
+    RelatedMultipart multipart;
+    RelatedPartPtr rootPart( new RelatedPart( rootName, rootType, rootContent ) );
+    string rootCid = multipart.addPart( rootPart );
+    RelatedPartPtr dataPart( new RelatedPart( dataName, dataType, dataStream, dataContent.size( ) ) );
+    string dataCid = multipart.addPart( dataPart );
+    multipart.setStart( rootCid, "some info" );
+
+    string boundary = multipart.getBoundary( );
+    string expected = "\r\n--" + boundary + "\r\n" +
+                      "Content-Id: <" + rootCid + ">\r\n" +
+                      "Content-Type: " + rootType + "\r\n" +
+                      "Content-Transfer-Encoding: binary\r\n" +
+                      "\r\n" +
+                      rootContent +
+                      "\r\n--" + boundary + "\r\n" +
+                      "Content-Id: <" + dataCid + ">\r\n" +
+                      "Content-Type: " + dataType + "\r\n" +
+                      "Content-Transfer-Encoding: binary\r\n" +
+                      "\r\n" +
+                      dataContent +
+                      "\r\n--" + boundary + "--\r\n";
+
+    boost::shared_ptr< istream > actual = multipart.getBodyStream( );
+
+    // The size is known without reading the content
+    actual->seekg( 0, ios::end );
+    CPPUNIT_ASSERT_EQUAL( long( expected.size( ) ), long( actual->tellg( ) ) );
+
+    // Read it twice, like when an HTTP request needs to be sent again
+    for ( int i = 0; i < 2; ++i )
+    {
+        actual->clear( );
+        actual->seekg( 0, ios::beg );
+        stringstream out;
+        out << actual->rdbuf( );
+        CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong body", expected, out.str( ) );
+    }
+
+    // Seek in the middle of the data part
+    size_t dataPos = expected.find( dataContent );
+    actual->clear( );
+    actual->seekg( streamoff( dataPos + 5000 ), ios::beg );
+    char buf[10];
+    actual->read( buf, sizeof( buf ) );
+    CPPUNIT_ASSERT_EQUAL( expected.substr( dataPos + 5000, sizeof( buf ) ), string( buf, sizeof( buf ) ) );
+
+    CPPUNIT_ASSERT_EQUAL( expected, multipart.toStream( )->str( ) );
+}
+
 void SoapTest::parseMultipartTest( )
 {
     string rootCid = "root-cid";
@@ -443,6 +512,75 @@ void SoapTest::parseMultipartTest( )
     CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong part2 part content", part2Content, actualPart2->getContent( ) );
 }
 
+void SoapTest::parseMultipartStreamedTest( )
+{
+    string rootCid = "root-cid";
+    string rootType = "text/xml";
+    string rootContent = "<root/>";
+
+    // Binary content with line ends and pieces of boundary in it
+    string boundary = "uuid:0123-4567";
+    string dataCid = "data-cid";
+    string dataType = "application/octet-stream";
+    string dataContent;
+    for ( int i = 0; i < 5000; ++i )
+    {
+        dataContent += char( i % 256 );
+        if ( i % 700 == 0 )
+            dataContent += "\r\n--uuid:0123";
+    }
+
+    string body = "--" + boundary + "\r\n" +
+                  "Content-Id: <" + rootCid + ">\r\n" +
+                  "Content-Type: " + rootType + "\r\n" +
+                  "\r\n" +
+                  rootContent +
+                  "\r\n--" + boundary + "\r\n" +
+                  "Content-Id: <" + dataCid + ">\r\n" +
+                  "Content-Type: " + dataType + "\r\n" +
+                  "\r\n" +
+                  dataContent +
+                  "\r\n--" + boundary + "--";
+
+    string contentType = "multipart/related;start=\"<" + rootCid + ">\";type=\"" + rootType + "\";" +
+                         "boundary=\"" + boundary + "\"";
+
+    size_t chunkSizes[] = { 1, 3, 17, 4096, body.size( ) };
+    for ( size_t i = 0; i < sizeof( chunkSizes ) / sizeof( size_t ); ++i )
+    {
+        // Write the body in chunks, spilling the parts above 1000 bytes
+        RelatedMultipartParser parser( contentType, 1000 );
+        ostream out( &parser );
+        for ( size_t pos = 0; pos < body.size( ); pos += chunkSizes[i] )
+            out.write( body.data( ) + pos, min( chunkSizes[i], body.size( ) - pos ) );
+        parser.finish( );
+
+        RelatedMultipart& multipart = parser.getMultipart( );
+        CPPUNIT_ASSERT_EQUAL( size_t( 2 ), multipart.getIds( ).size( ) );
+
+        RelatedPartPtr root = multipart.getPart( rootCid );
+        CPPUNIT_ASSERT_MESSAGE( "Missing root part", root.get( ) != NULL );
+        CPPUNIT_ASSERT_EQUAL( rootContent, root->getContent( ) );
+        CPPUNIT_ASSERT_MESSAGE( "Start part shouldn't be spilled", !root->isSpilled( ) );
+
+        RelatedPartPtr data = multipart.getPart( dataCid );
+        CPPUNIT_ASSERT_MESSAGE( "Missing data part", data.get( ) != NULL );
+        CPPUNIT_ASSERT_EQUAL( dataType, data->getContentType( ) );
+        CPPUNIT_ASSERT_MESSAGE( "Big part should be spilled", data->isSpilled( ) );
+        CPPUNIT_ASSERT_EQUAL( dataContent, data->getContent( ) );
+
+        // Read the part as a stream, even after the parser is gone
+        boost::shared_ptr< istream > stream = data->getContentStream( );
+        data.reset( );
+        stream->seekg( 0, ios::end );
+        CPPUNIT_ASSERT_EQUAL( long( dataContent.size( ) ), long( stream->tellg( ) ) );
+        stream->seekg( 0, ios::beg );
+        stringstream read;
+        read << stream->rdbuf( );
+        CPPUNIT_ASSERT_EQUAL( dataContent, read.str( ) );
+    }
+}
+
 void SoapTest::getStreamFromNodeXopTest( )
 {
     // Create the test multipart
@@ -520,6 +658,59 @@ void SoapTest::getStreamFromNodeBase64Test( )
     CPPUNIT_ASSERT_EQUAL( expectedContent, out.str( ) );
 }
 
+void SoapTest::xopInlineContentFilterTest( )
+{
+    string content;
+    for ( int i = 0; i < 3000; ++i )
+        content += char( i * 13 );
+
+    string encoded;
+    {
+        libcmis::EncodedData encoder( &encoded );
+        encoder.setEncoding( "base64" );
+        encoder.encode( ( void* )content.data( ), 1, content.size( ) );
+        encoder.finish( );
+    }
+
+    string body = string( "<S:Envelope xmlns:S=\"" ) + NS_SOAP_ENV_URL + "\"><S:Body>" +
+                  "<cmism:getContentStreamResponse xmlns:cmism=\"" + NS_CMISM_URL + "\">" +
+                  "<cmism:contentStream><cmism:mimeType>text/plain</cmism:mimeType>" +
+                  "<cmism:stream>" + encoded + "</cmism:stream>" +
+                  "</cmism:contentStream></cmism:getContentStreamResponse></S:Body></S:Envelope>";
+
+    // Receive the response in small chunks, spilling the content above 1000 bytes
+    libcmis::HttpResponse response;
+    response.setXmlContent( true );
+    boost::shared_ptr< XopInlineContentFilter > filter( new XopInlineContentFilter( 1000 ) );
+    response.setXmlTextFilter( filter );
+    for ( size_t pos = 0; pos < body.size( ); pos += 7 )
+        response.getData( )->decode( ( void* )( body.data( ) + pos ), 1, min( size_t( 7 ), body.size( ) - pos ) );
+    response.getData( )->finish( );
+
+    xmlDocPtr doc = response.getXmlDoc( );
+    CPPUNIT_ASSERT_MESSAGE( "Response not parsed", doc != NULL );
+    CPPUNIT_ASSERT_MESSAGE( "Body shouldn't be kept", response.getBody( ).empty( ) );
+
+    libcmis::XPathContext xpathCtx( doc );
+    xmlXPathObjectPtr xpathObj = xpathCtx.eval( "//cmism:stream" );
+    CPPUNIT_ASSERT( xpathObj != NULL && xpathObj->nodesetval && xpathObj->nodesetval->nodeNr == 1 );
+    xmlNodePtr node = xpathObj->nodesetval->nodeTab[0];
+    xmlXPathFreeObject( xpathObj );
+
+    // The base64 text isn't in the tree, but referenced like an MTOM attachment
+    CPPUNIT_ASSERT_MESSAGE( "Missing xop:Include", node->children != NULL && node->children->next == NULL );
+    CPPUNIT_ASSERT_EQUAL( string( "Include" ), string( ( const char* )node->children->name ) );
+
+    vector< string > ids = filter->getMultipart( ).getIds( );
+    CPPUNIT_ASSERT_EQUAL( size_t( 1 ), ids.size( ) );
+    CPPUNIT_ASSERT_MESSAGE( "Content should be spilled", filter->getMultipart( ).getPart( ids.front( ) )->isSpilled( ) );
+
+    boost::shared_ptr< istream > stream = getStreamFromNode( node, filter->getMultipart( ) );
+    stringstream out;
+    out << stream->rdbuf( );
+    CPPUNIT_ASSERT_EQUAL( content, out.str( ) );
+}
+
 void SoapTest::writeCmismStreamTest( )
 {
     // Initialize the writer
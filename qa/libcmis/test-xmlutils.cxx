@@ -26,6 +26,8 @@
  * instead of those above.
  */
 
+#include <climits>
+#include <cmath>
 #include <ctime>
 #include <sstream>
 
@@ -49,6 +51,7 @@
 #include <libcmis/property-type.hxx>
 #include <libcmis/xml-utils.hxx>
 
+#include "property-type-registry.hxx"
 #include "test-helpers.hxx"
 
 using namespace boost;
@@ -64,6 +67,8 @@ class XmlTest : public CppUnit::TestFixture
         void parseBoolTest( );
         void parseIntegerTest( );
         void parseDoubleTest( );
+        void parseScalarsFuzzTest( );
+        void parseScalarsBenchmarkTest( );
 
         void parsePropertyStringTest( );
         void parsePropertyIntegerTest( );
@@ -72,6 +77,7 @@ class XmlTest : public CppUnit::TestFixture
 
         void parseEmptyPropertyTest( );
         void parsePropertyNoTypeTest( );
+        void parsePropertySharedTypeTest( );
 
         void parseRenditionTest( );
         void parseRepositoryCapabilitiesTest( );
@@ -79,9 +85,15 @@ class XmlTest : public CppUnit::TestFixture
         // Writer tests
         void propertyStringAsXmlTest( );
         void propertyIntegerAsXmlTest( );
+        void propertyValuesTest( );
+        void propertyValuesBenchmarkTest( );
 
         // Other tests
         void sha1Test( );
+        void computeContentHashesTest( );
+        void xpathContextTest( );
+        void httpResponseBodyTest( );
+        void httpResponseXmlTest( );
         void propertyTypeUpdateTest( );
         void escapeTest( );
         void unescapeTest( );
@@ -91,17 +103,26 @@ class XmlTest : public CppUnit::TestFixture
         CPPUNIT_TEST( parseBoolTest );
         CPPUNIT_TEST( parseIntegerTest );
         CPPUNIT_TEST( parseDoubleTest );
+        CPPUNIT_TEST( parseScalarsFuzzTest );
+        CPPUNIT_TEST( parseScalarsBenchmarkTest );
         CPPUNIT_TEST( parsePropertyStringTest );
         CPPUNIT_TEST( parsePropertyIntegerTest );
         CPPUNIT_TEST( parsePropertyDateTimeTest );
         CPPUNIT_TEST( parsePropertyBoolTest );
         CPPUNIT_TEST( parseEmptyPropertyTest );
         CPPUNIT_TEST( parsePropertyNoTypeTest );
+        CPPUNIT_TEST( parsePropertySharedTypeTest );
         CPPUNIT_TEST( parseRenditionTest );
         CPPUNIT_TEST( parseRepositoryCapabilitiesTest );
         CPPUNIT_TEST( propertyStringAsXmlTest );
         CPPUNIT_TEST( propertyIntegerAsXmlTest );
+        CPPUNIT_TEST( propertyValuesTest );
+        CPPUNIT_TEST( propertyValuesBenchmarkTest );
         CPPUNIT_TEST( sha1Test );
+        CPPUNIT_TEST( computeContentHashesTest );
+        CPPUNIT_TEST( xpathContextTest );
+        CPPUNIT_TEST( httpResponseBodyTest );
+        CPPUNIT_TEST( httpResponseXmlTest );
         CPPUNIT_TEST( propertyTypeUpdateTest );
         CPPUNIT_TEST( escapeTest );
         CPPUNIT_TEST( unescapeTest );
@@ -375,6 +396,258 @@ void XmlTest::parseDoubleTest( )
     }
 }
 
+namespace
+{
+    // Reference implementations the fast scalar parsers have to match
+    posix_time::ptime lcl_refParseDateTime( const string& dateTimeStr )
+    {
+        posix_time::ptime t( boost::date_time::not_a_date_time );
+        posix_time::time_duration tzOffset( posix_time::duration_from_string( "+00:00" ) );
+
+        if ( dateTimeStr.empty( ) )
+            return t;
+
+        size_t teePos = dateTimeStr.find( 'T' );
+        if ( teePos == string::npos || teePos == dateTimeStr.size() - 1 )
+            return t;
+
+        string noTzStr = dateTimeStr.substr( 0, teePos + 1 );
+        string timeStr = dateTimeStr.substr( teePos + 1 );
+
+        if ( timeStr[ timeStr.size() - 1] == 'Z' )
+            noTzStr += timeStr.substr( 0, timeStr.size() - 1 );
+        else
+        {
+            size_t tzPos = timeStr.find( '+' );
+            if ( tzPos == string::npos )
+                tzPos = timeStr.find( '-' );
+
+            if ( tzPos != string::npos )
+            {
+                noTzStr += timeStr.substr( 0, tzPos );
+                string tzStr = timeStr.substr( tzPos );
+                try
+                {
+                    tzOffset = posix_time::time_duration( posix_time::duration_from_string( tzStr.c_str() ) );
+                }
+                catch ( const std::exception& )
+                {
+                    return t;
+                }
+            }
+            else
+                noTzStr += timeStr;
+        }
+
+        size_t pos = noTzStr.find_first_of( ":-" );
+        while ( pos != string::npos )
+        {
+            noTzStr.erase( pos, 1 );
+            pos = noTzStr.find_first_of( ":-" );
+        }
+        try
+        {
+            t = posix_time::from_iso_string( noTzStr.c_str( ) );
+            t = t + tzOffset;
+        }
+        catch ( const std::exception& )
+        {
+        }
+
+        return t;
+    }
+
+    string lcl_refWriteDateTime( posix_time::ptime time )
+    {
+        string str;
+        if ( !time.is_special( ) )
+            str = posix_time::to_iso_extended_string( time ) + "Z";
+        return str;
+    }
+
+    bool lcl_refParseInteger( const string& intStr, long& value )
+    {
+        char* end;
+        errno = 0;
+        value = strtol( intStr.c_str(), &end, 0 );
+        if ( ( ERANGE == errno && ( LONG_MAX == value || LONG_MIN == value ) ) ||
+             ( errno != 0 && value == 0 ) )
+            return false;
+        return string( end ).empty( );
+    }
+
+    bool lcl_refParseDouble( const string& doubleStr, double& value )
+    {
+        char* end;
+        errno = 0;
+        value = strtod( doubleStr.c_str(), &end );
+        if ( ( ERANGE == errno ) || ( errno != 0 && value == 0 ) )
+            return false;
+        return string( end ).empty( );
+    }
+
+    /// Randomly change, insert or remove characters of a string
+    string lcl_mutate( const string& str, unsigned int& seed )
+    {
+        static const char alphabet[] = "0123456789-+:.TZ x";
+        string mutated( str );
+        int changes = rand_r( &seed ) % 3;
+        for ( int i = 0; i < changes; ++i )
+        {
+            size_t pos = mutated.empty( ) ? 0 : rand_r( &seed ) % mutated.size( );
+            char c = alphabet[ rand_r( &seed ) % ( sizeof( alphabet ) - 1 ) ];
+            switch ( rand_r( &seed ) % 4 )
+            {
+                case 0:
+                    if ( !mutated.empty( ) )
+                        mutated[pos] = c;
+                    break;
+                case 1:
+                    mutated.insert( pos, 1, c );
+                    break;
+                case 2:
+                    if ( !mutated.empty( ) )
+                        mutated.erase( pos, 1 );
+                    break;
+                default:
+                    mutated = mutated.substr( 0, pos );
+                    break;
+            }
+        }
+        return mutated;
+    }
+
+    string lcl_readAll( istream& is )
+    {
+        stringstream out;
+        out << is.rdbuf( );
+        return out.str( );
+    }
+}
+
+void XmlTest::parseScalarsFuzzTest( )
+{
+    unsigned int seed = 42;
+
+    const char* dates[] = {
+        "2012-01-19T09:06:57.388Z", "2011-09-28T12:44:28", "2011-09-28T12:44:28+02:00",
+        "2011-09-28T12:44:28.5-05:30", "2000-02-29T23:59:59.123456Z", "1999-12-31T00:00:00Z",
+        "2011-02-30T12:44:28Z", "2011-09-28T24:00:00Z", "2011-09-28T12:44:28.1234567Z"
+    };
+    for ( int i = 0; i < 20000; ++i )
+    {
+        string str = lcl_mutate( dates[ i % ( sizeof( dates ) / sizeof( dates[0] ) ) ], seed );
+        posix_time::ptime expected = lcl_refParseDateTime( str );
+        CPPUNIT_ASSERT_EQUAL_MESSAGE( "Different date for: " + str, expected, libcmis::parseDateTime( str ) );
+        CPPUNIT_ASSERT_EQUAL_MESSAGE( "Different date string for: " + str,
+                lcl_refWriteDateTime( expected ), libcmis::writeDateTime( expected ) );
+    }
+
+    const char* numbers[] = {
+        "0", "12345", "-42", "+7", "010", "0x1F", "9223372036854775807", "-9223372036854775808",
+        "99999999999999999999", "3.14", "-1e10", "1.5E-3", "123456789012345678",
+        "9999999999"
+    };
+    for ( int i = 0; i < 20000; ++i )
+    {
+        string str = lcl_mutate( numbers[ i % ( sizeof( numbers ) / sizeof( numbers[0] ) ) ], seed );
+
+        long expectedLong = 0;
+        bool validLong = lcl_refParseInteger( str, expectedLong );
+        try
+        {
+            long actual = libcmis::parseInteger( str );
+            CPPUNIT_ASSERT_MESSAGE( "Integer should be invalid: " + str, validLong );
+            CPPUNIT_ASSERT_EQUAL_MESSAGE( "Different integer for: " + str, expectedLong, actual );
+        }
+        catch ( const libcmis::Exception& )
+        {
+            CPPUNIT_ASSERT_MESSAGE( "Integer should be valid: " + str, !validLong );
+        }
+
+        double expectedDouble = 0;
+        bool validDouble = lcl_refParseDouble( str, expectedDouble );
+        try
+        {
+            double actual = libcmis::parseDouble( str );
+            CPPUNIT_ASSERT_MESSAGE( "Decimal should be invalid: " + str, validDouble );
+            CPPUNIT_ASSERT_MESSAGE( "Different decimal for: " + str,
+                    expectedDouble == actual || ( std::isnan( expectedDouble ) && std::isnan( actual ) ) );
+        }
+        catch ( const libcmis::Exception& )
+        {
+            CPPUNIT_ASSERT_MESSAGE( "Decimal should be valid: " + str, !validDouble );
+        }
+    }
+}
+
+void XmlTest::parseScalarsBenchmarkTest( )
+{
+    // Compare with the previous implementations on typical values
+    const string date( "2012-01-19T09:06:57.388Z" );
+    const string integer( "1234567" );
+    const string decimal( "3.14159" );
+
+    posix_time::ptime refTime;
+    Benchmark refParseDate( "parseDateTime (previous)" );
+    while ( refParseDate.run( ) )
+        refTime = lcl_refParseDateTime( date );
+    refParseDate.report( );
+
+    posix_time::ptime time;
+    Benchmark parseDate( "parseDateTime" );
+    while ( parseDate.run( ) )
+        time = libcmis::parseDateTime( date );
+    parseDate.report( );
+    CPPUNIT_ASSERT_EQUAL( refTime, time );
+
+    string refTimeStr;
+    Benchmark refWriteDate( "writeDateTime (previous)" );
+    while ( refWriteDate.run( ) )
+        refTimeStr = lcl_refWriteDateTime( time );
+    refWriteDate.report( );
+
+    string timeStr;
+    Benchmark writeDate( "writeDateTime" );
+    while ( writeDate.run( ) )
+        timeStr = libcmis::writeDateTime( time );
+    writeDate.report( );
+    CPPUNIT_ASSERT_EQUAL( refTimeStr, timeStr );
+
+    long refLong = 0;
+    Benchmark refParseInt( "parseInteger (previous)" );
+    while ( refParseInt.run( ) )
+        lcl_refParseInteger( integer, refLong );
+    refParseInt.report( );
+
+    long longValue = 0;
+    Benchmark parseInt( "parseInteger" );
+    while ( parseInt.run( ) )
+        longValue = libcmis::parseInteger( integer );
+    parseInt.report( );
+    CPPUNIT_ASSERT_EQUAL( refLong, longValue );
+
+    double refDouble = 0;
+    Benchmark refParseDecimal( "parseDouble (previous)" );
+    while ( refParseDecimal.run( ) )
+        lcl_refParseDouble( decimal, refDouble );
+    refParseDecimal.report( );
+
+    double doubleValue = 0;
+    Benchmark parseDecimal( "parseDouble" );
+    while ( parseDecimal.run( ) )
+        doubleValue = libcmis::parseDouble( decimal );
+    parseDecimal.report( );
+    CPPUNIT_ASSERT_EQUAL( refDouble, doubleValue );
+
+    bool boolValue = false;
+    Benchmark parseBoolean( "parseBool" );
+    while ( parseBoolean.run( ) )
+        boolValue = libcmis::parseBool( "true" );
+    parseBoolean.report( );
+    CPPUNIT_ASSERT( boolValue );
+}
+
 void XmlTest::parsePropertyStringTest( )
 {
     stringstream buf;
@@ -460,6 +733,55 @@ void XmlTest::parsePropertyNoTypeTest( )
     CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong number of values parsed", vector<string>::size_type( 2 ), actual->getDateTimes( ).size( ) );
 }
 
+void XmlTest::parsePropertySharedTypeTest( )
+{
+    stringstream buf;
+    buf << "<cmis:propertyInteger " << getXmlns( )
+        <<            "propertyDefinitionId=\"SHARED-ID\" localName=\"LOCAL\">"
+        <<      "<cmis:value>42</cmis:value>"
+        << "</cmis:propertyInteger>";
+    libcmis::ObjectTypePtr noType;
+    libcmis::PropertyPtr first = libcmis::parseProperty( getXmlNode( buf.str( ) ), noType );
+    libcmis::PropertyPtr second = libcmis::parseProperty( getXmlNode( buf.str( ) ), noType );
+
+    libcmis::PropertyTypePtr shared = libcmis::getTemporaryPropertyType( "integer", "SHARED-ID", "LOCAL", "", "" );
+    CPPUNIT_ASSERT_MESSAGE( "Temporary type not shared",
+            shared == libcmis::getTemporaryPropertyType( "integer", "SHARED-ID", "LOCAL", "", "" ) );
+    CPPUNIT_ASSERT_MESSAGE( "Temporary type not flagged as shared", shared->isShared( ) );
+
+    // Different attributes mean a different type
+    libcmis::PropertyTypePtr other = libcmis::getTemporaryPropertyType( "integer", "SHARED-ID", "OTHER", "", "" );
+    CPPUNIT_ASSERT_MESSAGE( "Different types shared", shared != other );
+
+    // Reading the type doesn't need a copy
+    CPPUNIT_ASSERT_MESSAGE( "Shared type copied to be read", second->getPropertyTypeView( ) == shared );
+
+    // The properties hand out their own copy of the shared type
+    libcmis::PropertyTypePtr firstType = first->getPropertyType( );
+    CPPUNIT_ASSERT_MESSAGE( "Shared type handed out", firstType != shared && !firstType->isShared( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong type", libcmis::PropertyType::Integer, firstType->getType( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong local name", string( "LOCAL" ), firstType->getLocalName( ) );
+    CPPUNIT_ASSERT_MESSAGE( "Copy not kept", firstType == first->getPropertyType( ) );
+
+    // Modifying it doesn't change the other properties
+    firstType->setLocalName( "CHANGED" );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Shared type modified", string( "LOCAL" ), shared->getLocalName( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Other property type modified", string( "LOCAL" ),
+            second->getPropertyType( )->getLocalName( ) );
+
+    string id( "SHARED-ID" );
+    CPPUNIT_ASSERT_MESSAGE( "Property id not interned",
+            &libcmis::internPropertyId( id ) == &libcmis::internPropertyId( string( "SHARED-ID" ) ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong interned id", id, libcmis::internPropertyId( id ) );
+
+    // The content stream hash type of the JSON bindings is created once
+    libcmis::PropertyTypePtr hashType = libcmis::getContentStreamHashPropertyType( );
+    CPPUNIT_ASSERT_MESSAGE( "Hash type not reused", hashType == libcmis::getContentStreamHashPropertyType( ) );
+    CPPUNIT_ASSERT_MESSAGE( "Hash type not shared", hashType->isShared( ) );
+    CPPUNIT_ASSERT_MESSAGE( "Hash type not multi-valued", hashType->isMultiValued( ) );
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong hash type id", string( "cmis:contentStreamHash" ), hashType->getId( ) );
+}
+
 void XmlTest::parseRenditionTest( )
 {
     stringstream buf;
@@ -581,6 +903,95 @@ void XmlTest::propertyIntegerAsXmlTest( )
     CPPUNIT_ASSERT_EQUAL( expected.str( ), actual );
 }
 
+void XmlTest::propertyValuesTest( )
+{
+    ObjectTypeDummy factory;
+    libcmis::PropertyTypePtr intType = factory.getPropertiesTypes( )[ "INT-ID" ];
+
+    // Single value
+    {
+        vector< string > values( 1, string( "123" ) );
+        libcmis::Property property( intType, values );
+
+        CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong number of longs", size_t( 1 ), property.getLongValues( ).size( ) );
+        CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong long value", 123L, property.getLongValues( ).front( ) );
+        CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong string value", string( "123" ), property.getStringValues( ).front( ) );
+        CPPUNIT_ASSERT_MESSAGE( "Unexpected date values", property.getDateTimeValues( ).empty( ) );
+        CPPUNIT_ASSERT_MESSAGE( "Unexpected bool values", property.getBools( ).empty( ) );
+    }
+
+    // Multiple values, skipping the unparsable ones
+    {
+        vector< string > values;
+        values.push_back( string( "1" ) );
+        values.push_back( string( "not a number" ) );
+        values.push_back( string( "3" ) );
+        libcmis::Property property( intType, values );
+
+        vector< long > expected;
+        expected.push_back( 1 );
+        expected.push_back( 3 );
+        CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong number of strings", size_t( 3 ), property.getStringValues( ).size( ) );
+        CPPUNIT_ASSERT_MESSAGE( "Wrong long values", expected == property.getLongs( ) );
+
+        // Copies don't share the values
+        libcmis::Property copy( property );
+        vector< string > newValues( 1, string( "2" ) );
+        property.setValues( newValues );
+        CPPUNIT_ASSERT_MESSAGE( "Copy changed", expected == copy.getLongs( ) );
+        CPPUNIT_ASSERT_EQUAL_MESSAGE( "Wrong new value", 2L, property.getLongValues( )[0] );
+    }
+}
+
+void XmlTest::propertyValuesBenchmarkTest( )
+{
+    // A typical entry: id, name, modification date, content length and flag
+    ObjectTypeDummy factory;
+    map< string, libcmis::PropertyTypePtr >& types = factory.getPropertiesTypes( );
+    const char* ids[] = { "STR-ID", "STR-ID", "DATE-ID", "INT-ID", "BOOL-ID" };
+    const char* values[] = { "workspace://SpacesStore/f0ad8d81-ac1b-4b0a-9d3c-0d5e3a4c2b1a",
+                             "Quarterly report.odt", "2012-01-19T09:06:57.388Z", "123456", "true" };
+    const size_t count = sizeof( ids ) / sizeof( ids[0] );
+
+    vector< libcmis::PropertyPtr > entry;
+    Benchmark create( "Property creation (5 values)" );
+    while ( create.run( ) )
+    {
+        entry.clear( );
+        for ( size_t i = 0; i < count; ++i )
+            entry.push_back( libcmis::PropertyPtr( new libcmis::Property( types[ ids[i] ],
+                            vector< string >( 1, string( values[i] ) ) ) ) );
+    }
+    create.report( );
+
+    // Read the values like the Object getters do
+    size_t viewsSum = 0;
+    Benchmark views( "Property views read" );
+    while ( views.run( ) )
+    {
+        viewsSum += entry[0]->getStringValues( ).front( ).size( );
+        viewsSum += entry[1]->getStringValues( ).front( ).size( );
+        viewsSum += entry[2]->getDateTimeValues( ).front( ).date( ).day( );
+        viewsSum += size_t( entry[3]->getLongValues( ).front( ) );
+        viewsSum += entry[4]->getBoolValues( ).front( ) ? 1 : 0;
+    }
+    views.report( );
+
+    size_t copiesSum = 0;
+    Benchmark copies( "Property copies read" );
+    while ( copies.run( ) )
+    {
+        copiesSum += entry[0]->getStrings( ).front( ).size( );
+        copiesSum += entry[1]->getStrings( ).front( ).size( );
+        copiesSum += entry[2]->getDateTimes( ).front( ).date( ).day( );
+        copiesSum += size_t( entry[3]->getLongs( ).front( ) );
+        copiesSum += entry[4]->getBools( ).front( ) ? 1 : 0;
+    }
+    copies.report( );
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE( "Views and copies differ", copiesSum, viewsSum );
+}
+
 void XmlTest::sha1Test( )
 {
     {
@@ -595,6 +1006,137 @@ void XmlTest::sha1Test( )
     }
 }
 
+void XmlTest::computeContentHashesTest( )
+{
+    set< string > algorithms;
+    algorithms.insert( "md5" );
+    algorithms.insert( "sha-1" );
+    algorithms.insert( "quickxorhash" );
+    algorithms.insert( "sha-512" );
+
+    {
+        istringstream stream( "Hello" );
+        map< string, string > actual = libcmis::computeContentHashes( stream, algorithms );
+        CPPUNIT_ASSERT_EQUAL( size_t( 3 ), actual.size( ) );
+        CPPUNIT_ASSERT_EQUAL( string( "8b1a9953c4611296a827abf8c47804d7" ), actual["md5"] );
+        CPPUNIT_ASSERT_EQUAL( string( "f7ff9e8b7bb2e09b70935a5d785e0cc5d9d0abf0" ), actual["sha-1"] );
+        CPPUNIT_ASSERT_EQUAL( string( "SCgDG9jwBgAAAAAABQAAAAAAAAA=" ), actual["quickxorhash"] );
+    }
+
+    {
+        // Data spanning several read chunks and hash blocks
+        string data;
+        for ( int i = 0; i < 200003; ++i )
+            data += char( ( i * 7 + i / 300 ) & 0xff );
+        istringstream stream( data );
+        map< string, string > actual = libcmis::computeContentHashes( stream, algorithms );
+        CPPUNIT_ASSERT_EQUAL( string( "7cfaa6c9c0cb4948555ab7de0fe21be9" ), actual["md5"] );
+        CPPUNIT_ASSERT_EQUAL( string( "hmaKKLTEwgdrrrBzyTx/QHmB4qo=" ), actual["quickxorhash"] );
+    }
+}
+
+void XmlTest::xpathContextTest( )
+{
+    string xml = "<atom:feed xmlns:atom=\"" NS_ATOM_URL "\" xmlns:cmis=\"" NS_CMIS_URL "\">"
+                 "<atom:entry><cmis:value>first</cmis:value></atom:entry>"
+                 "<atom:entry><cmis:value>second</cmis:value></atom:entry>"
+                 "</atom:feed>";
+    xmlDocPtr doc = xmlReadMemory( xml.c_str( ), xml.size( ), "", NULL, 0 );
+
+    xmlNodePtr secondEntry = NULL;
+    {
+        libcmis::XPathContext ctx( doc );
+        xmlXPathObjectPtr xpathObj = ctx.eval( "//atom:entry" );
+        CPPUNIT_ASSERT( xpathObj != NULL && xpathObj->nodesetval != NULL );
+        CPPUNIT_ASSERT_EQUAL( 2, xpathObj->nodesetval->nodeNr );
+        secondEntry = xpathObj->nodesetval->nodeTab[1];
+        xmlXPathFreeObject( xpathObj );
+
+        CPPUNIT_ASSERT_EQUAL( string( "first" ), ctx.getValue( "//cmis:value" ) );
+    }
+
+    // The pooled context has to be reset for the next user
+    {
+        libcmis::XPathContext ctx( doc, secondEntry );
+        CPPUNIT_ASSERT_EQUAL( string( "second" ), ctx.getValue( "cmis:value" ) );
+        CPPUNIT_ASSERT( ctx.eval( "invalid[" ) == NULL );
+    }
+
+    xmlFreeDoc( doc );
+}
+
+void XmlTest::httpResponseBodyTest( )
+{
+    libcmis::HttpResponsePtr response( new libcmis::HttpResponse( ) );
+    response->reserveBody( 100 );
+
+    // Decoded data goes to the body buffer
+    response->getData( )->setEncoding( "base64" );
+    string encoded( "U29tZSBjb250ZW50" );
+    response->getData( )->decode( &encoded[0], 1, 8 );
+    response->getData( )->decode( &encoded[8], 1, 8 );
+    response->getData( )->finish( );
+
+    const string& body = response->getBody( );
+    CPPUNIT_ASSERT_EQUAL( string( "Some content" ), body );
+    CPPUNIT_ASSERT( body.capacity( ) >= 100 );
+
+    // The stream reads the body in place and keeps the response alive
+    boost::shared_ptr< istream > stream = response->getStream( );
+    response.reset( );
+
+    CPPUNIT_ASSERT_EQUAL( string( "Some content" ), lcl_readAll( *stream ) );
+    stream->clear( );
+    stream->seekg( -7, ios::end );
+    CPPUNIT_ASSERT_EQUAL( streampos( 5 ), stream->tellg( ) );
+    CPPUNIT_ASSERT_EQUAL( string( "content" ), lcl_readAll( *stream ) );
+}
+
+void XmlTest::httpResponseXmlTest( )
+{
+    string xml = "<?xml version=\"1.0\"?><root><child>value</child></root>";
+
+    // Parsed while the chunks arrive
+    {
+        libcmis::HttpResponse response;
+        response.setXmlContent( true );
+        for ( size_t i = 0; i < xml.size( ); i += 7 )
+        {
+            size_t len = xml.size( ) - i < 7 ? xml.size( ) - i : 7;
+            response.getData( )->decode( &xml[i], 1, len );
+        }
+        response.getData( )->finish( );
+
+        xmlDocPtr doc = response.getXmlDoc( );
+        CPPUNIT_ASSERT( doc != NULL );
+        CPPUNIT_ASSERT_EQUAL( string( "root" ), string( ( const char* )xmlDocGetRootElement( doc )->name ) );
+        CPPUNIT_ASSERT_EQUAL( xml, response.getBody( ) );
+    }
+
+    // Not announced as XML: parsed on demand
+    {
+        libcmis::HttpResponse response;
+        response.setXmlContent( true );
+        response.setXmlContent( false );
+        response.getData( )->decode( &xml[0], 1, xml.size( ) );
+        response.getData( )->finish( );
+
+        xmlDocPtr doc = response.getXmlDoc( );
+        CPPUNIT_ASSERT( doc != NULL );
+        CPPUNIT_ASSERT_EQUAL( string( "root" ), string( ( const char* )xmlDocGetRootElement( doc )->name ) );
+    }
+
+    // Not well-formed
+    {
+        libcmis::HttpResponse response;
+        response.setXmlContent( true );
+        string broken = "<root><child></root>";
+        response.getData( )->decode( &broken[0], 1, broken.size( ) );
+        response.getData( )->finish( );
+        CPPUNIT_ASSERT( response.getXmlDoc( ) == NULL );
+    }
+}
+
 void XmlTest::propertyTypeUpdateTest( )
 {
     libcmis::PropertyType propDef( "datetime", "DATE-ID", "", "", "" );
@@ -388,6 +388,82 @@ CURLcode curl_easy_getinfo( CURL * curl, long info, ... )
     return CURLE_OK;
 }
 
+CURLM *curl_multi_init( void )
+{
+    return new CurlMultiHandle( );
+}
+
+CURLMcode curl_multi_add_handle( CURLM * multi, CURL * curl )
+{
+    CurlMultiHandle* handle = static_cast< CurlMultiHandle* >( multi );
+    handle->m_pending.push_back( curl );
+    return CURLM_OK;
+}
+
+CURLMcode curl_multi_remove_handle( CURLM *, CURL * )
+{
+    return CURLM_OK;
+}
+
+CURLMcode curl_multi_perform( CURLM * multi, int * running_handles )
+{
+    CurlMultiHandle* handle = static_cast< CurlMultiHandle* >( multi );
+
+    // Run the transfers sequentially: the tests expect the requests
+    // to be recorded in the order they were added.
+    for ( vector< CURL* >::iterator it = handle->m_pending.begin( );
+          it != handle->m_pending.end( ); ++it )
+    {
+        CURLMsg msg;
+        msg.msg = CURLMSG_DONE;
+        msg.easy_handle = *it;
+        msg.data.result = curl_easy_perform( *it );
+        handle->m_done.push_back( msg );
+    }
+    handle->m_pending.clear( );
+
+    if ( running_handles != NULL )
+        *running_handles = 0;
+    return CURLM_OK;
+}
+
+CURLMcode curl_multi_wait( CURLM *, struct curl_waitfd*, unsigned int, int, int * ret )
+{
+    if ( ret != NULL )
+        *ret = 0;
+    return CURLM_OK;
+}
+
+CURLMsg *curl_multi_info_read( CURLM * multi, int * msgs_in_queue )
+{
+    CurlMultiHandle* handle = static_cast< CurlMultiHandle* >( multi );
+    CURLMsg* msg = NULL;
+    if ( !handle->m_done.empty( ) )
+    {
+        handle->m_current = handle->m_done.front( );
+        handle->m_done.pop_front( );
+        msg = &handle->m_current;
+    }
+
+    if ( msgs_in_queue != NULL )
+        *msgs_in_queue = handle->m_done.size( );
+    return msg;
+}
+
+CURLMcode curl_multi_cleanup( CURLM * multi )
+{
+    CurlMultiHandle* handle = static_cast< CurlMultiHandle* >( multi );
+    delete( handle );
+    return CURLM_OK;
+}
+
+CurlMultiHandle::CurlMultiHandle( ) :
+    m_pending( ),
+    m_done( ),
+    m_current( )
+{
+}
+
 CurlHandle::CurlHandle( ) :
     m_url( ),
     m_writeFn( NULL ),
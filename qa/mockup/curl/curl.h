@@ -142,6 +142,47 @@ typedef enum
 
 CURLcode curl_easy_getinfo( CURL *curl, long info, ... );
 
+typedef void CURLM;
+
+typedef enum
+{
+  CURLM_CALL_MULTI_PERFORM = -1,
+  CURLM_OK,
+  CURLM_BAD_HANDLE,
+  CURLM_BAD_EASY_HANDLE,
+  CURLM_LAST
+} CURLMcode;
+
+typedef enum
+{
+  CURLMSG_NONE,
+  CURLMSG_DONE,
+  CURLMSG_LAST
+} CURLMSG;
+
+struct CURLMsg
+{
+  CURLMSG msg;
+  CURL *easy_handle;
+  union
+  {
+    void *whatever;
+    CURLcode result;
+  } data;
+};
+typedef struct CURLMsg CURLMsg;
+
+struct curl_waitfd;
+
+CURLM *curl_multi_init( void );
+CURLMcode curl_multi_add_handle( CURLM *multi_handle, CURL *curl_handle );
+CURLMcode curl_multi_remove_handle( CURLM *multi_handle, CURL *curl_handle );
+CURLMcode curl_multi_perform( CURLM *multi_handle, int *running_handles );
+CURLMcode curl_multi_wait( CURLM *multi_handle, struct curl_waitfd extra_fds[],
+                           unsigned int extra_nfds, int timeout_ms, int *ret );
+CURLMsg *curl_multi_info_read( CURLM *multi_handle, int *msgs_in_queue );
+CURLMcode curl_multi_cleanup( CURLM *multi_handle );
+
 #define LIBCURL_VERSION_MAJOR 7
 #define LIBCURL_VERSION_MINOR 26
 #define LIBCURL_VERSION_PATCH 0
@@ -29,6 +29,7 @@
 #ifndef INCLUDED_QA_MOCKUP_INTERNALS_HXX
 #define INCLUDED_QA_MOCKUP_INTERNALS_HXX
 
+#include <deque>
 #include <map>
 #include <string>
 #include <vector>
@@ -75,6 +76,19 @@ class CurlHandle
         void reset( );
 };
 
+/** Multi handle running the added transfers one after the other
+    when curl_multi_perform is called.
+  */
+class CurlMultiHandle
+{
+    public:
+        CurlMultiHandle( );
+
+        std::vector< CURL* > m_pending;
+        std::deque< CURLMsg > m_done;
+        CURLMsg m_current;
+};
+
 namespace mockup
 {
     class Response
@@ -522,6 +522,42 @@ void CmisClient::execute( )
             else
                 throw CommandException( string( "Not a document object id: " ) + objIds.front() );
         }
+        else if ( "sync" == command )
+        {
+            unique_ptr<libcmis::Session> session( getSession( ) );
+
+            vector< string > args = m_vm["args"].as< vector< string > >( );
+            if ( args.size() < 2 )
+                throw CommandException( "Please provide a folder Id and a local directory" );
+
+            libcmis::SyncEngine engine( session.get( ), args[0], args[1] );
+            libcmis::SyncReport report;
+            if ( m_vm.count( "pull-only" ) > 0 )
+                report = engine.pull( );
+            else if ( m_vm.count( "push-only" ) > 0 )
+                report = engine.push( );
+            else
+                report = engine.sync( );
+
+            const vector< string >& downloaded = report.getDownloaded( );
+            for ( vector< string >::const_iterator it = downloaded.begin( ); it != downloaded.end( ); ++it )
+                cout << "Downloaded: " << *it << endl;
+            const vector< string >& uploaded = report.getUploaded( );
+            for ( vector< string >::const_iterator it = uploaded.begin( ); it != uploaded.end( ); ++it )
+                cout << "Uploaded: " << *it << endl;
+            const vector< string >& deletedLocally = report.getDeletedLocally( );
+            for ( vector< string >::const_iterator it = deletedLocally.begin( ); it != deletedLocally.end( ); ++it )
+                cout << "Deleted locally: " << *it << endl;
+            const vector< string >& deletedRemotely = report.getDeletedRemotely( );
+            for ( vector< string >::const_iterator it = deletedRemotely.begin( ); it != deletedRemotely.end( ); ++it )
+                cout << "Deleted on the server: " << *it << endl;
+            const vector< string >& conflicts = report.getConflicts( );
+            for ( vector< string >::const_iterator it = conflicts.begin( ); it != conflicts.end( ); ++it )
+                cout << "Conflict: " << *it << endl;
+            const map< string, string >& errors = report.getErrors( );
+            for ( map< string, string >::const_iterator it = errors.begin( ); it != errors.end( ); ++it )
+                cerr << "Failed: " << it->first << ": " << it->second << endl;
+        }
         else if ( "create-folder" == command )
         {
             unique_ptr<libcmis::Session> session( getSession( ) );
@@ -1043,6 +1079,14 @@ options_description CmisClient::getOptionsDescription( )
     ;
 
     desc.add( setcontentOpts );
+
+    options_description syncOpts( "sync options" );
+    syncOpts.add_options( )
+        ( "pull-only", "Only apply the changes of the server to the local directory" )
+        ( "push-only", "Only send the local changes to the server" )
+    ;
+
+    desc.add( syncOpts );
     return desc;
 }
 
@@ -1070,6 +1114,11 @@ void CmisClient::printHelp( )
     cerr << "   set-content <Object Id>\n"
             "           Replaces the stream of the content object by the\n"
             "           file selected with --input-file." << endl;
+    cerr << "   sync <Folder Id> <Local Directory>\n"
+            "           Synchronizes the content of the folder with the local directory.\n"
+            "           The changes are applied on both sides unless --pull-only or\n"
+            "           --push-only is given. Files changed on both sides are reported\n"
+            "           as conflicts and left untouched." << endl;
     cerr << "   create-folder <Parent Id> <Folder Name>\n"
             "           Creates a new folder inside the folder <Parent Id> named <Folder Name>." << endl;
     cerr << "   create-document <Parent Id> <Document Name>\n"
@@ -36,6 +36,122 @@ using libcmis::FolderPtr;
 using libcmis::PropertyPtrMap;
 using boost::dynamic_pointer_cast;
 
+namespace
+{
+    /** Stream buffer pulling the content from a libcmis_readFn one chunk
+        at a time, to upload it without holding it all in memory.
+
+        Seeking is lazy: the seekFn is only called when the next chunk
+        isn't read where the previous one ended, so that measuring the
+        length and rewinding to the start before the first read doesn't
+        need a seekable source.
+      */
+    class ReadFnStreamBuf : public streambuf
+    {
+        private:
+            libcmis_readFn m_readFn;
+            libcmis_seekFn m_seekFn;
+            void* m_userData;
+            long m_length;
+            vector< char > m_buffer;
+            const atomic< bool >& m_cancelled;
+
+            /// Position of the start of the buffer in the content
+            long m_bufferPos;
+
+            /// Position of the next byte the readFn will provide
+            long m_sourcePos;
+
+            string m_error;
+
+        public:
+            ReadFnStreamBuf( libcmis_readFn readFn, libcmis_seekFn seekFn, void* userData,
+                             long length, size_t chunkSize, const atomic< bool >& cancelled ) :
+                m_readFn( readFn ),
+                m_seekFn( seekFn ),
+                m_userData( userData ),
+                m_length( length ),
+                m_buffer( chunkSize > 0 ? chunkSize : 2048 ),
+                m_cancelled( cancelled ),
+                m_bufferPos( 0 ),
+                m_sourcePos( 0 ),
+                m_error( )
+            {
+                setg( &m_buffer[0], &m_buffer[0], &m_buffer[0] );
+            }
+
+            ReadFnStreamBuf( const ReadFnStreamBuf& copy ) = delete;
+            ReadFnStreamBuf& operator=( const ReadFnStreamBuf& copy ) = delete;
+
+            const string& getError( ) const { return m_error; }
+
+        protected:
+            virtual int_type underflow( )
+            {
+                if ( gptr( ) < egptr( ) )
+                    return traits_type::to_int_type( *gptr( ) );
+
+                // Throwing sets the badbit of the reading istream, which
+                // aborts the running transfer.
+                if ( m_cancelled )
+                    throw libcmis::Exception( "Content stream transfer cancelled" );
+
+                long pos = m_bufferPos + ( egptr( ) - eback( ) );
+                if ( pos != m_sourcePos )
+                {
+                    if ( m_seekFn == NULL || m_seekFn( m_userData, pos, SEEK_SET ) != 0 )
+                    {
+                        m_error = "Content stream can't be rewound";
+                        throw libcmis::Exception( m_error );
+                    }
+                    m_sourcePos = pos;
+                }
+
+                size_t read = m_readFn( &m_buffer[0], size_t( 1 ), m_buffer.size( ), m_userData );
+                m_bufferPos = pos;
+                m_sourcePos += read;
+                setg( &m_buffer[0], &m_buffer[0], &m_buffer[0] + read );
+
+                if ( read == 0 )
+                    return traits_type::eof( );
+                return traits_type::to_int_type( *gptr( ) );
+            }
+
+            virtual pos_type seekoff( off_type off, ios_base::seekdir dir,
+                                      ios_base::openmode which = ios_base::in | ios_base::out )
+            {
+                long base = 0;
+                if ( dir == ios_base::cur )
+                    base = m_bufferPos + ( gptr( ) - eback( ) );
+                else if ( dir == ios_base::end )
+                {
+                    if ( m_length < 0 )
+                        return pos_type( off_type( -1 ) );
+                    base = m_length;
+                }
+                return seekpos( pos_type( base + off ), which );
+            }
+
+            virtual pos_type seekpos( pos_type pos,
+                                      ios_base::openmode which = ios_base::in | ios_base::out )
+            {
+                long target = long( off_type( pos ) );
+                if ( !( which & ios_base::in ) || target < 0 || ( m_length >= 0 && target > m_length ) )
+                    return pos_type( off_type( -1 ) );
+
+                long bufferEnd = m_bufferPos + ( egptr( ) - eback( ) );
+                if ( target >= m_bufferPos && target <= bufferEnd )
+                    setg( eback( ), eback( ) + ( target - m_bufferPos ), egptr( ) );
+                else
+                {
+                    m_bufferPos = target;
+                    setg( &m_buffer[0], &m_buffer[0], &m_buffer[0] );
+                }
+                return pos;
+            }
+    };
+}
+
 void libcmis_vector_document_free( libcmis_vector_document_Ptr vector )
 {
     delete vector;
@@ -241,6 +357,197 @@ void libcmis_document_setContentStream(
 }
 
 
+libcmis_ContentStreamPtr libcmis_document_openContentStream(
+        libcmis_DocumentPtr document,
+        const char* streamId,
+        libcmis_ErrorPtr error )
+{
+    libcmis_ContentStreamPtr stream = NULL;
+    if ( document != NULL && document->handle.get( ) != NULL )
+    {
+        try
+        {
+            DocumentPtr doc = dynamic_pointer_cast< libcmis::Document >( document->handle );
+            if ( doc )
+            {
+                boost::shared_ptr< istream > handle = doc->getContentStream( createString( ( char* )streamId ) );
+                handle->seekg( 0 );
+
+                stream = new libcmis_content_stream( );
+                stream->handle = handle;
+            }
+        }
+        catch ( const libcmis::Exception& e )
+        {
+            if ( error != NULL )
+            {
+                error->message = strdup( e.what() );
+                error->type = strdup( e.getType().c_str() );
+            }
+        }
+        catch ( const bad_alloc& e )
+        {
+            if ( error != NULL )
+            {
+                error->message = strdup( e.what() );
+                error->badAlloc = true;
+            }
+        }
+        catch ( const exception& e )
+        {
+            if ( error != NULL )
+                error->message = strdup( e.what() );
+        }
+        catch ( ... )
+        {
+        }
+    }
+    return stream;
+}
+
+
+void libcmis_document_uploadContentStream(
+        libcmis_DocumentPtr document,
+        libcmis_ContentStreamPtr stream,
+        const char* contentType,
+        const char* fileName,
+        bool overwrite,
+        libcmis_ErrorPtr error )
+{
+    if ( document != NULL && document->handle.get( ) != NULL &&
+         stream != NULL && stream->source.get( ) != NULL )
+    {
+        try
+        {
+            if ( stream->cancelled )
+                throw libcmis::Exception( "Content stream transfer cancelled" );
+
+            boost::shared_ptr< std::ostream > os( new ostream( stream->source.get( ) ) );
+
+            DocumentPtr doc = dynamic_pointer_cast< libcmis::Document >( document->handle );
+            if ( doc )
+                doc->setContentStream( os, contentType, fileName, overwrite );
+
+            // The backends may not see a failed read as an error
+            ReadFnStreamBuf* source = dynamic_cast< ReadFnStreamBuf* >( stream->source.get( ) );
+            if ( stream->cancelled )
+                throw libcmis::Exception( "Content stream transfer cancelled" );
+            if ( source != NULL && !source->getError( ).empty( ) )
+                throw libcmis::Exception( source->getError( ) );
+        }
+        catch ( const libcmis::Exception& e )
+        {
+            if ( error != NULL )
+            {
+                error->message = strdup( e.what() );
+                error->type = strdup( e.getType().c_str() );
+            }
+        }
+        catch ( const bad_alloc& e )
+        {
+            if ( error != NULL )
+            {
+                error->message = strdup( e.what() );
+                error->badAlloc = true;
+            }
+        }
+        catch ( const exception& e )
+        {
+            if ( error != NULL )
+                error->message = strdup( e.what() );
+        }
+    }
+}
+
+
+libcmis_ContentStreamPtr libcmis_content_stream_create(
+        libcmis_readFn readFn,
+        libcmis_seekFn seekFn,
+        void* userData,
+        long length,
+        size_t chunkSize )
+{
+    libcmis_ContentStreamPtr stream = NULL;
+    if ( readFn != NULL )
+    {
+        stream = new libcmis_content_stream( );
+        stream->source.reset( new ReadFnStreamBuf( readFn, seekFn, userData,
+                    length, chunkSize, stream->cancelled ) );
+        stream->handle.reset( new istream( stream->source.get( ) ) );
+    }
+    return stream;
+}
+
+
+size_t libcmis_content_stream_read(
+        libcmis_ContentStreamPtr stream,
+        void* buffer,
+        size_t size,
+        libcmis_ErrorPtr error )
+{
+    size_t read = 0;
+    if ( stream != NULL && stream->handle.get( ) != NULL && buffer != NULL )
+    {
+        // Release the content as soon as the transfer is cancelled
+        if ( stream->cancelled )
+        {
+            stream->handle.reset( );
+            return 0;
+        }
+
+        try
+        {
+            stream->handle->read( ( char* )buffer, size );
+            read = stream->handle->gcount( );
+            if ( stream->handle->bad( ) && error != NULL )
+                error->message = strdup( "Failed to read the content stream" );
+        }
+        catch ( const bad_alloc& e )
+        {
+            if ( error != NULL )
+            {
+                error->message = strdup( e.what() );
+                error->badAlloc = true;
+            }
+        }
+        catch ( const exception& e )
+        {
+            if ( error != NULL )
+                error->message = strdup( e.what() );
+        }
+    }
+    return read;
+}
+
+
+bool libcmis_content_stream_isEof( libcmis_ContentStreamPtr stream )
+{
+    bool eof = true;
+    if ( stream != NULL && stream->handle.get( ) != NULL && !stream->cancelled )
+        eof = stream->handle->eof( );
+    return eof;
+}
+
+
+void libcmis_content_stream_cancel( libcmis_ContentStreamPtr stream )
+{
+    if ( stream != NULL )
+        stream->cancelled = true;
+}
+
+
+bool libcmis_content_stream_isCancelled( libcmis_ContentStreamPtr stream )
+{
+    return stream != NULL && stream->cancelled;
+}
+
+
+void libcmis_content_stream_close( libcmis_ContentStreamPtr stream )
+{
+    delete stream;
+}
+
+
 char* libcmis_document_getContentType( libcmis_DocumentPtr document )
 {
     char* value = NULL;
@@ -374,7 +681,7 @@ libcmis_DocumentPtr libcmis_document_checkIn(
                     for ( vector< libcmis::PropertyPtr >::iterator it = properties->handle.begin( );
                             it != properties->handle.end( ); ++it )
                     {
-                        string id = ( *it )->getPropertyType( )->getId( );
+                        string id = ( *it )->getPropertyTypeView( )->getId( );
                         propertiesMap.insert( pair< string, libcmis::PropertyPtr >( id, *it ) );
                     }
                 }
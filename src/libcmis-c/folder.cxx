@@ -223,7 +223,7 @@ libcmis_FolderPtr libcmis_folder_createFolder(
                         libcmis::PropertyPtr property = properties->handle[i];
                         if ( property.get( ) != NULL )
                         {
-                            string id = property->getPropertyType( )->getId( );
+                            string id = property->getPropertyTypeView( )->getId( );
                             mappedProperties.insert( pair< string, libcmis::PropertyPtr >( id, property ) );
                         }
                     }
@@ -292,7 +292,7 @@ libcmis_DocumentPtr libcmis_folder_createDocument(
                     for ( vector< libcmis::PropertyPtr >::iterator it = properties->handle.begin( );
                             it != properties->handle.end( ); ++it )
                     {
-                        string id = ( *it )->getPropertyType( )->getId( );
+                        string id = ( *it )->getPropertyTypeView( )->getId( );
                         propertiesMap.insert( pair< string, libcmis::PropertyPtr >( id, *it ) );
                     }
                 }
@@ -28,6 +28,9 @@
 #ifndef _LIBCMIS_INTERNALS_H_
 #define _LIBCMIS_INTERNALS_H_
 
+#include <atomic>
+#include <istream>
+#include <streambuf>
 #include <vector>
 
 #include <libcmis/allowable-actions.hxx>
@@ -134,6 +137,15 @@ struct libcmis_document : public libcmis_object
     libcmis_document( ) : libcmis_object( ) { }
 };
 
+struct libcmis_content_stream
+{
+    boost::shared_ptr< std::streambuf > source;
+    boost::shared_ptr< std::istream > handle;
+    std::atomic< bool > cancelled;
+
+    libcmis_content_stream( ) : source( ), handle( ), cancelled( false ) { }
+};
+
 struct libcmis_oauth2data
 {
     libcmis::OAuth2DataPtr handle;
@@ -55,7 +55,7 @@ namespace
                     it != properties->handle.end( ); ++it )
             {
                 libcmis::PropertyPtr propHandle = *it;
-                propertiesMap[ propHandle->getPropertyType()->getId( ) ] = propHandle;
+                propertiesMap[ propHandle->getPropertyTypeView( )->getId( ) ] = propHandle;
             }
         }
         return propertiesMap;
@@ -36,6 +36,7 @@
 
 #include <libcmis/xml-utils.hxx>
 
+#include "atom-feed-reader.hxx"
 #include "atom-session.hxx"
 
 using namespace std;
@@ -54,9 +55,7 @@ AtomDocument::AtomDocument( AtomPubSession* session, xmlNodePtr entryNd ) :
     AtomObject( session ),
     m_contentUrl( )
 {
-    xmlDocPtr doc = libcmis::wrapInDoc( entryNd );
-    refreshImpl( doc );
-    xmlFreeDoc( doc );
+    refreshImpl( entryNd );
 }
 
 AtomDocument::~AtomDocument( )
@@ -73,52 +72,25 @@ vector< libcmis::FolderPtr > AtomDocument::getParents( )
 
     vector< libcmis::FolderPtr > parents;
     
-    string buf;
+    libcmis::HttpResponsePtr response;
     try
     {
-        buf = getSession()->httpGetRequest( parentsLink->getHref( ) )->getStream( )->str( );
+        response = getSession()->httpGetRequest( parentsLink->getHref( ) );
     }
     catch ( const CurlException& e )
     {
         throw e.getCmisException( );
     }
 
-    xmlDocPtr doc = xmlReadMemory( buf.c_str(), buf.size(), parentsLink->getHref( ).c_str(), NULL, 0 );
-    if ( NULL != doc )
+    AtomFeedReader feed( response->getBody( ), parentsLink->getHref( ) );
+    for ( xmlNodePtr node = feed.nextEntry( ); node != NULL; node = feed.nextEntry( ) )
     {
-        xmlXPathContextPtr xpathCtx = xmlXPathNewContext( doc );
-        libcmis::registerNamespaces( xpathCtx );
-        if ( NULL != xpathCtx )
-        {
-            const string& entriesReq( "//atom:entry" );
-            xmlXPathObjectPtr xpathObj = xmlXPathEvalExpression( BAD_CAST( entriesReq.c_str() ), xpathCtx );
-
-            if ( NULL != xpathObj && NULL != xpathObj->nodesetval )
-            {
-                int size = xpathObj->nodesetval->nodeNr;
-                for ( int i = 0; i < size; i++ )
-                {
-                    xmlNodePtr node = xpathObj->nodesetval->nodeTab[i];
-                    xmlDocPtr entryDoc = libcmis::wrapInDoc( node );
-                    libcmis::ObjectPtr object = getSession()->createObjectFromEntryDoc( entryDoc );
-                    libcmis::FolderPtr folder = boost::dynamic_pointer_cast< libcmis::Folder >( object );
-
-                    if ( folder.get() )
-                        parents.push_back( folder );
-                    xmlFreeDoc( entryDoc );
-                }
-            }
+        libcmis::ObjectPtr object = getSession()->createObjectFromEntry( node );
+        libcmis::FolderPtr folder = boost::dynamic_pointer_cast< libcmis::Folder >( object );
 
-            xmlXPathFreeObject( xpathObj );
-        }
-
-        xmlXPathFreeContext( xpathCtx );
-    }
-    else
-    {
-        throw libcmis::Exception( "Failed to parse folder infos" );
+        if ( folder.get() )
+            parents.push_back( folder );
     }
-    xmlFreeDoc( doc );
 
     return parents;
 }
@@ -141,6 +113,11 @@ boost::shared_ptr< istream > AtomDocument::getContentStream( string /*streamId*/
     return stream;
 }
 
+string AtomDocument::getContentUrl( )
+{
+    return m_contentUrl;
+}
+
 void AtomDocument::setContentStream( boost::shared_ptr< ostream > os, string contentType, string fileName, bool overwrite )
 {
     if ( !os.get( ) )
@@ -269,20 +246,19 @@ libcmis::DocumentPtr AtomDocument::checkOut( )
 
     try
     {
-        resp = getSession( )->httpPostRequest( checkedOutUrl, is, "application/atom+xml;type=entry" );
+        resp = getSession( )->httpPostRequest( checkedOutUrl, is, "application/atom+xml;type=entry",
+                                               true, XmlContentHandler::getInstance( ) );
     }
     catch ( const CurlException& e )
     {
         throw e.getCmisException( );
     }
 
-    string respBuf = resp->getStream( )->str();
-    xmlDocPtr doc = xmlReadMemory( respBuf.c_str(), respBuf.size(), checkedOutUrl.c_str(), NULL, 0 );
+    xmlDocPtr doc = resp->getXmlDoc( );
     if ( NULL == doc )
         throw libcmis::Exception( "Failed to parse object infos" );
 
     libcmis::ObjectPtr created = getSession( )->createObjectFromEntryDoc( doc, AtomPubSession::RESULT_DOCUMENT );
-    xmlFreeDoc( doc );
 
     libcmis::DocumentPtr pwc = boost::dynamic_pointer_cast< libcmis::Document >( created );
     if ( !pwc.get( ) )
@@ -364,7 +340,7 @@ libcmis::DocumentPtr AtomDocument::checkIn( bool isMajor, string comment,
     {
         vector< string > headers;
         headers.push_back( string( "Content-Type: application/atom+xml;type=entry" ) );
-        response = getSession( )->httpPutRequest( checkInUrl, is, headers );
+        response = getSession( )->httpPutRequest( checkInUrl, is, headers, XmlContentHandler::getInstance( ) );
     }
     catch ( const CurlException& e )
     {
@@ -372,8 +348,7 @@ libcmis::DocumentPtr AtomDocument::checkIn( bool isMajor, string comment,
     }
     
     // Get the returned entry and update using it
-    string respBuf = response->getStream( )->str( );
-    xmlDocPtr doc = xmlReadMemory( respBuf.c_str(), respBuf.size(), checkInUrl.c_str(), NULL, 0 );
+    xmlDocPtr doc = response->getXmlDoc( );
     if ( NULL == doc )
         throw libcmis::Exception( "Failed to parse object infos" );
 
@@ -381,8 +356,7 @@ libcmis::DocumentPtr AtomDocument::checkIn( bool isMajor, string comment,
     libcmis::ObjectPtr newVersion = getSession( )->createObjectFromEntryDoc( doc, AtomPubSession::RESULT_DOCUMENT );
 
     if ( newVersion->getId( ) == getId( ) )
-        refreshImpl( doc );
-    xmlFreeDoc( doc );
+        refreshImpl( xmlDocGetRootElement( doc ) );
 
     return boost::dynamic_pointer_cast< libcmis::Document >( newVersion );
 }
@@ -399,80 +373,42 @@ vector< libcmis::DocumentPtr > AtomDocument::getAllVersions( )
     {
         string pageUrl = link->getHref( );
 
-        string buf;
+        libcmis::HttpResponsePtr response;
         try
         {
-            buf = getSession()->httpGetRequest( pageUrl )->getStream( )->str( );
+            response = getSession()->httpGetRequest( pageUrl );
         }
         catch ( const CurlException& e )
         {
             throw e.getCmisException( );
         }
 
-        xmlDocPtr doc = xmlReadMemory( buf.c_str(), buf.size(), pageUrl.c_str(), NULL, 0 );
-        if ( NULL != doc )
+        AtomFeedReader feed( response->getBody( ), pageUrl );
+        for ( xmlNodePtr node = feed.nextEntry( ); node != NULL; node = feed.nextEntry( ) )
         {
-            xmlXPathContextPtr xpathCtx = xmlXPathNewContext( doc );
-            libcmis::registerNamespaces( xpathCtx );
-            if ( NULL != xpathCtx )
-            {
-                // Get the entries
-                const string& entriesReq( "//atom:entry" );
-                xmlXPathObjectPtr xpathObj = xmlXPathEvalExpression( BAD_CAST( entriesReq.c_str() ), xpathCtx );
-
-                if ( NULL != xpathObj && NULL != xpathObj->nodesetval )
-                {
-                    int size = xpathObj->nodesetval->nodeNr;
-                    for ( int i = 0; i < size; i++ )
-                    {
-                        xmlNodePtr node = xpathObj->nodesetval->nodeTab[i];
-                        xmlDocPtr entryDoc = libcmis::wrapInDoc( node );
-                        libcmis::ObjectPtr cmisObject = getSession()->createObjectFromEntryDoc( entryDoc );
-                        libcmis::DocumentPtr cmisDoc = boost::dynamic_pointer_cast< libcmis::Document >( cmisObject );
-
-                        if ( cmisDoc.get() )
-                            versions.push_back( cmisDoc );
-                        xmlFreeDoc( entryDoc );
-                    }
-                }
-
-                xmlXPathFreeObject( xpathObj );
-            }
+            libcmis::ObjectPtr cmisObject = getSession()->createObjectFromEntry( node );
+            libcmis::DocumentPtr cmisDoc = boost::dynamic_pointer_cast< libcmis::Document >( cmisObject );
 
-            xmlXPathFreeContext( xpathCtx );
+            if ( cmisDoc.get() )
+                versions.push_back( cmisDoc );
         }
-        else
-        {
-            throw libcmis::Exception( "Failed to parse versions infos" );
-        }
-        xmlFreeDoc( doc );
 
     }
     return versions;
 }
 
-void AtomDocument::extractInfos( xmlDocPtr doc )
+void AtomDocument::extractInfos( xmlNodePtr entryNd )
 {
-    AtomObject::extractInfos( doc );
-   
-   // Get the content url 
-    xmlXPathContextPtr xpathCtx = xmlXPathNewContext( doc );
-    if ( NULL != doc )
-    {
-        libcmis::registerNamespaces( xpathCtx );
+    AtomObject::extractInfos( entryNd );
 
-        if ( NULL != xpathCtx )
+    // Get the content url
+    m_contentUrl.clear( );
+    for ( xmlNodePtr node = entryNd ? entryNd->children : NULL; node; node = node->next )
+    {
+        if ( libcmis::isXmlElement( node, NS_ATOM_URL, "content" ) )
         {
-            xmlXPathObjectPtr xpathObj = xmlXPathEvalExpression( BAD_CAST( "//atom:content" ), xpathCtx );
-            if ( xpathObj && xpathObj->nodesetval && xpathObj->nodesetval->nodeNr > 0 )
-            {
-                xmlNodePtr contentNd = xpathObj->nodesetval->nodeTab[0];
-                xmlChar* src = xmlGetProp( contentNd, BAD_CAST( "src" ) );
-                m_contentUrl = string( ( char* ) src );
-                xmlFree( src );
-            }
-            xmlXPathFreeObject( xpathObj );
+            m_contentUrl = libcmis::getXmlNodeAttributeValue( node, "src", "" );
+            break;
         }
-        xmlXPathFreeContext( xpathCtx );
     }
 }
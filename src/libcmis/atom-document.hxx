@@ -47,6 +47,8 @@ class AtomDocument : public libcmis::Document, public AtomObject
 
         virtual boost::shared_ptr< std::istream > getContentStream( std::string streamId = std::string( ) );
 
+        virtual std::string getContentUrl( );
+
         virtual void setContentStream( boost::shared_ptr< std::ostream > os, std::string contentType,
                                        std::string fileName, bool overwrite = true );
         
@@ -60,7 +62,7 @@ class AtomDocument : public libcmis::Document, public AtomObject
         virtual std::vector< libcmis::DocumentPtr > getAllVersions( );
     
     protected:
-        virtual void extractInfos( xmlDocPtr doc );
+        virtual void extractInfos( xmlNodePtr entryNd );
 };
 
 #endif
@@ -0,0 +1,94 @@
+/* libcmis
+ * Version: MPL 1.1 / GPLv2+ / LGPLv2+
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License or as specified alternatively below. You may obtain a copy of
+ * the License at http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * Major Contributor(s):
+ *
+ *
+ * All Rights Reserved.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPLv2+"), or
+ * the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+ * in which case the provisions of the GPLv2+ or the LGPLv2+ are applicable
+ * instead of those above.
+ */
+
+#include "atom-feed-reader.hxx"
+
+#include <libcmis/xml-utils.hxx>
+
+using namespace std;
+
+AtomFeedReader::AtomFeedReader( const string& buf, const string& url ) :
+    m_reader( xmlReaderForMemory( buf.c_str( ), buf.size( ), url.c_str( ), NULL, 0 ) ),
+    m_entry( NULL ),
+    m_nextHref( )
+{
+    if ( NULL == m_reader )
+        throw libcmis::Exception( "Failed to parse feed" );
+}
+
+AtomFeedReader::~AtomFeedReader( )
+{
+    xmlFreeTextReader( m_reader );
+}
+
+xmlNodePtr AtomFeedReader::nextEntry( )
+{
+    // Skip the subtree of the previous entry, the reader frees it
+    int ret = m_entry != NULL ? xmlTextReaderNext( m_reader ) : xmlTextReaderRead( m_reader );
+    m_entry = NULL;
+
+    while ( ret == 1 )
+    {
+        int depth = xmlTextReaderDepth( m_reader );
+        if ( xmlTextReaderNodeType( m_reader ) != XML_READER_TYPE_ELEMENT || depth == 0 )
+        {
+            ret = xmlTextReaderRead( m_reader );
+            continue;
+        }
+
+        bool isAtom = xmlStrEqual( xmlTextReaderConstNamespaceUri( m_reader ), BAD_CAST( NS_ATOM_URL ) );
+        const xmlChar* name = xmlTextReaderConstLocalName( m_reader );
+        if ( isAtom && xmlStrEqual( name, BAD_CAST( "entry" ) ) )
+        {
+            m_entry = xmlTextReaderExpand( m_reader );
+            if ( NULL == m_entry )
+                break;
+            return m_entry;
+        }
+
+        if ( isAtom && xmlStrEqual( name, BAD_CAST( "link" ) ) )
+        {
+            xmlChar* rel = xmlTextReaderGetAttribute( m_reader, BAD_CAST( "rel" ) );
+            if ( NULL != rel && xmlStrEqual( rel, BAD_CAST( "next" ) ) )
+            {
+                xmlChar* href = xmlTextReaderGetAttribute( m_reader, BAD_CAST( "href" ) );
+                if ( NULL != href )
+                    m_nextHref = string( ( char* )href );
+                xmlFree( href );
+            }
+            xmlFree( rel );
+        }
+
+        // Don't go down in the other elements of the feed
+        ret = xmlTextReaderNext( m_reader );
+    }
+
+    if ( ret != 0 )
+        throw libcmis::Exception( "Failed to parse feed" );
+
+    return NULL;
+}
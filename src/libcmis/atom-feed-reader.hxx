@@ -0,0 +1,72 @@
+/* libcmis
+ * Version: MPL 1.1 / GPLv2+ / LGPLv2+
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License or as specified alternatively below. You may obtain a copy of
+ * the License at http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * Major Contributor(s):
+ *
+ *
+ * All Rights Reserved.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPLv2+"), or
+ * the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+ * in which case the provisions of the GPLv2+ or the LGPLv2+ are applicable
+ * instead of those above.
+ */
+#ifndef _ATOM_FEED_READER_HXX_
+#define _ATOM_FEED_READER_HXX_
+
+#include <string>
+
+#include <libxml/xmlreader.h>
+
+/** Streaming reader for the entries of an Atom feed.
+
+    The feed is read with an xmlTextReader: only the current top-level entry
+    is expanded in memory, the previous ones are freed when moving to the
+    next entry.
+  */
+class AtomFeedReader
+{
+    private:
+        xmlTextReaderPtr m_reader;
+        xmlNodePtr m_entry;
+        std::string m_nextHref;
+
+    public:
+        AtomFeedReader( const std::string& buf, const std::string& url );
+        ~AtomFeedReader( );
+
+        /** Move to the next top-level entry of the feed.
+
+            \return
+                the entry node or NULL at the end of the feed. The node and
+                its document are only valid until the next call.
+
+            \throw libcmis::Exception
+                if the feed can't be parsed.
+          */
+        xmlNodePtr nextEntry( );
+
+        /** Get the URL of the next page of the feed. The whole feed needs to be
+            read before as the link may be after the entries.
+          */
+        std::string getNextHref( ) { return m_nextHref; }
+
+    private:
+        AtomFeedReader( const AtomFeedReader& copy );
+        AtomFeedReader& operator=( const AtomFeedReader& copy );
+};
+
+#endif
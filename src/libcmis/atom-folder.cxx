@@ -32,9 +32,12 @@
 
 #include <boost/shared_ptr.hpp>
 
+#include <libxml/xpath.h>
+
 #include <libcmis/xml-utils.hxx>
 
 #include "atom-document.hxx"
+#include "atom-feed-reader.hxx"
 #include "atom-session.hxx"
 
 using namespace std;
@@ -42,15 +45,44 @@ using libcmis::PropertyPtrMap;
 
 namespace
 {
+    /** Get the ids of all the objects of a descendants or folder tree feed.
+      */
+    vector< string > lcl_getTreeObjectIds( const string& buf, const string& url )
+    {
+        vector< string > ids;
+        xmlDocPtr doc = xmlReadMemory( buf.c_str(), buf.size(), url.c_str(), NULL, 0 );
+        if ( NULL == doc )
+            throw libcmis::Exception( "Failed to parse folder tree" );
+
+        {
+            libcmis::XPathContext xpathCtx( doc );
+            const string req( "//cmisra:object//cmis:propertyId[@propertyDefinitionId='cmis:objectId']/cmis:value" );
+            xmlXPathObjectPtr xpathObj = xpathCtx.eval( req );
+            if ( NULL != xpathObj && NULL != xpathObj->nodesetval )
+            {
+                for ( int i = 0; i < xpathObj->nodesetval->nodeNr; i++ )
+                {
+                    xmlChar* content = xmlNodeGetContent( xpathObj->nodesetval->nodeTab[i] );
+                    if ( content != NULL )
+                    {
+                        ids.push_back( string( ( char* )content ) );
+                        xmlFree( content );
+                    }
+                }
+            }
+            xmlXPathFreeObject( xpathObj );
+        }
+        xmlFreeDoc( doc );
+
+        return ids;
+    }
 }
 
 AtomFolder::AtomFolder( AtomPubSession* session, xmlNodePtr entryNd ) :
     libcmis::Object( session ),
     AtomObject( session )
 {
-    xmlDocPtr doc = libcmis::wrapInDoc( entryNd );
-    refreshImpl( doc );
-    xmlFreeDoc( doc );
+    refreshImpl( entryNd );
 }
 
 
@@ -76,59 +108,29 @@ vector< libcmis::ObjectPtr > AtomFolder::getChildren( )
     bool hasNext = true;
     while ( hasNext )
     {
-        string buf;
+        libcmis::HttpResponsePtr response;
         try
         {
-            buf = getSession()->httpGetRequest( pageUrl )->getStream( )->str( );
+            response = getSession()->httpGetRequest( pageUrl );
         }
         catch ( const CurlException& e )
         {
             throw e.getCmisException( );
         }
 
-        xmlDocPtr doc = xmlReadMemory( buf.c_str(), buf.size(), pageUrl.c_str(), NULL, 0 );
-        if ( NULL != doc )
+        AtomFeedReader feed( response->getBody( ), pageUrl );
+        for ( xmlNodePtr node = feed.nextEntry( ); node != NULL; node = feed.nextEntry( ) )
         {
-            xmlXPathContextPtr xpathCtx = xmlXPathNewContext( doc );
-            libcmis::registerNamespaces( xpathCtx );
-            if ( NULL != xpathCtx )
-            {
-                // Check if there is a next link to handled paged results
-                const string& nextReq( "/atom:feed/atom:link[@rel='next']/attribute::href" );
-                string nextHref = libcmis::getXPathValue( xpathCtx, nextReq );
-                hasNext = !nextHref.empty( );
-                if ( hasNext )
-                    pageUrl = nextHref;
-
-                // Get the page entries
-                const string& entriesReq( "//atom:entry" );
-                xmlXPathObjectPtr xpathObj = xmlXPathEvalExpression( BAD_CAST( entriesReq.c_str() ), xpathCtx );
-
-                if ( NULL != xpathObj && NULL != xpathObj->nodesetval )
-                {
-                    int size = xpathObj->nodesetval->nodeNr;
-                    for ( int i = 0; i < size; i++ )
-                    {
-                        xmlNodePtr node = xpathObj->nodesetval->nodeTab[i];
-                        xmlDocPtr entryDoc = libcmis::wrapInDoc( node );
-                        libcmis::ObjectPtr cmisObject = getSession()->createObjectFromEntryDoc( entryDoc );
-
-                        if ( cmisObject.get() )
-                            children.push_back( cmisObject );
-                        xmlFreeDoc( entryDoc );
-                    }
-                }
-
-                xmlXPathFreeObject( xpathObj );
-            }
-
-            xmlXPathFreeContext( xpathCtx );
-        }
-        else
-        {
-            throw libcmis::Exception( "Failed to parse folder infos" );
+            libcmis::ObjectPtr cmisObject = getSession()->createObjectFromEntry( node );
+            if ( cmisObject.get() )
+                children.push_back( cmisObject );
         }
-        xmlFreeDoc( doc );
+
+        // Check if there is a next link to handled paged results
+        string nextHref = feed.getNextHref( );
+        hasNext = !nextHref.empty( );
+        if ( hasNext )
+            pageUrl = nextHref;
     }
 
     return children;
@@ -161,7 +163,8 @@ libcmis::FolderPtr AtomFolder::createFolder( const PropertyPtrMap& properties )
     libcmis::HttpResponsePtr response;
     try
     {
-        response = getSession( )->httpPostRequest( childrenLink->getHref( ), is, "application/atom+xml;type=entry" );
+        response = getSession( )->httpPostRequest( childrenLink->getHref( ), is, "application/atom+xml;type=entry",
+                                                   true, XmlContentHandler::getInstance( ) );
     }
     catch ( const CurlException& e )
     {
@@ -172,13 +175,11 @@ libcmis::FolderPtr AtomFolder::createFolder( const PropertyPtrMap& properties )
         throw e.getCmisException( );
     }
 
-    string respBuf = response->getStream( )->str( );
-    xmlDocPtr doc = xmlReadMemory( respBuf.c_str(), respBuf.size(), getInfosUrl().c_str(), NULL, 0 );
+    xmlDocPtr doc = response->getXmlDoc( );
     if ( NULL == doc )
         throw libcmis::Exception( "Failed to parse object infos" );
 
     libcmis::ObjectPtr created = getSession( )->createObjectFromEntryDoc( doc, AtomPubSession::RESULT_FOLDER );
-    xmlFreeDoc( doc );
 
     libcmis::FolderPtr newFolder = boost::dynamic_pointer_cast< libcmis::Folder >( created );
     if ( !newFolder.get( ) )
@@ -211,16 +212,16 @@ libcmis::DocumentPtr AtomFolder::createDocument( const PropertyPtrMap& propertie
     libcmis::HttpResponsePtr response;
     try
     {
-        response = getSession( )->httpPostRequest( childrenLink->getHref( ), ss, "application/atom+xml;type=entry" );
+        response = getSession( )->httpPostRequest( childrenLink->getHref( ), ss, "application/atom+xml;type=entry",
+                                                   true, XmlContentHandler::getInstance( ) );
     }
     catch ( const CurlException& e )
     {
         throw e.getCmisException( );
     }
 
-    string respBuf = response->getStream( )->str( );
-    boost::shared_ptr< xmlDoc > doc( xmlReadMemory( respBuf.c_str(), respBuf.size(), getInfosUrl().c_str(), NULL, XML_PARSE_NOERROR ), xmlFreeDoc );
-    if ( !doc )
+    xmlDocPtr doc = response->getXmlDoc( );
+    if ( NULL == doc )
     {
         // We may not have the created document entry in the response body: this is
         // the behaviour of some servers, but the standard says we need to look for
@@ -236,9 +237,8 @@ libcmis::DocumentPtr AtomFolder::createDocument( const PropertyPtrMap& propertie
         {
             try
             {
-                response = getSession( )->httpGetRequest( it->second );
-                respBuf = response->getStream( )->str( );
-                doc.reset( xmlReadMemory( respBuf.c_str(), respBuf.size(), getInfosUrl().c_str(), NULL, XML_PARSE_NOERROR ), xmlFreeDoc );
+                response = getSession( )->httpGetRequest( it->second, XmlContentHandler::getInstance( ) );
+                doc = response->getXmlDoc( );
             }
             catch ( const CurlException& e )
             {
@@ -247,11 +247,11 @@ libcmis::DocumentPtr AtomFolder::createDocument( const PropertyPtrMap& propertie
         }
 
         // if doc is still NULL after that, then throw an exception
-        if ( !doc )
+        if ( NULL == doc )
             throw libcmis::Exception( "Missing expected response from server" );
     }
 
-    libcmis::ObjectPtr created = getSession( )->createObjectFromEntryDoc( doc.get(), AtomPubSession::RESULT_DOCUMENT );
+    libcmis::ObjectPtr created = getSession( )->createObjectFromEntryDoc( doc, AtomPubSession::RESULT_DOCUMENT );
 
     libcmis::DocumentPtr newDocument = boost::dynamic_pointer_cast< libcmis::Document >( created );
     if ( !newDocument.get( ) )
@@ -313,9 +313,32 @@ vector< string > AtomFolder::removeTree( bool allVersions, libcmis::UnfileObject
     }
     catch ( const CurlException& e )
     {
-        throw e.getCmisException( );
+        if ( e.getErrorCode( ) != CURLE_HTTP_RETURNED_ERROR || e.getHttpStatus( ) != 500 )
+            throw e.getCmisException( );
+
+        // Some objects couldn't be deleted, but the server doesn't tell which ones:
+        // they are the ones remaining in the tree.
+        string treeUrl = treeLink->getHref( );
+        if ( treeUrl.find( '?' ) != string::npos )
+            treeUrl += "&depth=-1";
+        else
+            treeUrl += "?depth=-1";
+
+        vector< string > failed;
+        try
+        {
+            string buf = getSession( )->httpGetRequest( treeUrl )->getBody( );
+            failed = lcl_getTreeObjectIds( buf, treeUrl );
+        }
+        catch ( const CurlException& )
+        {
+            throw e.getCmisException( );
+        }
+
+        // The folder itself is still there
+        failed.push_back( getId( ) );
+        return failed;
     }
 
-    // TODO Implement getting the failedIDs using a GET request on the same URL
     return vector< string >( );
 }
@@ -52,9 +52,7 @@ AtomObjectType::AtomObjectType( AtomPubSession* session, xmlNodePtr entryNd ) :
     m_selfUrl( ),
     m_childrenUrl( )
 {
-    xmlDocPtr doc = libcmis::wrapInDoc( entryNd );
-    refreshImpl( doc );
-    xmlFreeDoc( doc );
+    refreshImpl( entryNd );
 }
 
 AtomObjectType::AtomObjectType( const AtomObjectType& copy ) :
@@ -97,20 +95,20 @@ vector< libcmis::ObjectTypePtr > AtomObjectType::getChildren( )
     return m_session->getChildrenTypes( m_childrenUrl );
 }
 
-void AtomObjectType::refreshImpl( xmlDocPtr doc )
+void AtomObjectType::refreshImpl( xmlNodePtr entryNd )
 {
-    bool createdDoc = ( NULL == doc );
-    if ( createdDoc )
+    // Keeps the fetched document alive while reading it
+    libcmis::HttpResponsePtr response;
+    if ( NULL == entryNd )
     {
         string pattern = m_session->getAtomRepository()->getUriTemplate( UriTemplate::TypeById );
         map< string, string > vars;
         vars[URI_TEMPLATE_VAR_ID] = getId( );
         string url = m_session->createUrl( pattern, vars );
 
-        string buf;
         try
         {
-            buf  = m_session->httpGetRequest( url )->getStream()->str();
+            response = m_session->httpGetRequest( url, XmlContentHandler::getInstance( ) );
         }
         catch ( const CurlException& e )
         {
@@ -125,43 +123,39 @@ void AtomObjectType::refreshImpl( xmlDocPtr doc )
                 throw e.getCmisException( );
         }
 
-        doc = xmlReadMemory( buf.c_str(), buf.size(), m_selfUrl.c_str(), NULL, 0 );
-
+        xmlDocPtr doc = response->getXmlDoc( );
         if ( NULL == doc )
             throw libcmis::Exception( "Failed to parse object infos" );
+
+        entryNd = xmlDocGetRootElement( doc );
     }
 
-    extractInfos( doc );
-    
-    if ( createdDoc )
-        xmlFreeDoc( doc );
+    extractInfos( entryNd );
 }
 
-void AtomObjectType::extractInfos( xmlDocPtr doc )
+void AtomObjectType::extractInfos( xmlNodePtr entryNd )
 {
-    xmlXPathContextPtr xpathCtx = xmlXPathNewContext( doc );
+    if ( NULL == entryNd )
+        return;
+
+    // The expressions are relative to the entry: it may be one of the
+    // entries of a feed
+    libcmis::XPathContext xpathCtx( entryNd->doc, entryNd );
 
-    // Register the Service Document namespaces
-    libcmis::registerNamespaces( xpathCtx );
+    // Get the self URL
+    string selfUrlReq( ".//atom:link[@rel='self']/attribute::href" );
+    m_selfUrl = xpathCtx.getValue( selfUrlReq );
 
-    if ( NULL != xpathCtx )
+    // Get the children URL
+    string childrenUrlReq( ".//atom:link[@rel='down' and @type='application/atom+xml;type=feed']/attribute::href" );
+    m_childrenUrl = xpathCtx.getValue( childrenUrlReq );
+
+    // Get the cmisra:type node
+    xmlXPathObjectPtr xpathObj = xpathCtx.eval( ".//cmisra:type" );
+    if ( NULL != xpathObj && NULL != xpathObj->nodesetval && xpathObj->nodesetval->nodeNr )
     {
-        // Get the self URL
-        string selfUrlReq( "//atom:link[@rel='self']/attribute::href" );
-        m_selfUrl = libcmis::getXPathValue( xpathCtx, selfUrlReq );
-        
-        // Get the children URL
-        string childrenUrlReq( "//atom:link[@rel='down' and @type='application/atom+xml;type=feed']/attribute::href" );
-        m_childrenUrl = libcmis::getXPathValue( xpathCtx, childrenUrlReq );
-        
-        // Get the cmisra:type node
-        xmlXPathObjectPtr xpathObj = xmlXPathEvalExpression( BAD_CAST( "//cmisra:type" ), xpathCtx );
-        if ( NULL != xpathObj && NULL != xpathObj->nodesetval && xpathObj->nodesetval->nodeNr )
-        {
-            xmlNodePtr typeNode = xpathObj->nodesetval->nodeTab[0];
-            initializeFromNode( typeNode );
-        }
-        xmlXPathFreeObject( xpathObj );
+        xmlNodePtr typeNode = xpathObj->nodesetval->nodeTab[0];
+        initializeFromNode( typeNode );
     }
-    xmlXPathFreeContext( xpathCtx );
+    xmlXPathFreeObject( xpathObj );
 }
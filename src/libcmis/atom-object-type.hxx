@@ -56,8 +56,8 @@ class AtomObjectType : public libcmis::ObjectType
 
     private:
 
-        void refreshImpl( xmlDocPtr doc );
-        void extractInfos( xmlDocPtr doc );
+        void refreshImpl( xmlNodePtr entryNd );
+        void extractInfos( xmlNodePtr entryNd );
 };
 
 #endif
@@ -141,22 +141,20 @@ libcmis::ObjectPtr AtomObject::updateProperties( const PropertyPtrMap& propertie
     {
         vector< string > headers;
         headers.push_back( "Content-Type: application/atom+xml;type=entry" );
-        response = getSession( )->httpPutRequest( getInfosUrl( ), is, headers );
+        response = getSession( )->httpPutRequest( getInfosUrl( ), is, headers, XmlContentHandler::getInstance( ) );
     }
     catch ( const CurlException& e )
     {
         throw e.getCmisException( );
     }
 
-    string respBuf = response->getStream( )->str( );
-    xmlDocPtr doc = xmlReadMemory( respBuf.c_str(), respBuf.size(), getInfosUrl().c_str(), NULL, 0 );
+    xmlDocPtr doc = response->getXmlDoc( );
     if ( NULL == doc )
         throw libcmis::Exception( "Failed to parse object infos" );
 
     libcmis::ObjectPtr updated = getSession( )->createObjectFromEntryDoc( doc );
     if ( updated->getId( ) == getId( ) )
-        refreshImpl( doc );
-    xmlFreeDoc( doc );
+        refreshImpl( xmlDocGetRootElement( doc ) );
 
     return updated;
 }
@@ -171,14 +169,11 @@ libcmis::AllowableActionsPtr AtomObject::getAllowableActions( )
         {
             try
             {
-                libcmis::HttpResponsePtr response = getSession()->httpGetRequest( link->getHref() );
-                string buf = response->getStream()->str();
-                xmlDocPtr doc = xmlReadMemory( buf.c_str(), buf.size(), link->getHref().c_str(), NULL, 0 );
+                libcmis::HttpResponsePtr response = getSession()->httpGetRequest( link->getHref(), XmlContentHandler::getInstance( ) );
+                xmlDocPtr doc = response->getXmlDoc( );
                 xmlNodePtr actionsNode = xmlDocGetRootElement( doc );
                 if ( actionsNode )
                     m_allowableActions.reset( new libcmis::AllowableActions( actionsNode ) );
-
-                xmlFreeDoc( doc );
             }
             catch ( CurlException& )
             {
@@ -189,39 +184,36 @@ libcmis::AllowableActionsPtr AtomObject::getAllowableActions( )
     return libcmis::Object::getAllowableActions();
 }
 
-void AtomObject::refreshImpl( xmlDocPtr doc )
+void AtomObject::refreshImpl( xmlNodePtr entryNd )
 {
-    bool createdDoc = ( NULL == doc );
-    if ( createdDoc )
+    // Keeps the fetched document alive while reading it
+    libcmis::HttpResponsePtr response;
+    if ( NULL == entryNd )
     {
-        string buf;
         try
         {
-            buf  = getSession()->httpGetRequest( getInfosUrl() )->getStream( )->str( );
+            response = getSession()->httpGetRequest( getInfosUrl(), XmlContentHandler::getInstance( ) );
         }
         catch ( const CurlException& e )
         {
             throw e.getCmisException( );
         }
 
-        doc = xmlReadMemory( buf.c_str(), buf.size(), getInfosUrl().c_str(), NULL, 0 );
-
+        xmlDocPtr doc = response->getXmlDoc( );
         if ( NULL == doc )
             throw libcmis::Exception( "Failed to parse object infos" );
 
+        entryNd = xmlDocGetRootElement( doc );
     }
 
     // Cleanup the structures before setting them again
     m_typeDescription.reset( );
-    m_properties.clear( );
+    clearProperties( );
     m_allowableActions.reset( );
     m_links.clear( );
     m_renditions.clear( );
 
-    extractInfos( doc );
-
-    if ( createdDoc )
-        xmlFreeDoc( doc );
+    extractInfos( entryNd );
 }
 
 void AtomObject::remove( bool allVersions )
@@ -293,7 +285,8 @@ void AtomObject::move( boost::shared_ptr< libcmis::Folder > source, boost::share
     libcmis::HttpResponsePtr response;
     try
     {
-        response = getSession( )->httpPostRequest( postUrl, is, "application/atom+xml;type=entry" );
+        response = getSession( )->httpPostRequest( postUrl, is, "application/atom+xml;type=entry",
+                                                   true, XmlContentHandler::getInstance( ) );
     }
     catch ( const CurlException& e )
     {
@@ -301,12 +294,10 @@ void AtomObject::move( boost::shared_ptr< libcmis::Folder > source, boost::share
     }
 
     // refresh self from response
-    string respBuf = response->getStream( )->str( );
-    xmlDocPtr doc = xmlReadMemory( respBuf.c_str(), respBuf.size(), getInfosUrl().c_str(), NULL, 0 );
+    xmlDocPtr doc = response->getXmlDoc( );
     if ( NULL == doc )
         throw libcmis::Exception( "Failed to parse object infos" );
-    refreshImpl( doc );
-    xmlFreeDoc( doc );
+    refreshImpl( xmlDocGetRootElement( doc ) );
 }
 
 string AtomObject::getInfosUrl( )
@@ -317,75 +308,56 @@ string AtomObject::getInfosUrl( )
     return string( );
 }
 
-void AtomObject::extractInfos( xmlDocPtr doc )
+void AtomObject::extractInfos( xmlNodePtr entryNd )
 {
-    xmlXPathContextPtr xpathCtx = xmlXPathNewContext( doc );
+    m_links.clear( );
+    m_renditions.clear( );
 
-    libcmis::registerNamespaces( xpathCtx );
+    if ( NULL == entryNd )
+        return;
 
-    if ( NULL != xpathCtx )
+    for ( xmlNodePtr node = entryNd->children; node; node = node->next )
     {
-        m_links.clear( );
-        m_renditions.clear( );
-
-        // Get all the atom links
-        string linksReq( "//atom:link" );
-        xmlXPathObjectPtr xpathObj = xmlXPathEvalExpression( BAD_CAST( linksReq.c_str() ), xpathCtx );
-        if ( NULL != xpathObj && NULL != xpathObj->nodesetval )
+        if ( libcmis::isXmlElement( node, NS_ATOM_URL, "link" ) )
         {
-            int size = xpathObj->nodesetval->nodeNr;
-            for ( int i = 0; i < size; i++ )
+            try
             {
-                xmlNodePtr node = xpathObj->nodesetval->nodeTab[i];
-                try
+                AtomLink link( node );
+                // Add to renditions if alternate link
+                if ( link.getRel( ) == "alternate" )
                 {
-                    AtomLink link( node );
-                    // Add to renditions if alternate link
-                    if ( link.getRel( ) == "alternate" )
-                    {
-                        string kind;
-                        map< string, string >::iterator it = link.getOthers().find( "renditionKind" );
-                        if ( it != link.getOthers( ).end() )
-                            kind = it->second;
-
-                        string title;
-                        it = link.getOthers().find( "title" );
-                        if ( it != link.getOthers( ).end( ) )
-                            title = it->second;
-
-                        long length = -1;
-                        it = link.getOthers( ).find( "length" );
-                        if ( it != link.getOthers( ).end( ) )
-                            length = libcmis::parseInteger( it->second );
-
-                        libcmis::RenditionPtr rendition( new libcmis::Rendition(
-                                    string(), link.getType(), kind,
-                                    link.getHref( ), title, length ) );
-
-                        m_renditions.push_back( rendition );
-                    }
-                    else
-                        m_links.push_back( node );
-                }
-                catch ( const libcmis::Exception& )
-                {
-                    // Broken or incomplete link... don't add it
+                    string kind;
+                    map< string, string >::iterator it = link.getOthers().find( "renditionKind" );
+                    if ( it != link.getOthers( ).end() )
+                        kind = it->second;
+
+                    string title;
+                    it = link.getOthers().find( "title" );
+                    if ( it != link.getOthers( ).end( ) )
+                        title = it->second;
+
+                    long length = -1;
+                    it = link.getOthers( ).find( "length" );
+                    if ( it != link.getOthers( ).end( ) )
+                        length = libcmis::parseInteger( it->second );
+
+                    libcmis::RenditionPtr rendition( new libcmis::Rendition(
+                                string(), link.getType(), kind,
+                                link.getHref( ), title, length ) );
+
+                    m_renditions.push_back( rendition );
                 }
+                else
+                    m_links.push_back( link );
+            }
+            catch ( const libcmis::Exception& )
+            {
+                // Broken or incomplete link... don't add it
             }
         }
-        xmlXPathFreeObject( xpathObj );
-
-
-        xpathObj = xmlXPathEvalExpression( BAD_CAST( "//cmisra:object" ), xpathCtx );
-        if ( xpathObj && xpathObj->nodesetval && xpathObj->nodesetval->nodeNr > 0 )
-        {
-            xmlNodePtr node = xpathObj->nodesetval->nodeTab[0];
+        else if ( libcmis::isXmlElement( node, NS_CMISRA_URL, "object" ) )
             initializeFromNode( node );
-        }
-        xmlXPathFreeObject( xpathObj );
     }
-
-    xmlXPathFreeContext( xpathCtx );
 }
 
 AtomPubSession* AtomObject::getSession( )
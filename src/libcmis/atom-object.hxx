@@ -89,8 +89,16 @@ class AtomObject : public virtual libcmis::Object
     protected:
 
         std::string getInfosUrl( );
-        virtual void refreshImpl( xmlDocPtr doc );
-        virtual void extractInfos( xmlDocPtr doc );
+
+        /** Update the object from an atom:entry node, or from the server if the
+            node is NULL.
+          */
+        virtual void refreshImpl( xmlNodePtr entryNd );
+
+        /** Read the links, properties and allowable actions of the object
+            directly from the children of the atom:entry node.
+          */
+        virtual void extractInfos( xmlNodePtr entryNd );
 
         AtomPubSession* getSession( );
 
@@ -28,6 +28,7 @@
 
 #include "atom-session.hxx"
 
+#include <algorithm>
 #include <string>
 
 #include <boost/algorithm/string.hpp>
@@ -35,16 +36,230 @@
 
 #include <libxml/parser.h>
 #include <libxml/tree.h>
+#include <libxml/xmlwriter.h>
 #include <libxml/xpath.h>
 
 #include <libcmis/xml-utils.hxx>
 
 #include "atom-document.hxx"
+#include "atom-feed-reader.hxx"
 #include "atom-folder.hxx"
 #include "atom-object-type.hxx"
 
 using namespace std;
 
+namespace
+{
+    /** Write the atom entry to POST to the CMIS 1.1 bulk update collection.
+      */
+    string lcl_createBulkUpdateEntry( vector< string >::const_iterator idsBegin,
+            vector< string >::const_iterator idsEnd,
+            const libcmis::PropertyPtrMap& properties,
+            const vector< string >& addSecondaryTypes,
+            const vector< string >& removeSecondaryTypes )
+    {
+        xmlBufferPtr buf = xmlBufferCreate( );
+        xmlTextWriterPtr writer = xmlNewTextWriterMemory( buf, 0 );
+
+        xmlTextWriterStartDocument( writer, NULL, NULL, NULL );
+        xmlTextWriterStartElement( writer, BAD_CAST( "atom:entry" ) );
+        xmlTextWriterWriteAttribute( writer, BAD_CAST( "xmlns:atom" ), BAD_CAST( NS_ATOM_URL ) );
+        xmlTextWriterWriteAttribute( writer, BAD_CAST( "xmlns:cmis" ), BAD_CAST( NS_CMIS_URL ) );
+        xmlTextWriterWriteAttribute( writer, BAD_CAST( "xmlns:cmisra" ), BAD_CAST( NS_CMISRA_URL ) );
+
+        xmlTextWriterWriteElement( writer, BAD_CAST( "atom:title" ), BAD_CAST( "Bulk update" ) );
+        boost::posix_time::ptime now( boost::posix_time::second_clock::universal_time( ) );
+        xmlTextWriterWriteElement( writer, BAD_CAST( "atom:updated" ), BAD_CAST( libcmis::writeDateTime( now ).c_str( ) ) );
+
+        xmlTextWriterStartElement( writer, BAD_CAST( "cmisra:bulkUpdate" ) );
+        for ( vector< string >::const_iterator it = idsBegin; it != idsEnd; ++it )
+        {
+            xmlTextWriterStartElement( writer, BAD_CAST( "cmis:objectIdAndChangeToken" ) );
+            xmlTextWriterWriteElement( writer, BAD_CAST( "cmis:id" ), BAD_CAST( it->c_str( ) ) );
+            xmlTextWriterEndElement( writer );
+        }
+
+        xmlTextWriterStartElement( writer, BAD_CAST( "cmis:properties" ) );
+        for ( libcmis::PropertyPtrMap::const_iterator it = properties.begin( ); it != properties.end( ); ++it )
+            it->second->toXml( writer );
+        xmlTextWriterEndElement( writer ); // cmis:properties
+
+        for ( vector< string >::const_iterator it = addSecondaryTypes.begin( ); it != addSecondaryTypes.end( ); ++it )
+            xmlTextWriterWriteElement( writer, BAD_CAST( "cmis:addSecondaryTypeIds" ), BAD_CAST( it->c_str( ) ) );
+        for ( vector< string >::const_iterator it = removeSecondaryTypes.begin( ); it != removeSecondaryTypes.end( ); ++it )
+            xmlTextWriterWriteElement( writer, BAD_CAST( "cmis:removeSecondaryTypeIds" ), BAD_CAST( it->c_str( ) ) );
+
+        xmlTextWriterEndElement( writer ); // cmisra:bulkUpdate
+        xmlTextWriterEndElement( writer ); // atom:entry
+        xmlTextWriterEndDocument( writer );
+
+        string str( ( const char * )xmlBufferContent( buf ) );
+
+        xmlFreeTextWriter( writer );
+        xmlBufferFree( buf );
+
+        return str;
+    }
+
+    /** Ids and change token of an object updated by the server.
+      */
+    struct UpdatedObject
+    {
+        string m_id{ };
+        string m_newId{ };
+        string m_changeToken{ };
+    };
+
+    /** Read the ids and change tokens of the objects in an atom entry or feed
+        without creating the objects, in the order of the entries.
+
+        The entries either contain the object, or a cmis:objectIdAndChangeToken
+        giving the requested id and the new one if the server changed it.
+      */
+    vector< UpdatedObject > lcl_readUpdatedObjects( libcmis::HttpResponsePtr response )
+    {
+        vector< UpdatedObject > updated;
+        xmlDocPtr doc = response->getXmlDoc( );
+        if ( NULL == doc )
+            throw libcmis::Exception( "Failed to parse object infos" );
+
+        {
+            libcmis::XPathContext xpathCtx( doc );
+            xmlXPathObjectPtr xpathObj = xpathCtx.eval( "//atom:entry" );
+            if ( NULL != xpathObj && NULL != xpathObj->nodesetval )
+            {
+                int size = xpathObj->nodesetval->nodeNr;
+                for ( int i = 0; i < size; i++ )
+                {
+                    xpathCtx.setNode( xpathObj->nodesetval->nodeTab[i] );
+                    UpdatedObject object;
+                    object.m_id = xpathCtx.getValue( ".//cmis:objectIdAndChangeToken/cmis:id" );
+                    if ( !object.m_id.empty( ) )
+                    {
+                        object.m_newId = xpathCtx.getValue( ".//cmis:objectIdAndChangeToken/cmis:newId" );
+                        object.m_changeToken = xpathCtx.getValue( ".//cmis:objectIdAndChangeToken/cmis:changeToken" );
+                    }
+                    else
+                    {
+                        object.m_id = xpathCtx.getValue(
+                                "cmisra:object//cmis:propertyId[@propertyDefinitionId='cmis:objectId']/cmis:value" );
+                        object.m_changeToken = xpathCtx.getValue(
+                                "cmisra:object//cmis:propertyString[@propertyDefinitionId='cmis:changeToken']/cmis:value" );
+                    }
+                    if ( object.m_newId.empty( ) )
+                        object.m_newId = object.m_id;
+                    if ( !object.m_id.empty( ) )
+                        updated.push_back( object );
+                }
+            }
+            xmlXPathFreeObject( xpathObj );
+        }
+
+        return updated;
+    }
+
+    /** Match the objects returned for a bulk update with the requested ids.
+
+        The objects are matched by id first. The server may only give the new
+        id of the objects it versioned: if the other objects are as many as
+        the remaining ids, they are matched by position as the entries follow
+        the requested order.
+      */
+    void lcl_matchUpdatedObjects( vector< string >::const_iterator idsBegin,
+            vector< string >::const_iterator idsEnd,
+            const vector< UpdatedObject >& updated,
+            vector< libcmis::UpdateResult >& results )
+    {
+        size_t size = idsEnd - idsBegin;
+        vector< const UpdatedObject* > matches( size, NULL );
+        vector< const UpdatedObject* > others;
+        for ( vector< UpdatedObject >::const_iterator it = updated.begin( ); it != updated.end( ); ++it )
+        {
+            vector< string >::const_iterator idIt = find( idsBegin, idsEnd, it->m_id );
+            while ( idIt != idsEnd && matches[ idIt - idsBegin ] != NULL )
+                idIt = find( idIt + 1, idsEnd, it->m_id );
+
+            if ( idIt != idsEnd )
+                matches[ idIt - idsBegin ] = &( *it );
+            else
+                others.push_back( &( *it ) );
+        }
+
+        size_t unmatched = count( matches.begin( ), matches.end( ), static_cast< const UpdatedObject* >( NULL ) );
+        if ( others.size( ) == unmatched )
+        {
+            vector< const UpdatedObject* >::iterator otherIt = others.begin( );
+            for ( size_t i = 0; i < size; ++i )
+            {
+                if ( matches[i] == NULL )
+                    matches[i] = *otherIt++;
+            }
+        }
+
+        for ( size_t i = 0; i < size; ++i )
+        {
+            const string& id = *( idsBegin + i );
+            if ( matches[i] != NULL )
+                results.push_back( libcmis::UpdateResult( id, matches[i]->m_newId, matches[i]->m_changeToken ) );
+            else
+                results.push_back( libcmis::UpdateResult( id,
+                            libcmis::Exception( "Object not updated by the server: " + id ) ) );
+        }
+    }
+
+    /** Read the ids of the changed objects from a change log feed page.
+
+        \return
+            the URL of the next page or an empty string for the last page.
+      */
+    string lcl_readChangedIds( const string& buf, const string& url, vector< string >& ids )
+    {
+        AtomFeedReader feed( buf, url );
+        for ( xmlNodePtr node = feed.nextEntry( ); node != NULL; node = feed.nextEntry( ) )
+        {
+            libcmis::XPathContext xpathCtx( node->doc, node );
+            string id = xpathCtx.getValue(
+                    "cmisra:object//cmis:propertyId[@propertyDefinitionId='cmis:objectId']/cmis:value" );
+            if ( !id.empty( ) )
+                ids.push_back( id );
+        }
+
+        return feed.getNextHref( );
+    }
+
+    /** Read the latest change log token of a repository from a service
+        document.
+      */
+    string lcl_getLatestChangeLogToken( xmlDocPtr doc, const string& repositoryId )
+    {
+        if ( NULL == doc )
+            throw libcmis::Exception( "Failed to parse service document" );
+
+        string token;
+        libcmis::XPathContext xpathCtx( doc );
+        xmlXPathObjectPtr xpathObj = xpathCtx.eval( "//app:workspace" );
+        if ( xpathObj != NULL && xpathObj->nodesetval != NULL )
+        {
+            for ( int i = 0; i < xpathObj->nodesetval->nodeNr; ++i )
+            {
+                try
+                {
+                    AtomRepository repository( xpathObj->nodesetval->nodeTab[i] );
+                    // SharePoint is case insensitive for the id...
+                    if ( boost::to_lower_copy( repository.getId( ) ) == boost::to_lower_copy( repositoryId ) )
+                        token = repository.getLatestChangeLogToken( );
+                }
+                catch ( const libcmis::Exception& )
+                {
+                    // Invalid repository, don't take care of this
+                }
+            }
+        }
+        xmlXPathFreeObject( xpathObj );
+        return token;
+    }
+}
+
 AtomPubSession::AtomPubSession( string atomPubUrl, string repositoryId,
         string username, string password, bool noSslCheck,
         libcmis::OAuth2DataPtr oauth2, bool verbose ) :
@@ -77,23 +292,24 @@ void AtomPubSession::parseServiceDocument( const string& buf )
 {
     // parse the content
     const boost::shared_ptr< xmlDoc > doc( xmlReadMemory( buf.c_str(), buf.size(), m_bindingUrl.c_str(), NULL, 0 ), xmlFreeDoc );
+    parseServiceDocument( doc.get( ) );
+}
 
-    if ( bool( doc ) )
+void AtomPubSession::parseServiceDocument( xmlDocPtr doc )
+{
+    if ( NULL != doc )
     {
         // Check that we have an AtomPub service document
-        xmlNodePtr root = xmlDocGetRootElement( doc.get() );
+        xmlNodePtr root = xmlDocGetRootElement( doc );
         if ( !xmlStrEqual( root->name, BAD_CAST( "service" ) ) )
             throw libcmis::Exception( "Not an atompub service document" );
 
-        xmlXPathContextPtr xpathCtx = xmlXPathNewContext( doc.get() );
-
-        // Register the Service Document namespaces
-        libcmis::registerNamespaces( xpathCtx );
+        libcmis::XPathContext xpathCtx( doc );
 
-        if ( NULL != xpathCtx )
+        if ( NULL != xpathCtx.get( ) )
         {
             string workspacesXPath( "//app:workspace" );
-            xmlXPathObjectPtr xpathObj = xmlXPathEvalExpression( BAD_CAST( workspacesXPath.c_str() ), xpathCtx );
+            xmlXPathObjectPtr xpathObj = xpathCtx.eval( workspacesXPath );
 
             if ( xpathObj != NULL )
             {
@@ -125,7 +341,6 @@ void AtomPubSession::parseServiceDocument( const string& buf )
             }
             xmlXPathFreeObject( xpathObj );
         }
-        xmlXPathFreeContext( xpathCtx );
     }
     else
         throw libcmis::Exception( "Failed to parse service document" );
@@ -136,16 +351,11 @@ void AtomPubSession::initialize( libcmis::HttpResponsePtr response )
     if ( m_repositories.empty() )
     {
         // Pull the content from sAtomPubUrl
-        string buf;
-        if ( response )
-        {
-            buf = response->getStream( )->str( );
-        }
-        else
+        if ( !response )
         {
             try
             {
-                buf = httpGetRequest( m_bindingUrl )->getStream( )->str( );
+                response = httpGetRequest( m_bindingUrl, XmlContentHandler::getInstance( ) );
             }
             catch ( const CurlException& e )
             {
@@ -153,7 +363,8 @@ void AtomPubSession::initialize( libcmis::HttpResponsePtr response )
             }
         }
 
-        parseServiceDocument( buf );
+        // Service documents can be big: reuse the document parsed during the download
+        parseServiceDocument( response->getXmlDoc( ) );
     }
 }
 
@@ -193,56 +404,65 @@ libcmis::ObjectPtr AtomPubSession::createObjectFromEntryDoc( xmlDocPtr doc, Resu
     if ( NULL != doc )
     {
         // Get the atom:entry node
-        xmlXPathContextPtr xpathCtx = xmlXPathNewContext( doc );
-        libcmis::registerNamespaces( xpathCtx );
-        if ( NULL != xpathCtx )
-        {
-            const string& entriesReq( "//atom:entry" );
-            xmlXPathObjectPtr xpathObj = xmlXPathEvalExpression( BAD_CAST( entriesReq.c_str() ), xpathCtx );
+        libcmis::XPathContext xpathCtx( doc );
+        xmlXPathObjectPtr xpathObj = xpathCtx.eval( "//atom:entry" );
 
-            if ( NULL != xpathObj && NULL != xpathObj->nodesetval && ( 0 < xpathObj->nodesetval->nodeNr ) )
-            {
-                // Get the entry's base type
-                string baseTypeReq = "//atom:entry[1]//cmis:propertyId[@propertyDefinitionId='cmis:baseTypeId']/cmis:value/text()";
-                string baseType = libcmis::getXPathValue( xpathCtx, baseTypeReq );
+        if ( NULL != xpathObj && NULL != xpathObj->nodesetval && ( 0 < xpathObj->nodesetval->nodeNr ) )
+            cmisObject = createObjectFromEntry( xpathObj->nodesetval->nodeTab[0], res );
+        xmlXPathFreeObject( xpathObj );
+    }
 
-                xmlNodePtr node = xpathObj->nodesetval->nodeTab[0];
-                if ( res == RESULT_FOLDER || baseType == "cmis:folder" )
-                {
-                    cmisObject.reset( new AtomFolder( this, node ) );
-                }
-                else if ( res == RESULT_DOCUMENT || baseType == "cmis:document" )
-                {
-                    cmisObject.reset( new AtomDocument( this, node ) );
-                }
-                else
-                {
-                    // Not a valid CMIS atom entry... weird
-                }
-            }
-            xmlXPathFreeObject( xpathObj );
+    return cmisObject;
+}
+
+libcmis::ObjectPtr AtomPubSession::createObjectFromEntry( xmlNodePtr entryNd, ResultObjectType res )
+{
+    libcmis::ObjectPtr cmisObject;
+
+    if ( NULL != entryNd )
+    {
+        // Get the entry's base type
+        string baseType;
+        {
+            libcmis::XPathContext xpathCtx( entryNd->doc, entryNd );
+            string baseTypeReq = ".//cmis:propertyId[@propertyDefinitionId='cmis:baseTypeId']/cmis:value/text()";
+            baseType = xpathCtx.getValue( baseTypeReq );
+        }
+
+        if ( res == RESULT_FOLDER || baseType == "cmis:folder" )
+        {
+            cmisObject.reset( new AtomFolder( this, entryNd ) );
+        }
+        else if ( res == RESULT_DOCUMENT || baseType == "cmis:document" )
+        {
+            cmisObject.reset( new AtomDocument( this, entryNd ) );
+        }
+        else
+        {
+            // Not a valid CMIS atom entry... weird
         }
-        xmlXPathFreeContext( xpathCtx );
     }
 
     return cmisObject;
 }
 
-libcmis::ObjectPtr AtomPubSession::getObject( string id )
+string AtomPubSession::getObjectUrl( string id )
 {
     string pattern = getAtomRepository()->getUriTemplate( UriTemplate::ObjectById );
     map< string, string > vars;
     vars[URI_TEMPLATE_VAR_ID] = id;
     vars[string( "includeAllowableActions" )] = string( "true" );
-    string url = createUrl( pattern, vars );
+    return createUrl( pattern, vars );
+}
+
+libcmis::ObjectPtr AtomPubSession::getObject( string id )
+{
+    string url = getObjectUrl( id );
 
     try
     {
-        string buf = httpGetRequest( url )->getStream( )->str( );
-        xmlDocPtr doc = xmlReadMemory( buf.c_str(), buf.size(), url.c_str(), NULL, 0 );
-        libcmis::ObjectPtr cmisObject = createObjectFromEntryDoc( doc );
-        xmlFreeDoc( doc );
-        return cmisObject;
+        libcmis::HttpResponsePtr response = httpGetRequest( url, XmlContentHandler::getInstance( ) );
+        return createObjectFromEntryDoc( response->getXmlDoc( ) );
     }
     catch ( const CurlException& e )
     {
@@ -258,6 +478,217 @@ libcmis::ObjectPtr AtomPubSession::getObject( string id )
     }
 }
 
+vector< libcmis::ObjectResult > AtomPubSession::getObjects( const vector< string >& ids,
+                                                           const libcmis::BatchOptions& options )
+{
+    // AtomPub has no batch request: CMIS queries could be used, but they only
+    // return the queryable properties and no links. Get the objects concurrently.
+    vector< HttpTransferPtr > requests;
+    for ( vector< string >::const_iterator it = ids.begin( ); it != ids.end( ); ++it )
+    {
+        HttpTransferPtr request( new HttpTransfer( "GET", getObjectUrl( *it ) ) );
+        request->setContentHandler( XmlContentHandler::getInstance( ) );
+        requests.push_back( request );
+    }
+
+    httpRunConcurrentRequests( requests, options.getMaxConcurrency( ) );
+
+    vector< libcmis::ObjectResult > results;
+    for ( size_t i = 0; i < ids.size( ); ++i )
+    {
+        HttpTransferPtr request = requests[i];
+        if ( request->isFailed( ) )
+        {
+            if ( request->getHttpStatus( ) == 404 )
+                results.push_back( libcmis::ObjectResult( ids[i],
+                            libcmis::Exception( "No such node: " + ids[i], "objectNotFound" ) ) );
+            else
+                results.push_back( libcmis::ObjectResult( ids[i], request->getError( )->getCmisException( ) ) );
+            continue;
+        }
+
+        libcmis::ObjectPtr cmisObject;
+        try
+        {
+            cmisObject = createObjectFromEntryDoc( request->getResponse( )->getXmlDoc( ) );
+        }
+        catch ( const libcmis::Exception& e )
+        {
+            results.push_back( libcmis::ObjectResult( ids[i], e ) );
+            continue;
+        }
+
+        if ( cmisObject )
+            results.push_back( libcmis::ObjectResult( ids[i], cmisObject ) );
+        else
+            results.push_back( libcmis::ObjectResult( ids[i],
+                        libcmis::Exception( "Failed to parse object infos" ) ) );
+    }
+
+    return results;
+}
+
+vector< libcmis::UpdateResult > AtomPubSession::bulkUpdateProperties( const vector< string >& ids,
+        const libcmis::PropertyPtrMap& properties,
+        const vector< string >& addSecondaryTypes,
+        const vector< string >& removeSecondaryTypes,
+        const libcmis::BatchOptions& options )
+{
+    string bulkUpdateUrl = getAtomRepository( )->getCollectionUrl( Collection::BulkUpdate );
+    if ( bulkUpdateUrl.empty( ) )
+        return updateObjectsProperties( ids, properties, addSecondaryTypes, removeSecondaryTypes, options );
+
+    size_t batchSize = options.getMaxBatchSize( );
+    vector< HttpTransferPtr > requests;
+    for ( size_t start = 0; start < ids.size( ); start += batchSize )
+    {
+        size_t end = min( ids.size( ), start + batchSize );
+        vector< string > headers;
+        headers.push_back( "Content-Type: application/atom+xml;type=entry" );
+        string body = lcl_createBulkUpdateEntry( ids.begin( ) + start, ids.begin( ) + end,
+                properties, addSecondaryTypes, removeSecondaryTypes );
+        HttpTransferPtr request( new HttpTransfer( "POST", bulkUpdateUrl, headers, body ) );
+        request->setContentHandler( XmlContentHandler::getInstance( ) );
+        requests.push_back( request );
+    }
+
+    httpRunConcurrentRequests( requests, options.getMaxConcurrency( ) );
+
+    vector< libcmis::UpdateResult > results;
+    for ( size_t i = 0; i < requests.size( ); ++i )
+    {
+        size_t start = i * batchSize;
+        size_t end = min( ids.size( ), start + batchSize );
+        try
+        {
+            if ( requests[i]->isFailed( ) )
+                throw requests[i]->getError( )->getCmisException( );
+
+            // The feed only contains the objects that have been updated
+            vector< UpdatedObject > updated = lcl_readUpdatedObjects( requests[i]->getResponse( ) );
+            lcl_matchUpdatedObjects( ids.begin( ) + start, ids.begin( ) + end, updated, results );
+        }
+        catch ( const libcmis::Exception& e )
+        {
+            for ( size_t j = start; j < end; ++j )
+                results.push_back( libcmis::UpdateResult( ids[j], e ) );
+        }
+    }
+
+    return results;
+}
+
+vector< libcmis::UpdateResult > AtomPubSession::updateObjectsProperties( const vector< string >& ids,
+        const libcmis::PropertyPtrMap& properties,
+        const vector< string >& addSecondaryTypes,
+        const vector< string >& removeSecondaryTypes,
+        const libcmis::BatchOptions& options )
+{
+    vector< libcmis::PropertyPtrMap > objectsProperties;
+    vector< boost::shared_ptr< libcmis::Exception > > errors;
+    prepareBulkUpdate( ids, properties, addSecondaryTypes, removeSecondaryTypes, options,
+            objectsProperties, errors );
+
+    vector< HttpTransferPtr > requests( ids.size( ) );
+    vector< HttpTransferPtr > pending;
+    for ( size_t i = 0; i < ids.size( ); ++i )
+    {
+        if ( errors[i] )
+            continue;
+
+        xmlBufferPtr buf = xmlBufferCreate( );
+        xmlTextWriterPtr writer = xmlNewTextWriterMemory( buf, 0 );
+        xmlTextWriterStartDocument( writer, NULL, NULL, NULL );
+        boost::shared_ptr< ostream > stream;
+        AtomObject::writeAtomEntry( writer, objectsProperties[i], stream, string( ) );
+        xmlTextWriterEndDocument( writer );
+        string body( ( const char * )xmlBufferContent( buf ) );
+        xmlFreeTextWriter( writer );
+        xmlBufferFree( buf );
+
+        vector< string > headers;
+        headers.push_back( "Content-Type: application/atom+xml;type=entry" );
+        requests[i].reset( new HttpTransfer( "PUT", getObjectUrl( ids[i] ), headers, body ) );
+        requests[i]->setContentHandler( XmlContentHandler::getInstance( ) );
+        pending.push_back( requests[i] );
+    }
+
+    httpRunConcurrentRequests( pending, options.getMaxConcurrency( ) );
+
+    vector< libcmis::UpdateResult > results;
+    for ( size_t i = 0; i < ids.size( ); ++i )
+    {
+        try
+        {
+            if ( errors[i] )
+                throw *errors[i];
+            if ( requests[i]->isFailed( ) )
+                throw requests[i]->getError( )->getCmisException( );
+
+            // Only read what we need from the returned entry
+            vector< UpdatedObject > updated = lcl_readUpdatedObjects( requests[i]->getResponse( ) );
+            if ( updated.empty( ) )
+                throw libcmis::Exception( "Failed to parse object infos" );
+            results.push_back( libcmis::UpdateResult( ids[i], updated.front( ).m_newId,
+                        updated.front( ).m_changeToken ) );
+        }
+        catch ( const libcmis::Exception& e )
+        {
+            results.push_back( libcmis::UpdateResult( ids[i], e ) );
+        }
+    }
+
+    return results;
+}
+
+vector< string > AtomPubSession::getContentChanges( string& changeLogToken )
+{
+    string changesUrl;
+    if ( m_repository )
+        changesUrl = m_repository->getChangesUrl( );
+    if ( changesUrl.empty( ) || getRepository( )->getCapability( libcmis::Repository::Changes ) == "none" )
+        throw libcmis::Exception( "Change log not supported", "notSupported" );
+
+    // AtomPub only gives the latest change log token in the repository
+    // infos: read it from the service document, but keep the repositories
+    // of the session and their links. Reading it before the changes may
+    // report some changes twice, but won't miss any.
+    libcmis::HttpResponsePtr response;
+    try
+    {
+        response = httpGetRequest( m_bindingUrl, XmlContentHandler::getInstance( ) );
+    }
+    catch ( const CurlException& e )
+    {
+        throw e.getCmisException( );
+    }
+    string latestToken = lcl_getLatestChangeLogToken( response->getXmlDoc( ), m_repository->getId( ) );
+
+    vector< string > ids;
+    if ( !changeLogToken.empty( ) )
+    {
+        string pageUrl = changesUrl;
+        pageUrl += changesUrl.find( '?' ) == string::npos ? "?" : "&";
+        pageUrl += "changeLogToken=" + libcmis::escape( changeLogToken );
+
+        while ( !pageUrl.empty( ) )
+        {
+            try
+            {
+                response = httpGetRequest( pageUrl );
+            }
+            catch ( const CurlException& e )
+            {
+                throw e.getCmisException( );
+            }
+            pageUrl = lcl_readChangedIds( response->getBody( ), pageUrl, ids );
+        }
+    }
+
+    changeLogToken = latestToken;
+    return ids;
+}
+
 libcmis::ObjectPtr AtomPubSession::getObjectByPath( string path )
 {
     string pattern = getAtomRepository()->getUriTemplate( UriTemplate::ObjectByPath );
@@ -268,11 +699,8 @@ libcmis::ObjectPtr AtomPubSession::getObjectByPath( string path )
 
     try
     {
-        string buf = httpGetRequest( url )->getStream( )->str( );
-        xmlDocPtr doc = xmlReadMemory( buf.c_str(), buf.size(), url.c_str(), NULL, 0 );
-        libcmis::ObjectPtr cmisObject = createObjectFromEntryDoc( doc );
-        xmlFreeDoc( doc );
-        return cmisObject;
+        libcmis::HttpResponsePtr response = httpGetRequest( url, XmlContentHandler::getInstance( ) );
+        return createObjectFromEntryDoc( response->getXmlDoc( ) );
     }
     catch ( const CurlException& e )
     {
@@ -303,47 +731,22 @@ vector< libcmis::ObjectTypePtr > AtomPubSession::getBaseTypes( )
 vector< libcmis::ObjectTypePtr > AtomPubSession::getChildrenTypes( string url )
 {
     vector< libcmis::ObjectTypePtr > children;
-    string buf;
+    libcmis::HttpResponsePtr response;
     try
     {
-        buf = httpGetRequest( url )->getStream( )->str( );
+        response = httpGetRequest( url );
     }
     catch ( const CurlException& e )
     {
         throw e.getCmisException( );
     }
 
-    xmlDocPtr doc = xmlReadMemory( buf.c_str(), buf.size(), url.c_str(), NULL, 0 );
-    if ( NULL != doc )
-    {
-        xmlXPathContextPtr xpathCtx = xmlXPathNewContext( doc );
-        libcmis::registerNamespaces( xpathCtx );
-        if ( NULL != xpathCtx )
-        {
-            const string& entriesReq( "//atom:entry" );
-            xmlXPathObjectPtr xpathObj = xmlXPathEvalExpression( BAD_CAST( entriesReq.c_str() ), xpathCtx );
-
-            if ( NULL != xpathObj && NULL != xpathObj->nodesetval )
-            {
-                int size = xpathObj->nodesetval->nodeNr;
-                for ( int i = 0; i < size; i++ )
-                {
-                    xmlNodePtr node = xpathObj->nodesetval->nodeTab[i];
-                    libcmis::ObjectTypePtr type( new AtomObjectType( this, node ) );
-                    children.push_back( type );
-                }
-            }
-
-            xmlXPathFreeObject( xpathObj );
-        }
-
-        xmlXPathFreeContext( xpathCtx );
-    }
-    else
+    AtomFeedReader feed( response->getBody( ), url );
+    for ( xmlNodePtr node = feed.nextEntry( ); node != NULL; node = feed.nextEntry( ) )
     {
-        throw libcmis::Exception( "Failed to parse type children infos" );
+        libcmis::ObjectTypePtr type( new AtomObjectType( this, node ) );
+        children.push_back( type );
     }
-    xmlFreeDoc( doc );
 
     return children;
 }
@@ -58,6 +58,12 @@ class AtomPubSession : public BaseSession
 
         libcmis::ObjectPtr createObjectFromEntryDoc( xmlDocPtr doc, ResultObjectType res=RESULT_DYNAMIC );
 
+        /** Create the object for an atom:entry node, without copying it to a new document.
+          */
+        libcmis::ObjectPtr createObjectFromEntry( xmlNodePtr entryNd, ResultObjectType res=RESULT_DYNAMIC );
+
+        std::string getObjectUrl( std::string id );
+
         std::vector< libcmis::ObjectTypePtr > getChildrenTypes( std::string url );
 
         // Override session methods
@@ -68,6 +74,17 @@ class AtomPubSession : public BaseSession
 
         virtual libcmis::ObjectPtr getObject( std::string id );
 
+        virtual std::vector< libcmis::ObjectResult > getObjects( const std::vector< std::string >& ids,
+                                                                 const libcmis::BatchOptions& options = libcmis::BatchOptions( ) );
+
+        virtual std::vector< libcmis::UpdateResult > bulkUpdateProperties( const std::vector< std::string >& ids,
+                const libcmis::PropertyPtrMap& properties,
+                const std::vector< std::string >& addSecondaryTypes = std::vector< std::string >( ),
+                const std::vector< std::string >& removeSecondaryTypes = std::vector< std::string >( ),
+                const libcmis::BatchOptions& options = libcmis::BatchOptions( ) );
+
+        virtual std::vector< std::string > getContentChanges( std::string& changeLogToken );
+
         virtual libcmis::ObjectPtr getObjectByPath( std::string path );
 
         virtual libcmis::ObjectTypePtr getType( std::string id );
@@ -83,8 +100,18 @@ class AtomPubSession : public BaseSession
         AtomPubSession& operator=( const AtomPubSession& copy ) = delete;
 
         void parseServiceDocument( const std::string& buf );
+        void parseServiceDocument( xmlDocPtr doc );
 
         void initialize( libcmis::HttpResponsePtr response );
+
+        /** Update the objects using one PUT request per object for the servers
+            without bulk update collection.
+          */
+        std::vector< libcmis::UpdateResult > updateObjectsProperties( const std::vector< std::string >& ids,
+                const libcmis::PropertyPtrMap& properties,
+                const std::vector< std::string >& addSecondaryTypes,
+                const std::vector< std::string >& removeSecondaryTypes,
+                const libcmis::BatchOptions& options );
 };
 
 #endif
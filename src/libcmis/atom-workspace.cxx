@@ -35,44 +35,43 @@ using namespace std;
 AtomRepository::AtomRepository( xmlNodePtr wsNode ):
     Repository( ),
     m_collections( ),
-    m_uriTemplates( )
+    m_uriTemplates( ),
+    m_changesUrl( )
 {
     if ( wsNode != NULL )
     {
-        xmlDocPtr doc = libcmis::wrapInDoc( wsNode );
-        xmlXPathContextPtr xpathCtx = xmlXPathNewContext( doc );
-        libcmis::registerNamespaces( xpathCtx );
-
-        if ( NULL != xpathCtx )
-        {
-            // Get the collections
-            xmlXPathObjectPtr xpathObj = xmlXPathEvalExpression( BAD_CAST( "//app:collection" ), xpathCtx );
-            if ( NULL != xpathObj )
-                readCollections( xpathObj->nodesetval );
-            xmlXPathFreeObject( xpathObj );
-
-            // Get the URI templates
-            xpathObj = xmlXPathEvalExpression( BAD_CAST( "//cmisra:uritemplate" ), xpathCtx );
-            if ( NULL != xpathObj )
-                readUriTemplates( xpathObj->nodesetval );
-            xmlXPathFreeObject( xpathObj );
-
-            // Get the repository infos 
-            xpathObj = xmlXPathEvalExpression( BAD_CAST( "//cmisra:repositoryInfo" ), xpathCtx );
-            if ( NULL != xpathObj )
-                initializeFromNode( xpathObj->nodesetval->nodeTab[0] );
-            xmlXPathFreeObject( xpathObj );
-            
-        }
-        xmlXPathFreeContext( xpathCtx );
-        xmlFreeDoc( doc );
+        // Evaluate relatively to the workspace node: no need to copy it
+        libcmis::XPathContext xpathCtx( wsNode->doc, wsNode );
+
+        // Get the collections
+        xmlXPathObjectPtr xpathObj = xpathCtx.eval( ".//app:collection" );
+        if ( NULL != xpathObj )
+            readCollections( xpathObj->nodesetval );
+        xmlXPathFreeObject( xpathObj );
+
+        // Get the URI templates
+        xpathObj = xpathCtx.eval( ".//cmisra:uritemplate" );
+        if ( NULL != xpathObj )
+            readUriTemplates( xpathObj->nodesetval );
+        xmlXPathFreeObject( xpathObj );
+
+        // Get the change log link
+        m_changesUrl = xpathCtx.getValue(
+                ".//atom:link[@rel='http://docs.oasis-open.org/ns/cmis/link/200908/changes']/attribute::href" );
+
+        // Get the repository infos
+        xpathObj = xpathCtx.eval( ".//cmisra:repositoryInfo" );
+        if ( NULL != xpathObj && NULL != xpathObj->nodesetval && xpathObj->nodesetval->nodeNr > 0 )
+            initializeFromNode( xpathObj->nodesetval->nodeTab[0] );
+        xmlXPathFreeObject( xpathObj );
     }
 }
 
 AtomRepository::AtomRepository( const AtomRepository& rCopy ) :
     Repository( rCopy ),
     m_collections( rCopy.m_collections ),
-    m_uriTemplates( rCopy.m_uriTemplates )
+    m_uriTemplates( rCopy.m_uriTemplates ),
+    m_changesUrl( rCopy.m_changesUrl )
 {
 }
 
@@ -88,6 +87,7 @@ AtomRepository& AtomRepository::operator= ( const AtomRepository& rCopy )
     {
         m_collections = rCopy.m_collections;
         m_uriTemplates = rCopy.m_uriTemplates;
+        m_changesUrl = rCopy.m_changesUrl;
     }
 
     return *this;
@@ -157,6 +157,11 @@ void AtomRepository::readCollections( xmlNodeSetPtr nodeSet )
                         type = Collection::Unfiled;
                         typeDefined = true;
                     }
+                    else if ( xmlStrEqual( content, BAD_CAST( "update" ) ) )
+                    {
+                        type = Collection::BulkUpdate;
+                        typeDefined = true;
+                    }
 
                     if ( typeDefined )
                         m_collections[ type ] = collectionRef;
@@ -48,7 +48,8 @@ struct Collection {
         Types,
         Query,
         CheckedOut,
-        Unfiled
+        Unfiled,
+        BulkUpdate
     };
 };
 
@@ -71,6 +72,9 @@ class AtomRepository : public libcmis::Repository
         /// URI templates
         std::map< UriTemplate::Type, std::string > m_uriTemplates;
 
+        /// Change log feed URL
+        std::string m_changesUrl;
+
     public:
         AtomRepository( xmlNodePtr wsNode = NULL );
         AtomRepository( const AtomRepository& rCopy );
@@ -80,6 +84,7 @@ class AtomRepository : public libcmis::Repository
 
         std::string getCollectionUrl( Collection::Type );
         std::string getUriTemplate( UriTemplate::Type );
+        std::string getChangesUrl( ) { return m_changesUrl; }
 
     private:
         void readCollections( xmlNodeSetPtr pNodeSet );
@@ -28,7 +28,9 @@
 
 #include "base-session.hxx"
 
+#include <algorithm>
 #include <cctype>
+#include <set>
 #include <string>
 
 #include <libxml/parser.h>
@@ -145,3 +147,130 @@ libcmis::FolderPtr BaseSession::getFolder( string id )
     libcmis::FolderPtr folder = boost::dynamic_pointer_cast< libcmis::Folder >( object );
     return folder;
 }
+
+vector< string > BaseSession::deleteObjects( const vector< string >& ids, const libcmis::BatchOptions& )
+{
+    vector< string > failed;
+    for ( vector< string >::const_iterator it = ids.begin( ); it != ids.end( ); ++it )
+    {
+        try
+        {
+            libcmis::ObjectPtr object = getObject( *it );
+            if ( object )
+                object->remove( );
+        }
+        catch ( const libcmis::Exception& e )
+        {
+            if ( e.getType( ) != "objectNotFound" )
+                failed.push_back( *it );
+        }
+    }
+    return failed;
+}
+
+vector< string > BaseSession::removeTreeConcurrently( libcmis::Folder& folder, bool continueOnError,
+        const libcmis::BatchOptions& options )
+{
+    // List the whole tree, level by level
+    vector< vector< string > > levels;
+    map< string, string > parentIds;
+    levels.push_back( vector< string >( 1, folder.getId( ) ) );
+
+    vector< libcmis::ObjectPtr > level = folder.getChildren( );
+    for ( vector< libcmis::ObjectPtr >::iterator it = level.begin( ); it != level.end( ); ++it )
+        parentIds[ ( *it )->getId( ) ] = folder.getId( );
+
+    while ( !level.empty( ) )
+    {
+        vector< string > ids;
+        vector< libcmis::ObjectPtr > nextLevel;
+        for ( vector< libcmis::ObjectPtr >::iterator it = level.begin( ); it != level.end( ); ++it )
+        {
+            string id = ( *it )->getId( );
+            ids.push_back( id );
+
+            libcmis::FolderPtr subFolder = boost::dynamic_pointer_cast< libcmis::Folder >( *it );
+            if ( subFolder )
+            {
+                vector< libcmis::ObjectPtr > children = subFolder->getChildren( );
+                for ( vector< libcmis::ObjectPtr >::iterator childIt = children.begin( );
+                        childIt != children.end( ); ++childIt )
+                {
+                    parentIds[ ( *childIt )->getId( ) ] = id;
+                    nextLevel.push_back( *childIt );
+                }
+            }
+        }
+        levels.push_back( ids );
+        level.swap( nextLevel );
+    }
+
+    // Delete the deepest objects first
+    set< string > failedSet;
+    vector< string > failed;
+    for ( vector< vector< string > >::reverse_iterator levelIt = levels.rbegin( );
+            levelIt != levels.rend( ); ++levelIt )
+    {
+        vector< string > ids;
+        for ( vector< string >::iterator it = levelIt->begin( ); it != levelIt->end( ); ++it )
+        {
+            if ( failedSet.find( *it ) == failedSet.end( ) )
+                ids.push_back( *it );
+        }
+
+        vector< string > levelFailed = deleteObjects( ids, options );
+
+        // The parents of the failed objects can't be deleted either
+        for ( vector< string >::iterator it = levelFailed.begin( ); it != levelFailed.end( ); ++it )
+        {
+            string id = *it;
+            while ( !id.empty( ) && failedSet.insert( id ).second )
+            {
+                failed.push_back( id );
+                map< string, string >::iterator parentIt = parentIds.find( id );
+                id = parentIt != parentIds.end( ) ? parentIt->second : string( );
+            }
+        }
+
+        if ( !levelFailed.empty( ) && !continueOnError )
+            break;
+    }
+
+    return failed;
+}
+
+void BaseSession::prepareBulkUpdate( const vector< string >& ids,
+        const libcmis::PropertyPtrMap& properties,
+        const vector< string >& addSecondaryTypes,
+        const vector< string >& removeSecondaryTypes,
+        const libcmis::BatchOptions& options,
+        vector< libcmis::PropertyPtrMap >& objectsProperties,
+        vector< boost::shared_ptr< libcmis::Exception > >& errors )
+{
+    objectsProperties.assign( ids.size( ), properties );
+    errors.assign( ids.size( ), boost::shared_ptr< libcmis::Exception >( ) );
+
+    if ( addSecondaryTypes.empty( ) && removeSecondaryTypes.empty( ) )
+        return;
+
+    // The new secondary types depend on the current ones
+    vector< libcmis::ObjectResult > objects = getObjects( ids, options );
+    for ( size_t i = 0; i < ids.size( ); ++i )
+    {
+        if ( !objects[i].isOk( ) )
+        {
+            errors[i] = objects[i].getError( );
+            continue;
+        }
+
+        try
+        {
+            objectsProperties[i] = getBulkUpdateProperties( objects[i].getObject( ), properties,
+                    addSecondaryTypes, removeSecondaryTypes );
+        }
+        catch ( const libcmis::Exception& e )
+        {
+            errors[i].reset( new libcmis::Exception( e ) );
+        }
+    }
+}
@@ -81,6 +81,30 @@ class BaseSession : public libcmis::Session,
 
         std::string getBindingUrl( ) { return m_bindingUrl; }
 
+        /** Delete several objects at once. The objects that are already
+            gone aren't reported as failures.
+
+            The default implementation deletes the objects one after the other.
+
+            \return
+                the ids of the objects that couldn't be deleted.
+          */
+        virtual std::vector< std::string > deleteObjects( const std::vector< std::string >& ids,
+                const libcmis::BatchOptions& options = libcmis::BatchOptions( ) );
+
+        /** Delete a folder tree from the client side, for servers that can't
+            report which objects failed to be deleted.
+
+            The tree is deleted level after level starting with the deepest
+            one, each level being deleted using deleteObjects( ). A folder is
+            not deleted if one of its children failed to be deleted.
+
+            \return
+                the ids of the objects that couldn't be deleted.
+          */
+        std::vector< std::string > removeTreeConcurrently( libcmis::Folder& folder, bool continueOnError,
+                const libcmis::BatchOptions& options = libcmis::BatchOptions( ) );
+
         // HttpSession overridden methods
 
         virtual void setOAuth2Data( libcmis::OAuth2DataPtr oauth2 );
@@ -100,6 +124,24 @@ class BaseSession : public libcmis::Session,
 
         BaseSession( const BaseSession& copy ) = delete;
         BaseSession& operator=( const BaseSession& copy ) = delete;
+
+        /** Compute the properties to send to the server for each object of a
+            bulk update. The objects are fetched only if their secondary types
+            need to be changed.
+
+            \param objectsProperties
+                receives the properties to send for each id.
+            \param errors
+                receives the reason of the failure for each id, or an empty
+                pointer if the object can be updated.
+          */
+        void prepareBulkUpdate( const std::vector< std::string >& ids,
+                const libcmis::PropertyPtrMap& properties,
+                const std::vector< std::string >& addSecondaryTypes,
+                const std::vector< std::string >& removeSecondaryTypes,
+                const libcmis::BatchOptions& options,
+                std::vector< libcmis::PropertyPtrMap >& objectsProperties,
+                std::vector< boost::shared_ptr< libcmis::Exception > >& errors );
 };
 
 #endif
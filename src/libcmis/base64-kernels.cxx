@@ -0,0 +1,403 @@
+/* libcmis
+ * Version: MPL 1.1 / GPLv2+ / LGPLv2+
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License or as specified alternatively below. You may obtain a copy of
+ * the License at http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * Major Contributor(s):
+ *
+ *
+ * All Rights Reserved.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPLv2+"), or
+ * the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+ * in which case the provisions of the GPLv2+ or the LGPLv2+ are applicable
+ * instead of those above.
+ */
+
+#include "base64-kernels.hxx"
+
+// The x86 kernels are compiled for their instruction set with the target
+// attribute and only used if the CPU supports it. NEON is always available
+// on aarch64.
+#if ( defined( __x86_64__ ) || defined( __i386__ ) ) && \
+    ( defined( __clang__ ) || __GNUC__ > 4 || ( __GNUC__ == 4 && __GNUC_MINOR__ >= 9 ) )
+#define BASE64_X86_KERNELS 1
+#include <immintrin.h>
+#elif defined( __aarch64__ ) && defined( __ARM_NEON )
+#define BASE64_NEON_KERNEL 1
+#include <arm_neon.h>
+#endif
+
+using namespace std;
+
+namespace libcmis
+{
+    const char base64Chars[] =
+          "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    const signed char base64Values[256] =
+    {
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+        52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+        -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+        15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+        -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+        41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+    };
+}
+
+namespace
+{
+    size_t lcl_decodeScalar( const unsigned char* in, size_t len,
+                             char* out, size_t& outSize, size_t outCapacity )
+    {
+        size_t i = 0;
+        while ( i + 4 <= len && outSize + 3 <= outCapacity )
+        {
+            int a = libcmis::base64Values[ in[i] ];
+            int b = libcmis::base64Values[ in[i + 1] ];
+            int c = libcmis::base64Values[ in[i + 2] ];
+            int d = libcmis::base64Values[ in[i + 3] ];
+            if ( ( a | b | c | d ) < 0 )
+                break;
+
+            unsigned long value = ( a << 18 ) | ( b << 12 ) | ( c << 6 ) | d;
+            out[ outSize++ ] = char( value >> 16 );
+            out[ outSize++ ] = char( value >> 8 );
+            out[ outSize++ ] = char( value );
+            i += 4;
+        }
+        return i;
+    }
+
+    size_t lcl_encodeScalar( const unsigned char* in, size_t len,
+                             char* out, size_t& outSize, size_t outCapacity )
+    {
+        size_t i = 0;
+        while ( i + 3 <= len && outSize + 4 <= outCapacity )
+        {
+            unsigned long value = ( in[i] << 16 ) | ( in[i + 1] << 8 ) | in[i + 2];
+            out[ outSize++ ] = libcmis::base64Chars[ ( value >> 18 ) & 0x3F ];
+            out[ outSize++ ] = libcmis::base64Chars[ ( value >> 12 ) & 0x3F ];
+            out[ outSize++ ] = libcmis::base64Chars[ ( value >> 6 ) & 0x3F ];
+            out[ outSize++ ] = libcmis::base64Chars[ value & 0x3F ];
+            i += 3;
+        }
+        return i;
+    }
+
+#ifdef BASE64_X86_KERNELS
+    /* The SIMD kernels follow the algorithms of Wojciech Muła and Alfred
+       Klomp: the characters are checked and translated with nibble lookup
+       tables, the bits are then packed with multiply-add instructions.
+       Their stores go over the converted size: they stop one vector
+       before the end of the output buffer. */
+
+    __attribute__(( target( "sse4.1" ) ))
+    size_t lcl_decodeSse4( const unsigned char* in, size_t len,
+                           char* out, size_t& outSize, size_t outCapacity )
+    {
+        // Non-zero when anded for the characters out of the alphabet
+        const __m128i lutLo = _mm_setr_epi8(
+                0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A );
+        const __m128i lutHi = _mm_setr_epi8(
+                0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10 );
+        // Offset to add to the characters, by high nibble and for '/'
+        const __m128i lutRoll = _mm_setr_epi8(
+                0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0 );
+        const __m128i mask0F = _mm_set1_epi8( 0x0F );
+        const __m128i slashes = _mm_set1_epi8( '/' );
+        const __m128i packOrder = _mm_setr_epi8(
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1 );
+
+        size_t i = 0;
+        while ( i + 16 <= len && outSize + 16 <= outCapacity )
+        {
+            __m128i str = _mm_loadu_si128( reinterpret_cast< const __m128i* >( in + i ) );
+            __m128i hiNibbles = _mm_and_si128( _mm_srli_epi32( str, 4 ), mask0F );
+            __m128i loNibbles = _mm_and_si128( str, mask0F );
+            __m128i hi = _mm_shuffle_epi8( lutHi, hiNibbles );
+            __m128i lo = _mm_shuffle_epi8( lutLo, loNibbles );
+            if ( !_mm_testz_si128( lo, hi ) )
+                break;
+
+            __m128i roll = _mm_shuffle_epi8( lutRoll,
+                    _mm_add_epi8( _mm_cmpeq_epi8( str, slashes ), hiNibbles ) );
+            str = _mm_add_epi8( str, roll );
+
+            str = _mm_maddubs_epi16( str, _mm_set1_epi32( 0x01400140 ) );
+            str = _mm_madd_epi16( str, _mm_set1_epi32( 0x00011000 ) );
+            str = _mm_shuffle_epi8( str, packOrder );
+
+            _mm_storeu_si128( reinterpret_cast< __m128i* >( out + outSize ), str );
+            outSize += 12;
+            i += 16;
+        }
+        return i + lcl_decodeScalar( in + i, len - i, out, outSize, outCapacity );
+    }
+
+    __attribute__(( target( "sse4.1" ) ))
+    size_t lcl_encodeSse4( const unsigned char* in, size_t len,
+                           char* out, size_t& outSize, size_t outCapacity )
+    {
+        const __m128i spreadOrder = _mm_setr_epi8(
+                1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10 );
+        // Offset to add to the values, by range of values
+        const __m128i lutOffsets = _mm_setr_epi8(
+                65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0 );
+
+        size_t i = 0;
+        while ( i + 16 <= len && outSize + 16 <= outCapacity )
+        {
+            __m128i str = _mm_loadu_si128( reinterpret_cast< const __m128i* >( in + i ) );
+
+            // Spread the 12 bytes into 16 values of 6 bits
+            str = _mm_shuffle_epi8( str, spreadOrder );
+            __m128i t0 = _mm_and_si128( str, _mm_set1_epi32( 0x0FC0FC00 ) );
+            __m128i t1 = _mm_mulhi_epu16( t0, _mm_set1_epi32( 0x04000040 ) );
+            __m128i t2 = _mm_and_si128( str, _mm_set1_epi32( 0x003F03F0 ) );
+            __m128i t3 = _mm_mullo_epi16( t2, _mm_set1_epi32( 0x01000010 ) );
+            str = _mm_or_si128( t1, t3 );
+
+            __m128i indexes = _mm_subs_epu8( str, _mm_set1_epi8( 51 ) );
+            indexes = _mm_sub_epi8( indexes, _mm_cmpgt_epi8( str, _mm_set1_epi8( 25 ) ) );
+            str = _mm_add_epi8( str, _mm_shuffle_epi8( lutOffsets, indexes ) );
+
+            _mm_storeu_si128( reinterpret_cast< __m128i* >( out + outSize ), str );
+            outSize += 16;
+            i += 12;
+        }
+        return i + lcl_encodeScalar( in + i, len - i, out, outSize, outCapacity );
+    }
+
+    __attribute__(( target( "avx2" ) ))
+    size_t lcl_decodeAvx2( const unsigned char* in, size_t len,
+                           char* out, size_t& outSize, size_t outCapacity )
+    {
+        const __m256i lutLo = _mm256_setr_epi8(
+                0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A );
+        const __m256i lutHi = _mm256_setr_epi8(
+                0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10 );
+        const __m256i lutRoll = _mm256_setr_epi8(
+                0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0 );
+        const __m256i mask0F = _mm256_set1_epi8( 0x0F );
+        const __m256i slashes = _mm256_set1_epi8( '/' );
+        const __m256i packOrder = _mm256_setr_epi8(
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1 );
+        // Join the 12 bytes of each lane
+        const __m256i joinOrder = _mm256_setr_epi32( 0, 1, 2, 4, 5, 6, 7, 7 );
+
+        size_t i = 0;
+        while ( i + 32 <= len && outSize + 32 <= outCapacity )
+        {
+            __m256i str = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( in + i ) );
+            __m256i hiNibbles = _mm256_and_si256( _mm256_srli_epi32( str, 4 ), mask0F );
+            __m256i loNibbles = _mm256_and_si256( str, mask0F );
+            __m256i hi = _mm256_shuffle_epi8( lutHi, hiNibbles );
+            __m256i lo = _mm256_shuffle_epi8( lutLo, loNibbles );
+            if ( !_mm256_testz_si256( lo, hi ) )
+                break;
+
+            __m256i roll = _mm256_shuffle_epi8( lutRoll,
+                    _mm256_add_epi8( _mm256_cmpeq_epi8( str, slashes ), hiNibbles ) );
+            str = _mm256_add_epi8( str, roll );
+
+            str = _mm256_maddubs_epi16( str, _mm256_set1_epi32( 0x01400140 ) );
+            str = _mm256_madd_epi16( str, _mm256_set1_epi32( 0x00011000 ) );
+            str = _mm256_shuffle_epi8( str, packOrder );
+            str = _mm256_permutevar8x32_epi32( str, joinOrder );
+
+            _mm256_storeu_si256( reinterpret_cast< __m256i* >( out + outSize ), str );
+            outSize += 24;
+            i += 32;
+        }
+        return i + lcl_decodeScalar( in + i, len - i, out, outSize, outCapacity );
+    }
+
+    __attribute__(( target( "avx2" ) ))
+    size_t lcl_encodeAvx2( const unsigned char* in, size_t len,
+                           char* out, size_t& outSize, size_t outCapacity )
+    {
+        const __m256i spreadOrder = _mm256_setr_epi8(
+                1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10 );
+        const __m256i lutOffsets = _mm256_setr_epi8(
+                65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0,
+                65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0 );
+
+        size_t i = 0;
+        while ( i + 28 <= len && outSize + 32 <= outCapacity )
+        {
+            // Put 12 bytes in each lane, as the shuffles can't cross them
+            __m128i first = _mm_loadu_si128( reinterpret_cast< const __m128i* >( in + i ) );
+            __m128i second = _mm_loadu_si128( reinterpret_cast< const __m128i* >( in + i + 12 ) );
+            __m256i str = _mm256_inserti128_si256( _mm256_castsi128_si256( first ), second, 1 );
+
+            str = _mm256_shuffle_epi8( str, spreadOrder );
+            __m256i t0 = _mm256_and_si256( str, _mm256_set1_epi32( 0x0FC0FC00 ) );
+            __m256i t1 = _mm256_mulhi_epu16( t0, _mm256_set1_epi32( 0x04000040 ) );
+            __m256i t2 = _mm256_and_si256( str, _mm256_set1_epi32( 0x003F03F0 ) );
+            __m256i t3 = _mm256_mullo_epi16( t2, _mm256_set1_epi32( 0x01000010 ) );
+            str = _mm256_or_si256( t1, t3 );
+
+            __m256i indexes = _mm256_subs_epu8( str, _mm256_set1_epi8( 51 ) );
+            indexes = _mm256_sub_epi8( indexes, _mm256_cmpgt_epi8( str, _mm256_set1_epi8( 25 ) ) );
+            str = _mm256_add_epi8( str, _mm256_shuffle_epi8( lutOffsets, indexes ) );
+
+            _mm256_storeu_si256( reinterpret_cast< __m256i* >( out + outSize ), str );
+            outSize += 32;
+            i += 24;
+        }
+        return i + lcl_encodeScalar( in + i, len - i, out, outSize, outCapacity );
+    }
+
+    const libcmis::Base64Kernel sse4Kernel = { "sse4.1", lcl_decodeSse4, lcl_encodeSse4 };
+    const libcmis::Base64Kernel avx2Kernel = { "avx2", lcl_decodeAvx2, lcl_encodeAvx2 };
+#endif
+
+#ifdef BASE64_NEON_KERNEL
+    /** Get the values of 16 base64 characters, and flag the invalid ones.
+      */
+    inline uint8x16_t lcl_neonValues( uint8x16_t chars, uint8x16_t& invalid )
+    {
+        uint8x16_t upper = vsubq_u8( chars, vdupq_n_u8( 'A' ) );
+        uint8x16_t lower = vsubq_u8( chars, vdupq_n_u8( 'a' ) );
+        uint8x16_t digit = vsubq_u8( chars, vdupq_n_u8( '0' ) );
+        uint8x16_t isUpper = vcltq_u8( upper, vdupq_n_u8( 26 ) );
+        uint8x16_t isLower = vcltq_u8( lower, vdupq_n_u8( 26 ) );
+        uint8x16_t isDigit = vcltq_u8( digit, vdupq_n_u8( 10 ) );
+        uint8x16_t isPlus = vceqq_u8( chars, vdupq_n_u8( '+' ) );
+        uint8x16_t isSlash = vceqq_u8( chars, vdupq_n_u8( '/' ) );
+
+        uint8x16_t values = vandq_u8( isUpper, upper );
+        values = vorrq_u8( values, vandq_u8( isLower, vaddq_u8( lower, vdupq_n_u8( 26 ) ) ) );
+        values = vorrq_u8( values, vandq_u8( isDigit, vaddq_u8( digit, vdupq_n_u8( 52 ) ) ) );
+        values = vorrq_u8( values, vandq_u8( isPlus, vdupq_n_u8( 62 ) ) );
+        values = vorrq_u8( values, vandq_u8( isSlash, vdupq_n_u8( 63 ) ) );
+
+        uint8x16_t valid = vorrq_u8( vorrq_u8( isUpper, isLower ),
+                                     vorrq_u8( isDigit, vorrq_u8( isPlus, isSlash ) ) );
+        invalid = vorrq_u8( invalid, vmvnq_u8( valid ) );
+        return values;
+    }
+
+    size_t lcl_decodeNeon( const unsigned char* in, size_t len,
+                           char* out, size_t& outSize, size_t outCapacity )
+    {
+        size_t i = 0;
+        while ( i + 64 <= len && outSize + 48 <= outCapacity )
+        {
+            // Load the 4 characters of 16 blocks, one register for each rank
+            uint8x16x4_t chars = vld4q_u8( in + i );
+            uint8x16_t invalid = vdupq_n_u8( 0 );
+            uint8x16_t a = lcl_neonValues( chars.val[0], invalid );
+            uint8x16_t b = lcl_neonValues( chars.val[1], invalid );
+            uint8x16_t c = lcl_neonValues( chars.val[2], invalid );
+            uint8x16_t d = lcl_neonValues( chars.val[3], invalid );
+            if ( vmaxvq_u8( invalid ) != 0 )
+                break;
+
+            uint8x16x3_t bytes;
+            bytes.val[0] = vorrq_u8( vshlq_n_u8( a, 2 ), vshrq_n_u8( b, 4 ) );
+            bytes.val[1] = vorrq_u8( vshlq_n_u8( b, 4 ), vshrq_n_u8( c, 2 ) );
+            bytes.val[2] = vorrq_u8( vshlq_n_u8( c, 6 ), d );
+            vst3q_u8( reinterpret_cast< uint8_t* >( out + outSize ), bytes );
+            outSize += 48;
+            i += 64;
+        }
+        return i + lcl_decodeScalar( in + i, len - i, out, outSize, outCapacity );
+    }
+
+    size_t lcl_encodeNeon( const unsigned char* in, size_t len,
+                           char* out, size_t& outSize, size_t outCapacity )
+    {
+        const uint8_t* alphabet = reinterpret_cast< const uint8_t* >( libcmis::base64Chars );
+        uint8x16x4_t table;
+        table.val[0] = vld1q_u8( alphabet );
+        table.val[1] = vld1q_u8( alphabet + 16 );
+        table.val[2] = vld1q_u8( alphabet + 32 );
+        table.val[3] = vld1q_u8( alphabet + 48 );
+        const uint8x16_t mask3F = vdupq_n_u8( 0x3F );
+
+        size_t i = 0;
+        while ( i + 48 <= len && outSize + 64 <= outCapacity )
+        {
+            // Load the 3 bytes of 16 blocks, one register for each rank
+            uint8x16x3_t bytes = vld3q_u8( in + i );
+
+            uint8x16x4_t chars;
+            chars.val[0] = vshrq_n_u8( bytes.val[0], 2 );
+            chars.val[1] = vandq_u8( vorrq_u8( vshlq_n_u8( bytes.val[0], 4 ), vshrq_n_u8( bytes.val[1], 4 ) ), mask3F );
+            chars.val[2] = vandq_u8( vorrq_u8( vshlq_n_u8( bytes.val[1], 2 ), vshrq_n_u8( bytes.val[2], 6 ) ), mask3F );
+            chars.val[3] = vandq_u8( bytes.val[2], mask3F );
+            for ( int j = 0; j < 4; ++j )
+                chars.val[j] = vqtbl4q_u8( table, chars.val[j] );
+
+            vst4q_u8( reinterpret_cast< uint8_t* >( out + outSize ), chars );
+            outSize += 64;
+            i += 48;
+        }
+        return i + lcl_encodeScalar( in + i, len - i, out, outSize, outCapacity );
+    }
+
+    const libcmis::Base64Kernel neonKernel = { "neon", lcl_decodeNeon, lcl_encodeNeon };
+#endif
+
+    const libcmis::Base64Kernel scalarKernel = { "scalar", lcl_decodeScalar, lcl_encodeScalar };
+}
+
+namespace libcmis
+{
+    const Base64Kernel& getBase64Kernel( )
+    {
+        static const Base64Kernel* kernel = getBase64Kernels( ).back( );
+        return *kernel;
+    }
+
+    vector< const Base64Kernel* > getBase64Kernels( )
+    {
+        vector< const Base64Kernel* > kernels;
+        kernels.push_back( &scalarKernel );
+#if defined( BASE64_X86_KERNELS )
+        __builtin_cpu_init( );
+        if ( __builtin_cpu_supports( "sse4.1" ) )
+            kernels.push_back( &sse4Kernel );
+        if ( __builtin_cpu_supports( "avx2" ) )
+            kernels.push_back( &avx2Kernel );
+#elif defined( BASE64_NEON_KERNEL )
+        kernels.push_back( &neonKernel );
+#endif
+        return kernels;
+    }
+}
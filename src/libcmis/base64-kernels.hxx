@@ -0,0 +1,72 @@
+/* libcmis
+ * Version: MPL 1.1 / GPLv2+ / LGPLv2+
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License or as specified alternatively below. You may obtain a copy of
+ * the License at http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * Major Contributor(s):
+ *
+ *
+ * All Rights Reserved.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPLv2+"), or
+ * the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+ * in which case the provisions of the GPLv2+ or the LGPLv2+ are applicable
+ * instead of those above.
+ */
+
+#ifndef _BASE64_KERNELS_HXX_
+#define _BASE64_KERNELS_HXX_
+
+#include <cstddef>
+#include <vector>
+
+namespace libcmis
+{
+    /// The base64 alphabet
+    extern const char base64Chars[];
+
+    /// Values of the base64 characters, -1 for the other ones
+    extern const signed char base64Values[256];
+
+    /** Functions converting whole base64 blocks, used by EncodedData.
+
+        Decoding converts blocks of 4 characters to 3 bytes, encoding converts
+        blocks of 3 bytes to 4 characters. The conversion stops at the end of
+        the input, when the output can't hold another block, or before the
+        first block containing a character out of the base64 alphabet: the
+        padding and line breaks are left to the caller.
+
+        The functions return the number of input bytes converted and add the
+        number of output bytes to outSize.
+      */
+    struct Base64Kernel
+    {
+        typedef size_t ( *Converter )( const unsigned char* in, size_t len,
+                                       char* out, size_t& outSize, size_t outCapacity );
+
+        const char* m_name;
+        Converter m_decode;
+        Converter m_encode;
+    };
+
+    /** Get the fastest kernel the CPU supports, chosen on the first call.
+      */
+    const Base64Kernel& getBase64Kernel( );
+
+    /** Get all the kernels the CPU supports, starting with the scalar one.
+      */
+    std::vector< const Base64Kernel* > getBase64Kernels( );
+}
+
+#endif
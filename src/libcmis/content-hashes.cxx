@@ -0,0 +1,339 @@
+/* libcmis
+ * Version: MPL 1.1 / GPLv2+ / LGPLv2+
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License or as specified alternatively below. You may obtain a copy of
+ * the License at http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * Major Contributor(s):
+ *
+ *
+ * All Rights Reserved.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPLv2+"), or
+ * the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+ * in which case the provisions of the GPLv2+ or the LGPLv2+ are applicable
+ * instead of those above.
+ */
+
+
+#include <libcmis/xml-utils.hxx>
+
+#include <algorithm>
+#include <iomanip>
+#include <math.h>
+#include <sstream>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/version.hpp>
+
+#if BOOST_VERSION >= 106800
+#include <boost/uuid/detail/sha1.hpp>
+#else
+#include <boost/uuid/sha1.hpp>
+#endif
+
+using namespace std;
+
+namespace
+{
+    string lcl_sha1Digest( boost::uuids::detail::sha1& sha1 )
+    {
+        unsigned int digest[5];
+        sha1.get_digest( digest );
+
+        stringstream out;
+        // Setup writing mode. Every number must produce eight
+        // hexadecimal digits, including possible leading 0s, or we get
+        // less than 40 digits as result.
+        out << hex << setfill('0') << right;
+        for ( int i = 0; i < 5; ++i )
+            out << setw(8) << digest[i];
+        return out.str();
+    }
+
+    string lcl_hexDigest( const unsigned char* digest, size_t len )
+    {
+        static const char hexChars[] = "0123456789abcdef";
+        string out( len * 2, '0' );
+        for ( size_t i = 0; i < len; ++i )
+        {
+            out[2 * i] = hexChars[ digest[i] >> 4 ];
+            out[2 * i + 1] = hexChars[ digest[i] & 0x0f ];
+        }
+        return out;
+    }
+
+    /** MD5 implementation following RFC 1321, as boost only provides one
+        in its recent versions.
+      */
+    class Md5Hash
+    {
+        private:
+            uint32_t m_state[4];
+            uint64_t m_length;
+            unsigned char m_buffer[64];
+
+        public:
+            Md5Hash( ) :
+                m_length( 0 )
+            {
+                m_state[0] = 0x67452301;
+                m_state[1] = 0xefcdab89;
+                m_state[2] = 0x98badcfe;
+                m_state[3] = 0x10325476;
+            }
+
+            void process( const unsigned char* data, size_t len )
+            {
+                size_t used = m_length % 64;
+                m_length += len;
+
+                if ( used > 0 )
+                {
+                    size_t fill = min( 64 - used, len );
+                    memcpy( m_buffer + used, data, fill );
+                    data += fill;
+                    len -= fill;
+                    if ( used + fill < 64 )
+                        return;
+                    transform( m_buffer );
+                }
+
+                for ( ; len >= 64; data += 64, len -= 64 )
+                    transform( data );
+
+                memcpy( m_buffer, data, len );
+            }
+
+            string getDigest( )
+            {
+                uint64_t bits = m_length * 8;
+                size_t used = m_length % 64;
+                unsigned char padding[64] = { 0x80 };
+                process( padding, used < 56 ? 56 - used : 120 - used );
+
+                unsigned char length[8];
+                for ( int i = 0; i < 8; ++i )
+                    length[i] = ( unsigned char )( bits >> ( 8 * i ) );
+                process( length, 8 );
+
+                unsigned char digest[16];
+                for ( int i = 0; i < 16; ++i )
+                    digest[i] = ( unsigned char )( m_state[i / 4] >> ( 8 * ( i % 4 ) ) );
+                return lcl_hexDigest( digest, 16 );
+            }
+
+        private:
+            struct Constants
+            {
+                uint32_t values[64];
+
+                Constants( )
+                {
+                    for ( int i = 0; i < 64; ++i )
+                        values[i] = ( uint32_t )( fabs( sin( double( i + 1 ) ) ) * 4294967296.0 );
+                }
+            };
+
+            void transform( const unsigned char* block )
+            {
+                static const unsigned int shifts[64] = {
+                    7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+                    5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+                    4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+                    6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21 };
+                static const Constants constants;
+
+                uint32_t words[16];
+                for ( int i = 0; i < 16; ++i )
+                    words[i] = uint32_t( block[4 * i] ) | ( uint32_t( block[4 * i + 1] ) << 8 ) |
+                               ( uint32_t( block[4 * i + 2] ) << 16 ) | ( uint32_t( block[4 * i + 3] ) << 24 );
+
+                uint32_t a = m_state[0];
+                uint32_t b = m_state[1];
+                uint32_t c = m_state[2];
+                uint32_t d = m_state[3];
+                for ( int i = 0; i < 64; ++i )
+                {
+                    uint32_t f;
+                    int g;
+                    if ( i < 16 )
+                    {
+                        f = ( b & c ) | ( ~b & d );
+                        g = i;
+                    }
+                    else if ( i < 32 )
+                    {
+                        f = ( d & b ) | ( ~d & c );
+                        g = ( 5 * i + 1 ) % 16;
+                    }
+                    else if ( i < 48 )
+                    {
+                        f = b ^ c ^ d;
+                        g = ( 3 * i + 5 ) % 16;
+                    }
+                    else
+                    {
+                        f = c ^ ( b | ~d );
+                        g = ( 7 * i ) % 16;
+                    }
+
+                    uint32_t rotated = a + f + constants.values[i] + words[g];
+                    a = d;
+                    d = c;
+                    c = b;
+                    b += ( rotated << shifts[i] ) | ( rotated >> ( 32 - shifts[i] ) );
+                }
+
+                m_state[0] += a;
+                m_state[1] += b;
+                m_state[2] += c;
+                m_state[3] += d;
+            }
+    };
+
+    /** Microsoft QuickXorHash used by OneDrive and SharePoint.
+
+        The n-th byte of the data is xor'ed in a 160 bits circular register
+        at the bit ( n * 11 ) % 160: all the bytes at the same position modulo
+        160 end at the same place, so they are first xor'ed together in a lane
+        and the lanes are only shifted in the register at the end.
+      */
+    class QuickXorHash
+    {
+        private:
+            static const size_t WIDTH = 160;
+            static const size_t SHIFT = 11;
+
+            unsigned char m_lanes[WIDTH];
+            size_t m_lane;
+            uint64_t m_length;
+
+        public:
+            QuickXorHash( ) :
+                m_lane( 0 ),
+                m_length( 0 )
+            {
+                memset( m_lanes, 0, sizeof( m_lanes ) );
+            }
+
+            void process( const unsigned char* data, size_t len )
+            {
+                m_length += len;
+
+                size_t i = 0;
+                for ( ; i < len && m_lane != 0; ++i )
+                {
+                    m_lanes[m_lane] ^= data[i];
+                    m_lane = ( m_lane + 1 ) % WIDTH;
+                }
+
+                for ( ; i + WIDTH <= len; i += WIDTH )
+                {
+                    for ( size_t j = 0; j < WIDTH; ++j )
+                        m_lanes[j] ^= data[i + j];
+                }
+
+                for ( ; i < len; ++i )
+                {
+                    m_lanes[m_lane] ^= data[i];
+                    m_lane = ( m_lane + 1 ) % WIDTH;
+                }
+            }
+
+            string getDigest( )
+            {
+                unsigned char digest[WIDTH / 8];
+                memset( digest, 0, sizeof( digest ) );
+
+                for ( size_t lane = 0; lane < WIDTH; ++lane )
+                {
+                    size_t bit = ( lane * SHIFT ) % WIDTH;
+                    for ( size_t i = 0; i < 8; ++i )
+                    {
+                        if ( m_lanes[lane] & ( 1 << i ) )
+                        {
+                            size_t pos = ( bit + i ) % WIDTH;
+                            digest[pos / 8] ^= ( unsigned char )( 1 << ( pos % 8 ) );
+                        }
+                    }
+                }
+
+                // The length is xor'ed in the last 8 bytes
+                for ( size_t i = 0; i < 8; ++i )
+                    digest[WIDTH / 8 - 8 + i] ^= ( unsigned char )( m_length >> ( 8 * i ) );
+
+                return libcmis::base64encode( string( ( char* )digest, sizeof( digest ) ) );
+            }
+    };
+}
+
+namespace libcmis
+{
+    std::string sha1( const std::string& str )
+    {
+        boost::uuids::detail::sha1 sha1;
+        sha1.process_bytes( str.c_str(), str.size() );
+        return lcl_sha1Digest( sha1 );
+    }
+
+    std::string sha1( std::istream& stream )
+    {
+        boost::uuids::detail::sha1 sha1;
+        char buf[8192];
+        while ( stream.read( buf, sizeof( buf ) ) || stream.gcount( ) > 0 )
+            sha1.process_bytes( buf, stream.gcount( ) );
+        return lcl_sha1Digest( sha1 );
+    }
+
+    map< string, string > computeContentHashes( istream& stream, const set< string >& algorithms )
+    {
+        boost::scoped_ptr< Md5Hash > md5;
+        boost::scoped_ptr< boost::uuids::detail::sha1 > sha1;
+        boost::scoped_ptr< QuickXorHash > quickXor;
+        if ( algorithms.find( "md5" ) != algorithms.end( ) )
+            md5.reset( new Md5Hash( ) );
+        if ( algorithms.find( "sha-1" ) != algorithms.end( ) )
+            sha1.reset( new boost::uuids::detail::sha1( ) );
+        if ( algorithms.find( "quickxorhash" ) != algorithms.end( ) )
+            quickXor.reset( new QuickXorHash( ) );
+
+        map< string, string > hashes;
+        if ( !md5 && !sha1 && !quickXor )
+            return hashes;
+
+        vector< char > buf( 65536 );
+        while ( stream.read( &buf[0], buf.size( ) ) || stream.gcount( ) > 0 )
+        {
+            const unsigned char* data = ( const unsigned char* )&buf[0];
+            size_t len = stream.gcount( );
+            if ( md5 )
+                md5->process( data, len );
+            if ( sha1 )
+                sha1->process_bytes( data, len );
+            if ( quickXor )
+                quickXor->process( data, len );
+        }
+
+        if ( md5 )
+            hashes[ "md5" ] = md5->getDigest( );
+        if ( sha1 )
+            hashes[ "sha-1" ] = lcl_sha1Digest( *sha1 );
+        if ( quickXor )
+            hashes[ "quickxorhash" ] = quickXor->getDigest( );
+        return hashes;
+    }
+}
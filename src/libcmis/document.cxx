@@ -28,7 +28,10 @@
 
 #include <libcmis/document.hxx>
 
+#include <boost/algorithm/string.hpp>
+
 #include <libcmis/folder.hxx>
+#include <libcmis/xml-utils.hxx>
 
 using namespace std;
 using libcmis::PropertyPtrMap;
@@ -74,11 +77,87 @@ namespace libcmis
     {
         long contentLength = 0;
         PropertyPtrMap::const_iterator it = getProperties( ).find( string( "cmis:contentStreamLength" ) );
-        if ( it != getProperties( ).end( )  && it->second != NULL && !it->second->getLongs( ).empty( ) )
-            contentLength = it->second->getLongs( ).front( );
+        if ( it != getProperties( ).end( )  && it->second != NULL && !it->second->getLongValues( ).empty( ) )
+            contentLength = it->second->getLongValues( ).front( );
         return contentLength;
     }
 
+    string Document::getContentUrl( )
+    {
+        return string( );
+    }
+
+    map< string, string > Document::getContentHashes( )
+    {
+        map< string, string > hashes;
+        PropertyPtrMap::const_iterator it = getProperties( ).find( string( "cmis:contentStreamHash" ) );
+        if ( it != getProperties( ).end( ) && it->second != NULL )
+        {
+            // Values are formatted as {algorithm}hash
+            vector< string > values = it->second->getStrings( );
+            for ( vector< string >::iterator valueIt = values.begin( ); valueIt != values.end( ); ++valueIt )
+            {
+                string value = trim( *valueIt );
+                size_t end = value.find( '}' );
+                if ( value.empty( ) || value[0] != '{' || end == string::npos )
+                    continue;
+
+                string algorithm = boost::to_lower_copy( value.substr( 1, end - 1 ) );
+                string hash = trim( value.substr( end + 1 ) );
+                if ( !algorithm.empty( ) && !hash.empty( ) )
+                    hashes[ algorithm ] = hash;
+            }
+        }
+        return hashes;
+    }
+
+    bool Document::setContentStreamIfChanged( boost::shared_ptr< ostream > os, string contentType,
+                                              string filename, bool overwrite )
+    {
+        if ( !os.get( ) )
+            throw libcmis::Exception( "Missing stream" );
+
+        map< string, string > remoteHashes = getContentHashes( );
+        bool sameContent = !remoteHashes.empty( ) &&
+                           ( filename.empty( ) || filename == getContentFilename( ) );
+
+        if ( sameContent )
+        {
+            set< string > algorithms;
+            for ( map< string, string >::iterator it = remoteHashes.begin( ); it != remoteHashes.end( ); ++it )
+                algorithms.insert( it->first );
+
+            // The stream needs to be read again for the upload
+            istream is( os->rdbuf( ) );
+            streampos start = is.tellg( );
+            map< string, string > localHashes;
+            if ( start != streampos( -1 ) )
+            {
+                localHashes = computeContentHashes( is, algorithms );
+                is.clear( );
+                is.seekg( start );
+            }
+
+            sameContent = !localHashes.empty( );
+            for ( map< string, string >::iterator it = localHashes.begin( );
+                  sameContent && it != localHashes.end( ); ++it )
+            {
+                // Hexadecimal hashes may not be in lower case, base64 ones are case sensitive
+                string remoteHash = remoteHashes[ it->first ];
+                if ( it->first == "quickxorhash" )
+                    sameContent = remoteHash == it->second;
+                else
+                    sameContent = boost::iequals( remoteHash, it->second );
+            }
+        }
+
+        if ( sameContent )
+            return false;
+
+        setContentStream( os, contentType, filename, overwrite );
+        return true;
+    }
+
     // LCOV_EXCL_START
     string Document::toString( )
     {
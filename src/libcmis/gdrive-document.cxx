@@ -133,6 +133,11 @@ boost::shared_ptr< istream > GDriveDocument::getContentStream( string streamId )
     return stream;
 }
 
+string GDriveDocument::getContentUrl( )
+{
+    return getDownloadUrl( );
+}
+
 void GDriveDocument::uploadStream( boost::shared_ptr< ostream > os, 
                                    string contentType )
 {
@@ -147,7 +152,7 @@ void GDriveDocument::uploadStream( boost::shared_ptr< ostream > os,
     headers.push_back( string( "Content-Type: " ) + contentType );
     try
     {
-        string res = getSession()->httpPatchRequest( putUrl, *is, headers )->getStream()->str();
+        string res = getSession()->httpPatchRequest( putUrl, *is, headers )->getBody( );
     }
     catch ( const CurlException& e )
     {
@@ -217,7 +222,7 @@ vector< libcmis::DocumentPtr > GDriveDocument::getAllVersions( )
     string res;
     try
     {
-        res = getSession()->httpGetRequest( versionUrl )->getStream()->str();
+        res = getSession()->httpGetRequest( versionUrl )->getBody( );
     }
     catch ( const CurlException& e )
     {
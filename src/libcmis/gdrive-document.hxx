@@ -64,6 +64,8 @@ class GDriveDocument : public libcmis::Document, public GDriveObject
         virtual std::vector< libcmis::FolderPtr > getParents( );
         virtual boost::shared_ptr< std::istream > getContentStream( 
                 std::string streamId = std::string( ) );
+
+        virtual std::string getContentUrl( );
         
         virtual void setContentStream( boost::shared_ptr< std::ostream > os, 
                                        std::string contentType,
@@ -36,6 +36,41 @@
 using namespace std;
 using namespace libcmis;
 
+namespace
+{
+    /** Create the children objects while the listing is received.
+      */
+    class GDriveChildrenParser : public JsonListParser
+    {
+        private:
+            GDriveSession* m_session;
+            vector< libcmis::ObjectPtr >& m_children;
+
+        public:
+            GDriveChildrenParser( GDriveSession* session, vector< libcmis::ObjectPtr >& children ) :
+                JsonListParser( "files" ),
+                m_session( session ),
+                m_children( children )
+            {
+            }
+
+        protected:
+            virtual void itemParsed( Json item )
+            {
+                ObjectPtr child;
+                if ( item["mimeType"].toString( ) == GDRIVE_FOLDER_MIME_TYPE )
+                    child.reset( new GDriveFolder( m_session, item ) );
+                else
+                    child.reset( new GDriveDocument( m_session, item ) );
+                m_children.push_back( child );
+            }
+
+        private:
+            GDriveChildrenParser( const GDriveChildrenParser& );
+            GDriveChildrenParser& operator=( const GDriveChildrenParser& );
+    };
+}
+
 GDriveFolder::GDriveFolder( GDriveSession* session ):
     libcmis::Object( session ),
     GDriveObject( session )
@@ -61,31 +96,31 @@ vector< libcmis::ObjectPtr > GDriveFolder::getChildren( )
     // we send a single query to search for objects where parents
     // include the folderID.
     string query = GDRIVE_METADATA_LINK + "?q=\"" + getId( ) + "\"+in+parents+and+trashed+=+false" +
-        "&fields=files(kind,id,name,parents,mimeType,createdTime,modifiedTime,thumbnailLink,size)";
+        "&pageSize=1000&fields=nextPageToken,files(kind,id,name,parents,mimeType,createdTime,"
+        "modifiedTime,thumbnailLink,size,md5Checksum,sha256Checksum)";
 
-    string res;
-    try
+    // The objects are created while each page is received, the pages
+    // are chained by nextPageToken
+    string pageToken;
+    do
     {
-        res = getSession( )->httpGetRequest( query )->getStream()->str();
-    }
-    catch ( const CurlException& e )
-    {
-        throw e.getCmisException( );
-    }
-
-    Json jsonRes = Json::parse( res );
-    Json::JsonVector objs = jsonRes["files"].getList( );
-    
-    // Create children objects from Json objects
-    for(unsigned int i = 0; i < objs.size(); i++)
-    {   
-        ObjectPtr child;
-        if ( objs[i]["mimeType"].toString( ) == GDRIVE_FOLDER_MIME_TYPE )
-            child.reset( new GDriveFolder( getSession( ), objs[i] ) );
-        else
-            child.reset( new GDriveDocument( getSession( ), objs[i] ) );
-        children.push_back( child );
-    }   
+        string url = query;
+        if ( !pageToken.empty( ) )
+            url += "&pageToken=" + libcmis::escape( pageToken );
+
+        boost::shared_ptr< GDriveChildrenParser > parser( new GDriveChildrenParser( getSession( ), children ) );
+        try
+        {
+            getSession( )->httpGetRequest( url, parser );
+        }
+        catch ( const CurlException& e )
+        {
+            throw e.getCmisException( );
+        }
+        parser->finish( );
+
+        pageToken = parser->getMember( "nextPageToken" ).toString( );
+    } while ( !pageToken.empty( ) );
     
     return children;
 }
@@ -104,7 +139,7 @@ string GDriveFolder::uploadProperties( Json properties )
     try
     {
         response = getSession()->httpPostRequest( metaUrl, is, "application/json" )
-                                    ->getStream( )->str( );
+                                    ->getBody( );
     }
     catch ( const CurlException& e )
     {
@@ -173,18 +208,29 @@ libcmis::DocumentPtr GDriveFolder::createDocument(
 vector< string > GDriveFolder::removeTree( 
     bool /*allVersions*/, 
     libcmis::UnfileObjects::Type /*unfile*/, 
-    bool /*continueOnError*/ ) 
+    bool continueOnError ) 
 {
     try
-    {   
+    {
         getSession( )->httpDeleteRequest( GDRIVE_METADATA_LINK + getId( ) );
     }
     catch ( const CurlException& e )
     {
-        throw e.getCmisException( );
+        if ( e.getErrorCode( ) != CURLE_HTTP_RETURNED_ERROR || e.getHttpStatus( ) == 404 )
+            throw e.getCmisException( );
+
+        // The server doesn't tell which objects couldn't be deleted:
+        // delete the tree from here to find them out.
+        try
+        {
+            return getSession( )->removeTreeConcurrently( *this, continueOnError );
+        }
+        catch ( const libcmis::Exception& )
+        {
+            throw e.getCmisException( );
+        }
     }
-    
-    // Nothing to return here
+
     return vector< string >( );
 }
 
@@ -32,6 +32,7 @@
 #include "gdrive-allowable-actions.hxx"
 #include "gdrive-repository.hxx"
 #include "gdrive-utils.hxx"
+#include "property-type-registry.hxx"
 
 using namespace std;
 using namespace libcmis;
@@ -119,8 +120,21 @@ void GDriveObject::initializeFromJson ( Json json, string id, string name )
             }
         }
     }
+
+    // Expose the checksums as the standard content stream hashes
+    vector< string > hashes;
+    if ( !json["md5Checksum"].toString( ).empty( ) )
+        hashes.push_back( "{md5}" + json["md5Checksum"].toString( ) );
+    if ( !json["sha256Checksum"].toString( ).empty( ) )
+        hashes.push_back( "{sha-256}" + json["sha256Checksum"].toString( ) );
+    if ( !hashes.empty( ) )
+    {
+        m_properties[ "cmis:contentStreamHash" ] = PropertyPtr(
+                new Property( libcmis::getContentStreamHashPropertyType( ), hashes ) );
+    }
+
     m_refreshTimestamp = time( NULL );
-    
+
     // Create AllowableActions
     bool isFolder = json["mimeType"].toString( ) == GDRIVE_FOLDER_MIME_TYPE;
     m_allowableActions.reset( new GdriveAllowableActions( isFolder ) );
@@ -196,7 +210,7 @@ libcmis::ObjectPtr GDriveObject::updateProperties(
         throw e.getCmisException( );
     }
     
-    string res = response->getStream( )->str( );
+    const string& res = response->getBody( );
     Json jsonRes = Json::parse( res );
     libcmis::ObjectPtr updated( new GDriveObject ( getSession( ), jsonRes ) );
 
@@ -211,7 +225,7 @@ void GDriveObject::refresh( )
     string res;
     try
     {
-        res  = getSession()->httpGetRequest( getUrl( ) )->getStream( )->str( );
+        res  = getSession()->httpGetRequest( getUrl( ) )->getBody( );
     }
     catch ( const CurlException& e )
     {
@@ -251,7 +265,7 @@ void GDriveObject::move( FolderPtr /*source*/, FolderPtr destination )
     {   
         throw e.getCmisException( );
     }
-    string res = response->getStream( )->str( );
+    const string& res = response->getBody( );
     Json jsonRes = Json::parse( res );
 
     refreshImpl( jsonRes );
@@ -262,7 +276,8 @@ string GDriveObject::getUrl( )
     // thumbnailLink causes some operations to fail with internal server error,
     // see https://issuetracker.google.com/issues/36760667
     return GDRIVE_METADATA_LINK + getId( ) +
-                "?fields=kind,id,name,parents,mimeType,createdTime,modifiedTime,size";
+                "?fields=kind,id,name,parents,mimeType,createdTime,modifiedTime,size,"
+                "md5Checksum,sha256Checksum";
 }
 
 vector< string> GDriveObject::getMultiStringProperty( const string& propertyName )
@@ -39,6 +39,13 @@
 
 using namespace std;
 
+namespace
+{
+    const string GDRIVE_OBJECT_FIELDS =
+        "kind,id,name,parents,mimeType,createdTime,modifiedTime,thumbnailLink,size,"
+        "md5Checksum,sha256Checksum";
+}
+
 GDriveSession::GDriveSession ( string baseUrl,
                                string username,
                                string password,
@@ -125,18 +132,21 @@ libcmis::ObjectPtr GDriveSession::getObject( string objectId )
     }
     // Run the http request to get the properties definition
     string res;
-    string objectLink = GDRIVE_METADATA_LINK + objectId +
-         "?fields=kind,id,name,parents,mimeType,createdTime,modifiedTime,thumbnailLink,size";
+    string objectLink = GDRIVE_METADATA_LINK + objectId + "?fields=" + GDRIVE_OBJECT_FIELDS;
     try
     {
-        res = httpGetRequest( objectLink )->getStream()->str();
+        res = httpGetRequest( objectLink )->getBody( );
     }
     catch ( const CurlException& e )
     {
         throw e.getCmisException( );
     }
     Json jsonRes = Json::parse( res );
+    return getObjectFromJson( jsonRes );
+}
 
+libcmis::ObjectPtr GDriveSession::getObjectFromJson( Json& jsonRes )
+{
     // If we have a folder, then convert the object
     // into a GDriveFolder otherwise, convert it
     // into a GDriveDocument
@@ -161,6 +171,236 @@ libcmis::ObjectPtr GDriveSession::getObject( string objectId )
     return object;
 }
 
+vector< libcmis::ObjectResult > GDriveSession::getObjects( const vector< string >& ids,
+                                                          const libcmis::BatchOptions& options )
+{
+    vector< HttpTransferPtr > requests;
+    for ( vector< string >::const_iterator it = ids.begin( ); it != ids.end( ); ++it )
+        requests.push_back( HttpTransferPtr( new HttpTransfer( "GET",
+                        GDRIVE_BATCH_PATH + *it + "?fields=" + GDRIVE_OBJECT_FIELDS ) ) );
+
+    httpRunBatchRequests( requests, options );
+
+    vector< libcmis::ObjectResult > results;
+    for ( size_t i = 0; i < ids.size( ); ++i )
+    {
+        const string& id = ids[i];
+        try
+        {
+            if ( id == "root" )
+                results.push_back( libcmis::ObjectResult( id, getRootFolder( ) ) );
+            else if ( requests[i]->isFailed( ) )
+                results.push_back( libcmis::ObjectResult( id, requests[i]->getError( )->getCmisException( ) ) );
+            else
+            {
+                // A bad part of the batch response only fails its object
+                if ( !requests[i]->getResponse( ) )
+                    throw libcmis::Exception( "No response for object " + id );
+                Json jsonRes = Json::parse( requests[i]->getResponse( )->getBody( ) );
+                if ( jsonRes.getDataType( ) != Json::json_object )
+                    throw libcmis::Exception( "Invalid JSON response for object " + id );
+
+                libcmis::ObjectPtr object = getObjectFromJson( jsonRes );
+                if ( !object )
+                    throw libcmis::Exception( "No such node: " + id, "objectNotFound" );
+                results.push_back( libcmis::ObjectResult( id, object ) );
+            }
+        }
+        catch ( const libcmis::Exception& e )
+        {
+            results.push_back( libcmis::ObjectResult( id, e ) );
+        }
+        catch ( const exception& e )
+        {
+            results.push_back( libcmis::ObjectResult( id, libcmis::Exception( e.what( ) ) ) );
+        }
+    }
+
+    return results;
+}
+
+vector< libcmis::UpdateResult > GDriveSession::bulkUpdateProperties( const vector< string >& ids,
+        const libcmis::PropertyPtrMap& properties,
+        const vector< string >& addSecondaryTypes,
+        const vector< string >& removeSecondaryTypes,
+        const libcmis::BatchOptions& options )
+{
+    vector< libcmis::UpdateResult > results;
+    if ( !addSecondaryTypes.empty( ) || !removeSecondaryTypes.empty( ) )
+    {
+        for ( vector< string >::const_iterator it = ids.begin( ); it != ids.end( ); ++it )
+            results.push_back( libcmis::UpdateResult( *it,
+                        libcmis::Exception( "Secondary Types not supported", "constraint" ) ) );
+        return results;
+    }
+
+    // Only get the new version of the files, not the whole metadata
+    string body = GdriveUtils::toGdriveJson( properties ).toString( );
+    vector< string > headers;
+    headers.push_back( "Content-Type: application/json" );
+
+    vector< HttpTransferPtr > requests;
+    for ( vector< string >::const_iterator it = ids.begin( ); it != ids.end( ); ++it )
+        requests.push_back( HttpTransferPtr( new HttpTransfer( "PATCH",
+                        GDRIVE_BATCH_PATH + *it + "?fields=id,version", headers, body ) ) );
+
+    httpRunBatchRequests( requests, options );
+
+    for ( size_t i = 0; i < ids.size( ); ++i )
+    {
+        try
+        {
+            if ( requests[i]->isFailed( ) )
+                throw requests[i]->getError( )->getCmisException( );
+
+            Json jsonRes = Json::parse( requests[i]->getResponse( )->getBody( ) );
+            results.push_back( libcmis::UpdateResult( ids[i], jsonRes["id"].toString( ),
+                        jsonRes["version"].toString( ) ) );
+        }
+        catch ( const libcmis::Exception& e )
+        {
+            results.push_back( libcmis::UpdateResult( ids[i], e ) );
+        }
+    }
+
+    return results;
+}
+
+vector< string > GDriveSession::deleteObjects( const vector< string >& ids,
+                                               const libcmis::BatchOptions& options )
+{
+    vector< HttpTransferPtr > requests;
+    for ( vector< string >::const_iterator it = ids.begin( ); it != ids.end( ); ++it )
+        requests.push_back( HttpTransferPtr( new HttpTransfer( "DELETE", GDRIVE_BATCH_PATH + *it ) ) );
+
+    httpRunBatchRequests( requests, options );
+
+    vector< string > failed;
+    for ( size_t i = 0; i < ids.size( ); ++i )
+    {
+        if ( requests[i]->isFailed( ) && requests[i]->getHttpStatus( ) != 404 )
+            failed.push_back( ids[i] );
+    }
+    return failed;
+}
+
+vector< string > GDriveSession::getContentChanges( string& changeLogToken )
+{
+    vector< string > ids;
+    try
+    {
+        if ( changeLogToken.empty( ) )
+        {
+            string res = httpGetRequest( GDRIVE_CHANGES_LINK + "/startPageToken" )->getBody( );
+            changeLogToken = Json::parse( res )["startPageToken"].toString( );
+            return ids;
+        }
+
+        // The change pages are chained by nextPageToken, the last page
+        // gives the token to start from next time.
+        string pageToken = changeLogToken;
+        while ( !pageToken.empty( ) )
+        {
+            string url = GDRIVE_CHANGES_LINK + "?pageToken=" + libcmis::escape( pageToken ) +
+                "&fields=nextPageToken,newStartPageToken,changes(fileId)";
+            Json jsonRes = Json::parse( httpGetRequest( url )->getBody( ) );
+
+            Json::JsonVector changes = jsonRes["changes"].getList( );
+            for ( Json::JsonVector::iterator it = changes.begin( ); it != changes.end( ); ++it )
+                ids.push_back( ( *it )["fileId"].toString( ) );
+
+            pageToken = jsonRes["nextPageToken"].toString( );
+            string newStartToken = jsonRes["newStartPageToken"].toString( );
+            if ( !newStartToken.empty( ) )
+                changeLogToken = newStartToken;
+        }
+    }
+    catch ( const CurlException& e )
+    {
+        throw e.getCmisException( );
+    }
+    return ids;
+}
+
+void GDriveSession::httpRunBatchRequests( vector< HttpTransferPtr >& requests,
+                                          const libcmis::BatchOptions& options )
+{
+    // Group the requests in batches and send these concurrently
+    const string boundary( "libcmis_batch_boundary" );
+    size_t batchSize = min( options.getMaxBatchSize( ), GDRIVE_BATCH_MAX_SIZE );
+
+    vector< HttpTransferPtr > batches;
+    vector< string > parts;
+    for ( size_t i = 0; i < requests.size( ); ++i )
+    {
+        HttpTransferPtr request = requests[i];
+        string part = request->getMethod( ) + " " + request->getUrl( );
+        for ( vector< string >::const_iterator it = request->getHeaders( ).begin( );
+                it != request->getHeaders( ).end( ); ++it )
+            part += "\r\n" + *it;
+        if ( !request->getBody( ).empty( ) )
+            part += "\r\n\r\n" + request->getBody( );
+        parts.push_back( part );
+
+        if ( parts.size( ) == batchSize || i == requests.size( ) - 1 )
+        {
+            vector< string > headers;
+            headers.push_back( "Content-Type:multipart/mixed; boundary=" + boundary );
+            batches.push_back( HttpTransferPtr( new HttpTransfer( "POST", GDRIVE_BATCH_LINK, headers,
+                            GdriveUtils::createBatchBody( parts, boundary ) ) ) );
+            parts.clear( );
+        }
+    }
+
+    httpRunConcurrentRequests( batches, options.getMaxConcurrency( ) );
+
+    for ( size_t batch = 0; batch < batches.size( ); ++batch )
+    {
+        HttpTransferPtr batchRequest = batches[batch];
+        map< size_t, pair< long, string > > responses;
+        if ( !batchRequest->isFailed( ) )
+        {
+            libcmis::HttpResponsePtr response = batchRequest->getResponse( );
+            map< string, string >& headers = response->getHeaders( );
+            string contentType = headers["Content-Type"];
+            if ( contentType.empty( ) )
+                contentType = headers["content-type"];
+            responses = GdriveUtils::parseBatchResponse( response->getBody( ), contentType );
+        }
+
+        size_t first = batch * batchSize;
+        size_t last = min( first + batchSize, requests.size( ) );
+        for ( size_t i = first; i < last; ++i )
+        {
+            HttpTransferPtr request = requests[i];
+            if ( batchRequest->isFailed( ) )
+            {
+                request->setResult( libcmis::HttpResponsePtr( ), batchRequest->getHttpStatus( ),
+                                    batchRequest->getError( ) );
+                continue;
+            }
+
+            map< size_t, pair< long, string > >::iterator it = responses.find( i - first );
+            if ( it == responses.end( ) )
+            {
+                boost::shared_ptr< CurlException > error( new CurlException( "Missing batch response",
+                            CURLE_RECV_ERROR, request->getUrl( ), 0 ) );
+                request->setResult( libcmis::HttpResponsePtr( ), 0, error );
+                continue;
+            }
+
+            libcmis::HttpResponsePtr response( new libcmis::HttpResponse( ) );
+            response->setBody( it->second.second );
+
+            boost::shared_ptr< CurlException > error;
+            if ( it->second.first < 200 || it->second.first >= 300 )
+                error.reset( new CurlException( "Batch request failed", CURLE_HTTP_RETURNED_ERROR,
+                            request->getUrl( ), it->second.first ) );
+            request->setResult( response, it->second.first, error );
+        }
+    }
+}
+
 libcmis::ObjectPtr GDriveSession::getObjectByPath( string path )
 {
     size_t pos = 0;
@@ -196,7 +436,7 @@ libcmis::ObjectPtr GDriveSession::getObjectByPath( string path )
             string res;
             try
             {
-                res = httpGetRequest( childIdUrl )->getStream()->str();
+                res = httpGetRequest( childIdUrl )->getBody( );
             }
             catch ( const CurlException& e )
             {
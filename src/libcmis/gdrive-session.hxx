@@ -31,6 +31,7 @@
 #include <libcmis/repository.hxx>
 
 #include "base-session.hxx"
+#include "json-utils.hxx"
 
 class GDriveSession : public BaseSession
 {
@@ -50,6 +51,32 @@ class GDriveSession : public BaseSession
 
         virtual libcmis::ObjectPtr getObject( std::string id );
 
+        virtual std::vector< libcmis::ObjectResult > getObjects( const std::vector< std::string >& ids,
+                                                                 const libcmis::BatchOptions& options = libcmis::BatchOptions( ) );
+
+        virtual std::vector< libcmis::UpdateResult > bulkUpdateProperties( const std::vector< std::string >& ids,
+                const libcmis::PropertyPtrMap& properties,
+                const std::vector< std::string >& addSecondaryTypes = std::vector< std::string >( ),
+                const std::vector< std::string >& removeSecondaryTypes = std::vector< std::string >( ),
+                const libcmis::BatchOptions& options = libcmis::BatchOptions( ) );
+
+        virtual std::vector< std::string > deleteObjects( const std::vector< std::string >& ids,
+                const libcmis::BatchOptions& options = libcmis::BatchOptions( ) );
+
+        virtual std::vector< std::string > getContentChanges( std::string& changeLogToken );
+
+        libcmis::ObjectPtr getObjectFromJson( Json& jsonRes );
+
+        /** Run the requests using the Drive batch endpoint, several batches
+            being sent concurrently. The URL of the requests is the path on the
+            server, like "/drive/v3/files/id".
+
+            Once run, each request holds its own response or error, just like
+            after HttpSession::httpRunConcurrentRequests( ).
+          */
+        void httpRunBatchRequests( std::vector< HttpTransferPtr >& requests,
+                                   const libcmis::BatchOptions& options );
+
         virtual libcmis::ObjectPtr getObjectByPath( std::string path );
 
         virtual libcmis::ObjectTypePtr getType( std::string id );
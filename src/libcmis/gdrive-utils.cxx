@@ -28,6 +28,10 @@
 
 #include "gdrive-utils.hxx"
 
+#include <cstdlib>
+
+#include <boost/algorithm/string.hpp>
+
 #include <libcmis/xml-utils.hxx>
 
 #include "json-utils.hxx"
@@ -35,6 +39,37 @@
 using namespace std;
 using libcmis::PropertyPtrMap;
 
+namespace
+{
+    // Split a block of text in its headers and the remaining content
+    // after the first empty line.
+    string lcl_splitHeaders( const string& part, map< string, string >& headers )
+    {
+        size_t pos = 0;
+        while ( pos < part.size( ) )
+        {
+            size_t end = part.find( '\n', pos );
+            if ( end == string::npos )
+                end = part.size( );
+            string line = part.substr( pos, end - pos );
+            pos = end + 1;
+
+            if ( !line.empty( ) && line[line.size( ) - 1] == '\r' )
+                line.erase( line.size( ) - 1 );
+            if ( line.empty( ) )
+                return pos < part.size( ) ? part.substr( pos ) : string( );
+
+            size_t sepPos = line.find( ':' );
+            if ( sepPos != string::npos )
+                headers[ boost::to_lower_copy( line.substr( 0, sepPos ) ) ] =
+                    libcmis::trim( line.substr( sepPos + 1 ) );
+            else
+                headers[ line ] = string( );
+        }
+        return string( );
+    }
+}
+
 string GdriveUtils::toCmisKey( const string& key )
 {
     string convertedKey;
@@ -219,3 +254,76 @@ vector< string > GdriveUtils::parseGdriveProperty( string key, Json json )
     return values;
 }
 
+string GdriveUtils::createBatchBody( const vector< string >& requests, const string& boundary )
+{
+    string body;
+    for ( size_t i = 0; i < requests.size( ); ++i )
+    {
+        body += "--" + boundary + "\r\n";
+        body += "Content-Type: application/http\r\n";
+        body += "Content-ID: <item" + to_string( i ) + ">\r\n\r\n";
+        body += requests[i] + "\r\n\r\n";
+    }
+    body += "--" + boundary + "--\r\n";
+    return body;
+}
+
+map< size_t, pair< long, string > > GdriveUtils::parseBatchResponse( const string& body,
+                                                                     const string& contentType )
+{
+    map< size_t, pair< long, string > > results;
+
+    size_t boundaryPos = contentType.find( "boundary=" );
+    if ( boundaryPos == string::npos )
+        return results;
+    string boundary = contentType.substr( boundaryPos + 9 );
+    boundary = boundary.substr( 0, boundary.find( ';' ) );
+    if ( boundary.size( ) > 1 && boundary[0] == '"' )
+        boundary = boundary.substr( 1, boundary.size( ) - 2 );
+
+    const string delimiter = "--" + boundary;
+    size_t pos = body.find( delimiter );
+    while ( pos != string::npos )
+    {
+        size_t start = pos + delimiter.size( );
+        // The closing delimiter is followed by --
+        if ( body.compare( start, 2, "--" ) == 0 )
+            break;
+
+        // Skip the end of the delimiter line
+        start = body.find( '\n', start );
+        if ( start == string::npos )
+            break;
+        ++start;
+
+        size_t next = body.find( delimiter, start );
+        string part = body.substr( start, next == string::npos ? string::npos : next - start );
+        pos = next;
+
+        map< string, string > partHeaders;
+        string httpResponse = lcl_splitHeaders( part, partHeaders );
+
+        // Content-ID: <response-item3>
+        string contentId = partHeaders["content-id"];
+        size_t idPos = contentId.find( "item" );
+        if ( idPos == string::npos )
+            continue;
+        size_t index = strtoul( contentId.c_str( ) + idPos + 4, NULL, 10 );
+
+        // HTTP/1.1 200 OK
+        long status = 0;
+        size_t statusPos = httpResponse.find( ' ' );
+        if ( statusPos != string::npos )
+            status = strtol( httpResponse.c_str( ) + statusPos + 1, NULL, 10 );
+
+        size_t lineEnd = httpResponse.find( '\n' );
+        map< string, string > responseHeaders;
+        string responseBody;
+        if ( lineEnd != string::npos )
+            responseBody = lcl_splitHeaders( httpResponse.substr( lineEnd + 1 ), responseHeaders );
+
+        results[index] = make_pair( status, libcmis::trim( responseBody ) );
+    }
+
+    return results;
+}
@@ -28,7 +28,10 @@
 #ifndef _GDRIVE_UTILS_HXX_
 #define _GDRIVE_UTILS_HXX_
 
+#include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <libcmis/property.hxx>
 
@@ -37,6 +40,10 @@
 static const std::string GDRIVE_FOLDER_MIME_TYPE = "application/vnd.google-apps.folder" ;
 static const std::string GDRIVE_UPLOAD_LINK = "https://www.googleapis.com/upload/drive/v3/files/";
 static const std::string GDRIVE_METADATA_LINK = "https://www.googleapis.com/drive/v3/files/";
+static const std::string GDRIVE_CHANGES_LINK = "https://www.googleapis.com/drive/v3/changes";
+static const std::string GDRIVE_BATCH_LINK = "https://www.googleapis.com/batch/drive/v3";
+static const std::string GDRIVE_BATCH_PATH = "/drive/v3/files/";
+static const unsigned int GDRIVE_BATCH_MAX_SIZE = 100;
 
 class GdriveUtils
 {
@@ -62,6 +69,16 @@ class GdriveUtils
         
         // Parse a Gdrive property value to CMIS values
         static std::vector< std::string > parseGdriveProperty( std::string key, Json jsonValue );
+
+        // Create the multipart/mixed body of a batch request out of relative request lines
+        // like "GET /drive/v3/files/id". The Content-ID of each part is its index.
+        static std::string createBatchBody( const std::vector< std::string >& requests,
+                                            const std::string& boundary );
+
+        // Split a multipart/mixed batch response into the HTTP status and body of each
+        // part, indexed by the Content-ID of the request part
+        static std::map< size_t, std::pair< long, std::string > > parseBatchResponse(
+                                            const std::string& body, const std::string& contentType );
 };
 
 #endif
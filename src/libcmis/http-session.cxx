@@ -29,9 +29,13 @@
 #include "http-session.hxx"
 
 #include <cctype>
+#include <map>
 #include <memory>
 #include <string>
 #include <assert.h>
+#include <stdlib.h>
+
+#include <boost/algorithm/string.hpp>
 
 #include <libxml/parser.h>
 #include <libxml/tree.h>
@@ -46,9 +50,29 @@ using namespace std;
 
 namespace
 {
+    /** Check if a Content-Type header value is for an XML document, like
+        text/xml, application/xml or application/atom+xml.
+      */
+    bool lcl_isXmlContentType( const string& contentType )
+    {
+        string mediaType = contentType.substr( 0, contentType.find( ';' ) );
+        mediaType = boost::to_lower_copy( libcmis::trim( mediaType ) );
+        return mediaType == "text/xml" || mediaType == "application/xml" ||
+               boost::ends_with( mediaType, "+xml" );
+    }
+
+    /** Data given to the headers callback.
+      */
+    struct HeadersData
+    {
+        libcmis::HttpResponse* m_response;
+        HttpContentHandler* m_contentHandler;
+    };
+
     size_t lcl_getHeaders( void *ptr, size_t size, size_t nmemb, void *userdata )
     {
-        libcmis::HttpResponse* response = static_cast< libcmis::HttpResponse* >( userdata );
+        HeadersData* data = static_cast< HeadersData* >( userdata );
+        libcmis::HttpResponse* response = data->m_response;
 
         string buf( ( const char* ) ptr, size * nmemb );
 
@@ -63,6 +87,18 @@ namespace
 
             if ( "Content-Transfer-Encoding" == name )
                 response->getData( )->setEncoding( value );
+            else if ( boost::iequals( name, "Content-Type" ) )
+            {
+                if ( data->m_contentHandler != NULL )
+                    data->m_contentHandler->contentTypeReceived( *response, value );
+            }
+            else if ( boost::iequals( name, "Content-Length" ) )
+            {
+                // Size the body buffer once instead of growing it while receiving
+                long length = atol( value.c_str( ) );
+                if ( length > 0 )
+                    response->reserveBody( size_t( length ) );
+            }
         }
 
         return nmemb;
@@ -81,6 +117,10 @@ namespace
         char* out = ( char * ) buffer;
         is.read( out, size * nmemb );
 
+        // Don't send a truncated body if the source failed or was cancelled
+        if ( is.bad( ) )
+            return CURL_READFUNC_ABORT;
+
         return is.gcount( ) / size;
     }
 
@@ -134,6 +174,44 @@ namespace
         return CURL_SEEKFUNC_OK;
     }
 
+    /** State of one of the requests run by HttpSession::httpRunConcurrentRequests( ).
+      */
+    class ConcurrentTransfer
+    {
+        public:
+            HttpTransferPtr m_request;
+            libcmis::HttpResponsePtr m_response;
+            boost::shared_ptr< libcmis::EncodedData > m_data;
+            HeadersData m_headersData;
+            istringstream m_body;
+            struct curl_slist* m_headers;
+            char m_errBuff[CURL_ERROR_SIZE];
+
+            ConcurrentTransfer( HttpTransferPtr request ) :
+                m_request( request ),
+                m_response( new libcmis::HttpResponse( ) ),
+                m_data( ),
+                m_headersData( { m_response.get( ), request->getContentHandler( ).get( ) } ),
+                m_body( request->getBody( ) ),
+                m_headers( NULL )
+            {
+                m_errBuff[0] = 0;
+                if ( request->getOutputStream( ) )
+                    m_data.reset( new libcmis::EncodedData( request->getOutputStream( ).get( ) ) );
+                else
+                    m_data = m_response->getData( );
+            }
+
+            ~ConcurrentTransfer( )
+            {
+                curl_slist_free_all( m_headers );
+            }
+
+        private:
+            ConcurrentTransfer( const ConcurrentTransfer& ) = delete;
+            ConcurrentTransfer& operator=( const ConcurrentTransfer& ) = delete;
+    };
+
     template<typename T>
     class ScopeGuard
     {
@@ -156,6 +234,38 @@ namespace
     };
 }
 
+void XmlContentHandler::contentTypeReceived( libcmis::HttpResponse& response, const string& contentType )
+{
+    response.setXmlContent( lcl_isXmlContentType( contentType ) );
+}
+
+HttpContentHandlerPtr XmlContentHandler::getInstance( )
+{
+    static HttpContentHandlerPtr instance( new XmlContentHandler( ) );
+    return instance;
+}
+
+HttpTransfer::HttpTransfer( string method, string url, vector< string > headers, string body ) :
+    m_method( method ),
+    m_url( url ),
+    m_headers( headers ),
+    m_body( body ),
+    m_output( ),
+    m_contentHandler( ),
+    m_response( ),
+    m_httpStatus( 0 ),
+    m_error( )
+{
+}
+
+void HttpTransfer::setResult( libcmis::HttpResponsePtr response, long httpStatus,
+                             boost::shared_ptr< CurlException > error )
+{
+    m_response = response;
+    m_httpStatus = httpStatus;
+    m_error = error;
+}
+
 HttpSession::HttpSession( string username, string password, bool noSslCheck,
                           libcmis::OAuth2DataPtr oauth2, bool verbose,
                           libcmis::CurlInitProtocolsFunction initProtocolsFunction) :
@@ -265,7 +375,8 @@ string& HttpSession::getPassword( )
     return m_password;
 }
 
-libcmis::HttpResponsePtr HttpSession::httpGetRequest( string url )
+libcmis::HttpResponsePtr HttpSession::httpGetRequest( string url, boost::shared_ptr< streambuf > bodySink,
+                                                      HttpContentHandlerPtr contentHandler )
 {
     checkOAuth2( url );
 
@@ -274,12 +385,15 @@ libcmis::HttpResponsePtr HttpSession::httpGetRequest( string url )
     initProtocols( );
 
     libcmis::HttpResponsePtr response( new libcmis::HttpResponse( ) );
+    if ( bodySink )
+        response->setBodySink( bodySink );
 
     curl_easy_setopt( m_curlHandle, CURLOPT_WRITEFUNCTION, lcl_bufferData );
     curl_easy_setopt( m_curlHandle, CURLOPT_WRITEDATA, response->getData( ).get( ) );
 
+    HeadersData headersData = { response.get( ), contentHandler.get( ) };
     curl_easy_setopt( m_curlHandle, CURLOPT_HEADERFUNCTION, &lcl_getHeaders );
-    curl_easy_setopt( m_curlHandle, CURLOPT_WRITEHEADER, response.get() );
+    curl_easy_setopt( m_curlHandle, CURLOPT_WRITEHEADER, &headersData );
 
     // fix Cloudoku too many redirects error
     // note: though curl doc says -1 is the default for MAXREDIRS, the error i got
@@ -305,7 +419,7 @@ libcmis::HttpResponsePtr HttpSession::httpGetRequest( string url )
             {
                 // Avoid infinite recursive call
                 m_refreshedToken = true;
-                response = httpGetRequest( url );
+                response = httpGetRequest( url, bodySink, contentHandler );
                 m_refreshedToken = false;
             }
             catch (const CurlException& )
@@ -339,8 +453,9 @@ libcmis::HttpResponsePtr HttpSession::httpPatchRequest( string url, istream& is,
     curl_easy_setopt( m_curlHandle, CURLOPT_WRITEFUNCTION, lcl_bufferData );
     curl_easy_setopt( m_curlHandle, CURLOPT_WRITEDATA, response->getData( ).get( ) );
 
+    HeadersData headersData = { response.get( ), NULL };
     curl_easy_setopt( m_curlHandle, CURLOPT_HEADERFUNCTION, &lcl_getHeaders );
-    curl_easy_setopt( m_curlHandle, CURLOPT_WRITEHEADER, response.get() );
+    curl_easy_setopt( m_curlHandle, CURLOPT_WRITEHEADER, &headersData );
 
     curl_easy_setopt( m_curlHandle, CURLOPT_MAXREDIRS, 20);
 
@@ -414,7 +529,8 @@ libcmis::HttpResponsePtr HttpSession::httpPatchRequest( string url, istream& is,
     return response;
 }
 
-libcmis::HttpResponsePtr HttpSession::httpPutRequest( string url, istream& is, vector< string > headers )
+libcmis::HttpResponsePtr HttpSession::httpPutRequest( string url, istream& is, vector< string > headers,
+                                                      HttpContentHandlerPtr contentHandler )
 {
     checkOAuth2( url );
 
@@ -432,8 +548,9 @@ libcmis::HttpResponsePtr HttpSession::httpPutRequest( string url, istream& is, v
     curl_easy_setopt( m_curlHandle, CURLOPT_WRITEFUNCTION, lcl_bufferData );
     curl_easy_setopt( m_curlHandle, CURLOPT_WRITEDATA, response->getData( ).get( ) );
 
+    HeadersData headersData = { response.get( ), contentHandler.get( ) };
     curl_easy_setopt( m_curlHandle, CURLOPT_HEADERFUNCTION, &lcl_getHeaders );
-    curl_easy_setopt( m_curlHandle, CURLOPT_WRITEHEADER, response.get() );
+    curl_easy_setopt( m_curlHandle, CURLOPT_WRITEHEADER, &headersData );
 
     curl_easy_setopt( m_curlHandle, CURLOPT_MAXREDIRS, 20);
 
@@ -473,7 +590,7 @@ libcmis::HttpResponsePtr HttpSession::httpPutRequest( string url, istream& is, v
         {
             // Remember that we don't want 100-Continue for the future requests
             m_no100Continue = true;
-            response = httpPutRequest( url, isBackup, headers );
+            response = httpPutRequest( url, isBackup, headers, contentHandler );
         }
 
         // If the access token is expired, we get 401 error,
@@ -489,7 +606,7 @@ libcmis::HttpResponsePtr HttpSession::httpPutRequest( string url, istream& is, v
             {
                 // Avoid infinite recursive call
                 m_refreshedToken = true;
-                response = httpPutRequest( url, isBackup, headers );
+                response = httpPutRequest( url, isBackup, headers, contentHandler );
                 m_refreshedToken = false;
             }
             catch (const CurlException& )
@@ -507,14 +624,25 @@ libcmis::HttpResponsePtr HttpSession::httpPutRequest( string url, istream& is, v
 }
 
 libcmis::HttpResponsePtr HttpSession::httpPostRequest( const string& url, istream& is,
-    const string& contentType, bool redirect )
+    const string& contentType, bool redirect, HttpContentHandlerPtr contentHandler )
 {
     checkOAuth2( url );
 
-    // Duplicate istream in case we need to retry
-    string isStr( static_cast< stringstream const&>( stringstream( ) << is.rdbuf( ) ).str( ) );
-
-    istringstream isOriginal( isStr ), isBackup( isStr );
+    // Rewind the stream in case we need to retry: only duplicate it if it
+    // can't seek, to avoid holding big uploads in memory.
+    istream* body = &is;
+    boost::shared_ptr< istringstream > copy;
+    is.seekg( 0, ios::end );
+    long size = is.tellg( );
+    if ( size < 0 )
+    {
+        is.clear( );
+        copy.reset( new istringstream( static_cast< stringstream const&>( stringstream( ) << is.rdbuf( ) ).str( ) ) );
+        body = copy.get( );
+        body->seekg( 0, ios::end );
+        size = body->tellg( );
+    }
+    body->seekg( 0, ios::beg );
 
     // Reset the handle for the request
     curl_easy_reset( m_curlHandle );
@@ -525,25 +653,22 @@ libcmis::HttpResponsePtr HttpSession::httpPostRequest( const string& url, istrea
     curl_easy_setopt( m_curlHandle, CURLOPT_WRITEFUNCTION, lcl_bufferData );
     curl_easy_setopt( m_curlHandle, CURLOPT_WRITEDATA, response->getData( ).get( ) );
 
+    HeadersData headersData = { response.get( ), contentHandler.get( ) };
     curl_easy_setopt( m_curlHandle, CURLOPT_HEADERFUNCTION, &lcl_getHeaders );
-    curl_easy_setopt( m_curlHandle, CURLOPT_WRITEHEADER, response.get() );
+    curl_easy_setopt( m_curlHandle, CURLOPT_WRITEHEADER, &headersData );
 
     curl_easy_setopt( m_curlHandle, CURLOPT_MAXREDIRS, 20);
 
-    // Get the stream length
-    is.seekg( 0, ios::end );
-    long size = is.tellg( );
-    is.seekg( 0, ios::beg );
     curl_easy_setopt( m_curlHandle, CURLOPT_POSTFIELDSIZE, size );
-    curl_easy_setopt( m_curlHandle, CURLOPT_READDATA, &isOriginal );
+    curl_easy_setopt( m_curlHandle, CURLOPT_READDATA, body );
     curl_easy_setopt( m_curlHandle, CURLOPT_READFUNCTION, lcl_readStream );
     curl_easy_setopt( m_curlHandle, CURLOPT_POST, 1 );
 #if (LIBCURL_VERSION_MAJOR > 7) || (LIBCURL_VERSION_MAJOR == 7 && LIBCURL_VERSION_MINOR >= 85)
     curl_easy_setopt( m_curlHandle, CURLOPT_SEEKFUNCTION, lcl_seekStream );
-    curl_easy_setopt( m_curlHandle, CURLOPT_SEEKDATA, &isOriginal );
+    curl_easy_setopt( m_curlHandle, CURLOPT_SEEKDATA, body );
 #else
     curl_easy_setopt( m_curlHandle, CURLOPT_IOCTLFUNCTION, lcl_ioctlStream );
-    curl_easy_setopt( m_curlHandle, CURLOPT_IOCTLDATA, &isOriginal );
+    curl_easy_setopt( m_curlHandle, CURLOPT_IOCTLDATA, body );
 #endif
 
     vector< string > headers;
@@ -570,7 +695,9 @@ libcmis::HttpResponsePtr HttpSession::httpPostRequest( const string& url, istrea
         {
             // Remember that we don't want 100-Continue for the future requests
             m_no100Continue = true;
-            response = httpPostRequest( url, isBackup, contentType, redirect );
+            body->clear( );
+            body->seekg( 0, ios::beg );
+            response = httpPostRequest( url, *body, contentType, redirect, contentHandler );
         }
 
         // If the access token is expired, we get 401 error,
@@ -585,7 +712,9 @@ libcmis::HttpResponsePtr HttpSession::httpPostRequest( const string& url, istrea
             {
                 // Avoid infinite recursive call
                 m_refreshedToken = true;
-                response = httpPostRequest( url, isBackup, contentType, redirect );
+                body->clear( );
+                body->seekg( 0, ios::beg );
+                response = httpPostRequest( url, *body, contentType, redirect, contentHandler );
                 m_refreshedToken = false;
             }
             catch (const CurlException& )
@@ -646,6 +775,191 @@ void HttpSession::httpDeleteRequest( string url )
     m_refreshedToken = false;
 }
 
+void HttpSession::httpRunConcurrentRequests( vector< HttpTransferPtr >& requests,
+                                             unsigned int maxConcurrency )
+{
+    if ( requests.empty( ) )
+        return;
+
+    checkOAuth2( requests.front( )->getUrl( ) );
+
+    runConcurrently( requests, maxConcurrency );
+
+    // If the access token is expired, we get 401 errors: refresh
+    // the token once and resend the requests that failed because of it.
+    vector< HttpTransferPtr > unauthorized;
+    for ( vector< HttpTransferPtr >::iterator it = requests.begin( ); it != requests.end( ); ++it )
+    {
+        if ( ( *it )->isFailed( ) && ( *it )->getHttpStatus( ) == 401 )
+            unauthorized.push_back( *it );
+    }
+
+    if ( !unauthorized.empty( ) && !getRefreshToken( ).empty( ) )
+    {
+        oauth2Refresh( );
+        runConcurrently( unauthorized, maxConcurrency );
+    }
+}
+
+void HttpSession::runConcurrently( vector< HttpTransferPtr >& requests, unsigned int maxConcurrency )
+{
+    if ( maxConcurrency == 0 )
+        maxConcurrency = 1;
+
+    CURLM* multiHandle = curl_multi_init( );
+    map< CURL*, boost::shared_ptr< ConcurrentTransfer > > transfers;
+    size_t next = 0;
+
+    while ( next < requests.size( ) || !transfers.empty( ) )
+    {
+        // Start new transfers until we reach the concurrency limit
+        while ( next < requests.size( ) && transfers.size( ) < maxConcurrency )
+        {
+            boost::shared_ptr< ConcurrentTransfer > transfer( new ConcurrentTransfer( requests[next++] ) );
+            HttpTransfer& request = *transfer->m_request;
+
+            CURL* handle = curl_easy_init( );
+            initProtocols( handle );
+            initHandle( handle );
+
+            curl_easy_setopt( handle, CURLOPT_URL, request.getUrl( ).c_str( ) );
+            curl_easy_setopt( handle, CURLOPT_WRITEFUNCTION, lcl_bufferData );
+            curl_easy_setopt( handle, CURLOPT_WRITEDATA, transfer->m_data.get( ) );
+            curl_easy_setopt( handle, CURLOPT_HEADERFUNCTION, &lcl_getHeaders );
+            curl_easy_setopt( handle, CURLOPT_WRITEHEADER, &transfer->m_headersData );
+            curl_easy_setopt( handle, CURLOPT_MAXREDIRS, 20 );
+            curl_easy_setopt( handle, CURLOPT_ERRORBUFFER, transfer->m_errBuff );
+
+            const string& method = request.getMethod( );
+            bool hasBody = method != "GET" && method != "DELETE";
+            if ( method == "POST" )
+            {
+                curl_easy_setopt( handle, CURLOPT_POST, 1 );
+                curl_easy_setopt( handle, CURLOPT_POSTFIELDSIZE, long( request.getBody( ).size( ) ) );
+            }
+            else if ( hasBody )
+            {
+                curl_easy_setopt( handle, CURLOPT_UPLOAD, 1 );
+                curl_easy_setopt( handle, CURLOPT_INFILESIZE, long( request.getBody( ).size( ) ) );
+            }
+            if ( method != "GET" && method != "POST" && method != "PUT" )
+                curl_easy_setopt( handle, CURLOPT_CUSTOMREQUEST, method.c_str( ) );
+
+            if ( hasBody )
+            {
+                curl_easy_setopt( handle, CURLOPT_READDATA, &transfer->m_body );
+                curl_easy_setopt( handle, CURLOPT_READFUNCTION, lcl_readStream );
+#if (LIBCURL_VERSION_MAJOR > 7) || (LIBCURL_VERSION_MAJOR == 7 && LIBCURL_VERSION_MINOR >= 85)
+                curl_easy_setopt( handle, CURLOPT_SEEKFUNCTION, lcl_seekStream );
+                curl_easy_setopt( handle, CURLOPT_SEEKDATA, &transfer->m_body );
+#else
+                curl_easy_setopt( handle, CURLOPT_IOCTLFUNCTION, lcl_ioctlStream );
+                curl_easy_setopt( handle, CURLOPT_IOCTLDATA, &transfer->m_body );
+#endif
+            }
+
+            vector< string > headers = request.getHeaders( );
+            addSessionHeaders( headers );
+            if ( hasBody && m_no100Continue )
+                headers.push_back( "Expect:" );
+            for ( vector< string >::iterator it = headers.begin( ); it != headers.end( ); ++it )
+                transfer->m_headers = curl_slist_append( transfer->m_headers, it->c_str( ) );
+            curl_easy_setopt( handle, CURLOPT_HTTPHEADER, transfer->m_headers );
+
+            curl_multi_add_handle( multiHandle, handle );
+            transfers[handle] = transfer;
+        }
+
+        int stillRunning = 0;
+        curl_multi_perform( multiHandle, &stillRunning );
+
+        // Collect the finished transfers
+        int msgsLeft = 0;
+        CURLMsg* msg = NULL;
+        while ( ( msg = curl_multi_info_read( multiHandle, &msgsLeft ) ) != NULL )
+        {
+            if ( msg->msg != CURLMSG_DONE )
+                continue;
+
+            CURL* handle = msg->easy_handle;
+            CURLcode errCode = msg->data.result;
+            boost::shared_ptr< ConcurrentTransfer > transfer = transfers[handle];
+
+            long httpStatus = 0;
+            curl_easy_getinfo( handle, CURLINFO_RESPONSE_CODE, &httpStatus );
+
+            boost::shared_ptr< CurlException > error;
+            bool isHttpError = errCode == CURLE_HTTP_RETURNED_ERROR;
+            if ( CURLE_OK != errCode && !( m_noHttpErrors && isHttpError ) )
+                error.reset( new CurlException( string( transfer->m_errBuff ), errCode,
+                                                transfer->m_request->getUrl( ), httpStatus ) );
+            else
+                transfer->m_data->finish( );
+
+            transfer->m_request->setResult( transfer->m_response, httpStatus, error );
+
+            curl_multi_remove_handle( multiHandle, handle );
+            curl_easy_cleanup( handle );
+            transfers.erase( handle );
+        }
+
+        if ( stillRunning > 0 )
+            curl_multi_wait( multiHandle, NULL, 0, 1000, NULL );
+    }
+
+    curl_multi_cleanup( multiHandle );
+}
+
+void HttpSession::addSessionHeaders( vector< string >& headers )
+{
+    if ( m_oauth2Handler != NULL && !m_oauth2Handler->getHttpHeader( ).empty() )
+        headers.push_back( m_oauth2Handler->getHttpHeader( ) );
+}
+
+void HttpSession::initHandle( CURL* handle )
+{
+    curl_easy_setopt( handle, CURLOPT_FOLLOWLOCATION, 1 );
+
+    // Activate the cookie engine
+    curl_easy_setopt( handle, CURLOPT_COOKIEFILE, "" );
+
+    // OAuth2 authentication is passed as a header, see addSessionHeaders
+    if ( ( m_oauth2Handler == NULL || m_oauth2Handler->getHttpHeader( ).empty() ) &&
+         !getUsername().empty() )
+    {
+        curl_easy_setopt( handle, CURLOPT_HTTPAUTH, m_authMethod );
+        curl_easy_setopt( handle, CURLOPT_USERNAME, getUsername().c_str() );
+        curl_easy_setopt( handle, CURLOPT_PASSWORD, getPassword().c_str() );
+    }
+
+    // Set the proxy configuration if any
+    if ( !libcmis::SessionFactory::getProxy( ).empty() )
+    {
+        curl_easy_setopt( handle, CURLOPT_PROXY, libcmis::SessionFactory::getProxy( ).c_str() );
+        curl_easy_setopt( handle, CURLOPT_NOPROXY, libcmis::SessionFactory::getNoProxy( ).c_str() );
+        const string& proxyUser = libcmis::SessionFactory::getProxyUser( );
+        const string& proxyPass = libcmis::SessionFactory::getProxyPass( );
+        if ( !proxyUser.empty( ) && !proxyPass.empty( ) )
+        {
+            curl_easy_setopt( handle, CURLOPT_PROXYAUTH, CURLAUTH_ANY );
+            curl_easy_setopt( handle, CURLOPT_PROXYUSERNAME, proxyUser.c_str( ) );
+            curl_easy_setopt( handle, CURLOPT_PROXYPASSWORD, proxyPass.c_str( ) );
+        }
+    }
+
+    if ( !m_noHttpErrors )
+        curl_easy_setopt( handle, CURLOPT_FAILONERROR, 1 );
+
+    if ( m_verbose )
+        curl_easy_setopt( handle, CURLOPT_VERBOSE, 1 );
+
+    if ( m_noSSLCheck )
+    {
+        curl_easy_setopt( handle, CURLOPT_SSL_VERIFYHOST, 0 );
+        curl_easy_setopt( handle, CURLOPT_SSL_VERIFYPEER, 0 );
+    }
+}
+
 void HttpSession::checkCredentials( )
 {
     // Check that we have the complete credentials
@@ -678,11 +992,15 @@ void HttpSession::httpRunRequest( string url, vector< string > headers, bool red
         headers_slist.reset(curl_slist_append(headers_slist.release(), it->c_str()));
 
     // If we are using OAuth2, then add the proper header with token to authenticate
-    // Otherwise, just set the credentials normally using in libcurl options
-    if ( m_oauth2Handler != NULL && !m_oauth2Handler->getHttpHeader( ).empty() )
+    // Otherwise, just set the credentials normally using in libcurl options.
+    // The requests getting or refreshing the tokens don't send the access token.
+    string oauth2Header;
+    if ( m_oauth2Handler != NULL && !m_inOAuth2Authentication )
+        oauth2Header = m_oauth2Handler->getHttpHeader( );
+    if ( !oauth2Header.empty( ) )
     {
         headers_slist.reset(curl_slist_append(headers_slist.release(),
-                                           m_oauth2Handler->getHttpHeader().c_str()));
+                                           oauth2Header.c_str()));
     }
     else if ( !getUsername().empty() )
     {
@@ -814,8 +1132,26 @@ void HttpSession::checkOAuth2( string url )
     if ( m_oauth2Handler )
     {
         m_oauth2Handler->setOAuth2Parser( OAuth2Providers::getOAuth2Parser( url ) );
-        if ( m_oauth2Handler->getAccessToken().empty() && !m_inOAuth2Authentication )
+        if ( m_inOAuth2Authentication )
+            return;
+
+        // Another session of the same account may have shared its tokens
+        if ( m_oauth2Handler->getAccessToken().empty() && !m_oauth2Handler->loadTokens( ) )
             oauth2Authenticate( );
+
+        // Refresh the access token before it expires rather than after a 401
+        // error, to avoid sending the request and its body twice
+        if ( m_oauth2Handler->isExpiring( ) && !getRefreshToken( ).empty( ) )
+        {
+            try
+            {
+                oauth2Refresh( );
+            }
+            catch ( const libcmis::Exception& )
+            {
+                // The request will get a 401 error and try again
+            }
+        }
     }
 }
 
@@ -885,24 +1221,34 @@ string HttpSession::getRefreshToken( )
 
 void HttpSession::oauth2Refresh( )
 {
+    // A token request failing with a 401 error can't be fixed by refreshing
+    // the token again
+    if ( m_inOAuth2Authentication )
+        throw libcmis::Exception( "Couldn't refresh token " );
+
     const ScopeGuard<bool> inOauth2Guard(m_inOAuth2Authentication, true);
     m_oauth2Handler->refresh( );
 }
 
 void HttpSession::initProtocols( )
+{
+    initProtocols( m_curlHandle );
+}
+
+void HttpSession::initProtocols( CURL* handle )
 {
 #if (LIBCURL_VERSION_MAJOR > 7) || (LIBCURL_VERSION_MAJOR == 7 && LIBCURL_VERSION_MINOR >= 85)
     auto const protocols = "https,http";
-    curl_easy_setopt(m_curlHandle, CURLOPT_PROTOCOLS_STR, protocols);
-    curl_easy_setopt(m_curlHandle, CURLOPT_REDIR_PROTOCOLS_STR, protocols);
+    curl_easy_setopt(handle, CURLOPT_PROTOCOLS_STR, protocols);
+    curl_easy_setopt(handle, CURLOPT_REDIR_PROTOCOLS_STR, protocols);
 #else
     const unsigned long protocols = CURLPROTO_HTTP | CURLPROTO_HTTPS;
-    curl_easy_setopt(m_curlHandle, CURLOPT_PROTOCOLS, protocols);
-    curl_easy_setopt(m_curlHandle, CURLOPT_REDIR_PROTOCOLS, protocols);
+    curl_easy_setopt(handle, CURLOPT_PROTOCOLS, protocols);
+    curl_easy_setopt(handle, CURLOPT_REDIR_PROTOCOLS, protocols);
 #endif
     if (m_CurlInitProtocolsFunction)
     {
-        (*m_CurlInitProtocolsFunction)(m_curlHandle);
+        (*m_CurlInitProtocolsFunction)(handle);
     }
 }
 
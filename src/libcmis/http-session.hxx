@@ -33,6 +33,7 @@
 #include <vector>
 #include <string>
 
+#include <boost/shared_ptr.hpp>
 #include <curl/curl.h>
 #include <libxml/xmlstring.h>
 #include <libxml/xpath.h>
@@ -93,6 +94,87 @@ class CurlException : public std::exception
         libcmis::Exception getCmisException ( ) const;
 };
 
+/** Chooses how a response body is consumed, once its Content-Type is known.
+
+    The requests needing more than the body buffer pass one to HttpSession.
+  */
+class HttpContentHandler
+{
+    public:
+        virtual ~HttpContentHandler( ) { };
+
+        /** Called before the body is received. The redirections are received
+            too: the last call is for the final response.
+          */
+        virtual void contentTypeReceived( libcmis::HttpResponse& response,
+                                          const std::string& contentType ) = 0;
+};
+typedef boost::shared_ptr< HttpContentHandler > HttpContentHandlerPtr;
+
+/** Parse the XML bodies while they are received, for the requests reading
+    their response with HttpResponse::getXmlDoc( ).
+  */
+class XmlContentHandler : public HttpContentHandler
+{
+    public:
+        virtual void contentTypeReceived( libcmis::HttpResponse& response,
+                                          const std::string& contentType );
+
+        /** Get the instance shared by all the requests.
+          */
+        static HttpContentHandlerPtr getInstance( );
+};
+
+/** Request run along with other ones by HttpSession::httpRunConcurrentRequests( ).
+
+    Once the requests have been run, each of them holds either its response
+    or the error it failed with.
+  */
+class HttpTransfer
+{
+    private:
+        std::string m_method;
+        std::string m_url;
+        std::vector< std::string > m_headers;
+        std::string m_body;
+        boost::shared_ptr< std::ostream > m_output;
+        HttpContentHandlerPtr m_contentHandler;
+
+        libcmis::HttpResponsePtr m_response;
+        long m_httpStatus;
+        boost::shared_ptr< CurlException > m_error;
+
+    public:
+        HttpTransfer( std::string method, std::string url,
+                     std::vector< std::string > headers = std::vector< std::string >( ),
+                     std::string body = std::string( ) );
+
+        const std::string& getMethod( ) const { return m_method; }
+        const std::string& getUrl( ) const { return m_url; }
+        const std::vector< std::string >& getHeaders( ) const { return m_headers; }
+        const std::string& getBody( ) const { return m_body; }
+
+        /** Write the response body to the given stream as it is received,
+            rather than keeping it in the response. The response stream
+            will then be empty.
+          */
+        void setOutputStream( boost::shared_ptr< std::ostream > output ) { m_output = output; }
+        boost::shared_ptr< std::ostream > getOutputStream( ) { return m_output; }
+
+        void setContentHandler( HttpContentHandlerPtr handler ) { m_contentHandler = handler; }
+        HttpContentHandlerPtr getContentHandler( ) { return m_contentHandler; }
+
+        libcmis::HttpResponsePtr getResponse( ) { return m_response; }
+        long getHttpStatus( ) const { return m_httpStatus; }
+
+        bool isFailed( ) const { return m_error.get( ) != NULL; }
+        boost::shared_ptr< CurlException > getError( ) { return m_error; }
+
+        void setResult( libcmis::HttpResponsePtr response, long httpStatus,
+                        boost::shared_ptr< CurlException > error );
+};
+typedef boost::shared_ptr< HttpTransfer > HttpTransferPtr;
+
 class HttpSession
 {
     protected:
@@ -137,19 +219,43 @@ class HttpSession
           */
         virtual void setOAuth2Data( libcmis::OAuth2DataPtr oauth2 );
 
-        libcmis::HttpResponsePtr httpGetRequest( std::string url );
+        /** Send a GET request.
+
+            \param bodySink
+                if set, the response body is written to it while it is
+                received instead of being kept in the response.
+            \param contentHandler
+                if set, chooses how to consume the response body
+          */
+        libcmis::HttpResponsePtr httpGetRequest( std::string url,
+                boost::shared_ptr< std::streambuf > bodySink = boost::shared_ptr< std::streambuf >( ),
+                HttpContentHandlerPtr contentHandler = HttpContentHandlerPtr( ) );
+        libcmis::HttpResponsePtr httpGetRequest( std::string url, HttpContentHandlerPtr contentHandler )
+        {
+            return httpGetRequest( url, boost::shared_ptr< std::streambuf >( ), contentHandler );
+        }
         libcmis::HttpResponsePtr httpPatchRequest( std::string url,
                                                  std::istream& is,
                                                  std::vector< std::string > headers );
         libcmis::HttpResponsePtr httpPutRequest( std::string url,
                                                  std::istream& is,
-                                                 std::vector< std::string > headers );
+                                                 std::vector< std::string > headers,
+                                                 HttpContentHandlerPtr contentHandler = HttpContentHandlerPtr( ) );
         libcmis::HttpResponsePtr httpPostRequest( const std::string& url,
                                                   std::istream& is,
                                                   const std::string& contentType,
-                                                  bool redirect = true );
+                                                  bool redirect = true,
+                                                  HttpContentHandlerPtr contentHandler = HttpContentHandlerPtr( ) );
         void httpDeleteRequest( std::string url );
 
+        /** Run several requests concurrently, on at most maxConcurrency
+            connections at the same time.
+
+            The HTTP errors aren't thrown, but stored in each request.
+          */
+        void httpRunConcurrentRequests( std::vector< HttpTransferPtr >& requests,
+                                        unsigned int maxConcurrency );
+
         long getHttpStatus( );
 
         void setNoSSLCertificateCheck( bool noCheck );
@@ -169,11 +275,23 @@ class HttpSession
                                     std::vector< std::string > headers = std::vector< std::string > ( ),
                                     bool redirect = true );
 
+        /** Add the headers the session needs on every request. This is used
+            for the concurrent requests which can't go through httpRunRequest.
+          */
+        virtual void addSessionHeaders( std::vector< std::string >& headers );
+
+        /** Set the options shared by all requests on a curl handle: credentials,
+            proxy and SSL checks.
+          */
+        void initHandle( CURL* handle );
+
     private:
         void checkCredentials( );
         void checkOAuth2( std::string url );
         void oauth2Refresh( );
         void initProtocols( );
+        void initProtocols( CURL* handle );
+        void runConcurrently( std::vector< HttpTransferPtr >& requests, unsigned int maxConcurrency );
 };
 
 #endif
@@ -28,80 +28,691 @@
 
 #include "json-utils.hxx"
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+
 #include <boost/date_time/posix_time/posix_time.hpp>
-#include <boost/property_tree/ptree.hpp>
-#include <boost/property_tree/json_parser.hpp>
 
 #include <libcmis/exception.hxx>
 #include <libcmis/xml-utils.hxx>
 
 using namespace std;
 using namespace libcmis;
-using namespace boost;
-using boost::property_tree::ptree;
-using boost::property_tree::json_parser::read_json;
-using boost::property_tree::json_parser::write_json;
+
+/** Node of a JSON document.
+
+    The nodes and the strings they point to are allocated in the arena of
+    their document and never freed before it.
+  */
+struct JsonNode
+{
+    enum Kind { Null, Bool, Number, String, Object, Array };
+
+    JsonNode( Kind kind ) :
+        m_kind( kind ),
+        m_type( -1 ),
+        m_key( "" ),
+        m_keySize( 0 ),
+        m_value( "" ),
+        m_valueSize( 0 ),
+        m_first( NULL ),
+        m_last( NULL ),
+        m_next( NULL )
+    {
+    }
+
+    Kind m_kind;
+
+    /// Json::Type of the node, -1 until it has been computed
+    mutable atomic< int > m_type;
+
+    const char* m_key;
+    size_t m_keySize;
+
+    /// Unescaped string or literal of the number, boolean and null nodes
+    const char* m_value;
+    size_t m_valueSize;
+
+    JsonNode* m_first;
+    JsonNode* m_last;
+    JsonNode* m_next;
+
+    void appendChild( JsonNode* child )
+    {
+        if ( m_last != NULL )
+            m_last->m_next = child;
+        else
+            m_first = child;
+        m_last = child;
+    }
+};
+
+/** Arena owning the nodes and strings of a JSON document.
+  */
+class JsonDocument
+{
+    public:
+        JsonDocument( ) :
+            m_blocks( ),
+            m_current( NULL ),
+            m_left( 0 ),
+            m_blockSize( MIN_BLOCK_SIZE )
+        {
+        }
+
+        JsonDocument( const JsonDocument& copy ) = delete;
+        JsonDocument& operator=( const JsonDocument& copy ) = delete;
+
+        ~JsonDocument( )
+        {
+            for ( vector< char* >::iterator it = m_blocks.begin( ); it != m_blocks.end( ); ++it )
+                delete[] *it;
+        }
+
+        JsonNode* createNode( JsonNode::Kind kind )
+        {
+            return new ( allocate( sizeof( JsonNode ), alignof( JsonNode ) ) ) JsonNode( kind );
+        }
+
+        /** Copy a string in the arena, adding a trailing NUL character.
+          */
+        char* copyString( const char* str, size_t size )
+        {
+            char* copy = static_cast< char* >( allocate( size + 1, 1 ) );
+            memcpy( copy, str, size );
+            copy[size] = '\0';
+            return copy;
+        }
+
+    private:
+        static const size_t MIN_BLOCK_SIZE = 256;
+        static const size_t MAX_BLOCK_SIZE = 64 * 1024;
+
+        void* allocate( size_t size, size_t alignment )
+        {
+            size_t padding = ( alignment - reinterpret_cast< size_t >( m_current ) % alignment ) % alignment;
+            if ( m_current == NULL || padding + size > m_left )
+            {
+                // Big strings like the copy of a parsed text get their own block
+                size_t blockSize = max( size + alignment, m_blockSize );
+                m_blocks.push_back( new char[blockSize] );
+                m_current = m_blocks.back( );
+                m_left = blockSize;
+                if ( m_blockSize < MAX_BLOCK_SIZE )
+                    m_blockSize *= 2;
+                padding = ( alignment - reinterpret_cast< size_t >( m_current ) % alignment ) % alignment;
+            }
+            void* result = m_current + padding;
+            m_current += padding + size;
+            m_left -= padding + size;
+            return result;
+        }
+
+        vector< char* > m_blocks;
+        char* m_current;
+        size_t m_left;
+        size_t m_blockSize;
+};
+
+namespace
+{
+    /** Recursive descent parser unescaping the strings in place in the
+        buffer to parse.
+      */
+    class JsonParser
+    {
+        public:
+            JsonParser( JsonDocument& doc, char* begin, char* end ) :
+                m_doc( doc ),
+                m_pos( begin ),
+                m_end( end ),
+                m_depth( 0 )
+            {
+            }
+
+            JsonNode* parse( )
+            {
+                skipSpaces( );
+                JsonNode* root = parseValue( );
+                skipSpaces( );
+                if ( m_pos != m_end )
+                    return NULL;
+                return root;
+            }
+
+        private:
+            static const int MAX_DEPTH = 512;
+
+            void skipSpaces( )
+            {
+                while ( m_pos < m_end &&
+                        ( *m_pos == ' ' || *m_pos == '\n' || *m_pos == '\r' || *m_pos == '\t' ) )
+                    ++m_pos;
+            }
+
+            bool skipLiteral( const char* literal, size_t size )
+            {
+                if ( size_t( m_end - m_pos ) < size || memcmp( m_pos, literal, size ) != 0 )
+                    return false;
+                m_pos += size;
+                return true;
+            }
+
+            JsonNode* parseValue( )
+            {
+                if ( m_pos == m_end )
+                    return NULL;
+
+                JsonNode* node = NULL;
+                const char* start = m_pos;
+                switch ( *m_pos )
+                {
+                    case '{':
+                        return parseContainer( JsonNode::Object, '}' );
+                    case '[':
+                        return parseContainer( JsonNode::Array, ']' );
+                    case '"':
+                        node = m_doc.createNode( JsonNode::String );
+                        if ( !parseString( node->m_value, node->m_valueSize ) )
+                            return NULL;
+                        return node;
+                    case 't':
+                        if ( !skipLiteral( "true", 4 ) )
+                            return NULL;
+                        node = m_doc.createNode( JsonNode::Bool );
+                        break;
+                    case 'f':
+                        if ( !skipLiteral( "false", 5 ) )
+                            return NULL;
+                        node = m_doc.createNode( JsonNode::Bool );
+                        break;
+                    case 'n':
+                        if ( !skipLiteral( "null", 4 ) )
+                            return NULL;
+                        node = m_doc.createNode( JsonNode::Null );
+                        break;
+                    default:
+                        if ( !skipNumber( ) )
+                            return NULL;
+                        node = m_doc.createNode( JsonNode::Number );
+                        break;
+                }
+                node->m_value = start;
+                node->m_valueSize = m_pos - start;
+                return node;
+            }
+
+            JsonNode* parseContainer( JsonNode::Kind kind, char close )
+            {
+                if ( ++m_depth > MAX_DEPTH )
+                    return NULL;
+
+                JsonNode* node = m_doc.createNode( kind );
+                ++m_pos;
+                skipSpaces( );
+                if ( m_pos < m_end && *m_pos == close )
+                {
+                    ++m_pos;
+                    --m_depth;
+                    return node;
+                }
+
+                while ( true )
+                {
+                    const char* key = "";
+                    size_t keySize = 0;
+                    if ( kind == JsonNode::Object )
+                    {
+                        if ( m_pos == m_end || *m_pos != '"' || !parseString( key, keySize ) )
+                            return NULL;
+                        skipSpaces( );
+                        if ( m_pos == m_end || *m_pos != ':' )
+                            return NULL;
+                        ++m_pos;
+                        skipSpaces( );
+                    }
+
+                    JsonNode* child = parseValue( );
+                    if ( child == NULL )
+                        return NULL;
+                    child->m_key = key;
+                    child->m_keySize = keySize;
+                    node->appendChild( child );
+
+                    skipSpaces( );
+                    if ( m_pos == m_end )
+                        return NULL;
+                    if ( *m_pos == close )
+                        break;
+                    if ( *m_pos != ',' )
+                        return NULL;
+                    ++m_pos;
+                    skipSpaces( );
+                }
+                ++m_pos;
+                --m_depth;
+                return node;
+            }
+
+            bool skipDigits( )
+            {
+                const char* start = m_pos;
+                while ( m_pos < m_end && *m_pos >= '0' && *m_pos <= '9' )
+                    ++m_pos;
+                return m_pos != start;
+            }
+
+            bool skipNumber( )
+            {
+                if ( *m_pos == '-' )
+                    ++m_pos;
+                if ( m_pos < m_end && *m_pos == '0' )
+                    ++m_pos;
+                else if ( !skipDigits( ) )
+                    return false;
+
+                if ( m_pos < m_end && *m_pos == '.' )
+                {
+                    ++m_pos;
+                    if ( !skipDigits( ) )
+                        return false;
+                }
+                if ( m_pos < m_end && ( *m_pos == 'e' || *m_pos == 'E' ) )
+                {
+                    ++m_pos;
+                    if ( m_pos < m_end && ( *m_pos == '+' || *m_pos == '-' ) )
+                        ++m_pos;
+                    if ( !skipDigits( ) )
+                        return false;
+                }
+                return true;
+            }
+
+            static int hexValue( char c )
+            {
+                if ( c >= '0' && c <= '9' )
+                    return c - '0';
+                if ( c >= 'a' && c <= 'f' )
+                    return c - 'a' + 10;
+                if ( c >= 'A' && c <= 'F' )
+                    return c - 'A' + 10;
+                return -1;
+            }
+
+            bool parseCodeUnit( unsigned long& value )
+            {
+                if ( m_end - m_pos < 4 )
+                    return false;
+                value = 0;
+                for ( int i = 0; i < 4; ++i )
+                {
+                    int digit = hexValue( *m_pos++ );
+                    if ( digit < 0 )
+                        return false;
+                    value = value * 16 + digit;
+                }
+                return true;
+            }
+
+            static char* writeUtf8( char* out, unsigned long codePoint )
+            {
+                if ( codePoint < 0x80 )
+                    *out++ = char( codePoint );
+                else if ( codePoint < 0x800 )
+                {
+                    *out++ = char( 0xC0 | ( codePoint >> 6 ) );
+                    *out++ = char( 0x80 | ( codePoint & 0x3F ) );
+                }
+                else if ( codePoint < 0x10000 )
+                {
+                    *out++ = char( 0xE0 | ( codePoint >> 12 ) );
+                    *out++ = char( 0x80 | ( ( codePoint >> 6 ) & 0x3F ) );
+                    *out++ = char( 0x80 | ( codePoint & 0x3F ) );
+                }
+                else
+                {
+                    *out++ = char( 0xF0 | ( codePoint >> 18 ) );
+                    *out++ = char( 0x80 | ( ( codePoint >> 12 ) & 0x3F ) );
+                    *out++ = char( 0x80 | ( ( codePoint >> 6 ) & 0x3F ) );
+                    *out++ = char( 0x80 | ( codePoint & 0x3F ) );
+                }
+                return out;
+            }
+
+            /** Parse a string starting at the current opening quote. The
+                unescaped string never is longer than the escaped one and
+                overwrites it.
+              */
+            bool parseString( const char*& str, size_t& size )
+            {
+                char* begin = ++m_pos;
+
+                // Most strings have nothing to unescape: leave them untouched
+                while ( m_pos < m_end && *m_pos != '"' && *m_pos != '\\' &&
+                        static_cast< unsigned char >( *m_pos ) >= 0x20 )
+                    ++m_pos;
+
+                char* out = m_pos;
+                while ( m_pos < m_end && *m_pos != '"' )
+                {
+                    char c = *m_pos++;
+                    if ( static_cast< unsigned char >( c ) < 0x20 )
+                        return false;
+                    if ( c != '\\' )
+                    {
+                        *out++ = c;
+                        continue;
+                    }
+
+                    if ( m_pos == m_end )
+                        return false;
+                    switch ( *m_pos++ )
+                    {
+                        case '"': *out++ = '"'; break;
+                        case '\\': *out++ = '\\'; break;
+                        case '/': *out++ = '/'; break;
+                        case 'b': *out++ = '\b'; break;
+                        case 'f': *out++ = '\f'; break;
+                        case 'n': *out++ = '\n'; break;
+                        case 'r': *out++ = '\r'; break;
+                        case 't': *out++ = '\t'; break;
+                        case 'u':
+                        {
+                            unsigned long codePoint;
+                            if ( !parseCodeUnit( codePoint ) )
+                                return false;
+
+                            // Combine the UTF-16 surrogate pairs
+                            unsigned long low;
+                            if ( codePoint >= 0xD800 && codePoint < 0xDC00 &&
+                                 m_end - m_pos >= 6 && m_pos[0] == '\\' && m_pos[1] == 'u' )
+                            {
+                                char* save = m_pos;
+                                m_pos += 2;
+                                if ( parseCodeUnit( low ) && low >= 0xDC00 && low < 0xE000 )
+                                    codePoint = 0x10000 + ( ( codePoint - 0xD800 ) << 10 ) + ( low - 0xDC00 );
+                                else
+                                    m_pos = save;
+                            }
+                            out = writeUtf8( out, codePoint );
+                            break;
+                        }
+                        default:
+                            return false;
+                    }
+                }
+                if ( m_pos == m_end )
+                    return false;
+
+                ++m_pos;
+                str = begin;
+                size = out - begin;
+                return true;
+            }
+
+            JsonDocument& m_doc;
+            char* m_pos;
+            char* m_end;
+            int m_depth;
+    };
+
+    /** Escape a string the way boost::property_tree wrote it.
+      */
+    void lcl_writeEscaped( string& out, const char* str, size_t size )
+    {
+        static const char* hexDigits = "0123456789ABCDEF";
+        out += '"';
+        for ( size_t i = 0; i < size; ++i )
+        {
+            unsigned char c = str[i];
+            if ( c == 0x20 || c == 0x21 || ( c >= 0x23 && c <= 0x2E ) ||
+                 ( c >= 0x30 && c <= 0x5B ) || c >= 0x5D )
+                out += char( c );
+            else if ( c == '\b' ) out += "\\b";
+            else if ( c == '\f' ) out += "\\f";
+            else if ( c == '\n' ) out += "\\n";
+            else if ( c == '\r' ) out += "\\r";
+            else if ( c == '\t' ) out += "\\t";
+            else if ( c == '/' ) out += "\\/";
+            else if ( c == '"' ) out += "\\\"";
+            else if ( c == '\\' ) out += "\\\\";
+            else
+            {
+                out += "\\u00";
+                out += hexDigits[c >> 4];
+                out += hexDigits[c & 0xF];
+            }
+        }
+        out += '"';
+    }
+
+    void lcl_writeNode( string& out, const JsonNode* node, int indent )
+    {
+        switch ( node->m_kind )
+        {
+            case JsonNode::String:
+                lcl_writeEscaped( out, node->m_value, node->m_valueSize );
+                return;
+            case JsonNode::Object:
+            case JsonNode::Array:
+                break;
+            default:
+                out.append( node->m_value, node->m_valueSize );
+                return;
+        }
+
+        const bool isArray = node->m_kind == JsonNode::Array;
+        if ( node->m_first == NULL )
+        {
+            out += isArray ? "[]" : "{}";
+            return;
+        }
+
+        out += isArray ? "[\n" : "{\n";
+        for ( const JsonNode* child = node->m_first; child != NULL; child = child->m_next )
+        {
+            out.append( 4 * ( indent + 1 ), ' ' );
+            if ( !isArray )
+            {
+                lcl_writeEscaped( out, child->m_key, child->m_keySize );
+                out += ": ";
+            }
+            lcl_writeNode( out, child, indent + 1 );
+            if ( child->m_next != NULL )
+                out += ',';
+            out += '\n';
+        }
+        out.append( 4 * indent, ' ' );
+        out += isArray ? ']' : '}';
+    }
+
+    bool lcl_startsLikeNumber( const string& str, bool withDot )
+    {
+        size_t pos = 0;
+        while ( pos < str.size( ) && isspace( static_cast< unsigned char >( str[pos] ) ) )
+            ++pos;
+        if ( pos == str.size( ) )
+            return false;
+        char c = str[pos];
+        return ( c >= '0' && c <= '9' ) || c == '-' || c == '+' || ( withDot && c == '.' );
+    }
+
+    /** Guess the type of a string value, as the values of the Google Drive
+        API are often numbers or dates written as strings.
+      */
+    Json::Type lcl_guessStringType( const string& str )
+    {
+        if ( str.empty( ) )
+            return Json::json_string;
+
+        if ( str.find( 'T' ) != string::npos )
+        {
+            try
+            {
+                boost::posix_time::ptime time = libcmis::parseDateTime( str );
+                if ( !time.is_not_a_date_time( ) )
+                    return Json::json_datetime;
+            }
+            catch ( ... )
+            {
+                // Try other types
+            }
+        }
+
+        if ( str == "true" || str == "false" || str == "1" || str == "0" )
+            return Json::json_bool;
+
+        const bool hasDot = str.find( '.' ) != string::npos;
+        if ( !lcl_startsLikeNumber( str, hasDot ) )
+            return Json::json_string;
+        try
+        {
+            if ( hasDot )
+                parseDouble( str );
+            else
+                parseInteger( str );
+        }
+        catch ( ... )
+        {
+            return Json::json_string;
+        }
+        return hasDot ? Json::json_double : Json::json_int;
+    }
+
+    Json::Type lcl_computeType( const JsonNode* node )
+    {
+        switch ( node->m_kind )
+        {
+            case JsonNode::Null:
+                return Json::json_null;
+            case JsonNode::Bool:
+                return Json::json_bool;
+            case JsonNode::Object:
+                return Json::json_object;
+            case JsonNode::Array:
+                return Json::json_array;
+            case JsonNode::Number:
+            {
+                string value( node->m_value, node->m_valueSize );
+                if ( value.find_first_of( ".eE" ) == string::npos )
+                {
+                    try
+                    {
+                        parseInteger( value );
+                        return Json::json_int;
+                    }
+                    catch ( ... )
+                    {
+                        // Too big for a long
+                    }
+                }
+                return Json::json_double;
+            }
+            case JsonNode::String:
+                break;
+        }
+        return lcl_guessStringType( string( node->m_value, node->m_valueSize ) );
+    }
+
+    /** Copy a node and its children into another document.
+      */
+    JsonNode* lcl_copyNode( JsonDocument& doc, const JsonNode* node )
+    {
+        JsonNode* copy = doc.createNode( node->m_kind );
+        copy->m_type.store( node->m_type.load( memory_order_relaxed ), memory_order_relaxed );
+        copy->m_value = doc.copyString( node->m_value, node->m_valueSize );
+        copy->m_valueSize = node->m_valueSize;
+        for ( const JsonNode* child = node->m_first; child != NULL; child = child->m_next )
+        {
+            JsonNode* childCopy = lcl_copyNode( doc, child );
+            childCopy->m_key = doc.copyString( child->m_key, child->m_keySize );
+            childCopy->m_keySize = child->m_keySize;
+            copy->appendChild( childCopy );
+        }
+        return copy;
+    }
+
+    const JsonNode* lcl_findChild( const JsonNode* node, const char* key, size_t size )
+    {
+        for ( const JsonNode* child = node->m_first; child != NULL; child = child->m_next )
+        {
+            if ( child->m_keySize == size && memcmp( child->m_key, key, size ) == 0 )
+                return child;
+        }
+        return NULL;
+    }
+}
 
 Json::Json( ) :
-	m_tJson( ptree( ) ),
-    m_type( json_object )
+    m_doc( new JsonDocument( ) ),
+    m_node( NULL )
 {
+    m_node = m_doc->createNode( JsonNode::Object );
 }
 
 Json::Json( const char *str ) :
-    m_tJson( ptree( ) ),
-    m_type( json_string )
+    m_doc( new JsonDocument( ) ),
+    m_node( NULL )
 {
-    m_tJson.put_value( str );
-    m_type = parseType( );
+    m_node = m_doc->createNode( JsonNode::String );
+    m_node->m_valueSize = strlen( str );
+    m_node->m_value = m_doc->copyString( str, m_node->m_valueSize );
 }
 
-Json::Json( ptree tJson ) :
-    m_tJson( tJson ),
-    m_type( json_object )
+Json::Json( const boost::shared_ptr< JsonDocument >& doc, JsonNode* node ) :
+    m_doc( doc ),
+    m_node( node )
 {
-    m_type = parseType( );
 }
 
 Json::Json( const PropertyPtr& property ):
-    m_tJson( ),
-    m_type( json_object )
+    m_doc( ),
+    m_node( NULL )
 {
     string str = property->toString( );
-    m_tJson.put("", str );
+    Json( str.c_str( ) ).swap( *this );
 }
 
 Json::Json( const PropertyPtrMap& properties ) :
-    m_tJson( ptree( ) ),
-    m_type( json_array )
+    m_doc( new JsonDocument( ) ),
+    m_node( NULL )
 {
+    m_node = m_doc->createNode( JsonNode::Object );
     for ( PropertyPtrMap::const_iterator it = properties.begin() ; 
             it != properties.end() ; ++it )
         {
-            string key = it->first;
             string value = it->second->toString( );
-            m_tJson.put( key, value );
+            JsonNode* child = m_doc->createNode( JsonNode::String );
+            child->m_key = m_doc->copyString( it->first.c_str( ), it->first.size( ) );
+            child->m_keySize = it->first.size( );
+            child->m_value = m_doc->copyString( value.c_str( ), value.size( ) );
+            child->m_valueSize = value.size( );
+            m_node->appendChild( child );
         }
 }
 
 Json::Json( const Json& copy ) :
-    m_tJson( copy.m_tJson ),
-    m_type( copy.m_type )
+    m_doc( copy.m_doc ),
+    m_node( copy.m_node )
 {
 }
 
 Json::Json( const JsonObject& obj ) :
-    m_tJson( ptree( ) ),
-    m_type( json_array )
+    m_doc( new JsonDocument( ) ),
+    m_node( NULL )
 {
+    m_node = m_doc->createNode( JsonNode::Object );
     for ( JsonObject::const_iterator i = obj.begin() ; i != obj.end() ; ++i )
         add( i->first, i->second ) ;
 }
 
 Json::Json( const JsonVector& arr ) :
-    m_tJson( ptree( ) ),
-    m_type( json_array )
+    m_doc( new JsonDocument( ) ),
+    m_node( NULL )
 {
+    m_node = m_doc->createNode( JsonNode::Array );
     for ( std::vector<Json>::const_iterator i = arr.begin(); i != arr.end(); ++i )
         add( *i ) ;
 }
@@ -115,164 +726,129 @@ Json& Json::operator=( const Json& rhs )
 {
     if ( this != &rhs )
     {
-        m_tJson = rhs.m_tJson;
-        m_type = rhs.m_type;
+        m_doc = rhs.m_doc;
+        m_node = rhs.m_node;
     }
     return *this ;
 }
 
 void Json::swap( Json& rhs )
 {
-    std::swap( m_tJson, rhs.m_tJson );
-    std::swap( m_type, rhs.m_type );
+    std::swap( m_doc, rhs.m_doc );
+    std::swap( m_node, rhs.m_node );
 }
 
 Json Json::operator[]( string key ) const 
 {
-    ptree tJson;
-    try
-    {    
-        tJson = m_tJson.get_child( key );
-    }
-    catch ( boost::exception const& )
+    // Like the boost::property_tree paths, the keys are separated by dots
+    const JsonNode* node = m_node;
+    size_t start = 0;
+    while ( node != NULL && !key.empty( ) && start <= key.size( ) )
     {
-        return Json( "" );
+        size_t end = key.find( '.', start );
+        if ( end == string::npos )
+            end = key.size( );
+        node = lcl_findChild( node, key.c_str( ) + start, end - start );
+        start = end + 1;
     }
 
-    Json childJson( tJson );
+    if ( node == NULL )
+        return Json( "" );
 
-    return childJson ;
+    return Json( m_doc, const_cast< JsonNode* >( node ) );
 }
 
-void Json::add( const std::string& key, const Json& json ) 
+void Json::detach( )
 {
-    try
+    if ( m_doc.use_count( ) > 1 )
     {
-        m_tJson.add_child( key, json.getTree( ) );
+        boost::shared_ptr< JsonDocument > doc( new JsonDocument( ) );
+        m_node = lcl_copyNode( *doc, m_node );
+        m_doc = doc;
     }
-    catch ( boost::exception const& )
+}
+
+JsonNode* Json::append( const string& key, const Json& json )
+{
+    detach( );
+
+    // Copy the child before linking it in case it is a part of this node
+    JsonNode* child = lcl_copyNode( *m_doc, json.m_node );
+    child->m_key = m_doc->copyString( key.c_str( ), key.size( ) );
+    child->m_keySize = key.size( );
+
+    // Arrays are objects with empty keys
+    if ( m_node->m_kind != JsonNode::Object && m_node->m_kind != JsonNode::Array )
     {
-        throw libcmis::Exception( "Couldn't add Json object" );
+        m_node->m_value = "";
+        m_node->m_valueSize = 0;
     }
+    if ( key.empty( ) && ( m_node->m_kind != JsonNode::Object || m_node->m_first == NULL ) )
+        m_node->m_kind = JsonNode::Array;
+    else if ( !key.empty( ) )
+        m_node->m_kind = JsonNode::Object;
+    m_node->m_type.store( -1, memory_order_relaxed );
+
+    m_node->appendChild( child );
+    return child;
+}
+
+void Json::add( const std::string& key, const Json& json ) 
+{
+    append( key, json );
 }
 
 Json::JsonVector Json::getList()
 {
     JsonVector list;
-    for ( const auto& v : m_tJson.get_child("") )
+    for ( JsonNode* child = m_node->m_first; child != NULL; child = child->m_next )
     {
-        list.push_back( Json( v.second ) );
+        list.push_back( Json( m_doc, child ) );
     }
     return list;
 }
 
 void Json::add( const Json& json )
 {
-    try
-    {
-        m_tJson.push_back( ptree::value_type( "", json.getTree( )) );
-    }
-    catch ( boost::exception const& )
-    {
-        throw libcmis::Exception( "Couldn't add Json object" );
-    }
+    append( string( ), json );
 }
 
 Json Json::parse( const string& str )
 {
-    ptree pTree;
-    std::stringstream ss( str ); 
-    if ( ss.good( ) )
-    {
-        try 
-        {
-            property_tree::json_parser::read_json( ss, pTree );
-        }
-        catch ( boost::exception const& )
-        {
-            return Json( str.c_str( ) );
-        }
-    }
-    return Json( pTree );
+    boost::shared_ptr< JsonDocument > doc( new JsonDocument( ) );
+    char* buffer = doc->copyString( str.data( ), str.size( ) );
+    JsonParser parser( *doc, buffer, buffer + str.size( ) );
+    JsonNode* root = parser.parse( );
+    if ( root == NULL )
+        return Json( str.c_str( ) );
+    return Json( doc, root );
 }
 
 Json::JsonObject Json::getObjects( )
 {
     JsonObject objs;
-    for ( const auto &v: m_tJson.get_child("") )
+    for ( JsonNode* child = m_node->m_first; child != NULL; child = child->m_next )
     {
-        Json jsonValue( v.second ); 
-        objs.insert( JsonObject::value_type(v.first, jsonValue ) );
+        objs.insert( JsonObject::value_type( string( child->m_key, child->m_keySize ),
+                                             Json( m_doc, child ) ) );
     }
     return objs ;
 }
 
-Json::Type Json::parseType( )
+Json::Type Json::getDataType( ) const
 {
-    Type type = json_string;
-    string str = toString( );
-    if ( str.empty( ) )
-        return type;
-    try 
-    {
-        boost::posix_time::ptime time = libcmis::parseDateTime( str );
-        if ( !time.is_not_a_date_time( ) )
-            return json_datetime;
-    }
-    catch (...)
+    int type = m_node->m_type.load( memory_order_relaxed );
+    if ( type < 0 )
     {
-        // Try other types
-    }
-    Type backupType = type;
-    type = json_bool;
-    try
-    {
-        parseBool( str );
-    }
-    catch (...)
-    {
-        type = backupType;
-    }
-    if ( type != json_bool )
-    {
-        if ( str.find('.') == string::npos )
-        {
-            backupType = type;
-            type = json_int;
-            try
-            {
-                parseInteger( str );
-            }
-            catch(...) 
-            { 
-                type = backupType;
-            }
-        }
-        else
-        {
-            backupType = type;
-            type = json_double;
-            try
-            {
-                parseDouble( str );
-            }
-            catch(...) 
-            { 
-                type = backupType;
-            }
-        }
+        type = lcl_computeType( m_node );
+        m_node->m_type.store( type, memory_order_relaxed );
     }
-    return type;
-}
-
-Json::Type Json::getDataType( ) const
-{
-    return m_type;
+    return Type( type );
 }
 
 string Json::getStrType( ) const
 {
-    switch ( m_type )
+    switch ( getDataType( ) )
     {
         case json_null: return "json_null";
         case json_bool: return "json_bool";
@@ -288,19 +864,260 @@ string Json::getStrType( ) const
 
 string Json::toString( ) const
 {
+    if ( m_node->m_kind != JsonNode::Object && m_node->m_kind != JsonNode::Array )
+        return string( m_node->m_value, m_node->m_valueSize );
+
+    // empty json
     string str;
-    try 
+    if ( m_node->m_first == NULL )
+        return str;
+
+    lcl_writeNode( str, m_node, 0 );
+    str += '\n';
+    return str;
+}
+
+JsonListParser::JsonListParser( const string& listKey ) :
+    m_listKey( listKey ),
+    m_state( START ),
+    m_key( ),
+    m_inList( false ),
+    m_text( ),
+    m_depth( 0 ),
+    m_inString( false ),
+    m_escaped( false ),
+    m_members( ),
+    m_error( ),
+    m_errorType( )
+{
+}
+
+JsonListParser::~JsonListParser( )
+{
+}
+
+void JsonListParser::feed( const char* data, size_t size )
+{
+    if ( m_state == FAILED )
+        return;
+
+    try
     {
-        stringstream ss;
-        write_json( ss, m_tJson );
-        str = ss.str( );
+        parse( data, size );
     }
-    catch ( boost::exception const& )
+    catch ( const libcmis::Exception& e )
     {
-        str = m_tJson.get_value<string>( );
+        m_error = e.what( );
+        m_errorType = e.getType( );
+        m_state = FAILED;
     }
-    // empty json
-    if ( str == "{\n}\n" ) str = "";
-    return str;
 }
 
+void JsonListParser::finish( )
+{
+    if ( m_state == FAILED )
+        throw libcmis::Exception( m_error, m_errorType );
+    if ( m_state != END )
+        throw libcmis::Exception( "Incomplete JSON listing" );
+}
+
+Json JsonListParser::getMember( const string& key ) const
+{
+    map< string, Json >::const_iterator it = m_members.find( key );
+    if ( it == m_members.end( ) )
+        return Json( "" );
+    return it->second;
+}
+
+streamsize JsonListParser::xsputn( const char* s, streamsize n )
+{
+    feed( s, size_t( n ) );
+    return n;
+}
+
+JsonListParser::int_type JsonListParser::overflow( int_type c )
+{
+    if ( !traits_type::eq_int_type( c, traits_type::eof( ) ) )
+    {
+        char ch = traits_type::to_char_type( c );
+        feed( &ch, 1 );
+    }
+    return traits_type::not_eof( c );
+}
+
+void JsonListParser::parse( const char* data, size_t size )
+{
+    const char* pos = data;
+    const char* end = data + size;
+    while ( pos < end )
+    {
+        const char c = *pos;
+        const bool isSpace = c == ' ' || c == '\n' || c == '\r' || c == '\t';
+        switch ( m_state )
+        {
+            case START:
+                if ( c == '{' )
+                    m_state = MEMBERS;
+                else if ( !isSpace )
+                    throw libcmis::Exception( "Invalid JSON listing" );
+                ++pos;
+                break;
+            case MEMBERS:
+                if ( c == '"' )
+                {
+                    m_key.clear( );
+                    m_escaped = false;
+                    m_state = KEY;
+                }
+                else if ( c == '}' )
+                    m_state = END;
+                else if ( c != ',' && !isSpace )
+                    throw libcmis::Exception( "Invalid JSON listing" );
+                ++pos;
+                break;
+            case KEY:
+            {
+                const char* start = pos;
+                while ( pos < end && ( m_escaped || *pos != '"' ) )
+                {
+                    m_escaped = !m_escaped && *pos == '\\';
+                    ++pos;
+                }
+                m_key.append( start, pos );
+                if ( pos < end )
+                {
+                    if ( m_key.find( '\\' ) != string::npos )
+                        m_key = Json::parse( "\"" + m_key + "\"" ).toString( );
+                    m_state = COLON;
+                    ++pos;
+                }
+                break;
+            }
+            case COLON:
+                if ( c == ':' )
+                    m_state = VALUE_START;
+                else if ( !isSpace )
+                    throw libcmis::Exception( "Invalid JSON listing" );
+                ++pos;
+                break;
+            case VALUE_START:
+            case LIST:
+                if ( isSpace || ( m_state == LIST && c == ',' ) )
+                    ++pos;
+                else if ( m_state == LIST && c == ']' )
+                {
+                    m_state = MEMBERS;
+                    ++pos;
+                }
+                else if ( m_state == VALUE_START && c == '[' && m_key == m_listKey )
+                {
+                    m_state = LIST;
+                    ++pos;
+                }
+                else
+                {
+                    // The value starts here: the text is read in the VALUE state
+                    m_inList = m_state == LIST;
+                    m_text.clear( );
+                    m_depth = 0;
+                    m_inString = false;
+                    m_escaped = false;
+                    m_state = VALUE;
+                }
+                break;
+            case VALUE:
+            {
+                const char* valueEnd = findValueEnd( pos, end );
+                m_text.append( pos, valueEnd != NULL ? valueEnd : end );
+                if ( valueEnd == NULL )
+                    pos = end;
+                else
+                {
+                    pos = valueEnd;
+                    m_state = m_inList ? LIST : MEMBERS;
+                    valueParsed( );
+                }
+                break;
+            }
+            case END:
+                if ( !isSpace )
+                    throw libcmis::Exception( "Invalid JSON listing" );
+                ++pos;
+                break;
+            case FAILED:
+                return;
+        }
+    }
+}
+
+const char* JsonListParser::findValueEnd( const char* pos, const char* end )
+{
+    while ( pos < end )
+    {
+        if ( m_inString )
+        {
+            if ( m_escaped )
+            {
+                m_escaped = false;
+                ++pos;
+                continue;
+            }
+            while ( pos < end && *pos != '"' && *pos != '\\' )
+                ++pos;
+            if ( pos == end )
+                break;
+            if ( *pos == '\\' )
+                m_escaped = true;
+            else
+            {
+                m_inString = false;
+                if ( m_depth == 0 )
+                    return pos + 1;
+            }
+            ++pos;
+            continue;
+        }
+
+        switch ( *pos )
+        {
+            case '"':
+                m_inString = true;
+                break;
+            case '{':
+            case '[':
+                ++m_depth;
+                break;
+            case '}':
+            case ']':
+                // Numbers and literals end before the closing bracket
+                if ( m_depth == 0 )
+                    return pos;
+                if ( --m_depth == 0 )
+                    return pos + 1;
+                break;
+            case ',':
+            case ' ':
+            case '\n':
+            case '\r':
+            case '\t':
+                if ( m_depth == 0 )
+                    return pos;
+                break;
+        }
+        ++pos;
+    }
+    return NULL;
+}
+
+void JsonListParser::valueParsed( )
+{
+    Json value = Json::parse( m_text );
+    if ( ( m_text[0] == '{' && value.getDataType( ) != Json::json_object ) ||
+         ( m_text[0] == '[' && value.getDataType( ) != Json::json_array ) )
+        throw libcmis::Exception( "Invalid JSON listing" );
+
+    if ( m_inList )
+        itemParsed( value );
+    else
+        m_members.insert( make_pair( m_key, value ) );
+}
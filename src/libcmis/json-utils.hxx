@@ -31,13 +31,25 @@
 
 #include <string>
 #include <map>
+#include <streambuf>
 #include <vector>
 
-#include <boost/property_tree/ptree.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include <libcmis/exception.hxx>
 #include <libcmis/property.hxx>
 
+class JsonDocument;
+struct JsonNode;
+
+/** Handle on a node of a JSON document.
+
+    The parsed documents are stored in an arena: the strings are unescaped
+    in place in a copy of the input and the nodes only point to them. Copying
+    a Json, getting one of its children or listing them only copies a handle
+    sharing the document. The document is copied before being modified if
+    it is shared by other handles.
+  */
 class Json
 {
     public :
@@ -56,6 +68,15 @@ class Json
 
         ~Json( ) ;
 
+        /** Get a child of the node.
+
+            \param key
+                the key of the child, or a path of keys separated by dots.
+                An empty key designates the node itself.
+
+            \return
+                the child or an empty string if there is none.
+          */
         Json operator[]( std::string key ) const;
 
         Json& operator=( const Json& rhs ) ;
@@ -66,8 +87,18 @@ class Json
         
         void add( const std::string& key, const Json& json);
 
+        /** Parse a JSON text.
+
+            \return
+                the root of the document, or a string Json containing
+                the text if it isn't valid JSON.
+          */
         static Json parse( const std::string& str );
         
+        /** Get the value of a string, number, boolean or null node, or the
+            indented JSON text of an object or array. Empty objects and arrays
+            give an empty string.
+          */
         std::string toString( ) const;
         Type getDataType( ) const ;
         std::string getStrType( ) const ;
@@ -75,13 +106,103 @@ class Json
         JsonObject getObjects();
         JsonVector getList();
 
-        boost::property_tree::ptree getTree( ) const{ return m_tJson; }
     private :
-        Json( boost::property_tree::ptree tJson ) ;
-        boost::property_tree::ptree m_tJson ;
-        Type m_type;
-        Type parseType( );
+        Json( const boost::shared_ptr< JsonDocument >& doc, JsonNode* node );
+
+        /** Make sure that the document isn't shared before modifying it.
+          */
+        void detach( );
+        JsonNode* append( const std::string& key, const Json& json );
+
+        boost::shared_ptr< JsonDocument > m_doc;
+        JsonNode* m_node;
 } ;
 
-#endif /* _JSON_UTILS_HXX_ */
+/** Push parser of the JSON listings returned by the cloud APIs.
+
+    The listings are objects with an array of items and a few other members
+    like the next page token. The items are parsed and given to itemParsed( )
+    one by one as soon as their text has been received: only the text of the
+    current item is kept.
 
+    Errors can't be thrown while curl is writing the data: they are
+    thrown by finish( ) instead.
+  */
+class JsonListParser : public std::streambuf
+{
+    private:
+        enum State
+        {
+            START,
+            MEMBERS,
+            KEY,
+            COLON,
+            VALUE_START,
+            VALUE,
+            LIST,
+            END,
+            FAILED
+        };
+
+        std::string m_listKey;
+        State m_state;
+        std::string m_key;
+        bool m_inList;
+        std::string m_text;
+        int m_depth;
+        bool m_inString;
+        bool m_escaped;
+        std::map< std::string, Json > m_members;
+        std::string m_error;
+        std::string m_errorType;
+
+    public:
+        /** \param listKey
+                the key of the top-level member containing the items
+          */
+        JsonListParser( const std::string& listKey );
+        virtual ~JsonListParser( );
+
+        /** Parse the next chunk of the listing.
+          */
+        void feed( const char* data, size_t size );
+
+        /** Tell that the whole listing has been fed.
+
+            \throw libcmis::Exception
+                if the listing is invalid or if itemParsed( ) threw one.
+          */
+        void finish( );
+
+        /** Get a top-level member other than the list of items.
+
+            \return
+                the member or an empty string if there is none.
+          */
+        Json getMember( const std::string& key ) const;
+
+    protected:
+        /** Handle an item of the list.
+          */
+        virtual void itemParsed( Json item ) = 0;
+
+        virtual std::streamsize xsputn( const char* s, std::streamsize n );
+        virtual int_type overflow( int_type c );
+
+    private:
+        JsonListParser( const JsonListParser& );
+        JsonListParser& operator=( const JsonListParser& );
+
+        void parse( const char* data, size_t size );
+
+        /** Look for the end of the value being read.
+
+            \return
+                the position after the value or NULL if it continues
+                in the next chunk.
+          */
+        const char* findValueEnd( const char* pos, const char* end );
+        void valueParsed( );
+};
+
+#endif /* _JSON_UTILS_HXX_ */
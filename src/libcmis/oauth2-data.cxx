@@ -92,4 +92,41 @@ namespace libcmis
                !m_scope.empty() &&
                !m_redirectUri.empty();
     }
+
+    OAuth2Tokens::OAuth2Tokens( ) :
+        m_accessToken( ),
+        m_refreshToken( ),
+        m_expiry( 0 )
+    {
+    }
+
+    OAuth2Tokens::OAuth2Tokens( const string& accessToken, const string& refreshToken,
+                                time_t expiry ) :
+        m_accessToken( accessToken ),
+        m_refreshToken( refreshToken ),
+        m_expiry( expiry )
+    {
+    }
+
+    MemoryOAuth2TokenStore::MemoryOAuth2TokenStore( ) :
+        m_mutex( ),
+        m_tokens( )
+    {
+    }
+
+    bool MemoryOAuth2TokenStore::load( const string& account, OAuth2Tokens& tokens )
+    {
+        lock_guard< mutex > lock( m_mutex );
+        map< string, OAuth2Tokens >::iterator it = m_tokens.find( account );
+        if ( it == m_tokens.end( ) )
+            return false;
+        tokens = it->second;
+        return true;
+    }
+
+    void MemoryOAuth2TokenStore::save( const string& account, const OAuth2Tokens& tokens )
+    {
+        lock_guard< mutex > lock( m_mutex );
+        m_tokens[ account ] = tokens;
+    }
 }
@@ -26,6 +26,9 @@
  * instead of those above.
  */
 
+#include <cstdlib>
+#include <map>
+
 #include <boost/algorithm/string.hpp>
 
 #include "oauth2-handler.hxx"
@@ -38,11 +41,47 @@
 
 using namespace std;
 
+namespace
+{
+    // Refresh the access tokens a bit before they expire
+    const time_t TOKEN_RENEWAL_MARGIN = 60;
+
+    bool lcl_isExpiring( time_t expiry )
+    {
+        return expiry != 0 && time( NULL ) + TOKEN_RENEWAL_MARGIN >= expiry;
+    }
+
+    time_t lcl_getExpiry( Json& jresp )
+    {
+        time_t expiresIn = atol( jresp[ "expires_in" ].toString( ).c_str( ) );
+        if ( expiresIn <= 0 )
+            return 0;
+        return time( NULL ) + expiresIn;
+    }
+
+    /** Get the mutex serializing the token refreshes of an account, so that
+        its sessions don't all call the token endpoint at the same time.
+      */
+    mutex& lcl_getRefreshMutex( const string& account )
+    {
+        static mutex refreshMutexesMutex;
+        static map< string, boost::shared_ptr< mutex > > refreshMutexes;
+
+        lock_guard< mutex > lock( refreshMutexesMutex );
+        boost::shared_ptr< mutex >& refreshMutex = refreshMutexes[ account ];
+        if ( !refreshMutex )
+            refreshMutex.reset( new mutex( ) );
+        return *refreshMutex;
+    }
+}
+
 OAuth2Handler::OAuth2Handler(HttpSession* session, libcmis::OAuth2DataPtr data) :
         m_session( session ),
         m_data( data ),
         m_access( ),
         m_refresh( ),
+        m_expiry( 0 ),
+        m_mutex( ),
         m_oauth2Parser( )
 {
     if ( !m_data )
@@ -53,10 +92,16 @@ OAuth2Handler::OAuth2Handler(HttpSession* session, libcmis::OAuth2DataPtr data)
 OAuth2Handler::OAuth2Handler( const OAuth2Handler& copy ) :
         m_session( copy.m_session ),
         m_data( copy.m_data ),
-        m_access( copy.m_access ),
-        m_refresh( copy.m_refresh ),
+        m_access( ),
+        m_refresh( ),
+        m_expiry( 0 ),
+        m_mutex( ),
         m_oauth2Parser( copy.m_oauth2Parser )
 {
+    lock_guard< mutex > lock( copy.m_mutex );
+    m_access = copy.m_access;
+    m_refresh = copy.m_refresh;
+    m_expiry = copy.m_expiry;
 }
 
 OAuth2Handler::OAuth2Handler( ):
@@ -64,6 +109,8 @@ OAuth2Handler::OAuth2Handler( ):
         m_data( ),
         m_access( ),
         m_refresh( ),
+        m_expiry( 0 ),
+        m_mutex( ),
         m_oauth2Parser( )
 {
     m_data.reset( new libcmis::OAuth2Data() );
@@ -75,9 +122,17 @@ OAuth2Handler& OAuth2Handler::operator=( const OAuth2Handler& copy )
     {
         m_session = copy.m_session;
         m_data = copy.m_data;
-        m_access = copy.m_access;
-        m_refresh = copy.m_refresh;
         m_oauth2Parser = copy.m_oauth2Parser;
+
+        libcmis::OAuth2Tokens tokens;
+        {
+            lock_guard< mutex > lock( copy.m_mutex );
+            tokens = libcmis::OAuth2Tokens( copy.m_access, copy.m_refresh, copy.m_expiry );
+        }
+        lock_guard< mutex > lock( m_mutex );
+        m_access = tokens.getAccessToken( );
+        m_refresh = tokens.getRefreshToken( );
+        m_expiry = tokens.getExpiry( );
     }
 
     return *this;
@@ -115,21 +170,32 @@ void OAuth2Handler::fetchTokens( string authCode )
                 "Couldn't get tokens from the authorization code ");
     }
 
-    Json jresp = Json::parse( resp->getStream( )->str( ) );
-    m_access = jresp[ "access_token" ].toString( );
-    m_refresh = jresp[ "refresh_token" ].toString( );
+    Json jresp = Json::parse( resp->getBody( ) );
+    setTokens( libcmis::OAuth2Tokens( jresp[ "access_token" ].toString( ),
+                                      jresp[ "refresh_token" ].toString( ),
+                                      lcl_getExpiry( jresp ) ) );
+    saveTokens( );
 }
 
 void OAuth2Handler::refresh( )
 {
-    m_access = string( );
+    string expiredToken = getAccessToken( );
+
+    // Single flight: the other sessions of the account wait for this
+    // refresh and then use its token
+    lock_guard< mutex > refreshLock( lcl_getRefreshMutex( getAccount( ) ) );
+    if ( useNewerTokens( expiredToken ) )
+        return;
+
     string post =
-        "refresh_token="     + m_refresh +
+        "refresh_token="     + getRefreshToken( ) +
         "&client_id="        + m_data->getClientId() +
         "&grant_type=refresh_token" ;
     if(boost::starts_with(m_data->getTokenUrl(), "https://oauth2.googleapis.com/"))
         post += "&client_secret="    + m_data->getClientSecret();
 
+    // The old token is kept until the new one arrives, for the other
+    // requests of the session: the token requests are sent without it.
     istringstream is( post );
     libcmis::HttpResponsePtr resp;
     try
@@ -142,8 +208,90 @@ void OAuth2Handler::refresh( )
         throw libcmis::Exception( "Couldn't refresh token ");
     }
 
-    Json jresp = Json::parse( resp->getStream( )->str( ) );
-    m_access = jresp[ "access_token" ].toString();
+    Json jresp = Json::parse( resp->getBody( ) );
+    string accessToken = jresp[ "access_token" ].toString( );
+    if ( accessToken.empty( ) )
+        throw libcmis::Exception( "Couldn't refresh token: no access token in the response" );
+
+    // The refresh token may be replaced as well
+    string refreshToken = jresp[ "refresh_token" ].toString( );
+    if ( refreshToken.empty( ) )
+        refreshToken = getRefreshToken( );
+    setTokens( libcmis::OAuth2Tokens( accessToken, refreshToken, lcl_getExpiry( jresp ) ) );
+    saveTokens( );
+}
+
+time_t OAuth2Handler::getExpiry( ) const
+{
+    lock_guard< mutex > lock( m_mutex );
+    return m_expiry;
+}
+
+bool OAuth2Handler::isExpiring( ) const
+{
+    return lcl_isExpiring( getExpiry( ) );
+}
+
+bool OAuth2Handler::loadTokens( )
+{
+    libcmis::OAuth2TokenStorePtr store = libcmis::SessionFactory::getOAuth2TokenStore( );
+    libcmis::OAuth2Tokens tokens;
+    if ( !store || !store->load( getAccount( ), tokens ) || tokens.getAccessToken( ).empty( ) )
+        return false;
+
+    setTokens( tokens );
+    return true;
+}
+
+string OAuth2Handler::getAccount( )
+{
+    string username;
+    if ( m_session != NULL )
+        username = m_session->getUsername( );
+    return m_data->getTokenUrl( ) + " " + m_data->getClientId( ) + " " + username;
+}
+
+void OAuth2Handler::setTokens( const libcmis::OAuth2Tokens& tokens )
+{
+    lock_guard< mutex > lock( m_mutex );
+    m_access = tokens.getAccessToken( );
+    if ( !tokens.getRefreshToken( ).empty( ) )
+        m_refresh = tokens.getRefreshToken( );
+    m_expiry = tokens.getExpiry( );
+}
+
+void OAuth2Handler::saveTokens( )
+{
+    libcmis::OAuth2TokenStorePtr store = libcmis::SessionFactory::getOAuth2TokenStore( );
+    if ( !store )
+        return;
+
+    libcmis::OAuth2Tokens tokens;
+    {
+        lock_guard< mutex > lock( m_mutex );
+        tokens = libcmis::OAuth2Tokens( m_access, m_refresh, m_expiry );
+    }
+    store->save( getAccount( ), tokens );
+}
+
+bool OAuth2Handler::useNewerTokens( const string& expiredToken )
+{
+    // A copy of this handler may have refreshed the token...
+    string access = getAccessToken( );
+    if ( !access.empty( ) && access != expiredToken && !isExpiring( ) )
+        return true;
+
+    // ... or another session sharing the token store
+    libcmis::OAuth2TokenStorePtr store = libcmis::SessionFactory::getOAuth2TokenStore( );
+    libcmis::OAuth2Tokens tokens;
+    if ( store && store->load( getAccount( ), tokens ) &&
+         !tokens.getAccessToken( ).empty( ) && tokens.getAccessToken( ) != expiredToken &&
+         !lcl_isExpiring( tokens.getExpiry( ) ) )
+    {
+        setTokens( tokens );
+        return true;
+    }
+    return false;
 }
 
 string OAuth2Handler::getAuthURL( )
@@ -157,24 +305,28 @@ string OAuth2Handler::getAuthURL( )
 
 string OAuth2Handler::getAccessToken( )
 {
+    lock_guard< mutex > lock( m_mutex );
     return m_access;
 }
 
 string OAuth2Handler::getRefreshToken( )
 {
+    lock_guard< mutex > lock( m_mutex );
     return m_refresh;
 }
 
 void OAuth2Handler::setRefreshToken( string refreshToken )
 {
+    lock_guard< mutex > lock( m_mutex );
     m_refresh = refreshToken;
 }
 
 string OAuth2Handler::getHttpHeader( )
 {
+    string access = getAccessToken( );
     string header;
-    if ( !m_access.empty() )
-        header = "Authorization: Bearer " + m_access ;
+    if ( !access.empty() )
+        header = "Authorization: Bearer " + access ;
     return header;
 }
 
@@ -28,7 +28,12 @@
 #ifndef _OAUTH2_HANDLER_HXX_
 #define _OAUTH2_HANDLER_HXX_
 
+#include <ctime>
+#include <mutex>
 #include <string>
+
+#include <libcmis/oauth2-data.hxx>
+
 #include "http-session.hxx"
 #include "oauth2-providers.hxx"
 
@@ -45,6 +50,10 @@ class OAuth2Handler
 
         std::string m_access;
         std::string m_refresh;
+        time_t m_expiry;
+
+        // Protects the tokens: copies of the sessions share their handler
+        mutable std::mutex m_mutex;
 
         OAuth2Parser m_oauth2Parser;
 
@@ -74,8 +83,30 @@ class OAuth2Handler
                method.
           */
         void fetchTokens( std::string authCode );
+
+        /** Get a new access token using the refresh token.
+
+            Only one session of the account refreshes the token at a time: if
+            another one refreshed it in the meantime, its token is used.
+          */
         void refresh( );
 
+        /** \return the time when the access token expires, or 0 if it isn't known.
+          */
+        time_t getExpiry( ) const;
+
+        /** \return whether the access token expires in less than a minute
+                    and needs to be refreshed before sending a request.
+          */
+        bool isExpiring( ) const;
+
+        /** Get the tokens of the account from the token store of the
+            SessionFactory, if any.
+
+            \return whether a token was found
+          */
+        bool loadTokens( );
+
         /** Get the authentication code given credentials.
 
             This method should be overridden to parse the authentication URL response,
@@ -92,6 +123,23 @@ class OAuth2Handler
 
     protected:
         OAuth2Handler( );
+
+    private:
+        /** Get the key of the account in the token store.
+          */
+        std::string getAccount( );
+
+        void setTokens( const libcmis::OAuth2Tokens& tokens );
+        void saveTokens( );
+
+        /** Use the tokens refreshed by a copy of this handler or by another
+            session sharing the token store.
+
+            \param expiredToken
+                the access token that needed to be refreshed
+            \return whether a newer valid token was found
+          */
+        bool useNewerTokens( const std::string& expiredToken );
 };
 
 #endif /* _OAUTH2_HANDLER_HXX_ */
@@ -62,7 +62,7 @@ string OAuth2Providers::OAuth2Alfresco( HttpSession* session, const string& auth
     string res;
     try
     {
-        res = session->httpGetRequest( authUrl )->getStream( )->str( );
+        res = session->httpGetRequest( authUrl )->getBody( );
     }
     catch ( const CurlException& )
     {
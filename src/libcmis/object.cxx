@@ -30,9 +30,13 @@
 
 #include <algorithm>
 
+#include <boost/algorithm/string.hpp>
+
 #include <libcmis/session.hxx>
 #include <libcmis/xml-utils.hxx>
 
+#include "property-type-registry.hxx"
+
 using namespace std;
 
 namespace libcmis
@@ -44,7 +48,9 @@ namespace libcmis
         m_typeId( ),
         m_properties( ),
         m_allowableActions( ),
-        m_renditions( )
+        m_renditions( ),
+        m_rawProperties( ),
+        m_propertiesMutex( )
     {
     }
 
@@ -55,7 +61,9 @@ namespace libcmis
         m_typeId( ),
         m_properties( ),
         m_allowableActions( ),
-        m_renditions( )
+        m_renditions( ),
+        m_rawProperties( ),
+        m_propertiesMutex( )
     {
         initializeFromNode( node );
     }
@@ -65,10 +73,15 @@ namespace libcmis
         m_typeDescription( copy.m_typeDescription ),
         m_refreshTimestamp( copy.m_refreshTimestamp ),
         m_typeId( copy.m_typeId ),
-        m_properties( copy.m_properties ),
+        m_properties( ),
         m_allowableActions( copy.m_allowableActions ),
-        m_renditions( copy.m_renditions )
+        m_renditions( copy.m_renditions ),
+        m_rawProperties( ),
+        m_propertiesMutex( )
     {
+        lock_guard< recursive_mutex > lock( copy.m_propertiesMutex );
+        m_properties = copy.m_properties;
+        m_rawProperties = copy.m_rawProperties;
     }
 
     Object& Object::operator=( const Object& copy )
@@ -79,9 +92,13 @@ namespace libcmis
             m_typeDescription = copy.m_typeDescription;
             m_refreshTimestamp = copy.m_refreshTimestamp;
             m_typeId = copy.m_typeId;
-            m_properties = copy.m_properties;
             m_allowableActions = copy.m_allowableActions;
             m_renditions = copy.m_renditions;
+
+            lock_guard< recursive_mutex > lock( m_propertiesMutex );
+            lock_guard< recursive_mutex > copyLock( copy.m_propertiesMutex );
+            m_properties = copy.m_properties;
+            m_rawProperties = copy.m_rawProperties;
         }
 
         return *this;
@@ -89,61 +106,90 @@ namespace libcmis
 
     void Object::initializeFromNode( xmlNodePtr node )
     {
-        // Even if node is NULL we'll have an empty doc, so no need
-        // to worry about it.
-        xmlDocPtr doc = wrapInDoc( node );
-        xmlXPathContextPtr xpathCtx = xmlXPathNewContext( doc );
+        // Read the children of the object node directly rather than copying
+        // it into a new document to run XPath queries on it.
+        xmlNodePtr propertiesNd = NULL;
+        for ( xmlNodePtr child = node ? node->children : NULL; child; child = child->next )
+        {
+            if ( isXmlElement( child, NS_CMIS_URL, "allowableActions" ) )
+                m_allowableActions.reset( new libcmis::AllowableActions( child ) );
+            else if ( isXmlElement( child, NS_CMIS_URL, "properties" ) && propertiesNd == NULL )
+                propertiesNd = child;
+        }
 
-        libcmis::registerNamespaces( xpathCtx );
+        m_typeId.clear( );
 
-        if ( NULL != xpathCtx )
+        lock_guard< recursive_mutex > lock( m_propertiesMutex );
+        m_rawProperties.clear( );
+        if ( NULL != propertiesNd )
         {
-            // Get the allowableActions
-            xmlXPathObjectPtr xpathObj = xmlXPathEvalExpression( BAD_CAST( "//cmis:allowableActions" ), xpathCtx );
-            if ( xpathObj && xpathObj->nodesetval && xpathObj->nodesetval->nodeNr > 0 )
+            // Only keep the strings of the properties: they are decoded on
+            // first access as most objects only get a few properties read.
+            // This also avoids requesting the type definition of every object.
+            for ( xmlNodePtr child = propertiesNd->children; child; child = child->next )
             {
-                xmlNodePtr actionsNode = xpathObj->nodesetval->nodeTab[0];
-                m_allowableActions.reset( new libcmis::AllowableActions( actionsNode ) );
-            }
-            xmlXPathFreeObject( xpathObj );
-
-            // TODO Get rid of this request:
-            //   * Too time consuming
-            //   * Makes secondary aspect properties annoying to create
-            //   * Prevents from getting Alfresco additional properties
-            // First get the type id as it will give us the property definitions
-            string typeIdReq( "/*/cmis:properties/cmis:propertyId[@propertyDefinitionId='cmis:objectTypeId']/cmis:value/text()" );
-            m_typeId = libcmis::getXPathValue( xpathCtx, typeIdReq );
-
-            string propertiesReq( "/*/cmis:properties/*" );
-            xpathObj = xmlXPathEvalExpression( BAD_CAST( propertiesReq.c_str() ), xpathCtx );
-            if ( NULL != xpathObj && NULL != xpathObj->nodesetval )
-            {
-                int size = xpathObj->nodesetval->nodeNr;
-                for ( int i = 0; i < size; i++ )
+                if ( child->type != XML_ELEMENT_NODE || child->name == NULL )
+                    continue;
+
+                string id = getXmlNodeAttributeValue( child, "propertyDefinitionId", "" );
+                if ( id.empty( ) )
+                    continue;
+
+                RawProperty& raw = m_rawProperties[ &internPropertyId( id ) ];
+                m_properties.erase( id );
+
+                string xmlType( ( char * )child->name );
+                string propStr( "property" );
+                if ( xmlType.find( propStr ) == 0 )
+                {
+                    xmlType = xmlType.substr( propStr.length( ) );
+                    boost::to_lower( xmlType );
+                }
+
+                raw.m_temporaryType = getTemporaryPropertyType( xmlType, id,
+                        getXmlNodeAttributeValue( child, "localName", "" ),
+                        getXmlNodeAttributeValue( child, "displayName", "" ),
+                        getXmlNodeAttributeValue( child, "queryName", "" ) );
+                raw.m_values.clear( );
+
+                for ( xmlNodePtr value = child->children; value; value = value->next )
                 {
-                    xmlNodePtr propertyNode = xpathObj->nodesetval->nodeTab[i];
-                    libcmis::PropertyPtr property = libcmis::parseProperty( propertyNode, getTypeDescription( ) );
-                    if ( property != NULL )
-                        m_properties[ property->getPropertyType( )->getId() ] = property;
+                    if ( xmlStrEqual( value->name, BAD_CAST( "value" ) ) )
+                    {
+                        xmlChar* content = xmlNodeGetContent( value );
+                        raw.m_values.push_back( string( ( char * )content ) );
+                        xmlFree( content );
+                    }
                 }
             }
-            xmlXPathFreeObject( xpathObj );
-        }
 
-        xmlXPathFreeContext( xpathCtx );
-        xmlFreeDoc( doc );
+            // The type id gives us the property definitions
+            RawProperties::iterator typeIt = findRawProperty( "cmis:objectTypeId" );
+            if ( typeIt != m_rawProperties.end( ) && !typeIt->second.m_values.empty( ) )
+                m_typeId = typeIt->second.m_values.front( );
+        }
 
         m_refreshTimestamp = time( NULL );
     }
 
     string Object::getStringProperty( const string& propertyName )
     {
-       string name;
-       PropertyPtrMap::const_iterator it = getProperties( ).find( string( propertyName ) );
-       if ( it != getProperties( ).end( ) && it->second != NULL && !it->second->getStrings( ).empty( ) )
-           name = it->second->getStrings( ).front( );
-       return name;
+        // The string values don't need the property to be decoded
+        lock_guard< recursive_mutex > lock( m_propertiesMutex );
+        string name;
+        PropertyPtrMap::const_iterator it = m_properties.find( propertyName );
+        if ( it != m_properties.end( ) )
+        {
+            if ( it->second != NULL && !it->second->getStringValues( ).empty( ) )
+                name = it->second->getStringValues( ).front( );
+        }
+        else
+        {
+            RawProperties::iterator rawIt = findRawProperty( propertyName );
+            if ( rawIt != m_rawProperties.end( ) && !rawIt->second.m_values.empty( ) )
+                name = rawIt->second.m_values.front( );
+        }
+        return name;
     }
 
     string Object::getId( )
@@ -192,36 +238,36 @@ namespace libcmis
     boost::posix_time::ptime Object::getCreationDate( )
     {
         boost::posix_time::ptime value;
-        PropertyPtrMap::const_iterator it = getProperties( ).find( string( "cmis:creationDate" ) );
-        if ( it != getProperties( ).end( ) && it->second != NULL && !it->second->getDateTimes( ).empty( ) )
-            value = it->second->getDateTimes( ).front( );
+        PropertyPtr property = getProperty( "cmis:creationDate" );
+        if ( property != NULL && !property->getDateTimeValues( ).empty( ) )
+            value = property->getDateTimeValues( ).front( );
         return value;
     }
 
     boost::posix_time::ptime Object::getLastModificationDate( )
     {
         boost::posix_time::ptime value;
-        PropertyPtrMap::const_iterator it = getProperties( ).find( string( "cmis:lastModificationDate" ) );
-        if ( it != getProperties( ).end( ) && it->second != NULL && !it->second->getDateTimes( ).empty( ) )
-            value = it->second->getDateTimes( ).front( );
+        PropertyPtr property = getProperty( "cmis:lastModificationDate" );
+        if ( property != NULL && !property->getDateTimeValues( ).empty( ) )
+            value = property->getDateTimeValues( ).front( );
         return value;
     }
 
     bool Object::isImmutable( )
     {
         bool value = false;
-        PropertyPtrMap::const_iterator it = getProperties( ).find( string( "cmis:isImmutable" ) );
-        if ( it != getProperties( ).end( ) && it->second != NULL && !it->second->getBools( ).empty( ) )
-            value = it->second->getBools( ).front( );
+        PropertyPtr property = getProperty( "cmis:isImmutable" );
+        if ( property != NULL && !property->getBoolValues( ).empty( ) )
+            value = property->getBoolValues( ).front( );
         return value;
     }
 
     vector< string > Object::getSecondaryTypes( )
     {
         vector< string > types;
-        PropertyPtrMap::const_iterator it = getProperties( ).find( string( "cmis:secondaryObjectTypeIds" ) );
-        if ( it != getProperties( ).end( ) && it->second != NULL )
-            types = it->second->getStrings( );
+        PropertyPtr property = getProperty( "cmis:secondaryObjectTypeIds" );
+        if ( property != NULL )
+            types = property->getStrings( );
 
         return types;
     }
@@ -286,9 +332,99 @@ namespace libcmis
 
     PropertyPtrMap& Object::getProperties( )
     {
+        lock_guard< recursive_mutex > lock( m_propertiesMutex );
+        if ( !m_rawProperties.empty( ) )
+        {
+            ObjectTypePtr objectType = getTypeDescription( );
+
+            RawProperties rawProperties;
+            rawProperties.swap( m_rawProperties );
+            for ( RawProperties::iterator it = rawProperties.begin( );
+                    it != rawProperties.end( ); ++it )
+            {
+                // Properties set after the object initialization win
+                const string& id = *it->first;
+                if ( m_properties.find( id ) != m_properties.end( ) )
+                    continue;
+
+                PropertyPtr property = decodeRawProperty( id, it->second, objectType );
+                if ( property != NULL )
+                    m_properties[ id ] = property;
+            }
+        }
         return m_properties;
     }
 
+    PropertyPtr Object::getProperty( const string& id )
+    {
+        lock_guard< recursive_mutex > lock( m_propertiesMutex );
+        RawProperties::iterator rawIt = findRawProperty( id );
+        PropertyPtrMap::iterator it = m_properties.find( id );
+        if ( it != m_properties.end( ) )
+        {
+            // Properties set after the object initialization win
+            if ( rawIt != m_rawProperties.end( ) )
+                m_rawProperties.erase( rawIt );
+            return it->second;
+        }
+
+        PropertyPtr property;
+        if ( rawIt != m_rawProperties.end( ) )
+        {
+            // Getting the type description may need the raw properties
+            ObjectTypePtr objectType = getTypeDescription( );
+            rawIt = findRawProperty( id );
+            if ( rawIt != m_rawProperties.end( ) )
+            {
+                RawProperty raw;
+                swap( raw, rawIt->second );
+                m_rawProperties.erase( rawIt );
+
+                property = decodeRawProperty( id, raw, objectType );
+                if ( property != NULL )
+                    m_properties[ id ] = property;
+            }
+        }
+        return property;
+    }
+
+    void Object::clearProperties( )
+    {
+        lock_guard< recursive_mutex > lock( m_propertiesMutex );
+        m_properties.clear( );
+        m_rawProperties.clear( );
+    }
+
+    Object::RawProperties::iterator Object::findRawProperty( const string& id )
+    {
+        return m_rawProperties.find( &id );
+    }
+
+    PropertyPtr Object::decodeRawProperty( const string& id, const RawProperty& raw, ObjectTypePtr objectType )
+    {
+        PropertyPtr property;
+
+        // Try to get the property type definition
+        PropertyTypePtr propType = raw.m_temporaryType;
+        if ( objectType )
+        {
+            map< string, PropertyTypePtr >::iterator it = objectType->getPropertiesTypes( ).find( id );
+            if ( it != objectType->getPropertiesTypes( ).end( ) )
+                propType = it->second;
+        }
+
+        try
+        {
+            property.reset( new Property( propType, raw.m_values ) );
+        }
+        catch ( const Exception& )
+        {
+            // Ignore that non-property node
+        }
+
+        return property;
+    }
+
     libcmis::ObjectTypePtr Object::getTypeDescription( )
     {
         if ( !m_typeDescription.get( ) && m_session != NULL )
@@ -356,9 +492,12 @@ namespace libcmis
             if ( !toSkip )
             {
                 libcmis::PropertyPtr prop = it->second;
-                if ( prop != NULL && prop->getPropertyType( ) != NULL )
+                boost::shared_ptr< const PropertyType > propType;
+                if ( prop != NULL )
+                    propType = prop->getPropertyTypeView( );
+                if ( propType != NULL )
                 {
-                    buf << prop->getPropertyType( )->getDisplayName( ) << "( " << prop->getPropertyType()->getId( ) << " ): " << endl;
+                    buf << propType->getDisplayName( ) << "( " << propType->getId( ) << " ): " << endl;
                     vector< string > strValues = prop->getStrings( );
                     for ( vector< string >::iterator valueIt = strValues.begin( );
                           valueIt != strValues.end( ); ++valueIt )
@@ -84,6 +84,11 @@ boost::shared_ptr< istream > OneDriveDocument::getContentStream( string /*stream
     return stream;
 }
 
+string OneDriveDocument::getContentUrl( )
+{
+    return getStringProperty( "source" );
+}
+
 void OneDriveDocument::setContentStream( boost::shared_ptr< ostream > os, 
                                          string /*contentType*/, 
                                          string fileName, 
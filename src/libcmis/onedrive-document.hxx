@@ -53,6 +53,8 @@ class OneDriveDocument : public libcmis::Document, public OneDriveObject
 
         virtual boost::shared_ptr< std::istream > getContentStream( std::string streamId = std::string( ) );
 
+        virtual std::string getContentUrl( );
+
         virtual void setContentStream( boost::shared_ptr< std::ostream > os, 
                                        std::string contentType,
                                        std::string fileName, 
@@ -36,6 +36,36 @@
 using namespace std;
 using namespace libcmis;
 
+namespace
+{
+    /** Create the children objects while the listing is received.
+      */
+    class OneDriveChildrenParser : public JsonListParser
+    {
+        private:
+            OneDriveSession* m_session;
+            vector< libcmis::ObjectPtr >& m_children;
+
+        public:
+            OneDriveChildrenParser( OneDriveSession* session, vector< libcmis::ObjectPtr >& children ) :
+                JsonListParser( "value" ),
+                m_session( session ),
+                m_children( children )
+            {
+            }
+
+        protected:
+            virtual void itemParsed( Json item )
+            {
+                m_children.push_back( m_session->getObjectFromJson( item ) );
+            }
+
+        private:
+            OneDriveChildrenParser( const OneDriveChildrenParser& );
+            OneDriveChildrenParser& operator=( const OneDriveChildrenParser& );
+    };
+}
+
 OneDriveFolder::OneDriveFolder( OneDriveSession* session ):
     libcmis::Object( session ),
     OneDriveObject( session )
@@ -55,28 +85,25 @@ OneDriveFolder::~OneDriveFolder( )
 vector< libcmis::ObjectPtr > OneDriveFolder::getChildren( ) 
 {
     vector< libcmis::ObjectPtr > children;
-    // TODO: limited to 200 items by default - to get more one would have to
-    // follow @odata.nextLink or change pagination size
-    string query = getSession( )->getBindingUrl( ) + "/me/drive/items/" + getId( ) + "/children";
 
-    string res;
-    try
+    // The objects are created while each page is received, the
+    // pages are chained by @odata.nextLink
+    string pageUrl = getSession( )->getBindingUrl( ) + "/me/drive/items/" + getId( ) + "/children";
+    while ( !pageUrl.empty( ) )
     {
-        res = getSession( )->httpGetRequest( query )->getStream()->str();
-    }
-    catch ( const CurlException& e )
-    {
-        throw e.getCmisException( );
-    }
+        boost::shared_ptr< OneDriveChildrenParser > parser( new OneDriveChildrenParser( getSession( ), children ) );
+        try
+        {
+            getSession( )->httpGetRequest( pageUrl, parser );
+        }
+        catch ( const CurlException& e )
+        {
+            throw e.getCmisException( );
+        }
+        parser->finish( );
 
-    Json jsonRes = Json::parse( res );
-    Json::JsonVector objs = jsonRes["value"].getList( );
-    
-    // Create children objects from Json objects
-    for(unsigned int i = 0; i < objs.size(); i++)
-    {   
-        children.push_back( getSession( )->getObjectFromJson( objs[i] ) );
-    }   
+        pageUrl = parser->getMember( "@odata.nextLink" ).toString( );
+    }
     
     return children;
 }
@@ -92,7 +119,7 @@ libcmis::FolderPtr OneDriveFolder::createFolder(
     try
     {
         response = getSession()->httpPostRequest( uploadUrl, is, "application/json" )
-                                    ->getStream( )->str( );
+                                    ->getBody( );
     }
     catch ( const CurlException& e )
     {
@@ -136,7 +163,7 @@ libcmis::DocumentPtr OneDriveFolder::createDocument(
     {
         vector< string > headers;
         res = getSession( )->httpPutRequest( newDocUrl, *is, headers )
-                                ->getStream( )->str( );
+                                ->getBody( );
     }
     catch (const CurlException& e)
     {
@@ -157,9 +184,28 @@ libcmis::DocumentPtr OneDriveFolder::createDocument(
 vector< string > OneDriveFolder::removeTree( 
     bool /*allVersions*/, 
     libcmis::UnfileObjects::Type /*unfile*/, 
-    bool /*continueOnError*/ ) 
+    bool continueOnError ) 
 {
-    remove( ); 
-    // Nothing to return here
+    try
+    {
+        getSession( )->httpDeleteRequest( getUrl( ) );
+    }
+    catch ( const CurlException& e )
+    {
+        if ( e.getErrorCode( ) != CURLE_HTTP_RETURNED_ERROR || e.getHttpStatus( ) == 404 )
+            throw e.getCmisException( );
+
+        // The server doesn't tell which objects couldn't be deleted:
+        // delete the tree from here to find them out.
+        try
+        {
+            return getSession( )->removeTreeConcurrently( *this, continueOnError );
+        }
+        catch ( const libcmis::Exception& )
+        {
+            throw e.getCmisException( );
+        }
+    }
+
     return vector< string >( );
 }
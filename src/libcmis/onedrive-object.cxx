@@ -31,6 +31,7 @@
 #include "onedrive-property.hxx"
 #include "onedrive-repository.hxx"
 #include "onedrive-utils.hxx"
+#include "property-type-registry.hxx"
 
 using namespace std;
 using namespace libcmis;
@@ -82,6 +83,21 @@ void OneDriveObject::initializeFromJson ( Json json, string /*id*/, string /*nam
        }
     }
 
+    // Expose the file hashes as the standard content stream hashes
+    Json fileHashes = json["file"]["hashes"];
+    vector< string > hashes;
+    if ( !fileHashes["quickXorHash"].toString( ).empty( ) )
+        hashes.push_back( "{quickxorhash}" + fileHashes["quickXorHash"].toString( ) );
+    if ( !fileHashes["sha1Hash"].toString( ).empty( ) )
+        hashes.push_back( "{sha-1}" + fileHashes["sha1Hash"].toString( ) );
+    if ( !fileHashes["sha256Hash"].toString( ).empty( ) )
+        hashes.push_back( "{sha-256}" + fileHashes["sha256Hash"].toString( ) );
+    if ( !hashes.empty( ) )
+    {
+        m_properties[ "cmis:contentStreamHash" ] = PropertyPtr(
+                new Property( libcmis::getContentStreamHashPropertyType( ), hashes ) );
+    }
+
     m_refreshTimestamp = time( NULL );
     m_allowableActions.reset( new OneDriveAllowableActions( isFolder ) );
 }
@@ -103,7 +119,7 @@ void OneDriveObject::refresh( )
     string res;
     try
     {
-        res  = getSession()->httpGetRequest( getUrl( ) )->getStream( )->str( );
+        res  = getSession()->httpGetRequest( getUrl( ) )->getBody( );
     }
     catch ( const CurlException& e )
     {
@@ -164,7 +180,7 @@ libcmis::ObjectPtr OneDriveObject::updateProperties(
         throw e.getCmisException( );
     }
     
-    string res = response->getStream( )->str( );
+    const string& res = response->getBody( );
     Json jsonRes = Json::parse( res );
     libcmis::ObjectPtr updated = getSession()->getObjectFromJson( jsonRes );
 
@@ -191,7 +207,7 @@ void OneDriveObject::move( FolderPtr /*source*/, FolderPtr destination )
     {   
         throw e.getCmisException( );
     }
-    string res = response->getStream( )->str( );
+    const string& res = response->getBody( );
     Json jsonRes = Json::parse( res );
 
     refreshImpl( jsonRes );
@@ -34,6 +34,7 @@
 #include "onedrive-folder.hxx"
 #include "onedrive-object.hxx"
 #include "onedrive-repository.hxx"
+#include "onedrive-utils.hxx"
 
 using namespace std;
 
@@ -119,7 +120,7 @@ libcmis::ObjectPtr OneDriveSession::getObject( string objectId )
         objectLink = m_bindingUrl + objectId;
     try
     {
-        res = httpGetRequest( objectLink )->getStream()->str();
+        res = httpGetRequest( objectLink )->getBody( );
     }
     catch ( const CurlException& e )
     {
@@ -129,6 +130,233 @@ libcmis::ObjectPtr OneDriveSession::getObject( string objectId )
     return getObjectFromJson( jsonRes );
 }
 
+vector< libcmis::ObjectResult > OneDriveSession::getObjects( const vector< string >& ids,
+                                                            const libcmis::BatchOptions& options )
+{
+    vector< HttpTransferPtr > requests;
+    for ( vector< string >::const_iterator it = ids.begin( ); it != ids.end( ); ++it )
+    {
+        string url = "/me/drive/items/" + *it;
+        if ( *it == getRootId( ) )
+            url = *it;
+        requests.push_back( HttpTransferPtr( new HttpTransfer( "GET", url ) ) );
+    }
+
+    httpRunBatchRequests( requests, options );
+
+    vector< libcmis::ObjectResult > results;
+    for ( size_t i = 0; i < ids.size( ); ++i )
+    {
+        try
+        {
+            if ( requests[i]->isFailed( ) )
+                throw requests[i]->getError( )->getCmisException( );
+
+            // A bad part of the batch response only fails its object
+            if ( !requests[i]->getResponse( ) )
+                throw libcmis::Exception( "No response for object " + ids[i] );
+            Json body = Json::parse( requests[i]->getResponse( )->getBody( ) );
+            if ( body.getDataType( ) != Json::json_object )
+                throw libcmis::Exception( "Invalid JSON response for object " + ids[i] );
+
+            libcmis::ObjectPtr object = getObjectFromJson( body );
+            if ( !object )
+                throw libcmis::Exception( "No such node: " + ids[i], "objectNotFound" );
+            results.push_back( libcmis::ObjectResult( ids[i], object ) );
+        }
+        catch ( const libcmis::Exception& e )
+        {
+            results.push_back( libcmis::ObjectResult( ids[i], e ) );
+        }
+        catch ( const exception& e )
+        {
+            results.push_back( libcmis::ObjectResult( ids[i], libcmis::Exception( e.what( ) ) ) );
+        }
+    }
+
+    return results;
+}
+
+vector< libcmis::UpdateResult > OneDriveSession::bulkUpdateProperties( const vector< string >& ids,
+        const libcmis::PropertyPtrMap& properties,
+        const vector< string >& addSecondaryTypes,
+        const vector< string >& removeSecondaryTypes,
+        const libcmis::BatchOptions& options )
+{
+    vector< libcmis::UpdateResult > results;
+    if ( !addSecondaryTypes.empty( ) || !removeSecondaryTypes.empty( ) )
+    {
+        for ( vector< string >::const_iterator it = ids.begin( ); it != ids.end( ); ++it )
+            results.push_back( libcmis::UpdateResult( *it,
+                        libcmis::Exception( "Secondary Types not supported", "constraint" ) ) );
+        return results;
+    }
+
+    string body = OneDriveUtils::toOneDriveJson( properties ).toString( );
+    vector< HttpTransferPtr > requests;
+    for ( vector< string >::const_iterator it = ids.begin( ); it != ids.end( ); ++it )
+        requests.push_back( HttpTransferPtr( new HttpTransfer( "PATCH", "/me/drive/items/" + *it,
+                        vector< string >( ), body ) ) );
+
+    httpRunBatchRequests( requests, options );
+
+    // The eTag is what Graph uses to detect concurrent changes
+    for ( size_t i = 0; i < ids.size( ); ++i )
+    {
+        try
+        {
+            if ( requests[i]->isFailed( ) )
+                throw requests[i]->getError( )->getCmisException( );
+
+            Json jsonRes = Json::parse( requests[i]->getResponse( )->getBody( ) );
+            results.push_back( libcmis::UpdateResult( ids[i], jsonRes["id"].toString( ),
+                        jsonRes["eTag"].toString( ) ) );
+        }
+        catch ( const libcmis::Exception& e )
+        {
+            results.push_back( libcmis::UpdateResult( ids[i], e ) );
+        }
+    }
+
+    return results;
+}
+
+vector< string > OneDriveSession::deleteObjects( const vector< string >& ids,
+                                                 const libcmis::BatchOptions& options )
+{
+    vector< HttpTransferPtr > requests;
+    for ( vector< string >::const_iterator it = ids.begin( ); it != ids.end( ); ++it )
+        requests.push_back( HttpTransferPtr( new HttpTransfer( "DELETE", string( "/me/drive/items/" ) + *it ) ) );
+
+    httpRunBatchRequests( requests, options );
+
+    vector< string > failed;
+    for ( size_t i = 0; i < ids.size( ); ++i )
+    {
+        if ( requests[i]->isFailed( ) && requests[i]->getHttpStatus( ) != 404 )
+            failed.push_back( ids[i] );
+    }
+    return failed;
+}
+
+vector< string > OneDriveSession::getContentChanges( string& changeLogToken )
+{
+    // The change log token is the delta link returned by the last page
+    vector< string > ids;
+    bool initial = changeLogToken.empty( );
+    string pageUrl = initial ? m_bindingUrl + "/me/drive/root/delta?token=latest" : changeLogToken;
+    try
+    {
+        while ( !pageUrl.empty( ) )
+        {
+            Json jsonRes = Json::parse( httpGetRequest( pageUrl )->getBody( ) );
+
+            Json::JsonVector items = jsonRes["value"].getList( );
+            for ( Json::JsonVector::iterator it = items.begin( ); it != items.end( ); ++it )
+                ids.push_back( ( *it )["id"].toString( ) );
+
+            // Keys with dots can't be accessed using operator[]
+            Json::JsonObject links = jsonRes.getObjects( );
+            pageUrl = links.count( "@odata.nextLink" ) ? links["@odata.nextLink"].toString( ) : string( );
+            if ( links.count( "@odata.deltaLink" ) )
+                changeLogToken = links["@odata.deltaLink"].toString( );
+        }
+    }
+    catch ( const CurlException& e )
+    {
+        throw e.getCmisException( );
+    }
+
+    if ( initial )
+        ids.clear( );
+    return ids;
+}
+
+void OneDriveSession::httpRunBatchRequests( vector< HttpTransferPtr >& requests,
+                                            const libcmis::BatchOptions& options )
+{
+    // Group the requests in $batch requests and send these concurrently
+    size_t batchSize = min( options.getMaxBatchSize( ), ONEDRIVE_BATCH_MAX_SIZE );
+
+    vector< HttpTransferPtr > batches;
+    Json batchRequests;
+    size_t batchCount = 0;
+    for ( size_t i = 0; i < requests.size( ); ++i )
+    {
+        HttpTransferPtr request = requests[i];
+        Json body;
+        if ( !request->getBody( ).empty( ) )
+            body = Json::parse( request->getBody( ) );
+        batchRequests.add( OneDriveUtils::createBatchRequest( to_string( i ), request->getMethod( ),
+                    request->getUrl( ), body ) );
+        ++batchCount;
+
+        if ( batchCount == batchSize || i == requests.size( ) - 1 )
+        {
+            Json batch;
+            batch.add( "requests", batchRequests );
+
+            vector< string > headers;
+            headers.push_back( "Content-Type:application/json" );
+            batches.push_back( HttpTransferPtr( new HttpTransfer( "POST", m_bindingUrl + "/$batch",
+                            headers, batch.toString( ) ) ) );
+            batchRequests = Json( );
+            batchCount = 0;
+        }
+    }
+
+    httpRunConcurrentRequests( batches, options.getMaxConcurrency( ) );
+
+    for ( size_t batch = 0; batch < batches.size( ); ++batch )
+    {
+        HttpTransferPtr batchRequest = batches[batch];
+        map< string, Json > responses;
+        if ( !batchRequest->isFailed( ) )
+            responses = OneDriveUtils::parseBatchResponse( batchRequest->getResponse( )->getBody( ) );
+
+        size_t first = batch * batchSize;
+        size_t last = min( first + batchSize, requests.size( ) );
+        for ( size_t i = first; i < last; ++i )
+        {
+            HttpTransferPtr request = requests[i];
+            string url = m_bindingUrl + request->getUrl( );
+            if ( batchRequest->isFailed( ) )
+            {
+                request->setResult( libcmis::HttpResponsePtr( ), batchRequest->getHttpStatus( ),
+                                    batchRequest->getError( ) );
+                continue;
+            }
+
+            map< string, Json >::iterator it = responses.find( to_string( i ) );
+            if ( it == responses.end( ) )
+            {
+                boost::shared_ptr< CurlException > error( new CurlException( "Missing batch response",
+                            CURLE_RECV_ERROR, url, 0 ) );
+                request->setResult( libcmis::HttpResponsePtr( ), 0, error );
+                continue;
+            }
+
+            long status = 0;
+            try
+            {
+                status = libcmis::parseInteger( it->second["status"].toString( ) );
+            }
+            catch ( const libcmis::Exception& )
+            {
+            }
+
+            libcmis::HttpResponsePtr response( new libcmis::HttpResponse( ) );
+            response->setBody( it->second["body"].toString( ) );
+
+            boost::shared_ptr< CurlException > error;
+            if ( status < 200 || status >= 300 )
+                error.reset( new CurlException( it->second["body"]["error"]["message"].toString( ),
+                            CURLE_HTTP_RETURNED_ERROR, url, status ) );
+            request->setResult( response, status, error );
+        }
+    }
+}
+
 libcmis::ObjectPtr OneDriveSession::getObjectFromJson( Json& jsonRes ) 
 {
     libcmis::ObjectPtr object;
@@ -153,7 +381,7 @@ libcmis::ObjectPtr OneDriveSession::getObjectByPath( string path )
     string objectQuery = m_bindingUrl + "/me/drive/root:" + libcmis::escape( path );
     try
     {
-        res = httpGetRequest( objectQuery )->getStream( )->str( );
+        res = httpGetRequest( objectQuery )->getBody( );
     }
     catch ( const CurlException& e )
     {
@@ -185,7 +413,7 @@ bool OneDriveSession::isAPathMatch( Json objectJson, string path )
     string parentUrl = m_bindingUrl + "/" + parentId;
     try
     {
-        res = httpGetRequest( parentUrl )->getStream( )->str( );
+        res = httpGetRequest( parentUrl )->getBody( );
     }
     catch ( const CurlException& e )
     {
@@ -51,6 +51,31 @@ class OneDriveSession : public BaseSession
 
         virtual libcmis::ObjectPtr getObject( std::string id );
 
+        virtual std::vector< libcmis::ObjectResult > getObjects( const std::vector< std::string >& ids,
+                                                                 const libcmis::BatchOptions& options = libcmis::BatchOptions( ) );
+
+        virtual std::vector< libcmis::UpdateResult > bulkUpdateProperties( const std::vector< std::string >& ids,
+                const libcmis::PropertyPtrMap& properties,
+                const std::vector< std::string >& addSecondaryTypes = std::vector< std::string >( ),
+                const std::vector< std::string >& removeSecondaryTypes = std::vector< std::string >( ),
+                const libcmis::BatchOptions& options = libcmis::BatchOptions( ) );
+
+        virtual std::vector< std::string > deleteObjects( const std::vector< std::string >& ids,
+                const libcmis::BatchOptions& options = libcmis::BatchOptions( ) );
+
+        virtual std::vector< std::string > getContentChanges( std::string& changeLogToken );
+
+        /** Run the requests using Graph $batch requests, several batches
+            being sent concurrently. The URL of the requests is relative to
+            the binding URL, like "/me/drive/items/id", and their body, if any,
+            has to be JSON.
+
+            Once run, each request holds its own response or error, just like
+            after HttpSession::httpRunConcurrentRequests( ).
+          */
+        void httpRunBatchRequests( std::vector< HttpTransferPtr >& requests,
+                                   const libcmis::BatchOptions& options );
+
         virtual libcmis::ObjectPtr getObjectByPath( std::string path );
 
         virtual libcmis::ObjectTypePtr getType( std::string id );
@@ -129,3 +129,30 @@ Json OneDriveUtils::toOneDriveJson( const PropertyPtrMap& properties )
 
     return propsJson;
 } 
+
+Json OneDriveUtils::createBatchRequest( const string& id, const string& method,
+                                       const string& url, const Json& body )
+{
+    Json request;
+    request.add( "id", Json( id.c_str( ) ) );
+    request.add( "method", Json( method.c_str( ) ) );
+    request.add( "url", Json( url.c_str( ) ) );
+    if ( !body.toString( ).empty( ) )
+    {
+        Json headers;
+        headers.add( "Content-Type", Json( "application/json" ) );
+        request.add( "headers", headers );
+        request.add( "body", body );
+    }
+    return request;
+}
+
+map< string, Json > OneDriveUtils::parseBatchResponse( const string& res )
+{
+    map< string, Json > responses;
+    Json jsonRes = Json::parse( res );
+    Json::JsonVector items = jsonRes["responses"].getList( );
+    for ( Json::JsonVector::iterator it = items.begin( ); it != items.end( ); ++it )
+        responses[ ( *it )["id"].toString( ) ] = *it;
+    return responses;
+}
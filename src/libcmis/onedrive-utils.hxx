@@ -28,12 +28,15 @@
 #ifndef _ONEDRIVE_UTILS_HXX_
 #define _ONEDRIVE_UTILS_HXX_
 
+#include <map>
 #include <string>
 
 #include <libcmis/property.hxx>
 
 #include "json-utils.hxx"
 
+static const unsigned int ONEDRIVE_BATCH_MAX_SIZE = 20;
+
 class OneDriveUtils
 {
     public :
@@ -55,6 +58,14 @@ class OneDriveUtils
 
         // Convert CMIS properties to OneDrive properties
         static Json toOneDriveJson( const libcmis::PropertyPtrMap& properties );
+
+        // Create one request entry of a Graph $batch request. The body is sent as JSON
+        // if it isn't empty.
+        static Json createBatchRequest( const std::string& id, const std::string& method,
+                                        const std::string& url, const Json& body = Json( ) );
+
+        // Get the responses of a Graph $batch request, indexed by the request id
+        static std::map< std::string, Json > parseBatchResponse( const std::string& res );
 };
 
 #endif
@@ -0,0 +1,59 @@
+/* libcmis
+ * Version: MPL 1.1 / GPLv2+ / LGPLv2+
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License or as specified alternatively below. You may obtain a copy of
+ * the License at http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * Major Contributor(s):
+ *
+ *
+ * All Rights Reserved.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPLv2+"), or
+ * the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+ * in which case the provisions of the GPLv2+ or the LGPLv2+ are applicable
+ * instead of those above.
+ */
+#ifndef _PROPERTY_TYPE_REGISTRY_HXX_
+#define _PROPERTY_TYPE_REGISTRY_HXX_
+
+#include <string>
+
+#include <libcmis/property-type.hxx>
+
+namespace libcmis
+{
+    /** Get a temporary property type shared by the properties with the same attributes.
+
+        Temporary types are created for the properties without a known type
+        definition: sharing them avoids creating one for each property of
+        every object. The returned type is flagged as shared and mustn't be
+        modified: Property::getPropertyType( ) hands out a copy of it.
+
+        \param xmlType
+            the type as found in the property element name, like string or datetime.
+      */
+    PropertyTypePtr getTemporaryPropertyType( const std::string& xmlType,
+                                              const std::string& id,
+                                              const std::string& localName,
+                                              const std::string& displayName,
+                                              const std::string& queryName );
+
+    /** Get the shared type of the cmis:contentStreamHash property, for the
+        bindings without type definitions from the server. It is created
+        only once and, like the temporary types, mustn't be modified.
+      */
+    PropertyTypePtr getContentStreamHashPropertyType( );
+}
+
+#endif
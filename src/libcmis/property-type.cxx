@@ -28,13 +28,99 @@
 
 #include <libcmis/property-type.hxx>
 
+#include <map>
+#include <mutex>
+#include <set>
+
 #include <libcmis/object-type.hxx>
 #include <libcmis/xml-utils.hxx>
 
+#include "property-type-registry.hxx"
+
 using namespace std;
 
+namespace
+{
+    /** Maximum number of shared temporary property types.
+
+        Beyond it, new temporary types aren't shared any more to keep
+        the memory bounded when talking to lots of different repositories.
+      */
+    const size_t MAX_TEMPORARY_TYPES = 4096;
+}
+
 namespace libcmis
 {
+    /** Registry of the interned property ids and shared temporary types.
+      */
+    class PropertyTypeRegistry
+    {
+        private:
+            mutex m_mutex;
+            set< string > m_ids;
+            map< string, PropertyTypePtr > m_types;
+
+        public:
+            PropertyTypeRegistry( ) : m_mutex( ), m_ids( ), m_types( ) { }
+
+            const string& intern( const string& id )
+            {
+                lock_guard< mutex > lock( m_mutex );
+                return *m_ids.insert( id ).first;
+            }
+
+            PropertyTypePtr getTemporaryType( const string& xmlType, const string& id,
+                    const string& localName, const string& displayName, const string& queryName )
+            {
+                // The attributes can't contain a nul character: use it as separator
+                string key;
+                key.reserve( xmlType.size( ) + id.size( ) + localName.size( ) +
+                             displayName.size( ) + queryName.size( ) + 4 );
+                key.append( xmlType ).append( 1, '\0' ).append( id ).append( 1, '\0' )
+                   .append( localName ).append( 1, '\0' ).append( displayName )
+                   .append( 1, '\0' ).append( queryName );
+
+                lock_guard< mutex > lock( m_mutex );
+                map< string, PropertyTypePtr >::iterator it = m_types.find( key );
+                if ( it != m_types.end( ) )
+                    return it->second;
+
+                PropertyTypePtr type( new PropertyType( xmlType, id,
+                            localName, displayName, queryName ) );
+                if ( m_types.size( ) < MAX_TEMPORARY_TYPES )
+                {
+                    type->m_shared = true;
+                    m_types[ key ] = type;
+                }
+                return type;
+            }
+
+            PropertyTypePtr getContentStreamHashType( )
+            {
+                static const PropertyTypePtr type( newContentStreamHashType( ) );
+                return type;
+            }
+
+        private:
+            static PropertyTypePtr newContentStreamHashType( )
+            {
+                PropertyTypePtr type( new PropertyType( "string", "cmis:contentStreamHash",
+                            "cmis:contentStreamHash", "Content Stream Hash", "cmis:contentStreamHash" ) );
+                type->setMultiValued( true );
+                type->m_shared = true;
+                return type;
+            }
+    };
+
+    namespace
+    {
+        PropertyTypeRegistry& lcl_getPropertyTypeRegistry( )
+        {
+            static PropertyTypeRegistry registry;
+            return registry;
+        }
+    }
+
     PropertyType::PropertyType( ) :
         m_id( ),
         m_localName( ),
@@ -50,7 +136,8 @@ namespace libcmis
         m_queryable( false ),
         m_orderable( false ),
         m_openChoice( false ),
-        m_temporary( false )
+        m_temporary( false ),
+        m_shared( false )
     {
     }
 
@@ -69,7 +156,8 @@ namespace libcmis
         m_queryable( false ),
         m_orderable( false ),
         m_openChoice( false ),
-        m_temporary( false )
+        m_temporary( false ),
+        m_shared( false )
     {
         for ( xmlNodePtr child = node->children; child; child = child->next )
         {
@@ -121,7 +209,8 @@ namespace libcmis
         m_queryable ( copy.m_queryable ),
         m_orderable ( copy.m_orderable ),
         m_openChoice ( copy.m_openChoice ),
-        m_temporary( copy.m_temporary )
+        m_temporary( copy.m_temporary ),
+        m_shared( false )
     {
     }
 
@@ -144,7 +233,8 @@ namespace libcmis
         m_queryable( false ),
         m_orderable( false ),
         m_openChoice( false ),
-        m_temporary( true )
+        m_temporary( true ),
+        m_shared( false )
     {
         setTypeFromXml( m_xmlType );
     }
@@ -223,6 +313,10 @@ namespace libcmis
 
     void PropertyType::update( vector< ObjectTypePtr > typesDefs )
     {
+        // The shared types are used by other properties: they can't change
+        if ( m_shared )
+            return;
+
         for ( vector< ObjectTypePtr >::iterator it = typesDefs.begin();
                 it != typesDefs.end( ) && m_temporary; ++it )
         {
@@ -251,4 +345,21 @@ namespace libcmis
             }
         }
     }
+
+    const string& internPropertyId( const string& id )
+    {
+        return lcl_getPropertyTypeRegistry( ).intern( id );
+    }
+
+    PropertyTypePtr getTemporaryPropertyType( const string& xmlType, const string& id,
+            const string& localName, const string& displayName, const string& queryName )
+    {
+        return lcl_getPropertyTypeRegistry( ).getTemporaryType( xmlType, id,
+                localName, displayName, queryName );
+    }
+
+    PropertyTypePtr getContentStreamHashPropertyType( )
+    {
+        return lcl_getPropertyTypeRegistry( ).getContentStreamHashType( );
+    }
 }
@@ -28,108 +28,202 @@
 
 #include <libcmis/property.hxx>
 
+#include <mutex>
+
 #include <boost/algorithm/string.hpp>
 
 #include <libcmis/object-type.hxx>
 #include <libcmis/xml-utils.hxx>
 
+#include "property-type-registry.hxx"
+
 using namespace std;
 
+namespace
+{
+    /** Guards the property types replaced by their copy: there are too
+        many properties to give each of them its own mutex.
+      */
+    mutex& lcl_getPropertyTypeMutex( )
+    {
+        static mutex propertyTypeMutex;
+        return propertyTypeMutex;
+    }
+
+    bool lcl_isValidValue( const boost::posix_time::ptime& value )
+    {
+        return !value.is_not_a_date_time( );
+    }
+
+    template< typename T > bool lcl_isValidValue( const T& )
+    {
+        return true;
+    }
+
+    template< typename T >
+    bool lcl_parseValue( const string& str, T ( *parse )( const string& ), T& value )
+    {
+        try
+        {
+            value = parse( str );
+            return lcl_isValidValue( value );
+        }
+        catch( const libcmis::Exception& )
+        {
+            // Just ignore the unparsable values
+        }
+        return false;
+    }
+
+    template< typename T >
+    libcmis::SmallValueArray< T > lcl_convertValues( const vector< string >& strValues,
+                                                     T ( *parse )( const string& ) )
+    {
+        libcmis::SmallValueArray< T > converted;
+        T value = T( );
+
+        // No need for a temporary vector for the common single value case
+        if ( strValues.size( ) == 1 )
+        {
+            if ( lcl_parseValue( strValues.front( ), parse, value ) )
+                converted.assign( &value, &value + 1 );
+            return converted;
+        }
+
+        vector< T > values;
+        values.reserve( strValues.size( ) );
+        for ( vector< string >::const_iterator it = strValues.begin( ); it != strValues.end( ); ++it )
+        {
+            if ( lcl_parseValue( *it, parse, value ) )
+                values.push_back( value );
+        }
+        converted.assign( values.begin( ), values.end( ) );
+        return converted;
+    }
+
+    template< typename T, typename Variant >
+    libcmis::PropertyValues< T > lcl_getValues( const Variant& typedValues )
+    {
+        const libcmis::SmallValueArray< T >* values =
+            boost::get< libcmis::SmallValueArray< T > >( &typedValues );
+        if ( values != NULL )
+            return values->view( );
+        return libcmis::PropertyValues< T >( );
+    }
+}
+
 namespace libcmis
 {
     Property::Property( ):
         m_propertyType( ),
         m_strValues( ),
-        m_boolValues( ),
-        m_longValues( ),
-        m_doubleValues( ),
-        m_dateTimeValues( )
+        m_typedValues( )
     {
     }
 
     Property::Property( PropertyTypePtr propertyType, std::vector< std::string > strValues ) :
         m_propertyType( propertyType ),
         m_strValues( ),
-        m_boolValues( ),
-        m_longValues( ),
-        m_doubleValues( ),
-        m_dateTimeValues( )
+        m_typedValues( )
     {
         setValues( strValues );
     }
 
+    PropertyValues< long > Property::getLongValues( ) const
+    {
+        return lcl_getValues< long >( m_typedValues );
+    }
+
+    PropertyValues< double > Property::getDoubleValues( ) const
+    {
+        return lcl_getValues< double >( m_typedValues );
+    }
+
+    PropertyValues< bool > Property::getBoolValues( ) const
+    {
+        return lcl_getValues< bool >( m_typedValues );
+    }
+
+    PropertyValues< boost::posix_time::ptime > Property::getDateTimeValues( ) const
+    {
+        return lcl_getValues< boost::posix_time::ptime >( m_typedValues );
+    }
+
     void Property::setValues( vector< string > strValues )
     {
-        m_strValues = strValues;
-        m_boolValues.clear( );
-        m_longValues.clear( );
-        m_doubleValues.clear( );
-        m_dateTimeValues.clear( );
+        // If no PropertyType was provided at construction time, use String
+        PropertyType::Type type = PropertyType::String;
+        if ( m_propertyType != NULL )
+            type = m_propertyType->getType( );
 
-        for ( vector< string >::iterator it = strValues.begin(); it != strValues.end( ); ++it )
+        switch ( type )
         {
-            try
-            {
-                // If no PropertyType was provided at construction time, use String
-                PropertyType::Type type = PropertyType::String;
-                if ( getPropertyType( ) != NULL )
-                    type = getPropertyType( )->getType( );
-
-                switch ( type )
-                {
-                    case PropertyType::Integer:
-                        m_longValues.push_back( parseInteger( *it ) );
-                        break;
-                    case PropertyType::Decimal:
-                        m_doubleValues.push_back( parseDouble( *it ) );
-                        break;
-                    case PropertyType::Bool:
-                        m_boolValues.push_back( parseBool( *it ) );
-                        break;
-                    case PropertyType::DateTime:
-                        {
-                            boost::posix_time::ptime time = parseDateTime( *it );
-                            if ( !time.is_not_a_date_time( ) )
-                                m_dateTimeValues.push_back( time );
-                        }
-                        break;
-                    default:
-                    case PropertyType::String:
-                        // Nothing to convert for strings
-                        break;
-                }
-            }
-            catch( const Exception& )
-            {
-                // Just ignore the unparsable values
-            }
+            case PropertyType::Integer:
+                m_typedValues = lcl_convertValues< long >( strValues, parseInteger );
+                break;
+            case PropertyType::Decimal:
+                m_typedValues = lcl_convertValues< double >( strValues, parseDouble );
+                break;
+            case PropertyType::Bool:
+                m_typedValues = lcl_convertValues< bool >( strValues, parseBool );
+                break;
+            case PropertyType::DateTime:
+                m_typedValues = lcl_convertValues< boost::posix_time::ptime >( strValues, parseDateTime );
+                break;
+            default:
+            case PropertyType::String:
+                // Nothing to convert for strings
+                m_typedValues = boost::blank( );
+                break;
         }
+
+        m_strValues.assign( make_move_iterator( strValues.begin( ) ),
+                            make_move_iterator( strValues.end( ) ) );
+    }
+
+    PropertyTypePtr Property::getPropertyType( )
+    {
+        // Don't let the callers modify a type shared with other properties
+        lock_guard< mutex > lock( lcl_getPropertyTypeMutex( ) );
+        if ( m_propertyType && m_propertyType->isShared( ) )
+            m_propertyType.reset( new PropertyType( *m_propertyType ) );
+        return m_propertyType;
+    }
+
+    boost::shared_ptr< const PropertyType > Property::getPropertyTypeView( ) const
+    {
+        lock_guard< mutex > lock( lcl_getPropertyTypeMutex( ) );
+        return m_propertyType;
     }
 
     void Property::setPropertyType( PropertyTypePtr propertyType)
     {
+        lock_guard< mutex > lock( lcl_getPropertyTypeMutex( ) );
         m_propertyType = propertyType;
     }
+
     void Property::toXml( xmlTextWriterPtr writer )
     {
         // Don't write the property if we have no type for it.
-        if ( getPropertyType( ) != NULL )
+        boost::shared_ptr< const PropertyType > propertyType = getPropertyTypeView( );
+        if ( propertyType != NULL )
         {
-            string xmlType = string( "cmis:property" ) + getPropertyType()->getXmlType( );
+            string xmlType = string( "cmis:property" ) + propertyType->getXmlType( );
             xmlTextWriterStartElement( writer, BAD_CAST( xmlType.c_str( ) ) );
 
             // Write the attributes
             xmlTextWriterWriteFormatAttribute( writer, BAD_CAST( "propertyDefinitionId" ),
-                    "%s", BAD_CAST( getPropertyType()->getId( ).c_str( ) ) );
+                    "%s", BAD_CAST( propertyType->getId( ).c_str( ) ) );
             xmlTextWriterWriteFormatAttribute( writer, BAD_CAST( "localName" ),
-                    "%s", BAD_CAST( getPropertyType()->getLocalName( ).c_str( ) ) );
+                    "%s", BAD_CAST( propertyType->getLocalName( ).c_str( ) ) );
             xmlTextWriterWriteFormatAttribute( writer, BAD_CAST( "displayName" ),
-                    "%s", BAD_CAST( getPropertyType()->getDisplayName( ).c_str( ) ) );
+                    "%s", BAD_CAST( propertyType->getDisplayName( ).c_str( ) ) );
             xmlTextWriterWriteFormatAttribute( writer, BAD_CAST( "queryName" ),
-                    "%s", BAD_CAST( getPropertyType()->getQueryName( ).c_str( ) ) );
+                    "%s", BAD_CAST( propertyType->getQueryName( ).c_str( ) ) );
 
             // Write the values
-            for ( vector< string >::iterator it = m_strValues.begin( ); it != m_strValues.end( ); ++it )
+            PropertyValues< string > values = getStringValues( );
+            for ( PropertyValues< string >::const_iterator it = values.begin( ); it != values.end( ); ++it )
             {
                 xmlTextWriterWriteElement( writer, BAD_CAST( "cmis:value" ), BAD_CAST( it->c_str( ) ) );
             }
@@ -141,10 +235,11 @@ namespace libcmis
     string Property::toString( )
     {
         string res;
-        if ( getPropertyType( ) != NULL )
+        if ( getPropertyTypeView( ) != NULL )
         {
-            for ( vector< string >::iterator it = m_strValues.begin( );
-                    it != m_strValues.end( ); ++it )
+            PropertyValues< string > values = getStringValues( );
+            for ( PropertyValues< string >::const_iterator it = values.begin( );
+                    it != values.end( ); ++it )
             {
                 res.append( *it );
             }
@@ -197,9 +292,9 @@ namespace libcmis
                         boost::to_lower( xmlType );
                     }
 
-                    propType.reset( new PropertyType( xmlType, propDefinitionId,
-                                                      localName, displayName,
-                                                      queryName ) );
+                    propType = getTemporaryPropertyType( xmlType, propDefinitionId,
+                                                         localName, displayName,
+                                                         queryName );
                 }
             }
 
@@ -45,6 +45,7 @@ namespace libcmis
         m_productVersion( ),
         m_rootId( ),
         m_cmisVersionSupported( ),
+        m_latestChangeLogToken( ),
         m_thinClientUri( ),
         m_principalAnonymous( ),
         m_principalAnyone( ),
@@ -61,6 +62,7 @@ namespace libcmis
         m_productVersion( ),
         m_rootId( ),
         m_cmisVersionSupported( ),
+        m_latestChangeLogToken( ),
         m_thinClientUri( ),
         m_principalAnonymous( ),
         m_principalAnyone( ),
@@ -109,6 +111,11 @@ namespace libcmis
         return m_cmisVersionSupported;
     }
 
+    string Repository::getLatestChangeLogToken( ) const
+    {
+        return m_latestChangeLogToken;
+    }
+
     boost::shared_ptr< string > Repository::getThinClientUri( ) const
     {
         return m_thinClientUri;
@@ -151,6 +158,8 @@ namespace libcmis
                 m_rootId = value;
             else if ( localName == "cmisVersionSupported" )
                 m_cmisVersionSupported = value;
+            else if ( localName == "latestChangeLogToken" )
+                m_latestChangeLogToken = value;
             else if ( localName == "thinClientURI" )
                 m_thinClientUri.reset( new string( value ) );
             else if ( localName == "principalAnonymous" )
@@ -49,6 +49,8 @@ namespace libcmis
 
     CertValidationHandlerPtr SessionFactory::s_certValidationHandler;
 
+    OAuth2TokenStorePtr SessionFactory::s_oauth2TokenStore;
+
     void SessionFactory::setCurlInitProtocolsFunction(CurlInitProtocolsFunction const initProtocols)
     {
         g_CurlInitProtocolsFunction = initProtocols;
@@ -95,7 +97,7 @@ namespace libcmis
 
                 try
                 {
-                    response = httpSession->httpGetRequest( bindingUrl );
+                    response = httpSession->httpGetRequest( bindingUrl, XmlContentHandler::getInstance( ) );
                 }
                 catch (const CurlException& e)
                 {
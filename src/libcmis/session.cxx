@@ -0,0 +1,137 @@
+/* libcmis
+ * Version: MPL 1.1 / GPLv2+ / LGPLv2+
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License or as specified alternatively below. You may obtain a copy of
+ * the License at http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * Major Contributor(s):
+ *
+ *
+ * All Rights Reserved.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPLv2+"), or
+ * the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+ * in which case the provisions of the GPLv2+ or the LGPLv2+ are applicable
+ * instead of those above.
+ */
+
+
+#include <libcmis/session.hxx>
+
+#include <algorithm>
+
+#include <libcmis/exception.hxx>
+
+using namespace std;
+
+namespace libcmis
+{
+    vector< ObjectResult > Session::getObjects( const vector< string >& ids,
+                                                const BatchOptions& )
+    {
+        vector< ObjectResult > results;
+        for ( vector< string >::const_iterator it = ids.begin( ); it != ids.end( ); ++it )
+        {
+            try
+            {
+                ObjectPtr object = getObject( *it );
+                if ( object )
+                    results.push_back( ObjectResult( *it, object ) );
+                else
+                    results.push_back( ObjectResult( *it,
+                                Exception( "No such node: " + *it, "objectNotFound" ) ) );
+            }
+            catch ( const Exception& e )
+            {
+                results.push_back( ObjectResult( *it, e ) );
+            }
+        }
+        return results;
+    }
+
+    vector< UpdateResult > Session::bulkUpdateProperties( const vector< string >& ids,
+            const PropertyPtrMap& properties,
+            const vector< string >& addSecondaryTypes,
+            const vector< string >& removeSecondaryTypes,
+            const BatchOptions& )
+    {
+        // The session doesn't know how its requests are sent, so the objects
+        // can only be updated one after the other here: the HTTP sessions
+        // override this to send the requests concurrently.
+        vector< UpdateResult > results;
+        for ( vector< string >::const_iterator it = ids.begin( ); it != ids.end( ); ++it )
+        {
+            try
+            {
+                ObjectPtr object = getObject( *it );
+                if ( !object )
+                    throw Exception( "No such node: " + *it, "objectNotFound" );
+
+                PropertyPtrMap newProperties = getBulkUpdateProperties( object, properties,
+                        addSecondaryTypes, removeSecondaryTypes );
+                ObjectPtr updated = object->updateProperties( newProperties );
+                if ( !updated )
+                    updated = object;
+                results.push_back( UpdateResult( *it, updated->getId( ), updated->getChangeToken( ) ) );
+            }
+            catch ( const Exception& e )
+            {
+                results.push_back( UpdateResult( *it, e ) );
+            }
+        }
+        return results;
+    }
+
+    vector< string > Session::getContentChanges( string& )
+    {
+        throw Exception( "Change log not supported", "notSupported" );
+    }
+
+    PropertyPtrMap Session::getBulkUpdateProperties( ObjectPtr object,
+            const PropertyPtrMap& properties,
+            const vector< string >& addSecondaryTypes,
+            const vector< string >& removeSecondaryTypes )
+    {
+        PropertyPtrMap newProperties( properties );
+        if ( addSecondaryTypes.empty( ) && removeSecondaryTypes.empty( ) )
+            return newProperties;
+
+        // Same as Object::addSecondaryType( ) and Object::removeSecondaryType( ),
+        // but with all the changes at once.
+        map< string, PropertyTypePtr >& propertyTypes = object->getTypeDescription( )->
+            getPropertiesTypes( );
+        map< string, PropertyTypePtr >::iterator typeIt = propertyTypes.find( "cmis:secondaryObjectTypeIds" );
+        if ( typeIt == propertyTypes.end( ) )
+            throw Exception( "Secondary Types not supported", "constraint" );
+
+        vector< string > secTypes = object->getSecondaryTypes( );
+        vector< string > newSecTypes;
+        for ( vector< string >::iterator it = secTypes.begin( ); it != secTypes.end( ); ++it )
+        {
+            if ( find( removeSecondaryTypes.begin( ), removeSecondaryTypes.end( ), *it ) == removeSecondaryTypes.end( ) )
+                newSecTypes.push_back( *it );
+        }
+        for ( vector< string >::const_iterator it = addSecondaryTypes.begin( ); it != addSecondaryTypes.end( ); ++it )
+        {
+            if ( find( newSecTypes.begin( ), newSecTypes.end( ), *it ) == newSecTypes.end( ) )
+                newSecTypes.push_back( *it );
+        }
+
+        // No need to update the property if it didn't change
+        if ( newSecTypes != secTypes )
+            newProperties["cmis:secondaryObjectTypeIds"] =
+                PropertyPtr( new Property( typeIt->second, newSecTypes ) );
+
+        return newProperties;
+    }
+}
@@ -79,6 +79,12 @@ boost::shared_ptr< istream > SharePointDocument::getContentStream( string /*stre
     return stream;
 }
 
+string SharePointDocument::getContentUrl( )
+{
+    // file uri + /$value
+    return getId( ) + "/%24value";
+}
+
 void SharePointDocument::setContentStream( boost::shared_ptr< ostream > os, 
                                            string contentType, 
                                            string /*fileName*/, 
@@ -183,7 +189,7 @@ vector< libcmis::DocumentPtr > SharePointDocument::getAllVersions( )
     vector< libcmis::DocumentPtr > allVersions;
     try
     {
-        res = getSession( )->httpGetRequest( url )->getStream( )->str( );
+        res = getSession( )->httpGetRequest( url + "?%24select=ID" )->getBody( );
     }
     catch ( const CurlException& e )
     {
@@ -197,7 +203,7 @@ vector< libcmis::DocumentPtr > SharePointDocument::getAllVersions( )
     allVersions.push_back( doc );
 
     Json jsonRes = Json::parse( res );
-    Json::JsonVector objs = jsonRes["d"]["results"].getList( );
+    Json::JsonVector objs = SharePointUtils::getResults( jsonRes );
     for ( unsigned int i = 0; i < objs.size( ); i++) 
     {
         string versionNumber = objs[i]["ID"].toString( );
@@ -51,6 +51,8 @@ class SharePointDocument : public libcmis::Document, public SharePointObject
         virtual std::vector< libcmis::FolderPtr > getParents( );
         virtual boost::shared_ptr< std::istream > getContentStream( std::string streamId = std::string( ) );
 
+        virtual std::string getContentUrl( );
+
         virtual void setContentStream( boost::shared_ptr< std::ostream > os, 
                                        std::string contentType,
                                        std::string fileName, 
@@ -36,6 +36,30 @@
 using namespace std;
 using namespace libcmis;
 
+namespace
+{
+    // Only request the fields used by the objects
+    const string FILE_FIELDS( "CheckInComment,CheckOutType,ETag,Length,MajorVersion,MinorVersion,"
+                              "Name,ServerRelativeUrl,TimeCreated,TimeLastModified,Title,"
+                              "UIVersionLabel" );
+    const string FOLDER_FIELDS( "ItemCount,Name,ServerRelativeUrl" );
+
+    // The default list view threshold of SharePoint
+    const string PAGE_SIZE( "5000" );
+
+    string lcl_prefixFields( const string& prefix, const string& fields )
+    {
+        string prefixed = prefix;
+        for ( string::const_iterator it = fields.begin( ); it != fields.end( ); ++it )
+        {
+            prefixed += *it;
+            if ( *it == ',' )
+                prefixed += prefix;
+        }
+        return prefixed;
+    }
+}
+
 SharePointFolder::SharePointFolder( SharePointSession* session ):
     libcmis::Object( session ),
     SharePointObject( session )
@@ -61,7 +85,8 @@ string SharePointFolder::getParentId( )
         string res;
         try
         {
-            res = getSession( )->httpGetRequest( parentUrl )->getStream( )->str( );
+            res = getSession( )->httpGetRequest( parentUrl + "?%24select=" +
+                    FOLDER_FIELDS )->getBody( );
         }
         catch ( const CurlException& e )
         {
@@ -69,7 +94,8 @@ string SharePointFolder::getParentId( )
         }
 
         Json jsonRes = Json::parse( res );
-        parentId = jsonRes["d"]["__metadata"]["uri"].toString( );
+        parentId = SharePointUtils::getObjectUrl( SharePointUtils::getData( jsonRes ),
+                                                  getSession( )->getBindingUrl( ) );
         PropertyPtr property;
         property.reset( new SharePointProperty( "cmis:parentId",
                         Json( parentId.c_str( ) ) ) );
@@ -80,35 +106,92 @@ string SharePointFolder::getParentId( )
 
 vector< libcmis::ObjectPtr > SharePointFolder::getChildren( ) 
 {
-    vector< libcmis::ObjectPtr > children;
-    string filesUrl = getStringProperty( "Files" );
-    string foldersUrl = getStringProperty( "Folders" );
+    Json::JsonVector folders;
+    Json::JsonVector files;
+    string foldersUrl;
+    string filesUrl;
 
-    Json::JsonVector objs = getChildrenImpl( filesUrl );
-    Json::JsonVector folders = getChildrenImpl( foldersUrl );
-    objs.insert( objs.begin( ), folders.begin( ), folders.end( ) );
+    // Get the first page of the files, the folders and the parent folder at once
+    bool needsParent = getStringProperty( "cmis:parentId" ).empty( ) &&
+                       getId( ) != getSession( )->getRepository( )->getRootId( );
+    string url = getId( ) + "?%24expand=Files,Folders";
+    if ( needsParent )
+        url += ",ParentFolder";
+    url += "&%24select=" + lcl_prefixFields( "Files/", FILE_FIELDS ) + "," +
+           lcl_prefixFields( "Folders/", FOLDER_FIELDS );
+    if ( needsParent )
+        url += "," + lcl_prefixFields( "ParentFolder/", FOLDER_FIELDS );
 
-    for ( unsigned int i = 0; i < objs.size( ); i++)
+    bool expanded = false;
+    try
     {
-        children.push_back( getSession( )->getObjectFromJson( objs[i], getId( ) ) );
+        string res = getSession( )->httpGetRequest( url )->getBody( );
+        Json jsonRes = SharePointUtils::getData( Json::parse( res ) );
+        expanded = SharePointUtils::getExpandedResults( jsonRes, "Folders", folders, foldersUrl ) &&
+                   SharePointUtils::getExpandedResults( jsonRes, "Files", files, filesUrl );
+
+        string parentId = SharePointUtils::getObjectUrl( jsonRes["ParentFolder"],
+                                                         getSession( )->getBindingUrl( ) );
+        if ( expanded && needsParent && !parentId.empty( ) )
+        {
+            PropertyPtr property( new SharePointProperty( "cmis:parentId",
+                                                          Json( parentId.c_str( ) ) ) );
+            m_properties[ property->getPropertyType( )->getId()] = property;
+        }
+    }
+    catch ( const CurlException& )
+    {
+        // The server may refuse the expansion of big lists, list them separately
     }
-    return children;
-}
 
-Json::JsonVector SharePointFolder::getChildrenImpl( string url )
-{
-    string res;
-    try
+    if ( !expanded )
     {
-        res = getSession( )->httpGetRequest( url )->getStream( )->str( );
+        folders.clear( );
+        files.clear( );
+        foldersUrl = getStringProperty( "Folders" ) + "?%24select=" + FOLDER_FIELDS +
+                     "&%24top=" + PAGE_SIZE;
+        filesUrl = getStringProperty( "Files" ) + "?%24select=" + FILE_FIELDS +
+                   "&%24top=" + PAGE_SIZE;
     }
-    catch ( const CurlException& e )
+
+    // Get the remaining pages of both lists in parallel
+    string* urls[] = { &foldersUrl, &filesUrl };
+    Json::JsonVector* lists[] = { &folders, &files };
+    while ( !foldersUrl.empty( ) || !filesUrl.empty( ) )
     {
-        throw e.getCmisException( );
+        vector< HttpTransferPtr > requests;
+        vector< size_t > listIndexes;
+        for ( size_t i = 0; i < 2; ++i )
+        {
+            if ( urls[i]->empty( ) )
+                continue;
+            requests.push_back( HttpTransferPtr( new HttpTransfer( "GET", *urls[i] ) ) );
+            listIndexes.push_back( i );
+        }
+
+        getSession( )->httpRunConcurrentRequests( requests, requests.size( ) );
+
+        for ( size_t j = 0; j < requests.size( ); ++j )
+        {
+            if ( requests[j]->isFailed( ) )
+                throw requests[j]->getError( )->getCmisException( );
+
+            Json jsonRes = Json::parse( requests[j]->getResponse( )->getBody( ) );
+            Json::JsonVector page = SharePointUtils::getResults( jsonRes );
+            size_t index = listIndexes[j];
+            lists[index]->insert( lists[index]->end( ), page.begin( ), page.end( ) );
+            *urls[index] = SharePointUtils::getNextLink( jsonRes );
+        }
     }
-    Json jsonRes = Json::parse( res );
-    Json::JsonVector objs = jsonRes["d"]["results"].getList( );
-    return objs;
+
+    vector< libcmis::ObjectPtr > children;
+    Json::JsonVector objs = folders;
+    objs.insert( objs.end( ), files.begin( ), files.end( ) );
+    for ( unsigned int i = 0; i < objs.size( ); i++)
+    {
+        children.push_back( getSession( )->getObjectFromJson( objs[i], getId( ) ) );
+    }
+    return children;
 }
 
 libcmis::FolderPtr SharePointFolder::createFolder( const PropertyPtrMap& properties ) 
@@ -140,7 +223,7 @@ libcmis::FolderPtr SharePointFolder::createFolder( const PropertyPtrMap& propert
     string res;
     try 
     {   
-        res = getSession( )->httpPostRequest( folderUrl, is, "" )->getStream( )->str( );
+        res = getSession( )->httpPostRequest( folderUrl, is, "" )->getBody( );
     }
     catch ( const CurlException& e )
     {   
@@ -181,7 +264,7 @@ libcmis::DocumentPtr SharePointFolder::createDocument( const PropertyPtrMap& pro
     string res;
     try
     {
-        res = getSession( )->httpPostRequest( url, *is, contentType )->getStream( )->str( );
+        res = getSession( )->httpPostRequest( url, *is, contentType )->getBody( );
     }
     catch ( const CurlException& e )
     {
@@ -195,9 +278,28 @@ libcmis::DocumentPtr SharePointFolder::createDocument( const PropertyPtrMap& pro
 
 vector< string > SharePointFolder::removeTree( bool /*allVersions*/, 
                                                libcmis::UnfileObjects::Type /*unfile*/, 
-                                               bool /*continueOnError*/ ) 
+                                               bool continueOnError ) 
 {
-    remove( ); 
-    // Nothing to return here
+    try
+    {
+        getSession( )->httpDeleteRequest( getId( ) );
+    }
+    catch ( const CurlException& e )
+    {
+        if ( e.getErrorCode( ) != CURLE_HTTP_RETURNED_ERROR || e.getHttpStatus( ) == 404 )
+            throw e.getCmisException( );
+
+        // The server doesn't tell which objects couldn't be deleted:
+        // delete the tree from here to find them out.
+        try
+        {
+            return getSession( )->removeTreeConcurrently( *this, continueOnError );
+        }
+        catch ( const libcmis::Exception& )
+        {
+            throw e.getCmisException( );
+        }
+    }
+
     return vector< string >( );
 }
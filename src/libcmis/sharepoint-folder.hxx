@@ -49,8 +49,6 @@ class SharePointFolder : public libcmis::Folder, public SharePointObject
         virtual std::string getParentId( );
         virtual std::vector< libcmis::ObjectPtr > getChildren( );
 
-        Json::JsonVector getChildrenImpl( std::string url );
-
         virtual libcmis::FolderPtr createFolder( const libcmis::PropertyPtrMap& properties );
 
         virtual libcmis::DocumentPtr createDocument( const libcmis::PropertyPtrMap& properties, 
@@ -62,15 +62,15 @@ SharePointObject& SharePointObject::operator=( const SharePointObject& copy )
 
 void SharePointObject::initializeFromJson ( Json json, string parentId, string /*name*/ )
 {
-    if ( !json["d"].toString( ).empty( ) ) {
-        // Basic GET requests receive the data inside a "d" object, 
-        // but child listing doesn't, so this unifies the representation
-        json = json["d"];
-    }
+    // Basic GET requests receive the data inside a "d" object in the verbose
+    // format, but child listing doesn't, so this unifies the representation
+    json = SharePointUtils::getData( json );
     Json::JsonObject objs = json.getObjects( );
     Json::JsonObject::iterator it;
     PropertyPtr property;
-    bool isFolder = json["__metadata"]["type"].toString( ) == "SP.Folder";
+    string type = SharePointUtils::getObjectType( json );
+    bool isFolder = type == "SP.Folder";
+    bool isVersion = type == "SP.FileVersion";
     for ( it = objs.begin( ); it != objs.end( ); ++it)
     {
         property.reset( new SharePointProperty( it->first, it->second ) );
@@ -82,6 +82,42 @@ void SharePointObject::initializeFromJson ( Json json, string parentId, string /
         }
     }
 
+    if ( getId( ).empty( ) )
+    {
+        // The nometadata format has no object URL
+        string id = SharePointUtils::getObjectUrl( json, getSession( )->getBindingUrl( ) );
+        property.reset( new SharePointProperty( "cmis:objectId", Json( id.c_str( ) ) ) );
+        m_properties[ property->getPropertyType( )->getId()] = property;
+    }
+
+    // The JSON light formats have no deferred links, the verbose format
+    // only has the ones of the $selected and not expanded navigation properties
+    vector< string > navigationProperties;
+    if ( isFolder )
+    {
+        navigationProperties = { "Files", "Folders", "ListItemAllFields",
+                                 "ParentFolder", "Properties" };
+    }
+    else if ( isVersion )
+    {
+        navigationProperties = { "CreatedBy" };
+    }
+    else
+    {
+        navigationProperties = { "Author", "CheckedOutByUser", "ListItemAllFields",
+                                 "LockedByUser", "ModifiedBy", "Properties", "Versions" };
+    }
+    for ( vector< string >::iterator navIt = navigationProperties.begin( );
+          navIt != navigationProperties.end( ); ++navIt )
+    {
+        if ( getStringProperty( *navIt ).empty( ) )
+        {
+            string url = getId( ) + "/" + *navIt;
+            property.reset( new SharePointProperty( *navIt, Json( url.c_str( ) ) ) );
+            m_properties[ property->getPropertyType( )->getId()] = property;
+        }
+    }
+
     if ( !parentId.empty( ) )
     {
         // ParentId is not provided in the response
@@ -92,27 +128,26 @@ void SharePointObject::initializeFromJson ( Json json, string parentId, string /
     if ( !isFolder )
     {
         string authorUrl = getStringProperty( "Author" );
-        if ( authorUrl.empty( ) )
-        {
-            // it's a file version
+        if ( isVersion )
            authorUrl = getStringProperty( "CreatedBy" );
-        }
-        Json authorJson = getSession( )->getJsonFromUrl( authorUrl );
+        Json authorJson = getSession( )->getJsonFromUrl( authorUrl + "?%24select=Title" );
         property.reset( new SharePointProperty( "cmis:createdBy", 
-                    authorJson["d"]["Title"] ) );
+                    SharePointUtils::getData( authorJson )["Title"] ) );
         m_properties[ property->getPropertyType( )->getId( ) ] = property;
     }
     else
     {
         // we need to get the creation and lastUpdate time which aren't
         // provided in the response
-        Json propJson = getSession( )->getJsonFromUrl( getStringProperty( "Properties" ) );
+        Json propJson = getSession( )->getJsonFromUrl( getStringProperty( "Properties" ) +
+                "?%24select=vti_x005f_timecreated,vti_x005f_timelastmodified" );
+        propJson = SharePointUtils::getData( propJson );
         property.reset( new SharePointProperty( "cmis:creationDate", 
-                    propJson["d"]["vti_x005f_timecreated"] ) );
+                    propJson["vti_x005f_timecreated"] ) );
         m_properties[ property->getPropertyType( )->getId( ) ] = property;
 
         property.reset( new SharePointProperty( "cmis:lastModificationDate", 
-                    propJson["d"]["vti_x005f_timelastmodified"] ) );
+                    propJson["vti_x005f_timelastmodified"] ) );
         m_properties[ property->getPropertyType( )->getId( ) ] = property;
     }
 
@@ -137,7 +172,7 @@ void SharePointObject::refresh( )
     string res;
     try
     {
-        res  = getSession( )->httpGetRequest( getId( ) )->getStream( )->str( );
+        res  = getSession( )->httpGetRequest( getId( ) )->getBody( );
     }
     catch ( const CurlException& e )
     {
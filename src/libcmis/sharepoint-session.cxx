@@ -28,6 +28,11 @@
 
 #include "sharepoint-session.hxx"
 
+#include <cstdlib>
+#include <ctime>
+#include <map>
+#include <mutex>
+
 #include <libcmis/session-factory.hxx>
 
 #include "sharepoint-document.hxx"
@@ -39,6 +44,46 @@
 
 using namespace std;
 
+namespace
+{
+    /** Use the requested URL as the object URL if the response has none,
+        like in the nometadata format.
+      */
+    Json lcl_setDefaultUrl( Json json, const string& url )
+    {
+        Json data = SharePointUtils::getData( json );
+        if ( SharePointUtils::getObjectUrl( data, string( ) ).empty( ) )
+            data.add( "odata.id", Json( url.c_str( ) ) );
+        return data;
+    }
+
+    // Renew the request digests a bit before they expire
+    const time_t DIGEST_RENEWAL_MARGIN = 60;
+
+    struct CachedDigest
+    {
+        string m_digestCode{ };
+        time_t m_expiry = 0;
+        bool m_verboseOData = false;
+    };
+
+    /** Request digests shared by the sessions of the same site and user.
+      */
+    map< string, CachedDigest >& lcl_getDigestCache( mutex*& cacheMutex )
+    {
+        static mutex digestCacheMutex;
+        static map< string, CachedDigest > digestCache;
+        cacheMutex = &digestCacheMutex;
+        return digestCache;
+    }
+
+    bool lcl_isDigestExpired( time_t expiry )
+    {
+        // Without timeout the digest is only renewed when refused
+        return expiry != 0 && time( NULL ) >= expiry;
+    }
+}
+
 SharePointSession::SharePointSession ( string baseUrl,
                                string username,
                                string password,
@@ -46,7 +91,10 @@ SharePointSession::SharePointSession ( string baseUrl,
                                libcmis::CurlInitProtocolsFunction initProtocolsFunction) :
     BaseSession( baseUrl, string(), username, password, false,
                  libcmis::OAuth2DataPtr(), verbose, initProtocolsFunction ),
-    m_digestCode( string( ) ) 
+    m_digestCode( string( ) ),
+    m_digestExpiry( 0 ),
+    m_digestFallbackCount( 0 ),
+    m_verboseOData( false )
 
 {
     setAuthMethod( CURLAUTH_NTLM );
@@ -70,9 +118,12 @@ SharePointSession::SharePointSession( string baseUrl,
                                       const HttpSession& httpSession,
                                       libcmis::HttpResponsePtr response ) :
     BaseSession( baseUrl, string(), httpSession ),
-    m_digestCode( string( ) ) 
+    m_digestCode( string( ) ),
+    m_digestExpiry( 0 ),
+    m_digestFallbackCount( 0 ),
+    m_verboseOData( false )
 {
-    if ( !SharePointUtils::isSharePoint( response->getStream( )->str( ) ) )
+    if ( !SharePointUtils::isSharePoint( response->getBody( ) ) )
     {
         throw libcmis::Exception( "Not a SharePoint service" );
     }
@@ -82,7 +133,8 @@ SharePointSession::SharePointSession( string baseUrl,
 }
 
 SharePointSession::SharePointSession() :
-    BaseSession(), m_digestCode( string( ) )
+    BaseSession(), m_digestCode( string( ) ), m_digestExpiry( 0 ),
+    m_digestFallbackCount( 0 ), m_verboseOData( false )
 {
 }
 
@@ -108,23 +160,92 @@ libcmis::ObjectPtr SharePointSession::getObject( string objectId )
     string res;
     try
     {
-        res = httpGetRequest( objectId )->getStream()->str();
+        res = httpGetRequest( objectId )->getBody( );
     }
     catch ( const CurlException& e )
     {
         throw e.getCmisException( );
     }
-    Json jsonRes = Json::parse( res );
+    Json jsonRes = lcl_setDefaultUrl( Json::parse( res ), objectId );
     return getObjectFromJson( jsonRes );
 }
 
+vector< libcmis::ObjectResult > SharePointSession::getObjects( const vector< string >& ids,
+                                                              const libcmis::BatchOptions& options )
+{
+    // The ids are the objects URLs: just get them concurrently
+    vector< HttpTransferPtr > requests;
+    for ( vector< string >::const_iterator it = ids.begin( ); it != ids.end( ); ++it )
+        requests.push_back( HttpTransferPtr( new HttpTransfer( "GET", *it ) ) );
+
+    httpRunConcurrentRequests( requests, options.getMaxConcurrency( ) );
+
+    vector< libcmis::ObjectResult > results;
+    for ( size_t i = 0; i < ids.size( ); ++i )
+    {
+        if ( requests[i]->isFailed( ) )
+        {
+            results.push_back( libcmis::ObjectResult( ids[i], requests[i]->getError( )->getCmisException( ) ) );
+            continue;
+        }
+        Json jsonRes = lcl_setDefaultUrl( Json::parse( requests[i]->getResponse( )->getBody( ) ), ids[i] );
+        results.push_back( libcmis::ObjectResult( ids[i], getObjectFromJson( jsonRes ) ) );
+    }
+    return results;
+}
+
+vector< string > SharePointSession::deleteObjects( const vector< string >& ids,
+                                                   const libcmis::BatchOptions& options )
+{
+    // The SharePoint ids are the URLs of the objects
+    vector< HttpTransferPtr > requests;
+    for ( vector< string >::const_iterator it = ids.begin( ); it != ids.end( ); ++it )
+        requests.push_back( HttpTransferPtr( new HttpTransfer( "DELETE", *it ) ) );
+
+    httpRunConcurrentRequests( requests, options.getMaxConcurrency( ) );
+
+    vector< string > failed;
+    for ( size_t i = 0; i < ids.size( ); ++i )
+    {
+        if ( requests[i]->isFailed( ) && requests[i]->getHttpStatus( ) != 404 )
+            failed.push_back( ids[i] );
+    }
+    return failed;
+}
+
+vector< libcmis::UpdateResult > SharePointSession::bulkUpdateProperties( const vector< string >& ids,
+        const libcmis::PropertyPtrMap& /*properties*/,
+        const vector< string >& addSecondaryTypes,
+        const vector< string >& removeSecondaryTypes,
+        const libcmis::BatchOptions& options )
+{
+    vector< libcmis::UpdateResult > results;
+    if ( !addSecondaryTypes.empty( ) || !removeSecondaryTypes.empty( ) )
+    {
+        for ( vector< string >::const_iterator it = ids.begin( ); it != ids.end( ); ++it )
+            results.push_back( libcmis::UpdateResult( *it,
+                        libcmis::Exception( "Secondary Types not supported", "constraint" ) ) );
+        return results;
+    }
+
+    // There are no updatable properties, like in SharePointObject::updateProperties( ):
+    // just check that the objects exist.
+    vector< libcmis::ObjectResult > objects = getObjects( ids, options );
+    for ( vector< libcmis::ObjectResult >::iterator it = objects.begin( ); it != objects.end( ); ++it )
+    {
+        if ( it->isOk( ) )
+            results.push_back( libcmis::UpdateResult( it->getId( ), it->getObject( )->getId( ), string( ) ) );
+        else
+            results.push_back( libcmis::UpdateResult( it->getId( ), *it->getError( ) ) );
+    }
+    return results;
+}
+
 libcmis::ObjectPtr SharePointSession::getObjectFromJson( Json& jsonRes, string parentId ) 
 {
     libcmis::ObjectPtr object;
-    if ( !jsonRes["d"].toString( ).empty( ) ) {
-        jsonRes = jsonRes["d"];
-    }
-    string kind = jsonRes["__metadata"]["type"].toString( );
+    jsonRes = SharePointUtils::getData( jsonRes );
+    string kind = SharePointUtils::getObjectType( jsonRes );
     // only SharePointObject available for now
     if ( kind == "SP.Folder" )
     {
@@ -179,7 +300,7 @@ Json SharePointSession::getJsonFromUrl( string url )
     string response;
     try
     {
-        response = httpGetRequest( url )->getStream()->str();
+        response = httpGetRequest( url )->getBody( );
     }
     catch ( const CurlException& e )
     {
@@ -188,6 +309,14 @@ Json SharePointSession::getJsonFromUrl( string url )
     return Json::parse( response );
 }
 
+string SharePointSession::getAcceptHeader( ) const
+{
+    // The JSON light formats are much smaller than the verbose one
+    if ( m_verboseOData )
+        return "accept:application/json; odata=verbose";
+    return "accept:application/json; odata=minimalmetadata";
+}
+
 /* Overwriting HttpSession::httpRunRequest to add the "accept:application/json" header */
 void SharePointSession::httpRunRequest( string url, vector< string > headers, bool redirect )
 {
@@ -206,7 +335,7 @@ void SharePointSession::httpRunRequest( string url, vector< string > headers, bo
     for ( vector< string >::iterator it = headers.begin( ); it != headers.end( ); ++it )
         headers_slist.reset(curl_slist_append(headers_slist.release(), it->c_str()));
 
-    headers_slist.reset(curl_slist_append(headers_slist.release(), "accept:application/json; odata=verbose"));
+    headers_slist.reset(curl_slist_append(headers_slist.release(), getAcceptHeader( ).c_str()));
     headers_slist.reset(curl_slist_append(headers_slist.release(), ("x-requestdigest:" + m_digestCode).c_str()));
     // newer Sharepoint requires this; this can be detected based on header
     // "x-msdavext_error" starting with "917656;" typically with a 403 status
@@ -337,10 +466,18 @@ void SharePointSession::httpRunRequest( string url, vector< string > headers, bo
     }
 }
 
+void SharePointSession::addSessionHeaders( vector< string >& headers )
+{
+    headers.push_back( getAcceptHeader( ) );
+    headers.push_back( "x-requestdigest:" + m_digestCode );
+    headers.push_back( "X-FORMS_BASED_AUTH_ACCEPTED: f" );
+}
+
 libcmis::HttpResponsePtr SharePointSession::httpPutRequest( std::string url,
                                          std::istream& is,
                                          std::vector< std::string > headers )
 {
+    renewDigestCode( );
     libcmis::HttpResponsePtr response;
     try
     {
@@ -348,6 +485,8 @@ libcmis::HttpResponsePtr SharePointSession::httpPutRequest( std::string url,
     }
     catch ( const CurlException& e )
     {
+        // The digest may have been invalidated before its expiry
+        ++m_digestFallbackCount;
         fetchDigestCodeCurl( );
         response = HttpSession::httpPutRequest( url, is, headers );
     }
@@ -359,6 +498,7 @@ libcmis::HttpResponsePtr SharePointSession::httpPostRequest( const std::string&
                                           const std::string& contentType,
                                           bool redirect )
 {
+    renewDigestCode( );
     libcmis::HttpResponsePtr response;
     try
     {
@@ -366,6 +506,8 @@ libcmis::HttpResponsePtr SharePointSession::httpPostRequest( const std::string&
     }
     catch ( const CurlException& e )
     {
+        // The digest may have been invalidated before its expiry
+        ++m_digestFallbackCount;
         fetchDigestCodeCurl( );
         response = HttpSession::httpPostRequest( url, is, contentType, redirect );
     }
@@ -374,12 +516,15 @@ libcmis::HttpResponsePtr SharePointSession::httpPostRequest( const std::string&
 
 void SharePointSession::httpDeleteRequest( std::string url )
 {
+    renewDigestCode( );
     try
     {
         HttpSession::httpDeleteRequest( url );
     }
     catch ( const CurlException& e )
     {
+        // The digest may have been invalidated before its expiry
+        ++m_digestFallbackCount;
         fetchDigestCodeCurl( );
         HttpSession::httpDeleteRequest( url );
     }
@@ -388,21 +533,99 @@ void SharePointSession::httpDeleteRequest( std::string url )
 void SharePointSession::fetchDigestCode( )
 try
 {
-    fetchDigestCodeCurl( );
+    // Use the digest of another session if it is still valid
+    if ( getCachedDigestCode( ) )
+        return;
+
+    try
+    {
+        fetchDigestCodeCurl( );
+    }
+    catch ( const CurlException& e )
+    {
+        // SharePoint 2013 before SP1 only knows the verbose format
+        long status = e.getHttpStatus( );
+        if ( m_verboseOData || ( status != 400 && status != 406 && status != 415 ) )
+            throw;
+        m_verboseOData = true;
+        fetchDigestCodeCurl( );
+    }
 }
 catch ( const CurlException& e )
 {
     throw e.getCmisException( );
 }
 
+unsigned long SharePointSession::getDigestFallbackCount( ) const
+{
+    return m_digestFallbackCount;
+}
+
+void SharePointSession::renewDigestCode( )
+{
+    if ( !lcl_isDigestExpired( m_digestExpiry ) || getCachedDigestCode( ) )
+        return;
+
+    try
+    {
+        fetchDigestCodeCurl( );
+    }
+    catch ( const CurlException& )
+    {
+        // The request will fail and be retried with a new digest
+    }
+}
+
+string SharePointSession::getDigestCacheKey( ) const
+{
+    return getDigestUrl( ) + "\n" + m_username;
+}
+
+string SharePointSession::getDigestUrl( ) const
+{
+    // url = http://host/_api/contextinfo, first we remove the '/web' part
+    return m_bindingUrl.substr( 0, m_bindingUrl.size( ) - 4 ) + "/contextinfo";
+}
+
+bool SharePointSession::getCachedDigestCode( )
+{
+    mutex* cacheMutex = NULL;
+    map< string, CachedDigest >& cache = lcl_getDigestCache( cacheMutex );
+    lock_guard< mutex > lock( *cacheMutex );
+
+    map< string, CachedDigest >::iterator it = cache.find( getDigestCacheKey( ) );
+    if ( it == cache.end( ) || lcl_isDigestExpired( it->second.m_expiry ) )
+        return false;
+
+    m_digestCode = it->second.m_digestCode;
+    m_digestExpiry = it->second.m_expiry;
+    m_verboseOData = it->second.m_verboseOData;
+    return true;
+}
+
 void SharePointSession::fetchDigestCodeCurl( )
 {
     istringstream is( "empty" );
     libcmis::HttpResponsePtr response;
-    // url = http://host/_api/contextinfo, first we remove the '/web' part
-    string url = m_bindingUrl.substr( 0, m_bindingUrl.size( ) - 4 ) + "/contextinfo";
-    response = HttpSession::httpPostRequest( url, is, "" );
-    string res = response->getStream( )->str( );
-    Json jsonRes = Json::parse( res );
-    m_digestCode = jsonRes["d"]["GetContextWebInformation"]["FormDigestValue"].toString( );
+    response = HttpSession::httpPostRequest( getDigestUrl( ), is, "" );
+    const string& res = response->getBody( );
+
+    // The JSON light formats don't have the GetContextWebInformation object
+    Json info = SharePointUtils::getData( Json::parse( res ) );
+    if ( info["GetContextWebInformation"].getDataType( ) == Json::json_object )
+        info = info["GetContextWebInformation"];
+    m_digestCode = info["FormDigestValue"].toString( );
+
+    m_digestExpiry = 0;
+    time_t timeout = atol( info["FormDigestTimeoutSeconds"].toString( ).c_str( ) );
+    if ( timeout > 0 )
+        m_digestExpiry = time( NULL ) + max( timeout - DIGEST_RENEWAL_MARGIN, time_t( 0 ) );
+
+    mutex* cacheMutex = NULL;
+    map< string, CachedDigest >& cache = lcl_getDigestCache( cacheMutex );
+    lock_guard< mutex > lock( *cacheMutex );
+    CachedDigest& cached = cache[ getDigestCacheKey( ) ];
+    cached.m_digestCode = m_digestCode;
+    cached.m_expiry = m_digestExpiry;
+    cached.m_verboseOData = m_verboseOData;
 }
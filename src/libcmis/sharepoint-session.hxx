@@ -28,6 +28,8 @@
 #ifndef _SHAREPOINT_SESSION_HXX_
 #define _SHAREPOINT_SESSION_HXX_
 
+#include <ctime>
+
 #include <libcmis/repository.hxx>
 
 #include "base-session.hxx"
@@ -54,6 +56,18 @@ class SharePointSession : public BaseSession
 
         virtual libcmis::ObjectPtr getObject( std::string id );
 
+        virtual std::vector< libcmis::ObjectResult > getObjects( const std::vector< std::string >& ids,
+                                                                 const libcmis::BatchOptions& options = libcmis::BatchOptions( ) );
+
+        virtual std::vector< libcmis::UpdateResult > bulkUpdateProperties( const std::vector< std::string >& ids,
+                const libcmis::PropertyPtrMap& properties,
+                const std::vector< std::string >& addSecondaryTypes = std::vector< std::string >( ),
+                const std::vector< std::string >& removeSecondaryTypes = std::vector< std::string >( ),
+                const libcmis::BatchOptions& options = libcmis::BatchOptions( ) );
+
+        virtual std::vector< std::string > deleteObjects( const std::vector< std::string >& ids,
+                const libcmis::BatchOptions& options = libcmis::BatchOptions( ) );
+
         virtual libcmis::ObjectPtr getObjectByPath( std::string path );
 
         virtual libcmis::ObjectTypePtr getType( std::string id );
@@ -67,6 +81,11 @@ class SharePointSession : public BaseSession
 
         void fetchDigestCode( );
 
+        /** Get the number of writes that failed and were retried with a new
+            request digest, although the digest wasn't supposed to be expired.
+          */
+        unsigned long getDigestFallbackCount( ) const;
+
         void httpRunRequest( std::string url,
                              std::vector< std::string > headers,
                              bool redirect );
@@ -80,13 +99,38 @@ class SharePointSession : public BaseSession
                                                   bool redirect = true );
         void httpDeleteRequest( std::string url );
 
+    protected:
+        virtual void addSessionHeaders( std::vector< std::string >& headers );
 
     private:
         SharePointSession( );
         SharePointSession( const SharePointSession& copy ) = delete;
         SharePointSession& operator=( const SharePointSession& copy ) = delete;
         void fetchDigestCodeCurl( );
+
+        /** Get a new request digest if the current one is about to expire.
+          */
+        void renewDigestCode( );
+
+        /** Use the request digest fetched by another session of the same
+            site and user, if it is still valid.
+
+            \return whether a valid digest was found
+          */
+        bool getCachedDigestCode( );
+
+        std::string getDigestCacheKey( ) const;
+        std::string getDigestUrl( ) const;
+
+        /** Get the accept header requesting the JSON light format, or the
+            verbose one if the server doesn't support it.
+          */
+        std::string getAcceptHeader( ) const;
+
         std::string m_digestCode;
+        time_t m_digestExpiry;
+        unsigned long m_digestFallbackCount;
+        bool m_verboseOData;
 };
 
 #endif /* _SHAREPONT_SESSION_HXX_ */
@@ -37,10 +37,25 @@
 using namespace std;
 using libcmis::PropertyPtrMap;
 
+namespace
+{
+    // The JSON light annotations have dots in their names: they can't
+    // be reached with Json::operator[]
+    string lcl_getMember( Json json, const string& key )
+    {
+        Json::JsonObject objs = json.getObjects( );
+        Json::JsonObject::iterator it = objs.find( key );
+        if ( it != objs.end( ) )
+            return it->second.toString( );
+        return string( );
+    }
+}
+
 string SharePointUtils::toCmisKey( const string& key )
 {
     string convertedKey;
-    if ( key == "__metadata")
+    if ( key == "__metadata" ||
+         key == "odata.id" )
         convertedKey = "cmis:objectId";
     else if ( key == "CheckInComment" )
         convertedKey = "cmis:checkinComment";
@@ -106,8 +121,15 @@ vector< string > SharePointUtils::parseSharePointProperty( string key, Json json
          key == "Properties" ||
          key == "Versions" )
     {
-        string propertyUri = json["__deferred"]["uri"].toString( );
-        values.push_back( propertyUri );
+        // The verbose format has deferred links objects, the expanded
+        // navigation properties have no link at all
+        if ( json.getDataType( ) != Json::json_string )
+        {
+            string propertyUri = json["__deferred"]["uri"].toString( );
+            if ( !propertyUri.empty( ) )
+                values.push_back( propertyUri );
+            return values;
+        }
     }
     if ( key == "CheckOutType" )
     {
@@ -128,6 +150,89 @@ vector< string > SharePointUtils::parseSharePointProperty( string key, Json json
 bool SharePointUtils::isSharePoint( string response )
 {
     const boost::shared_ptr< xmlDoc > doc( xmlReadMemory( response.c_str( ), response.size( ), "noname.xml", NULL, 0 ), xmlFreeDoc );
-    const boost::shared_ptr< xmlXPathContext > xpath( xmlXPathNewContext( doc.get() ), xmlXPathFreeContext );
-    return "SP.Web" == libcmis::getXPathValue( xpath.get(), "//@term" );
+    libcmis::XPathContext xpath( doc.get( ) );
+    return "SP.Web" == xpath.getValue( "//@term" );
+}
+
+Json SharePointUtils::getData( Json json )
+{
+    Json data = json["d"];
+    if ( data.getDataType( ) == Json::json_object )
+        return data;
+    return json;
+}
+
+Json::JsonVector SharePointUtils::getResults( Json json )
+{
+    Json data = json["d"];
+    if ( data.getDataType( ) == Json::json_object )
+        return data["results"].getList( );
+    return json["value"].getList( );
+}
+
+string SharePointUtils::getObjectType( Json json )
+{
+    string type = json["__metadata"]["type"].toString( );
+    if ( type.empty( ) )
+        type = lcl_getMember( json, "odata.type" );
+    if ( type.empty( ) )
+    {
+        // nometadata: only folders have an item count and only
+        // files and file versions have a size
+        if ( !json["ItemCount"].toString( ).empty( ) )
+            type = "SP.Folder";
+        else if ( !json["Length"].toString( ).empty( ) )
+            type = "SP.File";
+        else if ( !json["VersionLabel"].toString( ).empty( ) )
+            type = "SP.FileVersion";
+    }
+    return type;
+}
+
+string SharePointUtils::getObjectUrl( Json json, const string& bindingUrl )
+{
+    string url = json["__metadata"]["uri"].toString( );
+    if ( url.empty( ) )
+        url = lcl_getMember( json, "odata.id" );
+
+    string path = json["ServerRelativeUrl"].toString( );
+    if ( url.empty( ) && !path.empty( ) && !bindingUrl.empty( ) )
+    {
+        string type = getObjectType( json );
+        if ( type == "SP.Folder" )
+            url = bindingUrl + "/getFolderByServerRelativeUrl('" + libcmis::escape( path ) + "')";
+        else if ( type == "SP.File" )
+            url = bindingUrl + "/getFileByServerRelativeUrl('" + libcmis::escape( path ) + "')";
+    }
+    return url;
+}
+
+bool SharePointUtils::getExpandedResults( Json json, const string& key,
+                                          Json::JsonVector& results, string& nextLink )
+{
+    Json collection = json[key];
+    if ( collection.getDataType( ) == Json::json_array )
+    {
+        results = collection.getList( );
+        nextLink = lcl_getMember( json, key + "@odata.nextLink" );
+        return true;
+    }
+
+    Json verboseResults = collection["results"];
+    if ( collection.getDataType( ) == Json::json_object &&
+         verboseResults.getDataType( ) == Json::json_array )
+    {
+        results = verboseResults.getList( );
+        nextLink = collection["__next"].toString( );
+        return true;
+    }
+    return false;
+}
+
+string SharePointUtils::getNextLink( Json json )
+{
+    Json data = json["d"];
+    if ( data.getDataType( ) == Json::json_object )
+        return data["__next"].toString( );
+    return lcl_getMember( json, "odata.nextLink" );
 }
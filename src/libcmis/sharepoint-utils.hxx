@@ -49,6 +49,54 @@ class SharePointUtils
 
         // Checks if a response came from a SharePoint service
         static bool isSharePoint( std::string response );
+
+        /** Get the object of a response, whatever the OData format.
+
+            The verbose format wraps it in a "d" object, the JSON light
+            formats (minimalmetadata and nometadata) don't.
+          */
+        static Json getData( Json json );
+
+        /** Get the items of a collection response: "d.results" in the
+            verbose format, "value" in the JSON light formats.
+          */
+        static Json::JsonVector getResults( Json json );
+
+        /** Get the URL of the next page of a collection response, or an
+            empty string if it is the last one.
+          */
+        static std::string getNextLink( Json json );
+
+        /** Get the items of an expanded navigation property of an object.
+
+            \param json the object, without the "d" wrapper
+            \param key the name of the navigation property, like "Files"
+            \param results the items of the first page
+            \param nextLink the URL of the next page, if any
+            \return false if the property hasn't been expanded
+          */
+        static bool getExpandedResults( Json json, const std::string& key,
+                                        Json::JsonVector& results, std::string& nextLink );
+
+        /** Get the SharePoint type of an object, like SP.Folder or SP.File.
+
+            The nometadata format doesn't provide it: it is guessed from
+            the fields of the object in that case.
+          */
+        static std::string getObjectType( Json json );
+
+        /** Get the URL of an object.
+
+            The nometadata format doesn't provide it: the URL is computed
+            from the ServerRelativeUrl of files and folders in that case.
+
+            \param json the object, without the "d" wrapper
+            \param bindingUrl the URL of the SharePoint web API, or an empty
+                   string to only get the URL provided by the metadata
+            \return the URL of the object or an empty string if it
+                     can't be found.
+          */
+        static std::string getObjectUrl( Json json, const std::string& bindingUrl );
 };
 
 #endif
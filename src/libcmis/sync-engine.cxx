@@ -0,0 +1,1110 @@
+/* libcmis
+ * Version: MPL 1.1 / GPLv2+ / LGPLv2+
+ *
+ * The contents of this file are subject to the Mozilla Public License Version
+ * 1.1 (the "License"); you may not use this file except in compliance with
+ * the License or as specified alternatively below. You may obtain a copy of
+ * the License at http://www.mozilla.org/MPL/
+ *
+ * Software distributed under the License is distributed on an "AS IS" basis,
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+ * for the specific language governing rights and limitations under the
+ * License.
+ *
+ * Major Contributor(s):
+ *
+ *
+ * All Rights Reserved.
+ *
+ * For minor contributions see the git repository.
+ *
+ * Alternatively, the contents of this file may be used under the terms of
+ * either the GNU General Public License Version 2 or later (the "GPLv2+"), or
+ * the GNU Lesser General Public License Version 2 or later (the "LGPLv2+"),
+ * in which case the provisions of the GPLv2+ or the LGPLv2+ are applicable
+ * instead of those above.
+ */
+
+#include <libcmis/sync-engine.hxx>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <sstream>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifdef _WIN32
+#include <direct.h>
+#include <io.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <libcmis/xml-utils.hxx>
+
+#include "http-session.hxx"
+
+using namespace std;
+
+namespace
+{
+    const string PART_SUFFIX( ".part" );
+    const string VERSION_SUFFIX( ".version" );
+
+    bool lcl_exists( const string& path )
+    {
+        struct stat st;
+        return stat( path.c_str( ), &st ) == 0;
+    }
+
+    bool lcl_isDirectory( const string& path )
+    {
+        struct stat st;
+        return stat( path.c_str( ), &st ) == 0 && ( st.st_mode & S_IFDIR ) != 0;
+    }
+
+    long lcl_fileSize( const string& path )
+    {
+        struct stat st;
+        if ( stat( path.c_str( ), &st ) != 0 )
+            return 0;
+        return long( st.st_size );
+    }
+
+    void lcl_makeDirectory( const string& path )
+    {
+#ifdef _WIN32
+        _mkdir( path.c_str( ) );
+#else
+        mkdir( path.c_str( ), 0777 );
+#endif
+    }
+
+    bool lcl_removeDirectory( const string& path )
+    {
+#ifdef _WIN32
+        return _rmdir( path.c_str( ) ) == 0;
+#else
+        return rmdir( path.c_str( ) ) == 0;
+#endif
+    }
+
+    /** Create a directory and its missing parents.
+      */
+    void lcl_makeDirectories( const string& path )
+    {
+        size_t pos = path.find( '/', 1 );
+        while ( pos != string::npos )
+        {
+            lcl_makeDirectory( path.substr( 0, pos ) );
+            pos = path.find( '/', pos + 1 );
+        }
+        lcl_makeDirectory( path );
+    }
+
+    bool lcl_rename( const string& from, const string& to )
+    {
+#ifdef _WIN32
+        // rename( ) doesn't replace existing files on Windows
+        remove( to.c_str( ) );
+#endif
+        return rename( from.c_str( ), to.c_str( ) ) == 0;
+    }
+
+    string lcl_fileHash( const string& path )
+    {
+        ifstream in( path.c_str( ), ios_base::in | ios_base::binary );
+        if ( !in )
+            return string( );
+        return libcmis::sha1( in );
+    }
+
+    string lcl_parentPath( const string& path )
+    {
+        size_t pos = path.rfind( '/' );
+        if ( pos == string::npos )
+            return string( );
+        return path.substr( 0, pos );
+    }
+
+    string lcl_baseName( const string& path )
+    {
+        size_t pos = path.rfind( '/' );
+        if ( pos == string::npos )
+            return path;
+        return path.substr( pos + 1 );
+    }
+
+    bool lcl_endsWith( const string& str, const string& suffix )
+    {
+        return str.size( ) > suffix.size( ) &&
+               str.compare( str.size( ) - suffix.size( ), suffix.size( ), suffix ) == 0;
+    }
+
+    /** Escape the tabs, line breaks and backslashes of a value written on
+        one line of the state files: ids, tokens and names are free strings.
+      */
+    string lcl_escapeField( const string& value )
+    {
+        string escaped;
+        escaped.reserve( value.size( ) );
+        for ( string::const_iterator it = value.begin( ); it != value.end( ); ++it )
+        {
+            switch ( *it )
+            {
+                case '\\':
+                    escaped += "\\\\";
+                    break;
+                case '\t':
+                    escaped += "\\t";
+                    break;
+                case '\n':
+                    escaped += "\\n";
+                    break;
+                case '\r':
+                    escaped += "\\r";
+                    break;
+                default:
+                    escaped += *it;
+            }
+        }
+        return escaped;
+    }
+
+    string lcl_unescapeField( const string& escaped )
+    {
+        string value;
+        value.reserve( escaped.size( ) );
+        for ( string::const_iterator it = escaped.begin( ); it != escaped.end( ); ++it )
+        {
+            if ( *it != '\\' || it + 1 == escaped.end( ) )
+            {
+                value += *it;
+                continue;
+            }
+
+            ++it;
+            switch ( *it )
+            {
+                case 't':
+                    value += '\t';
+                    break;
+                case 'n':
+                    value += '\n';
+                    break;
+                case 'r':
+                    value += '\r';
+                    break;
+                default:
+                    value += *it;
+            }
+        }
+        return value;
+    }
+
+    /** Read the version of the document being downloaded in a partial file,
+        stored next to it.
+      */
+    string lcl_readPartVersion( const string& partFile )
+    {
+        string version;
+        ifstream in( ( partFile + VERSION_SUFFIX ).c_str( ) );
+        getline( in, version );
+        return lcl_unescapeField( version );
+    }
+
+    bool lcl_writePartVersion( const string& partFile, const string& version )
+    {
+        ofstream out( ( partFile + VERSION_SUFFIX ).c_str( ), ios_base::out | ios_base::trunc );
+        out << lcl_escapeField( version ) << endl;
+        return bool( out );
+    }
+
+    void lcl_removePart( const string& partFile )
+    {
+        remove( partFile.c_str( ) );
+        remove( ( partFile + VERSION_SUFFIX ).c_str( ) );
+    }
+
+    bool lcl_isInPath( const string& path, const string& parentPath )
+    {
+        return path.size( ) > parentPath.size( ) &&
+               path.compare( 0, parentPath.size( ), parentPath ) == 0 &&
+               path[ parentPath.size( ) ] == '/';
+    }
+
+    /** Get the remote version of an object to compare with the one in the
+        state database: servers without change token still provide a
+        modification date.
+      */
+    string lcl_getVersion( libcmis::ObjectPtr object )
+    {
+        string version = object->getChangeToken( );
+        if ( version.empty( ) )
+        {
+            boost::posix_time::ptime date = object->getLastModificationDate( );
+            if ( !date.is_special( ) )
+                version = boost::posix_time::to_iso_extended_string( date );
+        }
+        return version;
+    }
+
+    /** Make a remote object name usable as a local file name: path
+        separators are allowed in the names on some servers and the names
+        must not point to the current or parent directories.
+      */
+    string lcl_safeName( const string& name )
+    {
+        string safe = name;
+        for ( string::iterator it = safe.begin( ); it != safe.end( ); ++it )
+        {
+            if ( *it == '/' || *it == '\\' || *it == '\0' )
+                *it = '_';
+        }
+        if ( safe.empty( ) || safe == "." || safe == ".." )
+            safe = string( safe.size( ) + 1, '_' );
+        return safe;
+    }
+
+    /** Check that a relative path can't resolve outside of the synchronized
+        folder.
+      */
+    bool lcl_isSafePath( const string& path )
+    {
+        if ( path.empty( ) )
+            return false;
+
+        size_t start = 0;
+        while ( start <= path.size( ) )
+        {
+            size_t end = path.find( '/', start );
+            if ( end == string::npos )
+                end = path.size( );
+            string name = path.substr( start, end - start );
+            if ( name != lcl_safeName( name ) )
+                return false;
+            start = end + 1;
+        }
+        return true;
+    }
+
+    /** Get the path of an object relative to the synchronized folder, or
+        an empty string if it isn't in that folder. Each segment of the path
+        is made safe to use locally.
+      */
+    string lcl_relativePath( libcmis::ObjectPtr object, const string& rootPath )
+    {
+        string prefix = rootPath;
+        if ( prefix.empty( ) || prefix[ prefix.size( ) - 1 ] != '/' )
+            prefix += '/';
+
+        vector< string > paths = object->getPaths( );
+        for ( vector< string >::iterator it = paths.begin( ); it != paths.end( ); ++it )
+        {
+            if ( it->size( ) > prefix.size( ) && it->compare( 0, prefix.size( ), prefix ) == 0 )
+            {
+                string path;
+                size_t start = prefix.size( );
+                while ( start <= it->size( ) )
+                {
+                    size_t end = it->find( '/', start );
+                    if ( end == string::npos )
+                        end = it->size( );
+                    if ( !path.empty( ) )
+                        path += '/';
+                    path += lcl_safeName( it->substr( start, end - start ) );
+                    start = end + 1;
+                }
+                return path;
+            }
+        }
+        return string( );
+    }
+
+    /** List the files and directories of a local directory recursively,
+        the paths being relative to the root.
+      */
+    void lcl_listLocal( const string& root, const string& path, vector< string >& files, vector< string >& dirs )
+    {
+        string dirPath = path.empty( ) ? root : root + "/" + path;
+        vector< string > names;
+#ifdef _WIN32
+        struct _finddata_t data;
+        intptr_t handle = _findfirst( ( dirPath + "/*" ).c_str( ), &data );
+        if ( handle != -1 )
+        {
+            do
+            {
+                names.push_back( data.name );
+            } while ( _findnext( handle, &data ) == 0 );
+            _findclose( handle );
+        }
+#else
+        DIR* dir = opendir( dirPath.c_str( ) );
+        if ( dir != NULL )
+        {
+            for ( struct dirent* entry = readdir( dir ); entry != NULL; entry = readdir( dir ) )
+                names.push_back( entry->d_name );
+            closedir( dir );
+        }
+#endif
+
+        for ( vector< string >::iterator it = names.begin( ); it != names.end( ); ++it )
+        {
+            if ( *it == "." || *it == ".." )
+                continue;
+
+            string childPath = path.empty( ) ? *it : path + "/" + *it;
+            if ( lcl_isDirectory( root + "/" + childPath ) )
+            {
+                dirs.push_back( childPath );
+                lcl_listLocal( root, childPath, files, dirs );
+            }
+            else
+                files.push_back( childPath );
+        }
+    }
+
+    /** Remove the first bytes of a file: used when the server sent the whole
+        content rather than the requested range.
+      */
+    void lcl_dropPrefix( const string& path, long size )
+    {
+        string tmpPath = path + ".tmp";
+        {
+            ifstream in( path.c_str( ), ios_base::in | ios_base::binary );
+            ofstream out( tmpPath.c_str( ), ios_base::out | ios_base::binary | ios_base::trunc );
+            in.seekg( size );
+            out << in.rdbuf( );
+        }
+        lcl_rename( tmpPath, path );
+    }
+
+    libcmis::PropertyPtrMap lcl_createProperties( libcmis::Session* session, const string& typeId, const string& name )
+    {
+        libcmis::PropertyPtrMap properties;
+        libcmis::ObjectTypePtr type = session->getType( typeId );
+        map< string, libcmis::PropertyTypePtr >& propertiesTypes = type->getPropertiesTypes( );
+
+        map< string, libcmis::PropertyTypePtr >::iterator it = propertiesTypes.find( "cmis:name" );
+        if ( it != propertiesTypes.end( ) )
+            properties[ "cmis:name" ].reset( new libcmis::Property( it->second, vector< string >( 1, name ) ) );
+
+        it = propertiesTypes.find( "cmis:objectTypeId" );
+        if ( it != propertiesTypes.end( ) )
+            properties[ "cmis:objectTypeId" ].reset( new libcmis::Property( it->second, vector< string >( 1, typeId ) ) );
+
+        return properties;
+    }
+}
+
+namespace libcmis
+{
+    const string SyncEngine::STATE_FILE( ".cmis-sync" );
+
+    void SyncReport::merge( const SyncReport& report )
+    {
+        m_downloaded.insert( m_downloaded.end( ), report.m_downloaded.begin( ), report.m_downloaded.end( ) );
+        m_uploaded.insert( m_uploaded.end( ), report.m_uploaded.begin( ), report.m_uploaded.end( ) );
+        m_deletedLocally.insert( m_deletedLocally.end( ), report.m_deletedLocally.begin( ), report.m_deletedLocally.end( ) );
+        m_deletedRemotely.insert( m_deletedRemotely.end( ), report.m_deletedRemotely.begin( ), report.m_deletedRemotely.end( ) );
+        m_conflicts.insert( m_conflicts.end( ), report.m_conflicts.begin( ), report.m_conflicts.end( ) );
+        m_errors.insert( report.m_errors.begin( ), report.m_errors.end( ) );
+    }
+
+    SyncEngine::SyncEngine( Session* session, string folderId, string localPath,
+                            const BatchOptions& options ) :
+        m_session( session ),
+        m_folderId( folderId ),
+        m_localPath( localPath ),
+        m_options( options ),
+        m_changeLogToken( ),
+        m_entries( )
+    {
+        while ( m_localPath.size( ) > 1 && m_localPath[ m_localPath.size( ) - 1 ] == '/' )
+            m_localPath.erase( m_localPath.size( ) - 1 );
+        lcl_makeDirectories( m_localPath );
+    }
+
+    SyncEngine::~SyncEngine( )
+    {
+    }
+
+    SyncReport SyncEngine::pull( )
+    {
+        SyncReport report;
+        loadState( );
+
+        FolderPtr root = m_session->getFolder( m_folderId );
+        if ( !root )
+            throw Exception( "Not a folder: " + m_folderId, "invalidArgument" );
+        string rootPath = root->getPath( );
+
+        // Find the remote objects to look at and the removed ones
+        map< string, pair< ObjectPtr, string > > remote;
+        vector< string > removed;
+        string changeLogToken = m_changeLogToken;
+        bool listTree = true;
+
+        if ( !changeLogToken.empty( ) )
+        {
+            vector< string > changed;
+            try
+            {
+                changed = m_session->getContentChanges( changeLogToken );
+                listTree = false;
+            }
+            catch ( const Exception& e )
+            {
+                if ( e.getType( ) != "notSupported" )
+                    throw;
+            }
+
+            sort( changed.begin( ), changed.end( ) );
+            changed.erase( unique( changed.begin( ), changed.end( ) ), changed.end( ) );
+            changed.erase( remove( changed.begin( ), changed.end( ), m_folderId ), changed.end( ) );
+
+            vector< ObjectResult > results = m_session->getObjects( changed, m_options );
+            for ( vector< ObjectResult >::iterator it = results.begin( ); it != results.end( ); ++it )
+            {
+                string id = it->getId( );
+                bool known = m_entries.find( id ) != m_entries.end( );
+                if ( it->isOk( ) )
+                {
+                    string path = lcl_relativePath( it->getObject( ), rootPath );
+                    if ( !path.empty( ) )
+                        remote[ id ] = make_pair( it->getObject( ), path );
+                    else if ( known )
+                        removed.push_back( id );
+                }
+                else if ( it->getError( )->getType( ) == "objectNotFound" )
+                {
+                    if ( known )
+                        removed.push_back( id );
+                }
+                else if ( known )
+                    report.addError( m_entries[ id ].getPath( ), it->getError( )->what( ) );
+            }
+        }
+
+        if ( listTree )
+        {
+            // Get the change log position before listing the tree: the changes
+            // made while listing will only be seen again the next time.
+            changeLogToken.clear( );
+            try
+            {
+                m_session->getContentChanges( changeLogToken );
+            }
+            catch ( const Exception& )
+            {
+                changeLogToken.clear( );
+            }
+
+            listRemoteTree( root, string( ), remote );
+            for ( map< string, SyncEntry >::iterator it = m_entries.begin( ); it != m_entries.end( ); ++it )
+            {
+                if ( remote.find( it->first ) == remote.end( ) )
+                    removed.push_back( it->first );
+            }
+        }
+
+        // Never write outside of the synchronized folder
+        for ( map< string, pair< ObjectPtr, string > >::iterator it = remote.begin( ); it != remote.end( ); )
+        {
+            if ( lcl_isSafePath( it->second.second ) )
+                ++it;
+            else
+            {
+                report.addError( it->second.second, "Invalid local path" );
+                remote.erase( it++ );
+            }
+        }
+
+        // Create or move the folders, parents first
+        vector< pair< string, ObjectPtr > > folders;
+        vector< pair< DocumentPtr, string > > documents;
+        for ( map< string, pair< ObjectPtr, string > >::iterator it = remote.begin( ); it != remote.end( ); ++it )
+        {
+            if ( boost::dynamic_pointer_cast< Folder >( it->second.first ) )
+                folders.push_back( make_pair( it->second.second, it->second.first ) );
+        }
+        sort( folders.begin( ), folders.end( ) );
+        for ( vector< pair< string, ObjectPtr > >::iterator it = folders.begin( ); it != folders.end( ); ++it )
+            pullFolder( it->second, it->first );
+
+        // Find the documents to download
+        for ( map< string, pair< ObjectPtr, string > >::iterator it = remote.begin( ); it != remote.end( ); ++it )
+        {
+            DocumentPtr document = boost::dynamic_pointer_cast< Document >( it->second.first );
+            if ( !document )
+                continue;
+
+            const string& path = it->second.second;
+            string localFile = m_localPath + "/" + path;
+            string version = lcl_getVersion( document );
+
+            map< string, SyncEntry >::iterator entryIt = m_entries.find( it->first );
+            if ( entryIt != m_entries.end( ) )
+            {
+                SyncEntry& entry = entryIt->second;
+                bool upToDate = entry.getChangeToken( ) == version;
+                if ( upToDate && entry.getPath( ) == path )
+                    continue;
+
+                string entryFile = m_localPath + "/" + entry.getPath( );
+                bool exists = lcl_exists( entryFile );
+                bool modified = exists && lcl_fileHash( entryFile ) != entry.getHash( );
+                if ( modified && !upToDate )
+                {
+                    report.addConflict( entry.getPath( ) );
+                    continue;
+                }
+
+                // Moved or renamed on the server
+                if ( exists && entry.getPath( ) != path )
+                {
+                    lcl_makeDirectories( lcl_parentPath( localFile ) );
+                    if ( lcl_exists( localFile ) || !lcl_rename( entryFile, localFile ) )
+                    {
+                        report.addConflict( path );
+                        continue;
+                    }
+                    entry.setPath( path );
+                }
+
+                // Local modifications will be sent by push( )
+                if ( upToDate || modified )
+                    continue;
+            }
+            else if ( lcl_exists( localFile ) )
+            {
+                // Local file created with the same name as a remote one
+                report.addConflict( path );
+                continue;
+            }
+
+            documents.push_back( make_pair( document, path ) );
+        }
+
+        pullDocuments( documents, report );
+        removeLocal( removed, report );
+
+        // Keep the previous change log position if some changes couldn't be
+        // applied: they will be read again the next time.
+        if ( report.getErrors( ).empty( ) && report.getConflicts( ).empty( ) )
+            m_changeLogToken = changeLogToken;
+        saveState( );
+
+        return report;
+    }
+
+    SyncReport SyncEngine::push( )
+    {
+        SyncReport report;
+        loadState( );
+
+        // Find the modified and removed objects
+        vector< string > ids;
+        map< string, string > hashes;
+        for ( map< string, SyncEntry >::iterator it = m_entries.begin( ); it != m_entries.end( ); ++it )
+        {
+            string localPath = m_localPath + "/" + it->second.getPath( );
+            if ( it->second.isFolder( ) )
+            {
+                if ( !lcl_isDirectory( localPath ) )
+                    ids.push_back( it->first );
+            }
+            else if ( !lcl_exists( localPath ) )
+                ids.push_back( it->first );
+            else
+            {
+                string hash = lcl_fileHash( localPath );
+                if ( hash != it->second.getHash( ) )
+                {
+                    hashes[ it->first ] = hash;
+                    ids.push_back( it->first );
+                }
+            }
+        }
+
+        // Check the remote versions before changing anything
+        vector< ObjectResult > results = m_session->getObjects( ids, m_options );
+        vector< pair< string, ObjectPtr > > removedFolders;
+        for ( size_t i = 0; i < results.size( ); ++i )
+        {
+            string id = ids[i];
+            SyncEntry entry = m_entries[ id ];
+            map< string, string >::iterator hashIt = hashes.find( id );
+            bool removed = hashIt == hashes.end( );
+
+            if ( !results[i].isOk( ) )
+            {
+                if ( results[i].getError( )->getType( ) != "objectNotFound" )
+                    report.addError( entry.getPath( ), results[i].getError( )->what( ) );
+                else
+                {
+                    // Modified locally, but removed on the server: the file
+                    // will be uploaded again as a new one.
+                    if ( !removed )
+                        report.addConflict( entry.getPath( ) );
+                    m_entries.erase( id );
+                }
+                continue;
+            }
+
+            ObjectPtr object = results[i].getObject( );
+            if ( lcl_getVersion( object ) != entry.getChangeToken( ) )
+            {
+                report.addConflict( entry.getPath( ) );
+                continue;
+            }
+
+            if ( removed && entry.isFolder( ) )
+            {
+                removedFolders.push_back( make_pair( entry.getPath( ), object ) );
+                continue;
+            }
+
+            try
+            {
+                if ( removed )
+                {
+                    object->remove( );
+                    m_entries.erase( id );
+                    report.addDeletedRemotely( entry.getPath( ) );
+                }
+                else
+                {
+                    DocumentPtr document = boost::dynamic_pointer_cast< Document >( object );
+                    if ( !document )
+                        continue;
+
+                    string localFile = m_localPath + "/" + entry.getPath( );
+                    ifstream is( localFile.c_str( ), ios_base::in | ios_base::binary );
+                    boost::shared_ptr< ostream > os( new ostream( is.rdbuf( ) ) );
+                    string contentType = document->getContentType( );
+                    if ( contentType.empty( ) )
+                        contentType = "application/octet-stream";
+                    // The server may already have this content: only the state needs an update then
+                    bool uploaded = document->setContentStreamIfChanged( os, contentType,
+                            document->getContentFilename( ) );
+
+                    // Some servers create a new version with a new id
+                    m_entries.erase( id );
+                    m_entries[ document->getId( ) ] = SyncEntry( document->getId( ), entry.getPath( ),
+                            lcl_getVersion( document ), hashIt->second );
+                    if ( uploaded )
+                        report.addUploaded( entry.getPath( ) );
+                }
+            }
+            catch ( const Exception& e )
+            {
+                report.addError( entry.getPath( ), e.what( ) );
+            }
+        }
+
+        // Remove the folders, children first. The folders still containing
+        // synchronized objects that couldn't be removed are kept.
+        sort( removedFolders.rbegin( ), removedFolders.rend( ) );
+        for ( vector< pair< string, ObjectPtr > >::iterator it = removedFolders.begin( ); it != removedFolders.end( ); ++it )
+        {
+            bool empty = true;
+            for ( map< string, SyncEntry >::iterator entryIt = m_entries.begin( ); entryIt != m_entries.end( ) && empty; ++entryIt )
+                empty = !lcl_isInPath( entryIt->second.getPath( ), it->first );
+            if ( !empty )
+                continue;
+
+            try
+            {
+                it->second->remove( );
+                m_entries.erase( it->second->getId( ) );
+                report.addDeletedRemotely( it->first );
+            }
+            catch ( const Exception& e )
+            {
+                report.addError( it->first, e.what( ) );
+            }
+        }
+
+        // Create the new directories and files
+        vector< string > files;
+        vector< string > dirs;
+        lcl_listLocal( m_localPath, string( ), files, dirs );
+
+        set< string > tracked;
+        for ( map< string, SyncEntry >::iterator it = m_entries.begin( ); it != m_entries.end( ); ++it )
+            tracked.insert( it->second.getPath( ) );
+
+        sort( dirs.begin( ), dirs.end( ) );
+        for ( vector< string >::iterator it = dirs.begin( ); it != dirs.end( ); ++it )
+        {
+            if ( tracked.find( *it ) != tracked.end( ) )
+                continue;
+
+            try
+            {
+                FolderPtr parent = m_session->getFolder( getParentId( *it ) );
+                FolderPtr folder = parent->createFolder(
+                        lcl_createProperties( m_session, "cmis:folder", lcl_baseName( *it ) ) );
+                m_entries[ folder->getId( ) ] = SyncEntry( folder->getId( ), *it,
+                        lcl_getVersion( folder ), string( ), true );
+                report.addUploaded( *it );
+            }
+            catch ( const Exception& e )
+            {
+                report.addError( *it, e.what( ) );
+            }
+        }
+
+        for ( vector< string >::iterator it = files.begin( ); it != files.end( ); ++it )
+        {
+            const string& path = *it;
+            bool isPart = lcl_endsWith( path, PART_SUFFIX ) ||
+                lcl_endsWith( path, PART_SUFFIX + VERSION_SUFFIX );
+            if ( tracked.find( path ) != tracked.end( ) || isPart ||
+                 path == STATE_FILE || path == STATE_FILE + ".tmp" )
+                continue;
+
+            try
+            {
+                string localFile = m_localPath + "/" + path;
+                string hash = lcl_fileHash( localFile );
+                string name = lcl_baseName( path );
+
+                FolderPtr parent = m_session->getFolder( getParentId( path ) );
+                ifstream is( localFile.c_str( ), ios_base::in | ios_base::binary );
+                boost::shared_ptr< ostream > os( new ostream( is.rdbuf( ) ) );
+                DocumentPtr document = parent->createDocument(
+                        lcl_createProperties( m_session, "cmis:document", name ),
+                        os, "application/octet-stream", name );
+                m_entries[ document->getId( ) ] = SyncEntry( document->getId( ), path,
+                        lcl_getVersion( document ), hash );
+                report.addUploaded( path );
+            }
+            catch ( const Exception& e )
+            {
+                report.addError( path, e.what( ) );
+            }
+        }
+
+        saveState( );
+        return report;
+    }
+
+    SyncReport SyncEngine::sync( )
+    {
+        SyncReport report = pull( );
+        report.merge( push( ) );
+        return report;
+    }
+
+    void SyncEngine::loadState( )
+    {
+        m_changeLogToken.clear( );
+        m_entries.clear( );
+
+        ifstream in( ( m_localPath + "/" + STATE_FILE ).c_str( ) );
+        string line;
+        while ( getline( in, line ) )
+        {
+            if ( line.empty( ) || line[0] == '#' )
+                continue;
+
+            // The fields are escaped: the tabs only separate them
+            vector< string > fields;
+            size_t start = 0;
+            size_t pos = line.find( '\t' );
+            while ( pos != string::npos && fields.size( ) < 4 )
+            {
+                fields.push_back( lcl_unescapeField( line.substr( start, pos - start ) ) );
+                start = pos + 1;
+                pos = line.find( '\t', start );
+            }
+            fields.push_back( lcl_unescapeField( line.substr( start ) ) );
+
+            if ( fields[0] == "token" && fields.size( ) == 2 )
+                m_changeLogToken = fields[1];
+            else if ( ( fields[0] == "f" || fields[0] == "d" ) && fields.size( ) == 5 )
+                m_entries[ fields[1] ] = SyncEntry( fields[1], fields[4], fields[2], fields[3], fields[0] == "d" );
+        }
+    }
+
+    void SyncEngine::saveState( )
+    {
+        // Write a new file and replace the old one, not to lose the state
+        // if something goes wrong
+        string statePath = m_localPath + "/" + STATE_FILE;
+        string tmpPath = statePath + ".tmp";
+        {
+            ofstream out( tmpPath.c_str( ), ios_base::out | ios_base::trunc );
+            out << "# libcmis sync state: kind, id, change token, hash, path" << endl;
+            out << "token\t" << lcl_escapeField( m_changeLogToken ) << endl;
+            for ( map< string, SyncEntry >::iterator it = m_entries.begin( ); it != m_entries.end( ); ++it )
+            {
+                const SyncEntry& entry = it->second;
+                out << ( entry.isFolder( ) ? "d" : "f" ) << "\t" << lcl_escapeField( entry.getId( ) ) << "\t"
+                    << lcl_escapeField( entry.getChangeToken( ) ) << "\t"
+                    << lcl_escapeField( entry.getHash( ) ) << "\t"
+                    << lcl_escapeField( entry.getPath( ) ) << endl;
+            }
+            if ( !out )
+                throw Exception( "Failed to write " + tmpPath );
+        }
+        if ( !lcl_rename( tmpPath, statePath ) )
+            throw Exception( "Failed to write " + statePath );
+    }
+
+    void SyncEngine::listRemoteTree( FolderPtr folder, const string& path,
+                                     map< string, pair< ObjectPtr, string > >& objects )
+    {
+        vector< ObjectPtr > children = folder->getChildren( );
+        for ( vector< ObjectPtr >::iterator it = children.begin( ); it != children.end( ); ++it )
+        {
+            string name = lcl_safeName( ( *it )->getName( ) );
+
+            string childPath = path.empty( ) ? name : path + "/" + name;
+            objects[ ( *it )->getId( ) ] = make_pair( *it, childPath );
+
+            FolderPtr childFolder = boost::dynamic_pointer_cast< Folder >( *it );
+            if ( childFolder )
+                listRemoteTree( childFolder, childPath, objects );
+        }
+    }
+
+    void SyncEngine::pullFolder( ObjectPtr folder, const string& path )
+    {
+        string id = folder->getId( );
+        string localDir = m_localPath + "/" + path;
+
+        map< string, SyncEntry >::iterator it = m_entries.find( id );
+        if ( it != m_entries.end( ) && it->second.getPath( ) != path )
+        {
+            // Moved or renamed folder: move the local directory with its content
+            string oldPath = it->second.getPath( );
+            string oldDir = m_localPath + "/" + oldPath;
+            if ( lcl_isDirectory( oldDir ) && !lcl_exists( localDir ) )
+            {
+                lcl_makeDirectories( lcl_parentPath( localDir ) );
+                if ( lcl_rename( oldDir, localDir ) )
+                {
+                    for ( map< string, SyncEntry >::iterator entryIt = m_entries.begin( );
+                          entryIt != m_entries.end( ); ++entryIt )
+                    {
+                        string entryPath = entryIt->second.getPath( );
+                        if ( lcl_isInPath( entryPath, oldPath ) )
+                            entryIt->second.setPath( path + entryPath.substr( oldPath.size( ) ) );
+                    }
+                }
+            }
+        }
+
+        lcl_makeDirectories( localDir );
+        m_entries[ id ] = SyncEntry( id, path, lcl_getVersion( folder ), string( ), true );
+    }
+
+    void SyncEngine::pullDocuments( vector< pair< DocumentPtr, string > >& documents, SyncReport& report )
+    {
+        // Download the documents concurrently if we can, into partial files
+        // to resume the interrupted downloads.
+        HttpSession* httpSession = dynamic_cast< HttpSession* >( m_session );
+
+        vector< HttpTransferPtr > transfers;
+        vector< size_t > transferDocuments;
+        vector< long > offsets;
+        vector< boost::shared_ptr< ofstream > > outputs;
+        vector< bool > downloaded( documents.size( ), false );
+
+        for ( size_t i = 0; i < documents.size( ); ++i )
+        {
+            DocumentPtr document = documents[i].first;
+            string partFile = m_localPath + "/" + documents[i].second + PART_SUFFIX;
+            lcl_makeDirectories( lcl_parentPath( partFile ) );
+
+            string url;
+            if ( httpSession != NULL )
+                url = document->getContentUrl( );
+
+            if ( !url.empty( ) )
+            {
+                // Only resume the partial file if it is for the same version
+                // of the document: the content may have changed since.
+                string version = lcl_getVersion( document );
+                long offset = lcl_fileSize( partFile );
+                if ( offset > 0 && ( version.empty( ) || lcl_readPartVersion( partFile ) != version ) )
+                {
+                    lcl_removePart( partFile );
+                    offset = 0;
+                }
+                if ( !lcl_writePartVersion( partFile, version ) )
+                {
+                    report.addError( documents[i].second, "Failed to write " + partFile + VERSION_SUFFIX );
+                    continue;
+                }
+
+                vector< string > headers;
+                if ( offset > 0 )
+                {
+                    stringstream range;
+                    range << "Range: bytes=" << offset << "-";
+                    headers.push_back( range.str( ) );
+                }
+
+                boost::shared_ptr< ofstream > output( new ofstream( partFile.c_str( ),
+                            ios_base::out | ios_base::binary | ios_base::app ) );
+                HttpTransferPtr transfer( new HttpTransfer( "GET", url, headers ) );
+                transfer->setOutputStream( output );
+
+                transfers.push_back( transfer );
+                transferDocuments.push_back( i );
+                offsets.push_back( offset );
+                outputs.push_back( output );
+            }
+            else
+            {
+                // No content URL: no resume possible
+                try
+                {
+                    boost::shared_ptr< istream > in = document->getContentStream( );
+                    ofstream out( partFile.c_str( ), ios_base::out | ios_base::binary | ios_base::trunc );
+                    out << in->rdbuf( );
+                    downloaded[i] = true;
+                }
+                catch ( const Exception& e )
+                {
+                    report.addError( documents[i].second, e.what( ) );
+                }
+            }
+        }
+
+        if ( !transfers.empty( ) )
+        {
+            try
+            {
+                httpSession->httpRunConcurrentRequests( transfers, m_options.getMaxConcurrency( ) );
+            }
+            catch ( const CurlException& e )
+            {
+                throw e.getCmisException( );
+            }
+        }
+
+        for ( size_t j = 0; j < transfers.size( ); ++j )
+        {
+            size_t i = transferDocuments[j];
+            string partFile = m_localPath + "/" + documents[i].second + PART_SUFFIX;
+            outputs[j]->close( );
+
+            if ( transfers[j]->isFailed( ) )
+            {
+                // The partial file can't be resumed: restart from scratch next time
+                if ( transfers[j]->getHttpStatus( ) == 416 )
+                    lcl_removePart( partFile );
+                report.addError( documents[i].second, transfers[j]->getError( )->getCmisException( ).what( ) );
+                continue;
+            }
+
+            // The server ignored the range and sent the whole content
+            if ( offsets[j] > 0 && transfers[j]->getHttpStatus( ) != 206 )
+                lcl_dropPrefix( partFile, offsets[j] );
+            downloaded[i] = true;
+        }
+
+        // Move the complete files in place
+        for ( size_t i = 0; i < documents.size( ); ++i )
+        {
+            if ( !downloaded[i] )
+                continue;
+
+            const string& path = documents[i].second;
+            string localFile = m_localPath + "/" + path;
+            if ( !lcl_rename( localFile + PART_SUFFIX, localFile ) )
+            {
+                report.addError( path, "Failed to write " + localFile );
+                continue;
+            }
+            remove( ( localFile + PART_SUFFIX + VERSION_SUFFIX ).c_str( ) );
+
+            DocumentPtr document = documents[i].first;
+            m_entries[ document->getId( ) ] = SyncEntry( document->getId( ), path,
+                    lcl_getVersion( document ), lcl_fileHash( localFile ) );
+            report.addDownloaded( path );
+        }
+    }
+
+    void SyncEngine::removeLocal( const vector< string >& ids, SyncReport& report )
+    {
+        // The content of the removed folders is removed too, even if the
+        // change log didn't list it.
+        set< string > removed( ids.begin( ), ids.end( ) );
+        for ( vector< string >::const_iterator it = ids.begin( ); it != ids.end( ); ++it )
+        {
+            map< string, SyncEntry >::iterator entryIt = m_entries.find( *it );
+            if ( entryIt == m_entries.end( ) || !entryIt->second.isFolder( ) )
+                continue;
+
+            string folderPath = entryIt->second.getPath( );
+            for ( map< string, SyncEntry >::iterator childIt = m_entries.begin( ); childIt != m_entries.end( ); ++childIt )
+            {
+                if ( lcl_isInPath( childIt->second.getPath( ), folderPath ) )
+                    removed.insert( childIt->first );
+            }
+        }
+
+        vector< string > folders;
+        for ( set< string >::iterator it = removed.begin( ); it != removed.end( ); ++it )
+        {
+            map< string, SyncEntry >::iterator entryIt = m_entries.find( *it );
+            if ( entryIt == m_entries.end( ) )
+                continue;
+
+            SyncEntry entry = entryIt->second;
+            m_entries.erase( entryIt );
+
+            if ( entry.isFolder( ) )
+            {
+                folders.push_back( entry.getPath( ) );
+                continue;
+            }
+
+            // A locally modified file is kept: push( ) will upload it as a new file
+            string localFile = m_localPath + "/" + entry.getPath( );
+            if ( !lcl_exists( localFile ) )
+                continue;
+            if ( lcl_fileHash( localFile ) != entry.getHash( ) )
+                report.addConflict( entry.getPath( ) );
+            else if ( remove( localFile.c_str( ) ) != 0 )
+                report.addError( entry.getPath( ), "Failed to remove " + localFile );
+            else
+                report.addDeletedLocally( entry.getPath( ) );
+        }
+
+        // Remove the directories, children first. The directories still
+        // containing local files are kept.
+        sort( folders.rbegin( ), folders.rend( ) );
+        for ( vector< string >::iterator it = folders.begin( ); it != folders.end( ); ++it )
+        {
+            if ( lcl_removeDirectory( m_localPath + "/" + *it ) )
+                report.addDeletedLocally( *it );
+        }
+    }
+
+    string SyncEngine::getParentId( const string& path )
+    {
+        string parentPath = lcl_parentPath( path );
+        if ( parentPath.empty( ) )
+            return m_folderId;
+
+        for ( map< string, SyncEntry >::iterator it = m_entries.begin( ); it != m_entries.end( ); ++it )
+        {
+            if ( it->second.isFolder( ) && it->second.getPath( ) == parentPath )
+                return it->first;
+        }
+        throw Exception( "No remote folder for " + parentPath );
+    }
+}
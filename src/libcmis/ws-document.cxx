@@ -124,9 +124,9 @@ vector< libcmis::DocumentPtr > WSDocument::getAllVersions( )
     vector< libcmis::DocumentPtr > versions;
     string repoId = getSession( )->getRepositoryId( );
     PropertyPtrMap::const_iterator it = getProperties( ).find( string( "cmis:versionSeriesId" ) );
-    if ( it != getProperties( ).end( ) && !it->second->getStrings( ).empty( ) )
+    if ( it != getProperties( ).end( ) && !it->second->getStringValues( ).empty( ) )
     {
-        string versionSeries = it->second->getStrings( ).front( );
+        string versionSeries = it->second->getStringValues( ).front( );
         versions = getSession( )->getVersioningService( ).getAllVersions( repoId, versionSeries );
     }
     return versions;
@@ -84,6 +84,48 @@ libcmis::ObjectPtr ObjectService::getObject( const string& repoId, const string&
     return object;
 }
 
+vector< libcmis::ObjectResult > ObjectService::getObjects( const string& repoId,
+        const vector< string >& ids, unsigned int maxConcurrency )
+{
+    vector< HttpTransferPtr > requests;
+    for ( vector< string >::const_iterator it = ids.begin( ); it != ids.end( ); ++it )
+    {
+        GetObjectRequest request( repoId, *it );
+        requests.push_back( m_session->createSoapTransfer( m_url, request ) );
+    }
+
+    m_session->httpRunConcurrentRequests( requests, maxConcurrency );
+
+    vector< libcmis::ObjectResult > results;
+    for ( size_t i = 0; i < ids.size( ); ++i )
+    {
+        try
+        {
+            if ( requests[i]->isFailed( ) )
+                throw requests[i]->getError( )->getCmisException( );
+
+            libcmis::ObjectPtr object;
+            vector< SoapResponsePtr > responses = m_session->parseSoapResponse( requests[i]->getResponse( ) );
+            if ( responses.size( ) == 1 )
+            {
+                GetObjectResponse* response = dynamic_cast< GetObjectResponse* >( responses.front( ).get( ) );
+                if ( response != NULL )
+                    object = response->getObject( );
+            }
+
+            if ( !object )
+                throw libcmis::Exception( "No such node: " + ids[i], "objectNotFound" );
+            results.push_back( libcmis::ObjectResult( ids[i], object ) );
+        }
+        catch ( const libcmis::Exception& e )
+        {
+            results.push_back( libcmis::ObjectResult( ids[i], e ) );
+        }
+    }
+
+    return results;
+}
+
 libcmis::ObjectPtr ObjectService::getObjectByPath( const string& repoId, const string& path )
 {
     libcmis::ObjectPtr object;
@@ -144,6 +186,45 @@ libcmis::ObjectPtr ObjectService::updateProperties(
     return object;
 }
 
+vector< libcmis::UpdateResult > ObjectService::updateProperties( const string& repoId,
+        const vector< string >& ids, const vector< PropertyPtrMap >& properties,
+        unsigned int maxConcurrency )
+{
+    vector< HttpTransferPtr > requests;
+    for ( size_t i = 0; i < ids.size( ); ++i )
+    {
+        UpdatePropertiesRequest request( repoId, ids[i], properties[i], string( ) );
+        requests.push_back( m_session->createSoapTransfer( m_url, request ) );
+    }
+
+    m_session->httpRunConcurrentRequests( requests, maxConcurrency );
+
+    vector< libcmis::UpdateResult > results;
+    for ( size_t i = 0; i < ids.size( ); ++i )
+    {
+        try
+        {
+            if ( requests[i]->isFailed( ) )
+                throw requests[i]->getError( )->getCmisException( );
+
+            vector< SoapResponsePtr > responses = m_session->parseSoapResponse( requests[i]->getResponse( ) );
+            UpdatePropertiesResponse* response = NULL;
+            if ( responses.size( ) == 1 )
+                response = dynamic_cast< UpdatePropertiesResponse* >( responses.front( ).get( ) );
+
+            if ( response == NULL )
+                throw libcmis::Exception( "Failed to parse the updateProperties response" );
+            results.push_back( libcmis::UpdateResult( ids[i], response->getObjectId( ), response->getChangeToken( ) ) );
+        }
+        catch ( const libcmis::Exception& e )
+        {
+            results.push_back( libcmis::UpdateResult( ids[i], e ) );
+        }
+    }
+
+    return results;
+}
+
 void ObjectService::deleteObject( const string& repoId, const string& id, bool allVersions )
 {
     DeleteObjectRequest request( repoId, id, allVersions );
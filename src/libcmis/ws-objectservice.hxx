@@ -32,6 +32,7 @@
 #include <string>
 #include <vector>
 
+#include <libcmis/batch.hxx>
 #include <libcmis/document.hxx>
 #include <libcmis/folder.hxx>
 #include <libcmis/object.hxx>
@@ -57,6 +58,11 @@ class ObjectService
 
         libcmis::ObjectPtr getObject( const std::string& repoId, const std::string& id );
 
+        /** Get several objects at once using concurrent requests.
+          */
+        std::vector< libcmis::ObjectResult > getObjects( const std::string& repoId,
+                const std::vector< std::string >& ids, unsigned int maxConcurrency );
+
         libcmis::ObjectPtr getObjectByPath( const std::string& repoId, const std::string& path );
 
         std::vector< libcmis::RenditionPtr > getRenditions(
@@ -68,6 +74,18 @@ class ObjectService
                 const std::map< std::string, libcmis::PropertyPtr > & properties,
                 std::string changeToken );
 
+        /** Update several objects at once using concurrent requests, without
+            fetching the updated objects.
+
+            \param properties
+                the properties to set on each object: there has to be as many
+                items as ids.
+          */
+        std::vector< libcmis::UpdateResult > updateProperties( const std::string& repoId,
+                const std::vector< std::string >& ids,
+                const std::vector< libcmis::PropertyPtrMap >& properties,
+                unsigned int maxConcurrency );
+
         void deleteObject( const std::string& repoId, const std::string& id, bool allVersions );
         
         std::vector< std::string > deleteTree( const std::string& repoId, const std::string& folderId, bool allVersions,
@@ -29,6 +29,7 @@
 #include "ws-relatedmultipart.hxx"
 
 #include <algorithm>
+#include <cstring>
 #include <sstream>
 #include <boost/algorithm/string.hpp>
 #include <boost/uuid/uuid_generators.hpp>
@@ -40,26 +41,396 @@
 using namespace std;
 using namespace boost::uuids;
 
+namespace
+{
+    /** Stream buffer reading the content of a part, either in place from
+        the memory or from its temporary file.
+      */
+    class RelatedPartBuf : public streambuf
+    {
+        private:
+            RelatedPartPtr m_part;
+            boost::shared_ptr< FILE > m_file;
+            const char* m_data;
+            size_t m_size;
+            size_t m_filePos;
+            char m_buffer[8192];
+
+        public:
+            RelatedPartBuf( RelatedPartPtr part, boost::shared_ptr< FILE > file,
+                            const string& content, size_t size ) :
+                m_part( part ),
+                m_file( file ),
+                m_data( content.data( ) ),
+                m_size( size ),
+                m_filePos( 0 )
+            {
+                if ( !m_file )
+                {
+                    char* begin = const_cast< char* >( m_data );
+                    setg( begin, begin, begin + m_size );
+                }
+            }
+
+        protected:
+            virtual int_type underflow( )
+            {
+                if ( gptr( ) < egptr( ) )
+                    return traits_type::to_int_type( *gptr( ) );
+                if ( !m_file || m_filePos >= m_size )
+                    return traits_type::eof( );
+
+                size_t read = 0;
+                if ( 0 == fseek( m_file.get( ), long( m_filePos ), SEEK_SET ) )
+                    read = fread( m_buffer, 1, min( sizeof( m_buffer ), m_size - m_filePos ), m_file.get( ) );
+                if ( read == 0 )
+                    return traits_type::eof( );
+
+                m_filePos += read;
+                setg( m_buffer, m_buffer, m_buffer + read );
+                return traits_type::to_int_type( *gptr( ) );
+            }
+
+            virtual pos_type seekoff( off_type off, ios_base::seekdir dir, ios_base::openmode )
+            {
+                off_type current = off_type( m_file ? m_filePos - ( egptr( ) - gptr( ) ) : gptr( ) - eback( ) );
+                off_type pos = off;
+                if ( dir == ios_base::cur )
+                    pos += current;
+                else if ( dir == ios_base::end )
+                    pos += off_type( m_size );
+                return seekpos( pos_type( pos ), ios_base::in );
+            }
+
+            virtual pos_type seekpos( pos_type pos, ios_base::openmode )
+            {
+                off_type offset( pos );
+                if ( offset < 0 || size_t( offset ) > m_size )
+                    return pos_type( off_type( -1 ) );
+
+                if ( m_file )
+                {
+                    m_filePos = size_t( offset );
+                    setg( m_buffer, m_buffer, m_buffer );
+                }
+                else
+                {
+                    char* begin = const_cast< char* >( m_data );
+                    setg( begin, begin + offset, begin + m_size );
+                }
+                return pos;
+            }
+
+        private:
+            RelatedPartBuf( const RelatedPartBuf& );
+            RelatedPartBuf& operator=( const RelatedPartBuf& );
+    };
+
+    /** Stream reading the content of a part from its source stream.
+      */
+    class RelatedPartSourceStream : public istream
+    {
+        private:
+            RelatedPartPtr m_part;
+
+        public:
+            RelatedPartSourceStream( RelatedPartPtr part, streambuf* buf ) :
+                istream( buf ),
+                m_part( part )
+            {
+                seekg( 0, ios::beg );
+            }
+    };
+
+    /** Stream buffer producing a multipart body: the boundaries and headers
+        are stored, the content of the parts is read from them when needed.
+      */
+    class RelatedMultipartBuf : public streambuf
+    {
+        private:
+            struct Segment
+            {
+                string m_text;
+                RelatedPartPtr m_part;
+                boost::shared_ptr< istream > m_stream;
+                size_t m_start;
+                size_t m_size;
+
+                Segment( RelatedPartPtr part, size_t start, size_t size ) :
+                    m_text( ),
+                    m_part( part ),
+                    m_stream( ),
+                    m_start( start ),
+                    m_size( size )
+                {
+                }
+            };
+
+            vector< Segment > m_segments;
+            size_t m_size;
+            size_t m_nextPos;
+            char m_buffer[16384];
+
+        public:
+            RelatedMultipartBuf( ) :
+                m_segments( ),
+                m_size( 0 ),
+                m_nextPos( 0 ),
+                m_buffer( )
+            {
+            }
+
+            void addText( const string& text )
+            {
+                if ( m_segments.empty( ) || m_segments.back( ).m_part )
+                    addSegment( RelatedPartPtr( ), 0 );
+
+                m_segments.back( ).m_text += text;
+                m_segments.back( ).m_size += text.size( );
+                m_size += text.size( );
+            }
+
+            void addPart( RelatedPartPtr part )
+            {
+                addSegment( part, part->getContentSize( ) );
+                m_size += part->getContentSize( );
+            }
+
+        protected:
+            virtual int_type underflow( )
+            {
+                if ( gptr( ) < egptr( ) )
+                    return traits_type::to_int_type( *gptr( ) );
+                if ( m_nextPos >= m_size )
+                    return traits_type::eof( );
+
+                size_t i = 0;
+                while ( m_segments[i].m_start + m_segments[i].m_size <= m_nextPos )
+                    ++i;
+                Segment& segment = m_segments[i];
+                size_t offset = m_nextPos - segment.m_start;
+
+                if ( !segment.m_part )
+                {
+                    char* text = const_cast< char* >( segment.m_text.data( ) );
+                    setg( text, text + offset, text + segment.m_size );
+                    m_nextPos = segment.m_start + segment.m_size;
+                }
+                else
+                {
+                    if ( !segment.m_stream )
+                        segment.m_stream = segment.m_part->getContentStream( );
+
+                    istream& is = *segment.m_stream;
+                    is.clear( );
+                    is.seekg( streamoff( offset ), ios::beg );
+                    is.read( m_buffer, streamsize( min( sizeof( m_buffer ), segment.m_size - offset ) ) );
+                    streamsize read = is.gcount( );
+                    if ( read <= 0 )
+                        return traits_type::eof( );
+
+                    setg( m_buffer, m_buffer, m_buffer + read );
+                    m_nextPos += size_t( read );
+                }
+                return traits_type::to_int_type( *gptr( ) );
+            }
+
+            virtual pos_type seekoff( off_type off, ios_base::seekdir dir, ios_base::openmode )
+            {
+                off_type pos = off;
+                if ( dir == ios_base::cur )
+                    pos += off_type( m_nextPos ) - off_type( egptr( ) - gptr( ) );
+                else if ( dir == ios_base::end )
+                    pos += off_type( m_size );
+                return seekpos( pos_type( pos ), ios_base::in );
+            }
+
+            virtual pos_type seekpos( pos_type pos, ios_base::openmode )
+            {
+                off_type offset( pos );
+                if ( offset < 0 || size_t( offset ) > m_size )
+                    return pos_type( off_type( -1 ) );
+
+                m_nextPos = size_t( offset );
+                setg( m_buffer, m_buffer, m_buffer );
+                return pos;
+            }
+
+        private:
+            RelatedMultipartBuf( const RelatedMultipartBuf& );
+            RelatedMultipartBuf& operator=( const RelatedMultipartBuf& );
+
+            void addSegment( RelatedPartPtr part, size_t size )
+            {
+                m_segments.push_back( Segment( part, m_size, part ? size : 0 ) );
+            }
+    };
+
+    class RelatedMultipartStream : public istream
+    {
+        private:
+            RelatedMultipartBuf m_buf;
+
+        public:
+            RelatedMultipartStream( ) :
+                istream( NULL ),
+                m_buf( )
+            {
+                rdbuf( &m_buf );
+            }
+
+            RelatedMultipartBuf& getBuf( ) { return m_buf; }
+    };
+
+    /** Stream buffer appending the data written to it to a part, and
+        moving the part to a temporary file when it gets too big.
+      */
+    class RelatedPartWriter : public streambuf
+    {
+        private:
+            RelatedPartPtr m_part;
+            size_t m_spillThreshold;
+
+        public:
+            RelatedPartWriter( RelatedPartPtr part, size_t spillThreshold ) :
+                m_part( part ),
+                m_spillThreshold( spillThreshold )
+            {
+            }
+
+        protected:
+            virtual streamsize xsputn( const char* s, streamsize n )
+            {
+                m_part->appendContent( s, size_t( n ) );
+                if ( m_part->getContentSize( ) > m_spillThreshold )
+                    m_part->spill( );
+                return n;
+            }
+
+            virtual int_type overflow( int_type c )
+            {
+                if ( !traits_type::eq_int_type( c, traits_type::eof( ) ) )
+                {
+                    char ch = traits_type::to_char_type( c );
+                    xsputn( &ch, 1 );
+                }
+                return traits_type::not_eof( c );
+            }
+    };
+
+    class RelatedPartStream : public istream
+    {
+        private:
+            RelatedPartBuf m_buf;
+
+        public:
+            RelatedPartStream( RelatedPartPtr part, boost::shared_ptr< FILE > file,
+                               const string& content, size_t size ) :
+                istream( NULL ),
+                m_buf( part, file, content, size )
+            {
+                rdbuf( &m_buf );
+            }
+    };
+}
+
 RelatedPart::RelatedPart( string& name, string& type, string& content ) :
     m_name( name ),
     m_contentType( type ),
-    m_content( content )
+    m_content( content ),
+    m_file( ),
+    m_source( ),
+    m_size( content.size( ) )
+{
+}
+
+RelatedPart::RelatedPart( string& name, string& type, boost::shared_ptr< ostream > content, size_t size ) :
+    m_name( name ),
+    m_contentType( type ),
+    m_content( ),
+    m_file( ),
+    m_source( content ),
+    m_size( size )
+{
+}
+
+string RelatedPart::getContent( )
+{
+    if ( !m_file && !m_source )
+        return m_content;
+
+    string content;
+    content.reserve( m_size );
+    boost::shared_ptr< istream > stream = getContentStream( );
+    char buf[8192];
+    while ( content.size( ) < m_size &&
+            ( stream->read( buf, streamsize( min( sizeof( buf ), m_size - content.size( ) ) ) ) ||
+              stream->gcount( ) > 0 ) )
+        content.append( buf, size_t( stream->gcount( ) ) );
+    return content;
+}
+
+boost::shared_ptr< istream > RelatedPart::getContentStream( )
+{
+    if ( m_source )
+        return boost::shared_ptr< istream >(
+                new RelatedPartSourceStream( shared_from_this( ), m_source->rdbuf( ) ) );
+
+    return boost::shared_ptr< istream >(
+            new RelatedPartStream( shared_from_this( ), m_file, m_content, m_size ) );
+}
+
+void RelatedPart::appendContent( const char* data, size_t len )
+{
+    if ( m_source )
+        return;
+
+    if ( m_file )
+    {
+        fseek( m_file.get( ), 0, SEEK_END );
+        if ( fwrite( data, 1, len, m_file.get( ) ) != len )
+            throw libcmis::Exception( "Failed to write the multipart content to a temporary file" );
+    }
+    else
+        m_content.append( data, len );
+    m_size += len;
+}
+
+bool RelatedPart::spill( )
 {
+    if ( m_file || m_source )
+        return true;
+
+    FILE* tmp = tmpfile( );
+    if ( tmp == NULL )
+        return false;
+
+    boost::shared_ptr< FILE > file( tmp, fclose );
+    if ( fwrite( m_content.data( ), 1, m_content.size( ), file.get( ) ) != m_content.size( ) )
+        return false;
+
+    m_file = file;
+    string( ).swap( m_content );
+    return true;
 }
 
 // LCOV_EXCL_START
 string RelatedPart::toString( const string& cid )
+{
+    return toHeaders( cid ) + getContent( );
+}
+// LCOV_EXCL_STOP
+
+string RelatedPart::toHeaders( const string& cid )
 {
     string buf;
 
     buf += "Content-Id: <" + cid + ">\r\n";
     buf += "Content-Type: " + getContentType( ) + "\r\n";
     buf += "Content-Transfer-Encoding: binary\r\n\r\n";
-    buf += getContent( );
 
     return buf;
 }
-// LCOV_EXCL_STOP
 
 RelatedMultipart::RelatedMultipart( ) :
     m_startId( ),
@@ -78,7 +449,15 @@ RelatedMultipart::RelatedMultipart( const string& body, const string& contentTyp
     m_parts( ),
     m_boundary( )
 {
-    // Parse the content-type
+    // Parse it all from memory: nothing gets spilled to a file
+    RelatedMultipartParser parser( contentType, size_t( -1 ) );
+    parser.feed( body.data( ), body.size( ) );
+    parser.finish( );
+    *this = parser.getMultipart( );
+}
+
+void RelatedMultipart::parseContentType( const string& contentType )
+{
     size_t lastPos = 0;
     size_t pos = contentType.find_first_of( ";\"" );
     while ( pos != string::npos )
@@ -121,93 +500,6 @@ RelatedMultipart::RelatedMultipart( const string& body, const string& contentTyp
             pos = contentType.find_first_of( ";\"", lastPos );
         }
     }
-
-    // Parse the multipart
-    string bodyFixed( body );
-    if ( boost::starts_with( bodyFixed, "--" + m_boundary + "\r\n" ) )
-        bodyFixed = "\r\n" + bodyFixed;
-
-    if ( bodyFixed[bodyFixed.length() - 1 ] != '\n' )
-        bodyFixed += '\n';
-
-    string lineEnd( "\n" );
-    string boundaryString( "--" + m_boundary );
-    string endBoundaryString( "--" + m_boundary + "--" );
-    pos = bodyFixed.find( lineEnd );
-    lastPos = 0;
-    bool inPart = false;
-    bool inHeaders = false;
-    string cid;
-    string name;
-    string type;
-    string partBody;
-
-    while ( pos != string::npos )
-    {
-        string line = bodyFixed.substr( lastPos, pos - lastPos );
-        if ( boost::starts_with( line, boundaryString ) )
-        {
-            // Found a part start
-            inPart = true;
-
-            if ( !cid.empty() && !type.empty( ) )
-            {
-                // Remove potential \r at the end of the body part
-                if ( partBody[partBody.length() - 1] == '\r' )
-                    partBody.pop_back();
-
-                RelatedPartPtr relatedPart( new RelatedPart( name, type, partBody ) );
-                m_parts[cid] = relatedPart;
-
-            }
-            cid.clear( );
-            type.clear( );
-            name.clear( );
-            partBody.clear( );
-            inHeaders = true;
-        }
-        else if ( inPart )
-        {
-            if ( inHeaders )
-            {
-                // Remove potential \r at the end
-                if ( !line.empty() && line[line.length() - 1] == '\r' )
-                    line.pop_back();
-
-                if ( line.empty( ) )
-                    inHeaders = false;
-                else
-                {
-                    size_t colonPos = line.find( ":" );
-                    string headerName = line.substr( 0, colonPos );
-                    string headerValue = line.substr( colonPos + 1 );
-                    if ( boost::to_lower_copy( headerName ) == "content-id" )
-                    {
-                        cid = libcmis::trim( headerValue );
-                        // Remove the '<' '>' around the id if any
-                        if ( cid[0] == '<' && cid[cid.size()-1] == '>' )
-                            cid = cid.substr( 1, cid.size() - 2 );
-                    }
-                    else if ( headerName == "Content-Type" )
-                        type = libcmis::trim( headerValue );
-                    // TODO Handle the Content-Transfer-Encoding
-                }
-            }
-            else
-            {
-                if ( !partBody.empty() )
-                    partBody += lineEnd;
-                partBody += line;
-            }
-        }
-
-        // If we found the end of the multipart, no need to continue looping
-        if ( boost::starts_with( line, endBoundaryString ) )
-            break;
-
-        lastPos = pos + lineEnd.length();
-        pos = bodyFixed.find( lineEnd, lastPos );
-    }
 }
 
 vector< string > RelatedMultipart::getIds( )
@@ -275,14 +567,25 @@ string RelatedMultipart::getContentType( )
 
 boost::shared_ptr< istringstream > RelatedMultipart::toStream( )
 {
-    string buf;
+    stringstream buf;
+    buf << getBodyStream( )->rdbuf( );
+
+    boost::shared_ptr< istringstream > is( new istringstream( buf.str( ) ) );
+    return is;
+}
+
+boost::shared_ptr< istream > RelatedMultipart::getBodyStream( )
+{
+    boost::shared_ptr< RelatedMultipartStream > stream( new RelatedMultipartStream( ) );
+    RelatedMultipartBuf& buf = stream->getBuf( );
 
     // Output the start part first
-    buf += "\r\n--" + m_boundary + "\r\n";
+    buf.addText( "\r\n--" + m_boundary + "\r\n" );
     RelatedPartPtr part = getPart( getStartId( ) );
     if ( part.get( ) != NULL )
     {
-        buf += part->toString( getStartId( ) );
+        buf.addText( part->toHeaders( getStartId( ) ) );
+        buf.addPart( part );
     }
 
     for ( map< string, RelatedPartPtr >::iterator it = m_parts.begin( );
@@ -290,15 +593,15 @@ boost::shared_ptr< istringstream > RelatedMultipart::toStream( )
     {
         if ( it->first != getStartId( ) )
         {
-            buf += "\r\n--" + m_boundary + "\r\n";
-            buf += it->second->toString( it->first );
+            buf.addText( "\r\n--" + m_boundary + "\r\n" );
+            buf.addText( it->second->toHeaders( it->first ) );
+            buf.addPart( it->second );
         }
     }
 
-    buf += "\r\n--" + m_boundary + "--\r\n";
+    buf.addText( "\r\n--" + m_boundary + "--\r\n" );
 
-    boost::shared_ptr< istringstream > is( new istringstream( buf ) );
-    return is;
+    return stream;
 }
 
 string RelatedMultipart::createPartId( const string& name )
@@ -311,9 +614,278 @@ string RelatedMultipart::createPartId( const string& name )
     return tmpStream.str();
 }
 
+RelatedMultipartParser::RelatedMultipartParser( const string& contentType, size_t spillThreshold ) :
+    m_multipart( ),
+    m_spillThreshold( spillThreshold ),
+    m_delimiter( ),
+    m_pending( ),
+    m_state( PREAMBLE ),
+    m_cid( ),
+    m_type( ),
+    m_part( )
+{
+    m_multipart.m_boundary.clear( );
+    m_multipart.parseContentType( contentType );
+
+    // The line end before the boundary belongs to the delimiter, RFC-2046
+    m_delimiter = "\n--" + m_multipart.m_boundary;
+
+    // The body may start with the boundary without line end before it
+    m_pending = "\r\n";
+}
+
+void RelatedMultipartParser::feed( const char* data, size_t len )
+{
+    // Complete the data left by the previous chunk until it is consumed,
+    // then scan the rest of the chunk in place.
+    const size_t step = max( m_delimiter.size( ), size_t( 256 ) );
+    while ( !m_pending.empty( ) && len > 0 )
+    {
+        size_t oldSize = m_pending.size( );
+        size_t added = min( len, step );
+        m_pending.append( data, added );
+        data += added;
+        len -= added;
+
+        size_t consumed = consume( m_pending.data( ), m_pending.size( ) );
+        if ( consumed >= oldSize )
+        {
+            // Only bytes from the chunk are left: go back to them
+            size_t left = m_pending.size( ) - consumed;
+            data -= left;
+            len += left;
+            m_pending.clear( );
+        }
+        else
+            m_pending.erase( 0, consumed );
+    }
+
+    if ( len > 0 )
+    {
+        size_t consumed = consume( data, len );
+        m_pending.assign( data + consumed, len - consumed );
+    }
+}
+
+void RelatedMultipartParser::finish( )
+{
+    // The end boundary may not be followed by a line end
+    if ( m_state == BOUNDARY_LINE && boost::starts_with( m_pending, "--" ) )
+        m_state = EPILOGUE;
+    else if ( m_state == BOUNDARY_LINE || m_state == HEADERS )
+    {
+        m_pending += "\n";
+        m_pending.erase( 0, consume( m_pending.data( ), m_pending.size( ) ) );
+    }
+
+    // A part without its closing boundary is incomplete
+    m_part.reset( );
+    m_pending.clear( );
+}
+
+streamsize RelatedMultipartParser::xsputn( const char* s, streamsize n )
+{
+    feed( s, size_t( n ) );
+    return n;
+}
+
+RelatedMultipartParser::int_type RelatedMultipartParser::overflow( int_type c )
+{
+    if ( !traits_type::eq_int_type( c, traits_type::eof( ) ) )
+    {
+        char ch = traits_type::to_char_type( c );
+        feed( &ch, 1 );
+    }
+    return traits_type::not_eof( c );
+}
+
+size_t RelatedMultipartParser::consume( const char* data, size_t len )
+{
+    const size_t delimiterSize = m_delimiter.size( );
+    size_t pos = 0;
+    while ( pos < len )
+    {
+        const char* start = data + pos;
+        const char* end = data + len;
+        size_t available = len - pos;
+
+        if ( m_state == PREAMBLE || m_state == BODY )
+        {
+            // Look for the delimiter at each line end
+            const char* found = NULL;
+            const char* nl = start;
+            while ( found == NULL &&
+                    ( nl = static_cast< const char* >( memchr( nl, '\n', end - nl ) ) ) != NULL &&
+                    size_t( end - nl ) >= delimiterSize )
+            {
+                if ( 0 == memcmp( nl, m_delimiter.data( ), delimiterSize ) )
+                    found = nl;
+                else
+                    ++nl;
+            }
+
+            if ( found == NULL )
+            {
+                // Keep what could be the start of a delimiter, and the \r before it
+                size_t safe = available > delimiterSize ? available - delimiterSize : 0;
+                appendToPart( start, safe );
+                return pos + safe;
+            }
+
+            size_t partEnd = found - start;
+            if ( partEnd > 0 && start[partEnd - 1] == '\r' )
+                --partEnd;
+            appendToPart( start, partEnd );
+            endPart( );
+
+            pos += ( found - start ) + delimiterSize;
+            m_state = BOUNDARY_LINE;
+        }
+        else if ( m_state == BOUNDARY_LINE || m_state == HEADERS )
+        {
+            const char* nl = static_cast< const char* >( memchr( start, '\n', available ) );
+            if ( nl == NULL )
+                return pos;
+
+            string line( start, nl - start );
+            pos += line.size( ) + 1;
+
+            if ( m_state == BOUNDARY_LINE )
+                m_state = boost::starts_with( line, "--" ) ? EPILOGUE : HEADERS;
+            else
+            {
+                // Remove potential \r at the end
+                if ( !line.empty( ) && line[line.length() - 1] == '\r' )
+                    line.pop_back( );
+
+                if ( line.empty( ) )
+                {
+                    startPart( );
+                    m_state = BODY;
+                }
+                else
+                    parseHeader( line );
+            }
+        }
+        else
+        {
+            // Nothing interesting after the end boundary
+            return len;
+        }
+    }
+    return pos;
+}
+
+void RelatedMultipartParser::appendToPart( const char* data, size_t len )
+{
+    if ( !m_part || len == 0 )
+        return;
+
+    m_part->appendContent( data, len );
+
+    // The SOAP envelope has to stay in memory to be parsed
+    if ( m_part->getContentSize( ) > m_spillThreshold && !m_part->isSpilled( ) &&
+         m_cid != m_multipart.getStartId( ) )
+        m_part->spill( );
+}
+
+void RelatedMultipartParser::parseHeader( string line )
+{
+    size_t colonPos = line.find( ":" );
+    string headerName = line.substr( 0, colonPos );
+    string headerValue = colonPos != string::npos ? line.substr( colonPos + 1 ) : string( );
+    if ( boost::iequals( headerName, "content-id" ) )
+    {
+        m_cid = libcmis::trim( headerValue );
+        // Remove the '<' '>' around the id if any
+        if ( !m_cid.empty( ) && m_cid[0] == '<' && m_cid[m_cid.size()-1] == '>' )
+            m_cid = m_cid.substr( 1, m_cid.size() - 2 );
+    }
+    else if ( boost::iequals( headerName, "content-type" ) )
+        m_type = libcmis::trim( headerValue );
+    // TODO Handle the Content-Transfer-Encoding
+}
+
+void RelatedMultipartParser::startPart( )
+{
+    m_part.reset( );
+    if ( !m_cid.empty( ) && !m_type.empty( ) )
+    {
+        string name;
+        string content;
+        m_part.reset( new RelatedPart( name, m_type, content ) );
+    }
+}
+
+void RelatedMultipartParser::endPart( )
+{
+    if ( m_part )
+        m_multipart.m_parts[m_cid] = m_part;
+
+    m_part.reset( );
+    m_cid.clear( );
+    m_type.clear( );
+}
+
+XopInlineContentFilter::XopInlineContentFilter( size_t spillThreshold ) :
+    m_multipart( ),
+    m_spillThreshold( spillThreshold ),
+    m_node( NULL ),
+    m_part( ),
+    m_writer( ),
+    m_out( ),
+    m_decoder( )
+{
+}
+
+void XopInlineContentFilter::startElement( xmlNodePtr node )
+{
+    if ( m_node == NULL && libcmis::isXmlElement( node, NS_CMISM_URL, "stream" ) )
+    {
+        string name( "stream" );
+        string type( "application/octet-stream" );
+        string content;
+        m_part.reset( new RelatedPart( name, type, content ) );
+        m_writer.reset( new RelatedPartWriter( m_part, m_spillThreshold ) );
+        m_out.reset( new ostream( m_writer.get( ) ) );
+        m_decoder.reset( new libcmis::EncodedData( m_out.get( ) ) );
+        m_decoder->setEncoding( "base64" );
+        m_node = node;
+    }
+}
+
+bool XopInlineContentFilter::characters( xmlNodePtr node, const xmlChar* text, int len )
+{
+    if ( node != m_node )
+        return false;
+
+    m_decoder->decode( ( void* )text, 1, size_t( len ) );
+    return true;
+}
+
+void XopInlineContentFilter::endElement( xmlNodePtr node )
+{
+    if ( node != m_node )
+        return;
+
+    m_decoder->finish( );
+
+    // Reference the decoded content like an MTOM attachment
+    string href = "cid:" + m_multipart.addPart( m_part );
+    xmlNodePtr include = xmlNewChild( node, NULL, BAD_CAST( "Include" ), NULL );
+    xmlSetNs( include, xmlNewNs( include, BAD_CAST( NS_XOP_URL ), BAD_CAST( "xop" ) ) );
+    xmlNewProp( include, BAD_CAST( "href" ), BAD_CAST( href.c_str( ) ) );
+
+    m_decoder.reset( );
+    m_out.reset( );
+    m_writer.reset( );
+    m_part.reset( );
+    m_node = NULL;
+}
+
 boost::shared_ptr< istream > getStreamFromNode( xmlNodePtr node, RelatedMultipart& multipart )
 {
-    boost::shared_ptr< stringstream > stream;
+    boost::shared_ptr< istream > stream;
     for ( xmlNodePtr child = node->children; child; child = child->next )
     {
         if ( xmlStrEqual( child->name, BAD_CAST( "Include" ) ) )
@@ -332,22 +904,32 @@ boost::shared_ptr< istream > getStreamFromNode( xmlNodePtr node, RelatedMultipar
             }
             RelatedPartPtr part = multipart.getPart( id );
             if ( part != NULL )
-                stream.reset( new stringstream( part->getContent( ) ) );
+                stream = part->getContentStream( );
         }
     }
 
-    // If there was no xop:Include, then use the content as base64 data
+    // If there was no xop:Include, then use the content as base64 data.
+    // Decode the text nodes in place, rather than copying the whole text.
     if ( stream.get( ) == NULL )
     {
-        xmlChar* content = xmlNodeGetContent( node );
-
-        stream.reset( new stringstream( ) );
-        libcmis::EncodedData decoder( stream.get( ) );
+        string name( "stream" );
+        string type( "application/octet-stream" );
+        string content;
+        RelatedPartPtr part( new RelatedPart( name, type, content ) );
+        RelatedPartWriter writer( part, RelatedMultipartParser::DEFAULT_SPILL_THRESHOLD );
+        ostream out( &writer );
+
+        libcmis::EncodedData decoder( &out );
         decoder.setEncoding( "base64" );
-        decoder.decode( ( void* )content, 1, xmlStrlen( content ) );
+        for ( xmlNodePtr child = node->children; child; child = child->next )
+        {
+            if ( ( child->type == XML_TEXT_NODE || child->type == XML_CDATA_SECTION_NODE ) &&
+                 child->content != NULL )
+                decoder.decode( ( void* )child->content, 1, xmlStrlen( child->content ) );
+        }
         decoder.finish( );
-        
-        xmlFree( content );
+
+        stream = part->getContentStream( );
     }
     return stream;
 }
@@ -28,35 +28,83 @@
 #ifndef _WS_RELATEDMULTIPART_HXX_
 #define _WS_RELATEDMULTIPART_HXX_
 
+#include <cstdio>
 #include <exception>
 #include <map>
 #include <string>
 #include <sstream>
+#include <streambuf>
 #include <vector>
 
+#include <boost/enable_shared_from_this.hpp>
 #include <boost/shared_ptr.hpp>
 #include <libxml/tree.h>
 
-class RelatedPart
+#include <libcmis/xml-utils.hxx>
+
+class RelatedPart : public boost::enable_shared_from_this< RelatedPart >
 {
     private:
         std::string m_name;
         std::string m_contentType;
         std::string m_content;
+        boost::shared_ptr< FILE > m_file;
+        boost::shared_ptr< std::ostream > m_source;
+        size_t m_size;
 
     public:
         RelatedPart( std::string& name, std::string& type, std::string& content );
+
+        /** Create a part reading its content from a stream only when it is
+            output, to avoid loading the documents to upload in memory.
+
+            \param content the stream to read the data from, starting at its beginning
+            \param size the number of bytes of the content
+          */
+        RelatedPart( std::string& name, std::string& type,
+                     boost::shared_ptr< std::ostream > content, size_t size );
         ~RelatedPart( ) { };
 
         std::string getName( ) { return m_name; }
         std::string getContentType( ) { return m_contentType; }
-        std::string getContent( ) { return m_content; }
+
+        /** Get a copy of the content, reading it back if it has been
+            spilled to a temporary file.
+          */
+        std::string getContent( );
+
+        /** Get a stream reading the content without copying it. The stream
+            keeps the part alive.
+          */
+        boost::shared_ptr< std::istream > getContentStream( );
+
+        size_t getContentSize( ) { return m_size; }
+
+        /** Append some data at the end of the content.
+          */
+        void appendContent( const char* data, size_t len );
+
+        /** Move the content to a temporary file, to free the memory.
+
+            \return
+                false if the temporary file can't be created: the
+                content is kept in memory in such a case.
+          */
+        bool spill( );
+
+        bool isSpilled( ) { return m_file.get( ) != NULL; }
 
         /** Create the string to place between the boundaries in the multipart.
 
             \param cid the content Id to output
           */
         std::string toString( const std::string& cid );
+
+        /** Create the headers to place between the boundary and the content.
+
+            \param cid the content Id to output
+          */
+        std::string toHeaders( const std::string& cid );
 };
 typedef boost::shared_ptr< RelatedPart > RelatedPartPtr;
 
@@ -64,6 +112,8 @@ typedef boost::shared_ptr< RelatedPart > RelatedPartPtr;
   */
 class RelatedMultipart
 {
+    friend class RelatedMultipartParser;
+
     private:
 
         std::string m_startId;
@@ -79,6 +129,9 @@ class RelatedMultipart
         RelatedMultipart( );
 
         /** Parse a multipart body to extract the entries from it.
+
+            The parts are kept in memory: use RelatedMultipartParser to
+            parse a body while it is received.
           */
         RelatedMultipart( const std::string& body, const std::string& contentType );
 
@@ -117,9 +170,19 @@ class RelatedMultipart
 
         /** Dump the multipart to an input stream: this can be provided as is as
             an HTTP post request body.
+
+            The whole body is built in memory: use getBodyStream( ) to send it.
           */
         boost::shared_ptr< std::istringstream > toStream( );
 
+        /** Get a stream producing the multipart body while it is read. The
+            content of the parts is read from their own streams when needed,
+            so the memory used doesn't depend on the size of the parts.
+
+            The stream can seek, to get its size or to send it again.
+          */
+        boost::shared_ptr< std::istream > getBodyStream( );
+
         /** Provide an access to the boundary token for the unit tests.
           */
         std::string getBoundary( ) { return m_boundary; }
@@ -129,6 +192,122 @@ class RelatedMultipart
         /** Generate a content id, using an entry name and some random uuid.
           */
         std::string createPartId( const std::string& name );
+
+        /** Extract the start, boundary and start-info parameters of the
+            multipart Content-Type.
+          */
+        void parseContentType( const std::string& contentType );
+};
+
+/** Streaming parser for multipart/related bodies.
+
+    The body is written to the parser chunk by chunk as it is received,
+    for example as the sink of an HttpResponse. The parts are split while
+    scanning for the boundary: only a few bytes at the end of a chunk are
+    kept between two writes. The start part, containing the SOAP envelope,
+    is kept in memory. The other parts are moved to a temporary file when
+    they get bigger than the spill threshold.
+  */
+class RelatedMultipartParser : public std::streambuf
+{
+    public:
+        static const size_t DEFAULT_SPILL_THRESHOLD = 1024 * 1024;
+
+    private:
+        enum State
+        {
+            PREAMBLE,
+            BOUNDARY_LINE,
+            HEADERS,
+            BODY,
+            EPILOGUE
+        };
+
+        RelatedMultipart m_multipart;
+        size_t m_spillThreshold;
+        std::string m_delimiter;
+        std::string m_pending;
+        State m_state;
+        std::string m_cid;
+        std::string m_type;
+        RelatedPartPtr m_part;
+
+    public:
+        /** \param contentType
+                the Content-Type header of the multipart body
+            \param spillThreshold
+                the size above which the non-start parts are moved
+                to a temporary file
+          */
+        RelatedMultipartParser( const std::string& contentType,
+                                size_t spillThreshold = DEFAULT_SPILL_THRESHOLD );
+
+        /** Parse the next chunk of the body.
+          */
+        void feed( const char* data, size_t len );
+
+        /** Tell that the whole body has been fed. Parts not terminated by
+            a boundary are dropped.
+          */
+        void finish( );
+
+        /** Get the parts parsed so far.
+          */
+        RelatedMultipart& getMultipart( ) { return m_multipart; }
+
+    protected:
+        virtual std::streamsize xsputn( const char* s, std::streamsize n );
+        virtual int_type overflow( int_type c );
+
+    private:
+        RelatedMultipartParser( const RelatedMultipartParser& );
+        RelatedMultipartParser& operator=( const RelatedMultipartParser& );
+
+        /** Process as much data as possible.
+
+            \return
+                the number of bytes processed, the others have to be
+                provided again with the following data.
+          */
+        size_t consume( const char* data, size_t len );
+        void appendToPart( const char* data, size_t len );
+        void parseHeader( std::string line );
+        void startPart( );
+        void endPart( );
+};
+
+/** Decode the base64 content of the cmism:stream elements while the SOAP
+    response is parsed, instead of keeping it as text in the tree.
+
+    The decoded content is stored as a part of a multipart, moved to a
+    temporary file when it gets big, and an xop:Include referencing that
+    part is added to the element, as if the response was using MTOM.
+  */
+class XopInlineContentFilter : public libcmis::XmlTextFilter
+{
+    private:
+        RelatedMultipart m_multipart;
+        size_t m_spillThreshold;
+        xmlNodePtr m_node;
+        RelatedPartPtr m_part;
+        boost::shared_ptr< std::streambuf > m_writer;
+        boost::shared_ptr< std::ostream > m_out;
+        boost::shared_ptr< libcmis::EncodedData > m_decoder;
+
+    public:
+        XopInlineContentFilter( size_t spillThreshold = RelatedMultipartParser::DEFAULT_SPILL_THRESHOLD );
+
+        virtual void startElement( xmlNodePtr node );
+        virtual bool characters( xmlNodePtr node, const xmlChar* text, int len );
+        virtual void endElement( xmlNodePtr node );
+
+        /** Get the parts holding the decoded contents.
+          */
+        RelatedMultipart& getMultipart( ) { return m_multipart; }
+
+    private:
+        XopInlineContentFilter( const XopInlineContentFilter& );
+        XopInlineContentFilter& operator=( const XopInlineContentFilter& );
 };
 
 /** Extract stream from xs:base64Binary node using either xop:Include or base64 encoded data.
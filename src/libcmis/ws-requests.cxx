@@ -97,30 +97,25 @@ boost::shared_ptr< libcmis::Exception > getCmisException( const SoapFault& fault
 
 void writeCmismStream( xmlTextWriterPtr writer, RelatedMultipart& multipart, boost::shared_ptr< ostream > os, string& contentType, const string& filename )
 {
-    // Get the stream as a string
+    // Only get the stream size: the content is read when sending the request
     istream is( os->rdbuf( ) );
     is.seekg( 0, ios::end );
     long size = is.tellg( );
     is.seekg( 0, ios::beg );
 
-    char* buf = new char[ size ];
-    is.read( buf, size );
-    string content( buf, size );
-    delete[ ] buf;
-
-    xmlTextWriterWriteFormatElement( writer, BAD_CAST( "cmism:length" ), "%ld", static_cast<long int>(content.size( )) );
+    xmlTextWriterWriteFormatElement( writer, BAD_CAST( "cmism:length" ), "%ld", size );
     xmlTextWriterWriteElement( writer, BAD_CAST( "cmism:mimeType" ), BAD_CAST( contentType.c_str( ) ) );
     if ( !filename.empty( ) )
         xmlTextWriterWriteElement( writer, BAD_CAST( "cmism:filename" ), BAD_CAST( filename.c_str( ) ) );
     xmlTextWriterStartElement( writer, BAD_CAST( "cmism:stream" ) );
 
     string name( "stream" );
-    RelatedPartPtr streamPart( new RelatedPart( name, contentType, content ) );
+    RelatedPartPtr streamPart( new RelatedPart( name, contentType, os, size_t( size ) ) );
     string partHref = "cid:";
     partHref += multipart.addPart( streamPart );
 
     xmlTextWriterStartElement( writer, BAD_CAST( "xop:Include" ) );
-    xmlTextWriterWriteAttribute( writer, BAD_CAST( "xmlns:xop" ), BAD_CAST( "http://www.w3.org/2004/08/xop/include" ) );
+    xmlTextWriterWriteAttribute( writer, BAD_CAST( "xmlns:xop" ), BAD_CAST( NS_XOP_URL ) );
     xmlTextWriterWriteAttribute( writer, BAD_CAST( "href" ), BAD_CAST( partHref.c_str( ) ) );
     xmlTextWriterEndElement( writer ); // xop:Include
     xmlTextWriterEndElement( writer ); // cmism:stream
@@ -348,7 +343,7 @@ void UpdatePropertiesRequest::toXml( xmlTextWriterPtr writer )
             it != m_properties.end( ); ++it )
     {
         libcmis::PropertyPtr property = it->second;
-        if( property->getPropertyType( )->isUpdatable( ) )
+        if( property->getPropertyTypeView( )->isUpdatable( ) )
             property->toXml( writer );
     }
     xmlTextWriterEndElement( writer ); // cmis:properties
@@ -373,6 +368,16 @@ SoapResponsePtr UpdatePropertiesResponse::create( xmlNodePtr node, RelatedMultip
                 response->m_id = value;
             }
         }
+        else if ( xmlStrEqual( child->name, BAD_CAST( "changeToken" ) ) )
+        {
+            xmlChar* content = xmlNodeGetContent( child );
+            if ( content != NULL )
+            {
+                string value( ( char* ) content );
+                xmlFree( content );
+                response->m_changeToken = value;
+            }
+        }
     }
 
     return SoapResponsePtr( response );
@@ -285,8 +285,9 @@ class UpdatePropertiesResponse : public SoapResponse
 {
     private:
         std::string m_id;
+        std::string m_changeToken;
 
-        UpdatePropertiesResponse( ) : SoapResponse( ), m_id( ) { }
+        UpdatePropertiesResponse( ) : SoapResponse( ), m_id( ), m_changeToken( ) { }
 
     public:
 
@@ -297,6 +298,7 @@ class UpdatePropertiesResponse : public SoapResponse
         static SoapResponsePtr create( xmlNodePtr node, RelatedMultipart& multipart, SoapSession* session );
 
         std::string getObjectId( ) { return m_id; }
+        std::string getChangeToken( ) { return m_changeToken; }
 };
 
 class DeleteObjectRequest : public SoapRequest
@@ -30,6 +30,7 @@
 
 #include <sstream>
 
+#include <boost/algorithm/string.hpp>
 #include <boost/date_time.hpp>
 #include <libxml/parser.h>
 #include <libxml/tree.h>
@@ -37,10 +38,39 @@
 
 #include <libcmis/xml-utils.hxx>
 
+#include "ws-relatedmultipart.hxx"
 #include "ws-requests.hxx"
 
 using namespace std;
 
+namespace
+{
+    /** Set up the SOAP responses to be parsed while they are received.
+      */
+    class SoapContentHandler : public XmlContentHandler
+    {
+        public:
+            virtual void contentTypeReceived( libcmis::HttpResponse& response, const string& contentType )
+            {
+                XmlContentHandler::contentTypeReceived( response, contentType );
+
+                // Split the MTOM responses while they arrive, to avoid keeping
+                // the whole body and copies of the attachments in memory
+                boost::shared_ptr< streambuf > sink;
+                if ( boost::icontains( contentType, "multipart/related" ) )
+                    sink.reset( new RelatedMultipartParser( contentType ) );
+                response.setBodySink( sink );
+
+                // SOAP 1.1 responses without MTOM may have inline base64 contents:
+                // decode them while parsing instead of keeping the text
+                boost::shared_ptr< libcmis::XmlTextFilter > filter;
+                if ( boost::istarts_with( libcmis::trim( contentType ), "text/xml" ) )
+                    filter.reset( new XopInlineContentFilter( ) );
+                response.setXmlTextFilter( filter );
+            }
+    };
+}
+
 WSSession::WSSession( const string& bindingUrl, const string& repositoryId, const string& username,
         const string& password, bool noSslCheck, libcmis::OAuth2DataPtr oauth2,
         bool verbose ) :
@@ -95,34 +125,24 @@ WSSession::~WSSession( )
     delete m_versioningService;
 }
 
-string WSSession::getWsdl( string url, libcmis::HttpResponsePtr response )
+libcmis::HttpResponsePtr WSSession::getWsdl( string url, libcmis::HttpResponsePtr response )
 {
-    string buf;
-    if ( response )
-        buf = response->getStream( )->str( );
-    else
-        buf = httpGetRequest( url )->getStream( )->str( );
+    if ( !response )
+        response = httpGetRequest( url, XmlContentHandler::getInstance( ) );
 
     // Do we have a wsdl file?
     bool isWsdl = false;
 
-    xmlDocPtr doc = xmlReadMemory( buf.c_str(), buf.size(), m_bindingUrl.c_str(), NULL, 0 );
+    xmlDocPtr doc = response->getXmlDoc( );
     if ( NULL != doc )
     {
-        xmlXPathContextPtr xpathCtx = xmlXPathNewContext( doc );
-        libcmis::registerCmisWSNamespaces( xpathCtx );
+        libcmis::XPathContext xpathCtx( doc );
+        string definitionsXPath( "/wsdl:definitions" );
+        xmlXPathObjectPtr xpathObj = xpathCtx.eval( definitionsXPath );
 
-        if ( NULL != xpathCtx )
-        {
-            string definitionsXPath( "/wsdl:definitions" );
-            xmlXPathObjectPtr xpathObj = xmlXPathEvalExpression( BAD_CAST( definitionsXPath.c_str() ), xpathCtx );
-
-            isWsdl = ( xpathObj != NULL ) && ( xpathObj->nodesetval != NULL ) && ( xpathObj->nodesetval->nodeNr > 0 );
-            xmlXPathFreeObject( xpathObj );
-        }
-        xmlXPathFreeContext( xpathCtx );
+        isWsdl = ( xpathObj != NULL ) && ( xpathObj->nodesetval != NULL ) && ( xpathObj->nodesetval->nodeNr > 0 );
+        xmlXPathFreeObject( xpathObj );
     }
-    xmlFreeDoc( doc );
 
     // If we don't have a wsdl file we may have received an HTML explanation for it,
     // try to add ?wsdl to the URL (last chance to get something)
@@ -134,37 +154,78 @@ string WSSession::getWsdl( string url, libcmis::HttpResponsePtr response )
             url += "&";
         url += "wsdl";
 
-        buf = httpGetRequest( url )->getStream( )->str( );
+        response = httpGetRequest( url, XmlContentHandler::getInstance( ) );
     }
 
-    return buf;
+    return response;
 }
 
 vector< SoapResponsePtr > WSSession::soapRequest( string& url, SoapRequest& request )
 {
-    vector< SoapResponsePtr > responses;
-
+    libcmis::HttpResponsePtr response;
     try
     {
         // Place the request in an envelope
         RelatedMultipart& multipart = request.getMultipart( getUsername( ), getPassword( ) );
-        libcmis::HttpResponsePtr response = httpPostRequest( url, *multipart.toStream( ).get( ), multipart.getContentType( ) );
+        boost::shared_ptr< istream > body = multipart.getBodyStream( );
+        response = httpPostRequest( url, *body, multipart.getContentType( ), true,
+                                    HttpContentHandlerPtr( new SoapContentHandler( ) ) );
+    }
+    catch ( const CurlException& e )
+    {
+        throw e.getCmisException( );
+    }
+
+    return parseSoapResponse( response );
+}
+
+HttpTransferPtr WSSession::createSoapTransfer( const string& url, SoapRequest& request )
+{
+    RelatedMultipart& multipart = request.getMultipart( getUsername( ), getPassword( ) );
+
+    stringstream body;
+    body << multipart.getBodyStream( )->rdbuf( );
+
+    vector< string > headers;
+    headers.push_back( "Content-Type:" + multipart.getContentType( ) );
+    HttpTransferPtr transfer( new HttpTransfer( "POST", url, headers, body.str( ) ) );
+    transfer->setContentHandler( HttpContentHandlerPtr( new SoapContentHandler( ) ) );
+    return transfer;
+}
+
+vector< SoapResponsePtr > WSSession::parseSoapResponse( libcmis::HttpResponsePtr response )
+{
+    vector< SoapResponsePtr > responses;
 
+    try
+    {
         map< string, string >::iterator it = response->getHeaders( ).find( "Content-Type" );
         if ( it != response->getHeaders( ).end( ) )
         {
             string responseType = it->second;
-            if ( string::npos != responseType.find( "multipart/related" ) )
+            RelatedMultipartParser* parser =
+                dynamic_cast< RelatedMultipartParser* >( response->getBodySink( ).get( ) );
+            if ( parser != NULL )
             {
-                RelatedMultipart answer( response->getStream( )->str( ), responseType );
+                // The parts have been split while the body was received
+                parser->finish( );
+                responses = getResponseFactory( ).parseResponse( parser->getMultipart( ) );
+            }
+            else if ( string::npos != responseType.find( "multipart/related" ) )
+            {
+                RelatedMultipart answer( response->getBody( ), responseType );
 
                 responses = getResponseFactory( ).parseResponse( answer );
             }
             else if ( string::npos != responseType.find( "text/xml" ) )
             {
-                // Parse the envelope
-                string xml = response->getStream( )->str( );
-                responses = getResponseFactory( ).parseResponse( xml );
+                // The envelope has been parsed while it was received, with
+                // the inline contents decoded into parts
+                RelatedMultipart noParts;
+                XopInlineContentFilter* filter =
+                    dynamic_cast< XopInlineContentFilter* >( response->getXmlTextFilter( ).get( ) );
+                RelatedMultipart& parts = filter != NULL ? filter->getMultipart( ) : noParts;
+                responses = getResponseFactory( ).parseResponse( response->getXmlDoc( ), parts );
             }
         }
     }
@@ -177,10 +238,6 @@ vector< SoapResponsePtr > WSSession::soapRequest( string& url, SoapRequest& requ
         }
         throw libcmis::Exception( fault.what( ), "runtime" );
     }
-    catch ( const CurlException& e )
-    {
-        throw e.getCmisException( );
-    }
 
     return responses;
 }
@@ -189,24 +246,27 @@ void WSSession::parseWsdl( const string& buf )
 {
     // parse the content
     const boost::shared_ptr< xmlDoc > doc( xmlReadMemory( buf.c_str(), buf.size(), m_bindingUrl.c_str(), NULL, 0 ), xmlFreeDoc );
+    parseWsdl( doc.get( ) );
+}
 
-    if ( bool( doc ) )
+void WSSession::parseWsdl( xmlDocPtr doc )
+{
+    if ( NULL != doc )
     {
         // Check that we have a WSDL document
-        xmlNodePtr root = xmlDocGetRootElement( doc.get() );
+        xmlNodePtr root = xmlDocGetRootElement( doc );
         if ( !xmlStrEqual( root->name, BAD_CAST( "definitions" ) ) )
             throw libcmis::Exception( "Not a WSDL document" );
 
         // Get all the services soap URLs
         m_servicesUrls.clear( );
 
-        xmlXPathContextPtr xpathCtx = xmlXPathNewContext( doc.get() );
-        libcmis::registerCmisWSNamespaces( xpathCtx );
+        libcmis::XPathContext xpathCtx( doc );
 
-        if ( NULL != xpathCtx )
+        if ( NULL != xpathCtx.get( ) )
         {
             string serviceXPath( "//wsdl:service" );
-            xmlXPathObjectPtr xpathObj = xmlXPathEvalExpression( BAD_CAST( serviceXPath.c_str() ), xpathCtx );
+            xmlXPathObjectPtr xpathObj = xpathCtx.eval( serviceXPath );
 
             if ( xpathObj != NULL )
             {
@@ -221,15 +281,14 @@ void WSSession::parseWsdl( const string& buf )
                     string name = libcmis::getXmlNodeAttributeValue( node, "name" );
 
                     // Gimme you soap:address location attribute
-                    string locationXPath = serviceXPath + "[@name='" + name + "']/wsdl:port/soap:address/attribute::location";
-                    string location = libcmis::getXPathValue( xpathCtx, locationXPath );
+                    xpathCtx.setNode( node );
+                    string location = xpathCtx.getValue( "wsdl:port/soap:address/attribute::location" );
 
                     m_servicesUrls[name] = location;
                 }
             }
             xmlXPathFreeObject( xpathObj );
         }
-        xmlXPathFreeContext( xpathCtx );
     }
     else
         throw libcmis::Exception( "Failed to parse service document" );
@@ -264,17 +323,17 @@ void WSSession::initialize( libcmis::HttpResponsePtr response )
     if ( m_repositories.empty() )
     {
         // Get the wsdl file
-        string buf;
+        libcmis::HttpResponsePtr wsdl;
         try
         {
-            buf = getWsdl( m_bindingUrl, response );
+            wsdl = getWsdl( m_bindingUrl, response );
         }
         catch ( const CurlException& e )
         {
             throw e.getCmisException( );
         }
 
-        parseWsdl( buf );
+        parseWsdl( wsdl->getXmlDoc( ) );
         initializeResponseFactory( );
         map< string, string > repositories = getRepositoryService( ).getRepositories( );
         initializeRepositories( repositories );
@@ -400,6 +459,51 @@ libcmis::ObjectPtr WSSession::getObject( string id )
     return getObjectService( ).getObject( getRepositoryId( ), id );
 }
 
+vector< libcmis::ObjectResult > WSSession::getObjects( const vector< string >& ids,
+                                                      const libcmis::BatchOptions& options )
+{
+    return getObjectService( ).getObjects( m_repositoryId, ids, options.getMaxConcurrency( ) );
+}
+
+vector< libcmis::UpdateResult > WSSession::bulkUpdateProperties( const vector< string >& ids,
+        const libcmis::PropertyPtrMap& properties,
+        const vector< string >& addSecondaryTypes,
+        const vector< string >& removeSecondaryTypes,
+        const libcmis::BatchOptions& options )
+{
+    vector< libcmis::PropertyPtrMap > objectsProperties;
+    vector< boost::shared_ptr< libcmis::Exception > > errors;
+    prepareBulkUpdate( ids, properties, addSecondaryTypes, removeSecondaryTypes, options,
+            objectsProperties, errors );
+
+    // The bulkUpdateProperties operation only came with CMIS 1.1: send
+    // concurrent updateProperties requests instead.
+    vector< string > updatedIds;
+    vector< libcmis::PropertyPtrMap > updatedProperties;
+    for ( size_t i = 0; i < ids.size( ); ++i )
+    {
+        if ( !errors[i] )
+        {
+            updatedIds.push_back( ids[i] );
+            updatedProperties.push_back( objectsProperties[i] );
+        }
+    }
+
+    vector< libcmis::UpdateResult > updates = getObjectService( ).updateProperties( m_repositoryId,
+            updatedIds, updatedProperties, options.getMaxConcurrency( ) );
+
+    vector< libcmis::UpdateResult > results;
+    vector< libcmis::UpdateResult >::iterator updateIt = updates.begin( );
+    for ( size_t i = 0; i < ids.size( ); ++i )
+    {
+        if ( errors[i] )
+            results.push_back( libcmis::UpdateResult( ids[i], *errors[i] ) );
+        else
+            results.push_back( *updateIt++ );
+    }
+    return results;
+}
+
 libcmis::ObjectPtr WSSession::getObjectByPath( string path )
 {
     return getObjectService( ).getObjectByPath( getRepositoryId( ), path );
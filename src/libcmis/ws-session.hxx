@@ -72,12 +72,22 @@ class WSSession : public BaseSession, public SoapSession
           */
         SoapResponseFactory& getResponseFactory( ) { return m_responseFactory; }
 
-        /** Try hard to get a WSDL file at the given URL (tries to add ?wsdl if needed)
+        /** Try hard to get a WSDL response at the given URL (tries to add ?wsdl if needed)
           */
-        std::string getWsdl( std::string url, libcmis::HttpResponsePtr response );
+        libcmis::HttpResponsePtr getWsdl( std::string url, libcmis::HttpResponsePtr response );
 
         std::vector< SoapResponsePtr > soapRequest( std::string& url, SoapRequest& request );
 
+        /** Prepare a SOAP request to be sent later using httpRunConcurrentRequests( ).
+            The responses need to be parsed with parseSoapResponse( ).
+          */
+        HttpTransferPtr createSoapTransfer( const std::string& url, SoapRequest& request );
+
+        /** Parse the SOAP response of a request, throwing the SOAP faults
+            as libcmis::Exception.
+          */
+        std::vector< SoapResponsePtr > parseSoapResponse( libcmis::HttpResponsePtr response );
+
         /** Get the service location URL given its name.
           */
         std::string getServiceUrl( std::string name );
@@ -99,6 +109,15 @@ class WSSession : public BaseSession, public SoapSession
 
         virtual libcmis::ObjectPtr getObject( std::string id );
 
+        virtual std::vector< libcmis::ObjectResult > getObjects( const std::vector< std::string >& ids,
+                                                                 const libcmis::BatchOptions& options = libcmis::BatchOptions( ) );
+
+        virtual std::vector< libcmis::UpdateResult > bulkUpdateProperties( const std::vector< std::string >& ids,
+                const libcmis::PropertyPtrMap& properties,
+                const std::vector< std::string >& addSecondaryTypes = std::vector< std::string >( ),
+                const std::vector< std::string >& removeSecondaryTypes = std::vector< std::string >( ),
+                const libcmis::BatchOptions& options = libcmis::BatchOptions( ) );
+
         virtual libcmis::ObjectPtr getObjectByPath( std::string path );
 
         virtual libcmis::ObjectTypePtr getType( std::string id );
@@ -113,6 +132,7 @@ class WSSession : public BaseSession, public SoapSession
         WSSession& operator=( const WSSession& copy ) = delete;
 
         void parseWsdl( const std::string& buf );
+        void parseWsdl( xmlDocPtr doc );
         void initializeResponseFactory( );
         void initializeRepositories( const std::map< std::string, std::string >& repositories );
         void initialize( libcmis::HttpResponsePtr response = libcmis::HttpResponsePtr() );
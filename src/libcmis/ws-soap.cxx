@@ -140,25 +140,26 @@ vector< SoapResponsePtr > SoapResponseFactory::parseResponse( RelatedMultipart&
     if ( part.get() != NULL )
         xml = part->getContent( );
 
-    vector< SoapResponsePtr > responses;
-
     const boost::shared_ptr< xmlDoc > doc( xmlReadMemory( xml.c_str(), xml.size(), "", NULL, 0 ), xmlFreeDoc );
 
-    if ( bool( doc ) )
-    {
-        const boost::shared_ptr< xmlXPathContext > xpathCtx( xmlXPathNewContext( doc.get() ), xmlXPathFreeContext );
-        libcmis::registerSoapNamespaces( xpathCtx.get() );
+    return parseResponse( doc.get( ), multipart );
+}
 
-        for ( map< string, string >::iterator it = m_namespaces.begin( );
-              it != m_namespaces.end( ); ++it )
-        {
-            xmlXPathRegisterNs( xpathCtx.get(), BAD_CAST( it->first.c_str() ),  BAD_CAST( it->second.c_str( ) ) );
-        }
+vector< SoapResponsePtr > SoapResponseFactory::parseResponse( xmlDocPtr doc, RelatedMultipart& multipart )
+{
+    vector< SoapResponsePtr > responses;
+
+    if ( NULL != doc )
+    {
+        // The pooled contexts already have the SOAP namespaces, and the
+        // responses are then found from their node namespace: the factory
+        // namespaces don't need to be registered.
+        libcmis::XPathContext xpathCtx( doc );
 
-        if ( bool( xpathCtx ) )
+        if ( NULL != xpathCtx.get( ) )
         {
             string bodyXPath( "//soap-env:Body/*" );
-            const boost::shared_ptr< xmlXPathObject > xpathObj( xmlXPathEvalExpression( BAD_CAST( bodyXPath.c_str() ), xpathCtx.get() ), xmlXPathFreeObject );
+            const boost::shared_ptr< xmlXPathObject > xpathObj( xpathCtx.eval( bodyXPath ), xmlXPathFreeObject );
 
             if ( bool( xpathObj ) )
             {
@@ -137,6 +137,11 @@ class SoapResponseFactory
          */
         std::vector< SoapResponsePtr > parseResponse( std::string& xml );
 
+        /** Extract the response objects from an already parsed Soap envelope. The related
+            parts referenced by the envelope are read from the multipart.
+          */
+        std::vector< SoapResponsePtr > parseResponse( xmlDocPtr doc, RelatedMultipart& multipart );
+
         /** Create a SoapResponse object depending on the node we have. This shouldn't be used
             directly: only from parseResponse or unit tests.
           */
@@ -28,43 +28,358 @@
 
 #include <libcmis/xml-utils.hxx>
 
+#include <algorithm>
 #include <errno.h>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <stdlib.h>
+#include <vector>
 
 #include <boost/algorithm/string.hpp>
-#include <boost/version.hpp>
-
-#if BOOST_VERSION >= 106800
-#include <boost/uuid/detail/sha1.hpp>
-#else
-#include <boost/uuid/sha1.hpp>
-#endif
 #include <curl/curl.h>
+#include <libxml/SAX2.h>
 
+#include "base64-kernels.hxx"
 
 using namespace std;
 
 namespace
 {
-    static const char chars64[]=
-          "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    /// Size of the buffers used to batch the encoded or decoded output
+    const size_t BASE64_OUTPUT_SIZE = 4096;
 
-    bool lcl_getBufValue( char encoded, int* value )
+    /** Process-wide store of the compiled XPath expressions and of the
+        idle XPath contexts with the libcmis namespaces registered.
+      */
+    class XPathCache
     {
-        bool found = false;
-        const char *i = chars64;
-        while ( !found && *i )
+        private:
+            static const size_t MAX_EXPRESSIONS = 512;
+            static const size_t MAX_IDLE_CONTEXTS = 16;
+
+            mutex m_mutex;
+            map< string, xmlXPathCompExprPtr > m_expressions;
+            vector< xmlXPathContextPtr > m_contexts;
+            xmlXPathContextPtr m_compileCtx;
+
+        public:
+            XPathCache( ) : m_mutex( ), m_expressions( ), m_contexts( ), m_compileCtx( NULL )
+            {
+            }
+
+            ~XPathCache( )
+            {
+                for ( map< string, xmlXPathCompExprPtr >::iterator it = m_expressions.begin( );
+                      it != m_expressions.end( ); ++it )
+                    xmlXPathFreeCompExpr( it->second );
+                for ( vector< xmlXPathContextPtr >::iterator it = m_contexts.begin( );
+                      it != m_contexts.end( ); ++it )
+                    xmlXPathFreeContext( *it );
+                xmlXPathFreeContext( m_compileCtx );
+            }
+
+            /** Get the compiled expression, or NULL if it can't be compiled.
+
+                \param owned set to true if the expression isn't cached and
+                    needs to be freed by the caller.
+              */
+            xmlXPathCompExprPtr getExpression( const string& req, bool& owned )
+            {
+                lock_guard< mutex > lock( m_mutex );
+                owned = false;
+
+                map< string, xmlXPathCompExprPtr >::iterator it = m_expressions.find( req );
+                if ( it != m_expressions.end( ) )
+                    return it->second;
+
+                // Compile with the namespaces at hand to get the best libxml2 optimizations
+                if ( m_compileCtx == NULL )
+                    m_compileCtx = newContext( );
+                xmlXPathCompExprPtr comp = xmlXPathCtxtCompile( m_compileCtx, BAD_CAST( req.c_str( ) ) );
+
+                if ( m_expressions.size( ) < MAX_EXPRESSIONS )
+                    m_expressions[req] = comp;
+                else
+                    owned = true;
+                return comp;
+            }
+
+            xmlXPathContextPtr acquireContext( )
+            {
+                lock_guard< mutex > lock( m_mutex );
+                if ( m_contexts.empty( ) )
+                    return newContext( );
+
+                xmlXPathContextPtr ctx = m_contexts.back( );
+                m_contexts.pop_back( );
+                return ctx;
+            }
+
+            void releaseContext( xmlXPathContextPtr ctx )
+            {
+                if ( ctx == NULL )
+                    return;
+
+                ctx->doc = NULL;
+                ctx->node = NULL;
+
+                lock_guard< mutex > lock( m_mutex );
+                if ( m_contexts.size( ) < MAX_IDLE_CONTEXTS )
+                    m_contexts.push_back( ctx );
+                else
+                    xmlXPathFreeContext( ctx );
+            }
+
+        private:
+            XPathCache( const XPathCache& );
+            XPathCache& operator=( const XPathCache& );
+
+            static xmlXPathContextPtr newContext( )
+            {
+                xmlXPathContextPtr ctx = xmlXPathNewContext( NULL );
+                libcmis::registerNamespaces( ctx );
+                libcmis::registerCmisWSNamespaces( ctx );
+                return ctx;
+            }
+    };
+
+    /** Stream buffer dropping everything written to it.
+      */
+    class NullStreamBuf : public streambuf
+    {
+        protected:
+            virtual streamsize xsputn( const char*, streamsize n ) { return n; }
+            virtual int_type overflow( int_type c ) { return traits_type::not_eof( c ); }
+    };
+
+    /** Stream buffer reading a string in place.
+      */
+    class StringViewBuf : public streambuf
+    {
+        public:
+            StringViewBuf( const string& data )
+            {
+                char* begin = const_cast< char* >( data.data( ) );
+                setg( begin, begin, begin + data.size( ) );
+            }
+
+        protected:
+            virtual pos_type seekoff( off_type off, ios_base::seekdir dir, ios_base::openmode )
+            {
+                off_type pos = off;
+                if ( dir == ios_base::cur )
+                    pos += gptr( ) - eback( );
+                else if ( dir == ios_base::end )
+                    pos += egptr( ) - eback( );
+                return seekpos( pos_type( pos ), ios_base::in );
+            }
+
+            virtual pos_type seekpos( pos_type pos, ios_base::openmode )
+            {
+                off_type offset( pos );
+                if ( offset < 0 || offset > egptr( ) - eback( ) )
+                    return pos_type( off_type( -1 ) );
+
+                setg( eback( ), eback( ) + offset, egptr( ) );
+                return pos;
+            }
+    };
+
+    /** Stream reading the body of a response in place, keeping the response alive.
+      */
+    class HttpResponseStream : public istream
+    {
+        private:
+            libcmis::HttpResponsePtr m_response;
+            StringViewBuf m_buf;
+
+        public:
+            HttpResponseStream( libcmis::HttpResponsePtr response ) :
+                istream( NULL ),
+                m_response( response ),
+                m_buf( response->getBody( ) )
+            {
+                rdbuf( &m_buf );
+            }
+    };
+
+    XPathCache& lcl_getXPathCache( )
+    {
+        static XPathCache cache;
+        return cache;
+    }
+
+    /** Read a fixed number of decimal digits.
+
+        \return
+            false if one of the characters isn't a digit.
+      */
+    bool lcl_readDigits( const char* str, size_t count, long& value )
+    {
+        value = 0;
+        for ( size_t i = 0; i < count; ++i )
+        {
+            if ( str[i] < '0' || str[i] > '9' )
+                return false;
+            value = value * 10 + ( str[i] - '0' );
+        }
+        return true;
+    }
+
+    void lcl_writeDigits( char* str, size_t count, long value )
+    {
+        for ( size_t i = count; i > 0; --i )
+        {
+            str[i - 1] = char( '0' + value % 10 );
+            value /= 10;
+        }
+    }
+
+    /** Parse the common YYYY-MM-DDThh:mm:ss[.fff][Z|(+|-)hh:mm] xsd:dateTime form.
+
+        \return
+            false if the string isn't in that form and needs the complete parser.
+            Invalid dates in the right form are returned as not_a_date_time.
+      */
+    bool lcl_parseDateTimeFast( const string& str, boost::posix_time::ptime& result )
+    {
+        const char* s = str.c_str( );
+        size_t size = str.size( );
+        if ( size < 19 || s[4] != '-' || s[7] != '-' || s[10] != 'T' ||
+             s[13] != ':' || s[16] != ':' )
+            return false;
+
+        long year, month, day, hours, minutes, seconds;
+        if ( !lcl_readDigits( s, 4, year ) || !lcl_readDigits( s + 5, 2, month ) ||
+             !lcl_readDigits( s + 8, 2, day ) || !lcl_readDigits( s + 11, 2, hours ) ||
+             !lcl_readDigits( s + 14, 2, minutes ) || !lcl_readDigits( s + 17, 2, seconds ) )
+            return false;
+
+        // Let the complete parser handle the overflowing values
+        if ( hours > 23 || minutes > 59 || seconds > 59 )
+            return false;
+
+        size_t pos = 19;
+        boost::int64_t fraction = 0;
+        if ( pos < size && s[pos] == '.' )
         {
-            if ( *i == encoded )
+            const size_t maxDigits = boost::posix_time::time_duration::num_fractional_digits( );
+            size_t digits = 0;
+            ++pos;
+            while ( pos < size && s[pos] >= '0' && s[pos] <= '9' )
             {
-                found = true;
-                *value = ( i - chars64 );
+                if ( ++digits > maxDigits )
+                    return false;
+                fraction = fraction * 10 + ( s[pos] - '0' );
+                ++pos;
             }
-            ++i;
+            if ( digits == 0 )
+                return false;
+            for ( ; digits < maxDigits; ++digits )
+                fraction *= 10;
+        }
+
+        long tzMinutes = 0;
+        if ( pos == size - 1 && s[pos] == 'Z' )
+            ++pos;
+        else if ( pos + 6 == size && ( s[pos] == '+' || s[pos] == '-' ) && s[pos + 3] == ':' )
+        {
+            long tzHours, tzMins;
+            if ( !lcl_readDigits( s + pos + 1, 2, tzHours ) || !lcl_readDigits( s + pos + 4, 2, tzMins ) ||
+                 tzMins > 59 )
+                return false;
+            tzMinutes = tzHours * 60 + tzMins;
+            if ( s[pos] == '-' )
+                tzMinutes = -tzMinutes;
+            pos = size;
+        }
+        if ( pos != size )
+            return false;
+
+        result = boost::posix_time::ptime( boost::date_time::not_a_date_time );
+        try
+        {
+            boost::gregorian::date date( year, month, day );
+            result = boost::posix_time::ptime( date,
+                        boost::posix_time::time_duration( hours, minutes, seconds, fraction ) ) +
+                     boost::posix_time::minutes( tzMinutes );
         }
-        return found;
+        catch ( const std::exception& )
+        {
+            // Invalid date: will result in not_a_date_time
+        }
+        return true;
+    }
+
+    /// Complete xsd:dateTime parser for the forms lcl_parseDateTimeFast( ) doesn't handle
+    boost::posix_time::ptime lcl_parseDateTimeSlow( const string& dateTimeStr )
+    {
+        boost::posix_time::ptime t( boost::date_time::not_a_date_time );
+        // Get the time zone offset
+        boost::posix_time::time_duration tzOffset( 0, 0, 0 );
+
+        if ( dateTimeStr.empty( ) )
+            return t; // obviously not a time
+
+        size_t teePos = dateTimeStr.find( 'T' );
+        if ( teePos == string::npos || teePos == dateTimeStr.size() - 1 )
+            return t; // obviously not a time
+
+        string noTzStr = dateTimeStr.substr( 0, teePos + 1 );
+        string timeStr = dateTimeStr.substr( teePos + 1 );
+
+        // Get the TZ if any
+        if ( timeStr[ timeStr.size() - 1] == 'Z' )
+        {
+            noTzStr += timeStr.substr( 0, timeStr.size() - 1 );
+        }
+        else
+        {
+            size_t tzPos = timeStr.find( '+' );
+            if ( tzPos == string::npos )
+                tzPos = timeStr.find( '-' );
+
+            if ( tzPos != string::npos )
+            {
+                noTzStr += timeStr.substr( 0, tzPos );
+
+                // Check the validity of the TZ value
+                string tzStr = timeStr.substr( tzPos );
+                try
+                {
+                    tzOffset = boost::posix_time::time_duration( boost::posix_time::duration_from_string( tzStr.c_str() ) );
+                }
+                catch ( const std::exception& )
+                {
+                    // Error converting, not a datetime
+                    return t;
+                }
+
+            }
+            else
+                noTzStr += timeStr;
+        }
+
+        // Remove all the '-' and ':'
+        size_t pos = noTzStr.find_first_of( ":-" );
+        while ( pos != string::npos )
+        {
+            noTzStr.erase( pos, 1 );
+            pos = noTzStr.find_first_of( ":-" );
+        }
+        try
+        {
+            t = boost::posix_time::from_iso_string( noTzStr.c_str( ) );
+            t = t + tzOffset;
+        }
+        catch ( const std::exception& )
+        {
+            // Ignore boost parsing errors: will result in not_a_date_time
+        }
+
+        return t;
     }
 }
 
@@ -74,6 +389,9 @@ namespace libcmis
         m_writer( NULL ),
         m_stream( stream ),
         m_outStream( NULL ),
+        m_buffer( NULL ),
+        m_parser( NULL ),
+        m_sink( NULL ),
         m_encoding( ),
         m_decode( false ),
         m_pendingValue( 0 ),
@@ -86,6 +404,24 @@ namespace libcmis
         m_writer( NULL ),
         m_stream( NULL ),
         m_outStream( stream ),
+        m_buffer( NULL ),
+        m_parser( NULL ),
+        m_sink( NULL ),
+        m_encoding( ),
+        m_decode( false ),
+        m_pendingValue( 0 ),
+        m_pendingRank( 0 ),
+        m_missingBytes( 0 )
+    {
+    }
+
+    EncodedData::EncodedData( string* buffer ) :
+        m_writer( NULL ),
+        m_stream( NULL ),
+        m_outStream( NULL ),
+        m_buffer( buffer ),
+        m_parser( NULL ),
+        m_sink( NULL ),
         m_encoding( ),
         m_decode( false ),
         m_pendingValue( 0 ),
@@ -98,6 +434,9 @@ namespace libcmis
         m_writer( writer ),
         m_stream( NULL ),
         m_outStream( NULL ),
+        m_buffer( NULL ),
+        m_parser( NULL ),
+        m_sink( NULL ),
         m_encoding( ),
         m_decode( false ),
         m_pendingValue( 0 ),
@@ -110,6 +449,9 @@ namespace libcmis
         m_writer( copy.m_writer ),
         m_stream( copy.m_stream ),
         m_outStream( copy.m_outStream ),
+        m_buffer( copy.m_buffer ),
+        m_parser( copy.m_parser ),
+        m_sink( copy.m_sink ),
         m_encoding( copy.m_encoding ),
         m_decode( copy.m_decode ),
         m_pendingValue( copy.m_pendingValue ),
@@ -125,6 +467,9 @@ namespace libcmis
             m_writer = copy.m_writer;
             m_stream = copy.m_stream;
             m_outStream = copy.m_outStream;
+            m_buffer = copy.m_buffer;
+            m_parser = copy.m_parser;
+            m_sink = copy.m_sink;
             m_encoding = copy.m_encoding;
             m_decode = copy.m_decode;
             m_pendingValue = copy.m_pendingValue;
@@ -136,12 +481,19 @@ namespace libcmis
 
     void EncodedData::write( void* buf, size_t size, size_t nmemb )
     {
-        if ( m_writer )
+        if ( m_sink )
+            m_sink->sputn( ( const char* )buf, streamsize( size * nmemb ) );
+        else if ( m_writer )
             xmlTextWriterWriteRawLen( m_writer, ( xmlChar* )buf, size * nmemb );
         else if ( m_stream )
             fwrite( buf, size, nmemb, m_stream );
         else if ( m_outStream )
             m_outStream->write( ( const char* )buf, size * nmemb );
+        else if ( m_buffer )
+            m_buffer->append( ( const char* )buf, size * nmemb );
+
+        if ( m_parser )
+            xmlParseChunk( m_parser, ( const char* )buf, int( size * nmemb ), 0 );
     }
 
     void EncodedData::decode( void* buf, size_t size, size_t nmemb )
@@ -192,10 +544,10 @@ namespace libcmis
             {
                 // Missing bytes should be zeroed: no need to do it
                 char encoded[4];
-                encoded[0] = chars64[ ( m_pendingValue & 0xFC0000 ) >> 18 ];
-                encoded[1] = chars64[ ( m_pendingValue & 0x03F000 ) >> 12 ];
-                encoded[2] = chars64[ ( m_pendingValue & 0x000FC0 ) >> 6  ];
-                encoded[3] = chars64[ ( m_pendingValue & 0x00003F )       ];
+                encoded[0] = base64Chars[ ( m_pendingValue & 0xFC0000 ) >> 18 ];
+                encoded[1] = base64Chars[ ( m_pendingValue & 0x03F000 ) >> 12 ];
+                encoded[2] = base64Chars[ ( m_pendingValue & 0x000FC0 ) >> 6  ];
+                encoded[3] = base64Chars[ ( m_pendingValue & 0x00003F )       ];
 
                 // Output the padding
                 int nEquals = 3 - m_pendingRank;
@@ -212,15 +564,30 @@ namespace libcmis
 
     void EncodedData::decodeBase64( const char* buf, size_t len )
     {
+        const unsigned char* in = reinterpret_cast< const unsigned char* >( buf );
         unsigned long blockValue = m_pendingValue;
         int byteRank = m_pendingRank;
         int missingBytes = m_missingBytes;
 
+        // Batch the decoded bytes rather than writing each block
+        char decoded[ BASE64_OUTPUT_SIZE ];
+        size_t decodedSize = 0;
+
         size_t i = 0;
         while ( i < len )
         {
-            int value = 0;
-            if ( lcl_getBufValue( buf[i], &value ) )
+            // Decode whole blocks of valid characters at once, with the SIMD
+            // kernel the CPU supports if any
+            if ( byteRank == 0 )
+            {
+                i += getBase64Kernel( ).m_decode( in + i, len - i,
+                                                  decoded, decodedSize, BASE64_OUTPUT_SIZE );
+                if ( i >= len )
+                    break;
+            }
+
+            int value = base64Values[ in[i] ];
+            if ( value >= 0 )
             {
                 blockValue += value << ( ( 3 - byteRank ) * 6 );
                 ++byteRank;
@@ -234,20 +601,33 @@ namespace libcmis
             // Reached the end of a block, decode it
             if ( byteRank >= 4 )
             {
-                char decoded[3];
-                decoded[0] = ( blockValue & 0xFF0000 ) >> 16;
-                decoded[1] = ( blockValue & 0xFF00 ) >> 8;
-                decoded[2] = ( blockValue & 0xFF );
+                if ( decodedSize + 3 > BASE64_OUTPUT_SIZE )
+                {
+                    write( decoded, 1, decodedSize );
+                    decodedSize = 0;
+                }
 
-                write( decoded, 1, 3 - missingBytes );
+                decoded[ decodedSize++ ] = ( blockValue & 0xFF0000 ) >> 16;
+                decoded[ decodedSize++ ] = ( blockValue & 0xFF00 ) >> 8;
+                decoded[ decodedSize++ ] = ( blockValue & 0xFF );
+                decodedSize -= std::min( size_t( missingBytes ), size_t( 3 ) );
 
                 byteRank = 0;
                 blockValue = 0;
                 missingBytes = 0;
             }
             ++i;
+
+            if ( decodedSize + 3 > BASE64_OUTPUT_SIZE )
+            {
+                write( decoded, 1, decodedSize );
+                decodedSize = 0;
+            }
         }
 
+        if ( decodedSize > 0 )
+            write( decoded, 1, decodedSize );
+
         // Store the values if the last block is incomplete: they may come later
         m_pendingValue = blockValue;
         m_pendingRank = byteRank;
@@ -256,26 +636,42 @@ namespace libcmis
 
     void EncodedData::encodeBase64( const char* buf, size_t len )
     {
+        const unsigned char* in = reinterpret_cast< const unsigned char* >( buf );
         unsigned long blockValue = m_pendingValue;
         int byteRank = m_pendingRank;
 
+        // Batch the encoded characters rather than writing each block
+        char encoded[ BASE64_OUTPUT_SIZE ];
+        size_t encodedSize = 0;
+
         size_t i = 0;
         while ( i < len )
         {
-            // Cast the char to an unsigned char or we'll shift negative values
-            blockValue += static_cast< unsigned char >( buf[i] ) << ( 2 - byteRank ) * 8;
+            // Encode whole blocks at once, with the SIMD kernel the CPU supports if any
+            if ( byteRank == 0 )
+            {
+                i += getBase64Kernel( ).m_encode( in + i, len - i,
+                                                  encoded, encodedSize, BASE64_OUTPUT_SIZE );
+                if ( encodedSize + 4 > BASE64_OUTPUT_SIZE )
+                {
+                    write( encoded, 1, encodedSize );
+                    encodedSize = 0;
+                    continue;
+                }
+                if ( i >= len )
+                    break;
+            }
+
+            blockValue += in[i] << ( 2 - byteRank ) * 8;
             ++byteRank;
 
             // Reached the end of a block, encode it
             if ( byteRank >= 3 )
             {
-                char encoded[4];
-                encoded[0] = chars64[ ( blockValue & 0xFC0000 ) >> 18 ];
-                encoded[1] = chars64[ ( blockValue & 0x03F000 ) >> 12 ];
-                encoded[2] = chars64[ ( blockValue & 0x000FC0 ) >> 6  ];
-                encoded[3] = chars64[ ( blockValue & 0x00003F )       ];
-
-                write( encoded, 1, 4 );
+                encoded[ encodedSize++ ] = base64Chars[ ( blockValue & 0xFC0000 ) >> 18 ];
+                encoded[ encodedSize++ ] = base64Chars[ ( blockValue & 0x03F000 ) >> 12 ];
+                encoded[ encodedSize++ ] = base64Chars[ ( blockValue & 0x000FC0 ) >> 6  ];
+                encoded[ encodedSize++ ] = base64Chars[ ( blockValue & 0x00003F )       ];
 
                 byteRank = 0;
                 blockValue = 0;
@@ -283,6 +679,9 @@ namespace libcmis
             ++i;
         }
 
+        if ( encodedSize > 0 )
+            write( encoded, 1, encodedSize );
+
         // Store the values if the last block is incomplete: they may come later
         m_pendingValue = blockValue;
         m_pendingRank = byteRank;
@@ -290,11 +689,186 @@ namespace libcmis
 
     HttpResponse::HttpResponse( ) :
         m_headers( ),
-        m_stream( ),
-        m_data( )
+        m_body( ),
+        m_data( ),
+        m_bodySink( ),
+        m_xmlTextFilter( ),
+        m_xmlParser( NULL ),
+        m_xmlDoc( NULL ),
+        m_xmlParsed( false )
+    {
+        m_data.reset( new EncodedData( &m_body ) );
+    }
+
+    HttpResponse::~HttpResponse( )
+    {
+        resetXml( );
+    }
+
+    void HttpResponse::setBody( const string& body )
+    {
+        m_body = body;
+        resetXml( );
+        m_data->setSink( NULL );
+        m_bodySink.reset( );
+    }
+
+    void HttpResponse::setBodySink( boost::shared_ptr< streambuf > sink )
+    {
+        // Some of the body is already in the buffer: keep it all there
+        if ( !m_body.empty( ) )
+            return;
+
+        // The headers of redirections are received too: the last ones win
+        m_bodySink = sink;
+        m_data->setSink( sink.get( ) );
+    }
+
+    void HttpResponse::setXmlContent( bool isXml )
+    {
+        // Too late to see the whole body, it will be parsed when needed
+        if ( !m_body.empty( ) || m_xmlParsed )
+            return;
+
+        // The headers of redirections are received too: the last ones win
+        if ( !isXml )
+            resetXml( );
+        else if ( m_xmlParser == NULL )
+        {
+            m_xmlParser = xmlCreatePushParserCtxt( NULL, NULL, NULL, 0, NULL );
+            if ( m_xmlParser != NULL )
+                xmlCtxtUseOptions( m_xmlParser, XML_PARSE_NOERROR | XML_PARSE_NOWARNING );
+            m_data->setParser( m_xmlParser );
+            hookXmlParser( );
+        }
+    }
+
+    void HttpResponse::setXmlTextFilter( boost::shared_ptr< XmlTextFilter > filter )
+    {
+        if ( !m_body.empty( ) || m_xmlParsed )
+            return;
+
+        // The headers of redirections are received too: the last ones win
+        m_xmlTextFilter = filter;
+        hookXmlParser( );
+    }
+
+    void HttpResponse::hookXmlParser( )
+    {
+        if ( m_xmlParser == NULL || m_xmlParser->sax == NULL )
+            return;
+
+        xmlSAXHandlerPtr sax = m_xmlParser->sax;
+        if ( m_xmlTextFilter )
+        {
+            m_xmlParser->_private = this;
+            sax->startElementNs = filterStartElement;
+            sax->endElementNs = filterEndElement;
+            sax->characters = filterCharacters;
+        }
+        else
+        {
+            m_xmlParser->_private = NULL;
+            sax->startElementNs = xmlSAX2StartElementNs;
+            sax->endElementNs = xmlSAX2EndElementNs;
+            sax->characters = xmlSAX2Characters;
+        }
+    }
+
+    void HttpResponse::filterStartElement( void* ctx, const xmlChar* localname, const xmlChar* prefix,
+            const xmlChar* uri, int nbNamespaces, const xmlChar** namespaces,
+            int nbAttributes, int nbDefaulted, const xmlChar** attributes )
+    {
+        xmlSAX2StartElementNs( ctx, localname, prefix, uri, nbNamespaces, namespaces,
+                               nbAttributes, nbDefaulted, attributes );
+
+        xmlParserCtxtPtr ctxt = static_cast< xmlParserCtxtPtr >( ctx );
+        HttpResponse* response = static_cast< HttpResponse* >( ctxt->_private );
+        if ( ctxt->node != NULL )
+            response->m_xmlTextFilter->startElement( ctxt->node );
+    }
+
+    void HttpResponse::filterEndElement( void* ctx, const xmlChar* localname, const xmlChar* prefix,
+            const xmlChar* uri )
+    {
+        xmlParserCtxtPtr ctxt = static_cast< xmlParserCtxtPtr >( ctx );
+        HttpResponse* response = static_cast< HttpResponse* >( ctxt->_private );
+        if ( ctxt->node != NULL )
+            response->m_xmlTextFilter->endElement( ctxt->node );
+
+        xmlSAX2EndElementNs( ctx, localname, prefix, uri );
+    }
+
+    void HttpResponse::filterCharacters( void* ctx, const xmlChar* text, int len )
+    {
+        xmlParserCtxtPtr ctxt = static_cast< xmlParserCtxtPtr >( ctx );
+        HttpResponse* response = static_cast< HttpResponse* >( ctxt->_private );
+        if ( ctxt->node == NULL || !response->m_xmlTextFilter->characters( ctxt->node, text, len ) )
+        {
+            xmlSAX2Characters( ctx, text, len );
+            return;
+        }
+
+        // The filtered text would only bloat the body: stop keeping it
+        if ( !response->m_bodySink )
+        {
+            response->m_bodySink.reset( new NullStreamBuf( ) );
+            response->m_data->setSink( response->m_bodySink.get( ) );
+            string( ).swap( response->m_body );
+        }
+    }
+
+    xmlDocPtr HttpResponse::getXmlDoc( )
+    {
+        if ( !m_xmlParsed )
+        {
+            m_xmlParsed = true;
+            if ( m_xmlParser != NULL )
+            {
+                xmlParseChunk( m_xmlParser, NULL, 0, 1 );
+                if ( m_xmlParser->wellFormed )
+                    m_xmlDoc = m_xmlParser->myDoc;
+                else
+                    xmlFreeDoc( m_xmlParser->myDoc );
+                m_xmlParser->myDoc = NULL;
+
+                m_data->setParser( NULL );
+                xmlFreeParserCtxt( m_xmlParser );
+                m_xmlParser = NULL;
+            }
+            else if ( !m_body.empty( ) )
+            {
+                m_xmlDoc = xmlReadMemory( m_body.c_str( ), m_body.size( ), NULL, NULL,
+                                          XML_PARSE_NOERROR | XML_PARSE_NOWARNING );
+            }
+        }
+        return m_xmlDoc;
+    }
+
+    void HttpResponse::resetXml( )
+    {
+        if ( m_xmlParser != NULL )
+        {
+            m_data->setParser( NULL );
+            xmlFreeDoc( m_xmlParser->myDoc );
+            xmlFreeParserCtxt( m_xmlParser );
+            m_xmlParser = NULL;
+        }
+        xmlFreeDoc( m_xmlDoc );
+        m_xmlDoc = NULL;
+        m_xmlParsed = false;
+    }
+
+    void HttpResponse::reserveBody( size_t size )
+    {
+        // Don't trust insanely big announced sizes, the buffer can still grow
+        const size_t maxReserve = 64 * 1024 * 1024;
+        m_body.reserve( min( size, maxReserve ) );
+    }
+
+    boost::shared_ptr< istream > HttpResponse::getStream( )
     {
-        m_stream.reset( new stringstream( ) );
-        m_data.reset( new EncodedData( m_stream.get( ) ) );
+        return boost::shared_ptr< istream >( new HttpResponseStream( shared_from_this( ) ) );
     }
 
     void registerNamespaces( xmlXPathContextPtr xpathCtx )
@@ -342,7 +916,7 @@ namespace libcmis
         string value;
         if ( xpathCtx != NULL )
         {
-            xmlXPathObjectPtr xpathObj = xmlXPathEvalExpression( BAD_CAST( req.c_str() ), xpathCtx );
+            xmlXPathObjectPtr xpathObj = evalXPath( xpathCtx, req );
             if ( xpathObj && xpathObj->nodesetval && xpathObj->nodesetval->nodeNr > 0 )
             {
                 xmlChar* pContent = xmlNodeGetContent( xpathObj->nodesetval->nodeTab[0] );
@@ -355,6 +929,45 @@ namespace libcmis
         return value;
     }
 
+    xmlXPathObjectPtr evalXPath( xmlXPathContextPtr xpathCtx, const string& req )
+    {
+        if ( xpathCtx == NULL )
+            return NULL;
+
+        bool owned = false;
+        xmlXPathCompExprPtr comp = lcl_getXPathCache( ).getExpression( req, owned );
+        if ( comp == NULL )
+            return NULL;
+
+        xmlXPathObjectPtr xpathObj = xmlXPathCompiledEval( comp, xpathCtx );
+        if ( owned )
+            xmlXPathFreeCompExpr( comp );
+        return xpathObj;
+    }
+
+    XPathContext::XPathContext( xmlDocPtr doc, xmlNodePtr node ) :
+        m_ctx( lcl_getXPathCache( ).acquireContext( ) )
+    {
+        if ( m_ctx != NULL )
+        {
+            m_ctx->doc = doc;
+            m_ctx->node = node;
+            m_ctx->contextSize = -1;
+            m_ctx->proximityPosition = -1;
+        }
+    }
+
+    XPathContext::~XPathContext( )
+    {
+        lcl_getXPathCache( ).releaseContext( m_ctx );
+    }
+
+    void XPathContext::setNode( xmlNodePtr node )
+    {
+        if ( m_ctx != NULL )
+            m_ctx->node = node;
+    }
+
     xmlDocPtr wrapInDoc( xmlNodePtr entryNd )
     {
         xmlDocPtr doc = xmlNewDoc(BAD_CAST "1.0");
@@ -366,6 +979,13 @@ namespace libcmis
         return doc;
     }
 
+    bool isXmlElement( xmlNodePtr node, const char* nsUrl, const char* name )
+    {
+        return node != NULL && node->type == XML_ELEMENT_NODE &&
+               node->ns != NULL && xmlStrEqual( node->ns->href, BAD_CAST( nsUrl ) ) &&
+               xmlStrEqual( node->name, BAD_CAST( name ) );
+    }
+
     string getXmlNodeAttributeValue( xmlNodePtr node,
                                      const char* attributeName,
                                      const char* defaultValue )
@@ -386,68 +1006,8 @@ namespace libcmis
     boost::posix_time::ptime parseDateTime( const string& dateTimeStr )
     {
         boost::posix_time::ptime t( boost::date_time::not_a_date_time );
-        // Get the time zone offset
-        boost::posix_time::time_duration tzOffset( boost::posix_time::duration_from_string( "+00:00" ) );
-
-        if ( dateTimeStr.empty( ) )
-            return t; // obviously not a time
-
-        size_t teePos = dateTimeStr.find( 'T' );
-        if ( teePos == string::npos || teePos == dateTimeStr.size() - 1 )
-            return t; // obviously not a time
-
-        string noTzStr = dateTimeStr.substr( 0, teePos + 1 );
-        string timeStr = dateTimeStr.substr( teePos + 1 );
-
-        // Get the TZ if any
-        if ( timeStr[ timeStr.size() - 1] == 'Z' )
-        {
-            noTzStr += timeStr.substr( 0, timeStr.size() - 1 );
-        }
-        else
-        {
-            size_t tzPos = timeStr.find( '+' );
-            if ( tzPos == string::npos )
-                tzPos = timeStr.find( '-' );
-
-            if ( tzPos != string::npos )
-            {
-                noTzStr += timeStr.substr( 0, tzPos );
-
-                // Check the validity of the TZ value
-                string tzStr = timeStr.substr( tzPos );
-                try
-                {
-                    tzOffset = boost::posix_time::time_duration( boost::posix_time::duration_from_string( tzStr.c_str() ) );
-                }
-                catch ( const std::exception& )
-                {
-                    // Error converting, not a datetime
-                    return t;
-                }
-
-            }
-            else
-                noTzStr += timeStr;
-        }
-
-        // Remove all the '-' and ':'
-        size_t pos = noTzStr.find_first_of( ":-" );
-        while ( pos != string::npos )
-        {
-            noTzStr.erase( pos, 1 );
-            pos = noTzStr.find_first_of( ":-" );
-        }
-        try
-        {
-            t = boost::posix_time::from_iso_string( noTzStr.c_str( ) );
-            t = t + tzOffset;
-        }
-        catch ( const std::exception& )
-        {
-            // Ignore boost parsing errors: will result in not_a_date_time
-        }
-
+        if ( !lcl_parseDateTimeFast( dateTimeStr, t ) )
+            t = lcl_parseDateTimeSlow( dateTimeStr );
         return t;
     }
 
@@ -456,8 +1016,34 @@ namespace libcmis
         string str;
         if ( !time.is_special( ) )
         {
-            str = boost::posix_time::to_iso_extended_string( time );
-            str += "Z";
+            // YYYY-MM-DDThh:mm:ss[.fff]Z written without any stream or temporary string
+            char buf[64];
+            boost::gregorian::date date = time.date( );
+            boost::posix_time::time_duration timeOfDay = time.time_of_day( );
+
+            lcl_writeDigits( buf, 4, date.year( ) );
+            buf[4] = '-';
+            lcl_writeDigits( buf + 5, 2, date.month( ) );
+            buf[7] = '-';
+            lcl_writeDigits( buf + 8, 2, date.day( ) );
+            buf[10] = 'T';
+            lcl_writeDigits( buf + 11, 2, timeOfDay.hours( ) );
+            buf[13] = ':';
+            lcl_writeDigits( buf + 14, 2, timeOfDay.minutes( ) );
+            buf[16] = ':';
+            lcl_writeDigits( buf + 17, 2, timeOfDay.seconds( ) );
+            size_t size = 19;
+
+            boost::int64_t fraction = timeOfDay.fractional_seconds( );
+            if ( fraction != 0 )
+            {
+                size_t digits = boost::posix_time::time_duration::num_fractional_digits( );
+                buf[size++] = '.';
+                lcl_writeDigits( buf + size, digits, fraction );
+                size += digits;
+            }
+            buf[size++] = 'Z';
+            str.assign( buf, size );
         }
         return str;
     }
@@ -476,16 +1062,30 @@ namespace libcmis
 
     long parseInteger( const string& intStr )
     {
+        // Fast path for plain decimal numbers: no leading zero as strtol
+        // would read them as octal, and few enough digits to fit in a long
+        // whatever its size.
+        const char* str = intStr.c_str( );
+        size_t size = intStr.size( );
+        size_t start = ( size > 1 && ( str[0] == '-' || str[0] == '+' ) ) ? 1 : 0;
+        size_t maxDigits = numeric_limits< long >::digits10;
+        long value = 0;
+        if ( size > start && size - start <= maxDigits && ( str[start] != '0' || size - start == 1 ) &&
+             lcl_readDigits( str + start, size - start, value ) )
+        {
+            return str[0] == '-' ? -value : value;
+        }
+
         char* end;
         errno = 0;
-        long value = strtol( intStr.c_str(), &end, 0 );
+        value = strtol( str, &end, 0 );
 
         if ( ( ERANGE == errno && ( LONG_MAX == value || LONG_MIN == value ) ) ||
              ( errno != 0 && value == 0 ) )
         {
             throw Exception( string( "xsd:integer input can't fit to long: " ) + intStr );
         }
-        else if ( !string( end ).empty( ) )
+        else if ( *end != '\0' )
         {
             throw Exception( string( "Invalid xsd:integer input: " ) + intStr );
         }
@@ -503,7 +1103,7 @@ namespace libcmis
         {
             throw Exception( string( "xsd:decimal input can't fit to double: " ) + doubleStr );
         }
-        else if ( !string( end ).empty( ) )
+        else if ( *end != '\0' )
         {
             throw Exception( string( "Invalid xsd:decimal input: " ) + doubleStr );
         }
@@ -526,24 +1126,6 @@ namespace libcmis
         return stream.str();
     }
 
-    std::string sha1( const std::string& str )
-    {
-        boost::uuids::detail::sha1 sha1;
-        sha1.process_bytes( str.c_str(), str.size() );
-
-        unsigned int digest[5];
-        sha1.get_digest( digest );
-
-        stringstream out;
-        // Setup writing mode. Every number must produce eight
-        // hexadecimal digits, including possible leading 0s, or we get
-        // less than 40 digits as result.
-        out << hex << setfill('0') << right;
-        for ( int i = 0; i < 5; ++i )
-            out << setw(8) << digest[i];
-        return out.str();
-    }
-
     int stringstream_write_callback( void * context, const char * s, int len )
     {
         stringstream * ss=static_cast< stringstream * >( context );